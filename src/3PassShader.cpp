@@ -49,7 +49,7 @@ static bool CompileHlsl(const char* hlsl, const char* entry, const char* target,
 }
 
 // This file contains a 3-pass compute pipeline (DepthRaw, DepthSmooth, ParallaxSbs).
-// Renderer binds and dispatches all three passes.
+// Renderer binds and dispatches all three passes, or the single fused pass (CSDepthFused).
 static const char* kThreePassHlsl = R"HLSL(
 // ------------------------------------------------------------
 // Common resources
@@ -57,6 +57,7 @@ static const char* kThreePassHlsl = R"HLSL(
 Texture2D srcTex              : register(t0);
 Texture2D<float> depthRawTex  : register(t1); // NOTE: renderer binds *smoothed depth* here for pass 3
 Texture2D<float> depthPrevTex : register(t2);
+Buffer<float2> toneLut        : register(t3); // (curve_blend, shaped) over g_soft in [0, 1]
 SamplerState samp0            : register(s0);
 
 RWTexture2D<float>      depthRawOut    : register(u0);
@@ -68,7 +69,7 @@ cbuffer CSParams : register(b0)
 {
     uint  outWidth;
     uint  outHeight;
-    uint  mode3d;      // 0 = fullscreen, 1 = OU, 2 = SBS
+    uint  mode3d;      // output layout (Renderer::StereoLayout): 1 = OU, 2 = half SBS, 3 = full SBS, 4 = 2D + depth
     int   zoomLevel;
 
     float parallaxPx;
@@ -105,12 +106,21 @@ void EyeMapping(uint2 gid, out bool rightEye, out uint localX, out uint viewW, o
 // ------------------------------------------------------------
 // PASS 1: Depth-from-luma
 // ------------------------------------------------------------
-[numthreads(16, 16, 1)]
-void CSDepthRaw(uint3 tid : SV_DispatchThreadID)
+// The 5-layer curve blend and dark-push shaping depend on g_soft alone, so the renderer uploads
+// them as a table (DepthCpu::Kernels::BuildToneCurveLut, which also holds the analytic form).
+static const uint kToneLutSize = 1024; // DepthCpu::Kernels::kToneCurveLutSize
+
+void ToneCurveLookup(float g_soft, out float curve_blend, out float shaped)
 {
-    uint2 gid = tid.xy;
-    if (gid.x >= outWidth || gid.y >= outHeight) return;
+    float x = saturate(g_soft) * float(kToneLutSize - 1);
+    uint i = min(uint(x), kToneLutSize - 2);
+    float2 e = lerp(toneLut[i], toneLut[i + 1], x - float(i));
+    curve_blend = e.x;
+    shaped = e.y;
+}
 
+float DepthRawAt(uint2 gid)
+{
     bool  rightEye;
     uint  localX;
     uint  viewW;
@@ -157,41 +167,10 @@ void CSDepthRaw(uint3 tid : SV_DispatchThreadID)
     float spec_pop = highlight * contrast;
     g_soft = lerp(g_soft, g_soft * 0.92, spec_pop * 0.15);
 
-    // === CURVE LAYERS (5-layer depth) ===
-    float dark_push = pow(1.0 - g_soft, 2.0);
-
-    float t = saturate(g_soft);
-
-    float b_near1 = pow(t, 0.22);
-    float b_near2 = pow(t, 0.50);
-    float b_mid = pow(t, 0.90);
-    float b_far1 = pow(1.0 - t, 1.55);
-    float b_far2 = pow(1.0 - t, 2.65);
-
-    float w_near1 = smoothstep(0.00, 0.40, t);
-    float w_near2 = smoothstep(0.10, 0.60, t);
-    float w_mid = smoothstep(0.20, 0.80, t);
-    float w_far1 = smoothstep(0.15, 0.85, 1.0 - t);
-    float w_far2 = smoothstep(0.35, 1.00, 1.0 - t);
-
-    float w_sum = w_near1 + w_near2 + w_mid + w_far1 + w_far2 + 1e-6;
-
-    float d_near1 = b_near1;
-    float d_near2 = b_near2;
-    float d_mid = b_mid;
-    float d_far1 = 1.0 - b_far1;
-    float d_far2 = 1.0 - b_far2;
-
-    float curve_blend = (
-        d_near1 * w_near1 +
-        d_near2 * w_near2 +
-        d_mid * w_mid +
-        d_far1 * w_far1 +
-        d_far2 * w_far2
-    ) / w_sum;
-
-    // === DEPTH SHAPING USING BLENDED CURVE ===
-    float depth = lerp(curve_blend, dark_push, 1.00 - g_soft);
+    // === CURVE LAYERS (5-layer depth) + DEPTH SHAPING USING BLENDED CURVE ===
+    float curve_blend;
+    float depth;
+    ToneCurveLookup(g_soft, curve_blend, depth);
 
     depth = (depth - 0.5) * depth_aggression + 0.5;
     depth = lerp(depth, curve_blend, 0.040);
@@ -216,20 +195,24 @@ void CSDepthRaw(uint3 tid : SV_DispatchThreadID)
     float boost_nonflat = lerp(1.10, 1.05, flatness);
     depth = (depth - depth_mid) * boost_nonflat + depth_mid;
 
-    depthRawOut[gid] = saturate(depth);
-
+    return saturate(depth);
 }
 
-// ------------------------------------------------------------
-// PASS 2: Temporal + spatial smoothing
-// ------------------------------------------------------------
 [numthreads(16, 16, 1)]
-void CSDepthSmooth(uint3 tid : SV_DispatchThreadID)
+void CSDepthRaw(uint3 tid : SV_DispatchThreadID)
 {
     uint2 gid = tid.xy;
     if (gid.x >= outWidth || gid.y >= outHeight) return;
 
-    float depth = depthRawTex.Load(int3(gid, 0));
+    depthRawOut[gid] = DepthRawAt(gid);
+}
+
+// ------------------------------------------------------------
+// PASS 2: Temporal + spatial smoothing
+// ------------------------------------------------------------
+// Reads history from depthPrevTex; the caller writes the result to depthPrevOut.
+float DepthSmoothAt(uint2 gid, float depth)
+{
     depth = saturate(depth);
 
     float d = pow(depth, 0.65);
@@ -266,6 +249,16 @@ void CSDepthSmooth(uint3 tid : SV_DispatchThreadID)
 
     float horiz = vert * 0.95 + (h1 + h2) * 0.025;
     float final_depth = lerp(vert, horiz, 0.05);
+    return final_depth;
+}
+
+[numthreads(16, 16, 1)]
+void CSDepthSmooth(uint3 tid : SV_DispatchThreadID)
+{
+    uint2 gid = tid.xy;
+    if (gid.x >= outWidth || gid.y >= outHeight) return;
+
+    float final_depth = DepthSmoothAt(gid, depthRawTex.Load(int3(gid, 0)));
 
     depthPrevOut[gid] = final_depth;
     depthSmoothOut[gid] = final_depth;
@@ -274,21 +267,14 @@ void CSDepthSmooth(uint3 tid : SV_DispatchThreadID)
 // ------------------------------------------------------------
 // PASS 3: Parallax SBS using smoothed depth
 // ------------------------------------------------------------
-[numthreads(16, 16, 1)]
-void CSParallaxSbs(uint3 tid : SV_DispatchThreadID)
+float4 ParallaxSbsAt(uint2 gid, float depth)
 {
-    uint2 gid = tid.xy;
-    if (gid.x >= outWidth || gid.y >= outHeight) return;
-
     bool  rightEye;
     uint  localX;
     uint  viewW;
     float2 uvEye;
     EyeMapping(gid, rightEye, localX, viewW, uvEye);
 
-    // Use depth bound at t1 (renderer binds smoothed depth SRV to slot 1 for pass 3).
-    float depth = depthRawTex.Load(int3(gid, 0));
-
     depth = saturate(depth);
 
     // Simple shaping; you can tweak exponent/scale
@@ -308,16 +294,583 @@ void CSParallaxSbs(uint3 tid : SV_DispatchThreadID)
     bool hitEdge = (shiftedRaw < 0.0) || (shiftedRaw > float(max(1u, viewW) - 1));
     if (hitEdge)
     {
-        outImage[gid] = float4(0.0, 0.0, 0.0, 1.0);
-        return;
+        return float4(0.0, 0.0, 0.0, 1.0);
     }
 
     float u = (shiftedRaw + 0.5) / float(max(1u, viewW));
     float v = (float(gid.y) + 0.5) / float(max(1u, outHeight));
 
     float2 uv0 = cropOffset + float2(u, v) * cropScale;
-    float4 c = srcTex.SampleLevel(samp0, uv0, 0);
-    outImage[gid] = c;
+    return srcTex.SampleLevel(samp0, uv0, 0);
+}
+
+[numthreads(16, 16, 1)]
+void CSParallaxSbs(uint3 tid : SV_DispatchThreadID)
+{
+    uint2 gid = tid.xy;
+    if (gid.x >= outWidth || gid.y >= outHeight) return;
+
+    // Use depth bound at t1 (renderer binds smoothed depth SRV to slot 1 for pass 3).
+    outImage[gid] = ParallaxSbsAt(gid, depthRawTex.Load(int3(gid, 0)));
+}
+
+// ------------------------------------------------------------
+// PASS 3, foveated (DepthCpu::Kernels::FoveaResolveRect): t1 holds passes 1-2 over the centre box at
+// full resolution and t4 over the whole view at reduced resolution, each as two per-eye halves
+// (2 * foveaCentreSize.x / 2 * foveaPeripherySize.x wide). The centre wins inside the radius, the
+// bilinearly upsampled periphery past the falloff.
+// ------------------------------------------------------------
+Texture2D<float> foveaPeripheryTex : register(t4);
+
+cbuffer FoveaParams : register(b1)
+{
+    uint2 foveaCentreOrigin;  // centre box origin in eye-view pixels
+    uint2 foveaCentreSize;
+    uint2 foveaPeripherySize;
+    float foveaRadius;        // fractions of the view's half-size, elliptical
+    float foveaFalloff;
+};
+
+float FoveatedDepthAt(uint2 gid)
+{
+    const uint viewW = max(1u, outWidth / 2);
+    const bool rightEye = (gid.x >= viewW);
+    const int2 p = int2(rightEye ? gid.x - viewW : gid.x, gid.y);
+    const float2 viewSize = float2(viewW, max(1u, outHeight));
+
+    const float2 n = (float2(p) + 0.5) / viewSize * 2.0 - 1.0;
+    const float r = length(n);
+    const float w = (foveaFalloff > 0.0) ? 1.0 - smoothstep(foveaRadius, foveaRadius + foveaFalloff, r) : (r < foveaRadius ? 1.0 : 0.0);
+
+    int2 c = clamp(p - int2(foveaCentreOrigin), int2(0, 0), int2(foveaCentreSize) - 1);
+    c.x += rightEye ? int(foveaCentreSize.x) : 0;
+    const float dc = depthRawTex.Load(int3(c, 0));
+
+    const float2 q = (float2(p) + 0.5) * float2(foveaPeripherySize) / viewSize - 0.5;
+    const float2 q0 = floor(q);
+    const float2 f = q - q0;
+    const int2 hi = int2(foveaPeripherySize) - 1;
+    const int2 a = clamp(int2(q0), int2(0, 0), hi);
+    const int2 b = clamp(int2(q0) + 1, int2(0, 0), hi);
+    const int ox = rightEye ? int(foveaPeripherySize.x) : 0;
+    const float d00 = foveaPeripheryTex.Load(int3(a.x + ox, a.y, 0));
+    const float d10 = foveaPeripheryTex.Load(int3(b.x + ox, a.y, 0));
+    const float d01 = foveaPeripheryTex.Load(int3(a.x + ox, b.y, 0));
+    const float d11 = foveaPeripheryTex.Load(int3(b.x + ox, b.y, 0));
+    const float dp = lerp(lerp(d00, d10, f.x), lerp(d01, d11, f.x), f.y);
+
+    return lerp(dp, dc, w);
+}
+
+[numthreads(16, 16, 1)]
+void CSParallaxFoveated(uint3 tid : SV_DispatchThreadID)
+{
+    uint2 gid = tid.xy;
+    if (gid.x >= outWidth || gid.y >= outHeight) return;
+
+    outImage[gid] = ParallaxSbsAt(gid, FoveatedDepthAt(gid));
+}
+
+// ------------------------------------------------------------
+// PASS 3, interpolated (DepthCpu::Kernels::InterpolatedSbsAt): phase interpT between picture A (t5,
+// its smoothed depth at t6) and picture B (t0, smoothed depth at t1), along the block motion field at
+// t7 (CSMotionFine: du, dv in source UV from B to A, match cost, B's depth at the block centre).
+// ------------------------------------------------------------
+Texture2D srcPictureATex          : register(t5);
+Texture2D<float> depthPictureATex  : register(t6);
+Texture2D<float4> motionFieldTex   : register(t7);
+
+cbuffer InterpParams : register(b2)
+{
+    float interpT;
+    float3 pad1;
+    uint2 motionBlocks;
+    float2 motionBlockUV; // block size in source UV
+};
+
+static const float kMotionDepthSharpness = 400.0; // DepthCpu::Kernels::kMotionDepthSharpness
+
+// Bilinear depth of one eye view of an SBS depth plane (viewH rows) at view pixel coordinates (pixel centres at +0.5).
+float SampleDepthView(Texture2D<float> plane, uint viewX0, uint viewW, uint viewH, float2 p)
+{
+    const float2 f = p - 0.5;
+    const float2 f0 = floor(f);
+    const float2 a = f - f0;
+    const int2 hi = int2(max(1u, viewW) - 1, max(1u, viewH) - 1);
+    const int2 q0 = clamp(int2(f0), int2(0, 0), hi);
+    const int2 q1 = clamp(int2(f0) + 1, int2(0, 0), hi);
+    const float d00 = plane.Load(int3(q0.x + viewX0, q0.y, 0));
+    const float d10 = plane.Load(int3(q1.x + viewX0, q0.y, 0));
+    const float d01 = plane.Load(int3(q0.x + viewX0, q1.y, 0));
+    const float d11 = plane.Load(int3(q1.x + viewX0, q1.y, 0));
+    return lerp(lerp(d00, d10, a.x), lerp(d01, d11, a.x), a.y);
+}
+
+// The four block vectors around source UV `uv`, bilinearly weighted and down-weighted where the block's
+// depth differs from `depth`. Returns (du, dv, cost).
+float3 MotionAt(float2 uv, float depth)
+{
+    const float2 b = uv / motionBlockUV - 0.5;
+    const float2 b0 = floor(b);
+    const float2 a = b - b0;
+    const int2 hi = int2(motionBlocks) - 1;
+
+    float3 sum = float3(0.0, 0.0, 0.0);
+    float wSum = 0.0;
+    [unroll] for (int j = 0; j < 2; ++j) {
+        [unroll] for (int i = 0; i < 2; ++i) {
+            const float4 e = motionFieldTex.Load(int3(clamp(int2(b0) + int2(i, j), int2(0, 0), hi), 0));
+            const float dd = depth - e.w;
+            const float w = (i ? a.x : 1.0 - a.x) * (j ? a.y : 1.0 - a.y) / (1.0 + kMotionDepthSharpness * dd * dd);
+            sum += e.xyz * w;
+            wSum += w;
+        }
+    }
+    return (wSum > 0.0) ? sum / wSum : float3(0.0, 0.0, 0.0);
+}
+
+[numthreads(16, 16, 1)]
+void CSParallaxInterp(uint3 tid : SV_DispatchThreadID)
+{
+    uint2 gid = tid.xy;
+    if (gid.x >= outWidth || gid.y >= outHeight) return;
+
+    bool  rightEye;
+    uint  localX;
+    uint  viewW;
+    float2 uvEye;
+    EyeMapping(gid, rightEye, localX, viewW, uvEye);
+
+    const float t = interpT;
+    const uint viewX0 = rightEye ? outWidth / 2 : 0;
+    const float viewWf = float(max(1u, viewW));
+    const float2 pxUV = cropScale / float2(viewWf, float(max(1u, outHeight)));
+    const float2 lp = float2(localX, gid.y) + 0.5;
+    const float vS = cropOffset.y + uvEye.y * cropScale.y;
+
+    // Depth at t: A's fetched t of the way along the vector, B's (1 - t) of the way back.
+    float3 mv = MotionAt(cropOffset + uvEye * cropScale, SampleDepthView(depthRawTex, viewX0, viewW, outHeight, lp));
+    const float2 m = mv.xy / pxUV;
+    const float dA = SampleDepthView(depthPictureATex, viewX0, viewW, outHeight, lp + t * m);
+    const float dB = SampleDepthView(depthRawTex, viewX0, viewW, outHeight, lp - (1.0 - t) * m);
+    const float depth = saturate(lerp(dA, dB, t));
+
+    float shift = parallaxPx * depth;
+    if (zoomLevel < 0)
+    {
+        float maxShift = viewWf * 0.10;
+        shift = clamp(shift, -maxShift, +maxShift);
+    }
+    const float shiftedRaw = float(localX) + (rightEye ? -shift : shift);
+    if ((shiftedRaw < 0.0) || (shiftedRaw > viewWf - 1.0))
+    {
+        outImage[gid] = float4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    const float2 uvS = float2(cropOffset.x + (shiftedRaw + 0.5) / viewWf * cropScale.x, vS);
+    mv = MotionAt(uvS, depth);
+    const float4 cA = srcPictureATex.SampleLevel(samp0, uvS + t * mv.xy, 0);
+    const float4 cB = srcTex.SampleLevel(samp0, uvS - (1.0 - t) * mv.xy, 0);
+
+    // Where the fetches disagree or the block matched poorly, lean to the picture nearer in time.
+    const float mismatch = abs(Luma(cA.rgb) - Luma(cB.rgb));
+    const float k = max(smoothstep(0.08, 0.25, mismatch), smoothstep(0.04, 0.12, mv.z));
+    const float wB = lerp(t, (t < 0.5) ? 0.0 : 1.0, k);
+    outImage[gid] = cA * (1.0 - wB) + cB * wB;
+}
+
+// ------------------------------------------------------------
+// PASS 3 in any output layout at any size (DepthCpu::Kernels::LayoutAt): t1 holds the smoothed depth
+// of a half-SBS canvas (its texture size, which output sinks may not share); mode3d picks the layout
+// written to u3 for the canvas outWidth x outHeight (OU and half SBS are outWidth x outHeight, full
+// SBS and 2D + depth 2 * outWidth x outHeight). Each view samples its eye's half of the depth at its
+// own UV, with the shift scaled from the half-SBS depth view width to its own.
+// ------------------------------------------------------------
+float4 LayoutAt(uint2 gid)
+{
+    uint depthCanvasW, depthH;
+    depthRawTex.GetDimensions(depthCanvasW, depthH);
+
+    bool rightEye;
+    uint2 local = gid;
+    uint2 viewSize = uint2(outWidth, outHeight);
+    if (mode3d == 1)
+    {
+        const uint topH = outHeight / 2;
+        rightEye = (gid.y >= topH);
+        local.y = rightEye ? gid.y - topH : gid.y;
+        viewSize.y = rightEye ? outHeight - topH : topH;
+    }
+    else if (mode3d == 2)
+    {
+        const uint outLeftW = outWidth / 2;
+        rightEye = (gid.x >= outLeftW);
+        local.x = rightEye ? gid.x - outLeftW : gid.x;
+        viewSize.x = rightEye ? outWidth - outLeftW : outLeftW;
+    }
+    else
+    {
+        rightEye = (gid.x >= outWidth);
+        local.x = rightEye ? gid.x - outWidth : gid.x;
+    }
+    const float2 viewSizeF = float2(max(uint2(1, 1), viewSize));
+    const float2 uv = (float2(local) + 0.5) / viewSizeF;
+    const float vS = cropOffset.y + uv.y * cropScale.y;
+
+    // 2D + depth reads the left eye's half for both of its images (they show the same source UVs).
+    const bool depthRight = rightEye && (mode3d != 4);
+    const uint leftW = depthCanvasW / 2;
+    const uint depthViewW = depthRight ? depthCanvasW - leftW : leftW;
+    const float depthViewWf = float(max(1u, depthViewW));
+    const float d = saturate(SampleDepthView(depthRawTex, depthRight ? leftW : 0, depthViewW, depthH, uv * float2(depthViewWf, float(depthH))));
+
+    if (mode3d == 4)
+    {
+        return rightEye ? float4(d, d, d, 1.0) : srcTex.SampleLevel(samp0, float2(cropOffset.x + uv.x * cropScale.x, vS), 0);
+    }
+
+    float shift = parallaxPx * d;
+    if (zoomLevel < 0)
+    {
+        float maxShift = depthViewWf * 0.10;
+        shift = clamp(shift, -maxShift, +maxShift);
+    }
+    shift *= viewSizeF.x / depthViewWf;
+
+    const float shiftedRaw = float(local.x) + (rightEye ? -shift : shift);
+    if ((shiftedRaw < 0.0) || (shiftedRaw > viewSizeF.x - 1.0))
+    {
+        return float4(0.0, 0.0, 0.0, 1.0);
+    }
+    return srcTex.SampleLevel(samp0, float2(cropOffset.x + (shiftedRaw + 0.5) / viewSizeF.x * cropScale.x, vS), 0);
+}
+
+// Runs on the canvas grid like the other passes (so the content fingerprint's indirect args apply);
+// in the double-width layouts each thread also writes the same pixel of the right half.
+[numthreads(16, 16, 1)]
+void CSParallaxLayout(uint3 tid : SV_DispatchThreadID)
+{
+    uint2 gid = tid.xy;
+    if (gid.x >= outWidth || gid.y >= outHeight) return;
+
+    outImage[gid] = LayoutAt(gid);
+    if (mode3d >= 3)
+    {
+        const uint2 right = gid + uint2(outWidth, 0);
+        outImage[right] = LayoutAt(right);
+    }
+}
+
+// ------------------------------------------------------------
+// FUSED: all three passes in one dispatch.
+// Pass 2 only reads depthRaw at its own pixel and pass 3 only reads depthSmooth at its own pixel,
+// so both intermediates stay in registers. History still ping-pongs (t2 -> u1) because pass 2
+// reads neighbouring history texels.
+// ------------------------------------------------------------
+[numthreads(16, 16, 1)]
+void CSDepthFused(uint3 tid : SV_DispatchThreadID)
+{
+    uint2 gid = tid.xy;
+    if (gid.x >= outWidth || gid.y >= outHeight) return;
+
+    float final_depth = DepthSmoothAt(gid, DepthRawAt(gid));
+    depthPrevOut[gid] = final_depth;
+    outImage[gid] = ParallaxSbsAt(gid, final_depth);
+}
+)HLSL";
+
+// Content fingerprint: decides on the GPU whether a new capture frame differs from the previous one,
+// so identical re-presents (cursor-only updates, compositor repeats) don't re-run the depth passes.
+// CSContentLattice samples a fixed latticeN x latticeN grid; CSContentHash optionally refines it with a
+// hash of every 16x16 block. Both compare against fpState and flag a change; CSContentResolve then
+// writes one DispatchIndirect args triple per grid Renderer issues against it.
+static const char* kContentFingerprintHlsl = R"HLSL(
+#define kFingerprintGrids 8 // Renderer::kFingerprintGrids
+
+Texture2D srcTex          : register(t0);
+RWBuffer<uint> fpState    : register(u0); // [latticeN^2 lattice samples][blocksX * blocksY block hashes]
+RWBuffer<uint> fpArgs     : register(u1); // [grid i args at 3 * i], then the kArg* counters below
+
+cbuffer FingerprintParams : register(b0)
+{
+    uint newFrame;    // 1 when a new capture frame was fingerprinted this tick
+    uint force;       // 1 when the CPU changed pass inputs (restarts settling)
+    uint settleTicks; // Renderer::kDepthSettleTicks
+    uint latticeN;
+
+    uint blocksX;
+    uint3 pad0;
+
+    uint4 grids[kFingerprintGrids]; // xy = thread groups; z = 1 for a grid issued only on skipped ticks
+};
+
+static const uint kArgChanged = kFingerprintGrids * 3;        // set by the fingerprint passes, cleared by resolve
+static const uint kArgTicks = kFingerprintGrids * 3 + 1;      // ticks the passes ran since the content last changed
+static const uint kArgContentNew = kFingerprintGrids * 3 + 2; // total new frames whose content changed
+static const uint kArgSkipped = kFingerprintGrids * 3 + 3;    // total ticks resolved to zero thread groups
+
+uint HashTexel(float4 c, uint2 p)
+{
+    // Alpha is ignored: the depth passes never read it.
+    uint h = asuint(c.r) * 0x9E3779B1u;
+    h ^= asuint(c.g) * 0x85EBCA77u;
+    h ^= asuint(c.b) * 0xC2B2AE3Du;
+    h ^= ((p.y << 16) | (p.x & 0xFFFFu)) * 0x27D4EB2Fu;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return h;
+}
+
+[numthreads(16, 16, 1)]
+void CSContentLattice(uint3 tid : SV_DispatchThreadID)
+{
+    if (tid.x >= latticeN || tid.y >= latticeN) return;
+
+    uint w, h;
+    srcTex.GetDimensions(w, h);
+    const uint2 p = uint2(((tid.x * 2 + 1) * w) / (latticeN * 2), ((tid.y * 2 + 1) * h) / (latticeN * 2));
+
+    const uint v = HashTexel(srcTex.Load(int3(p, 0)), p);
+    const uint idx = tid.y * latticeN + tid.x;
+    if (fpState[idx] != v) {
+        fpState[idx] = v;
+        InterlockedOr(fpArgs[kArgChanged], 1u);
+    }
+}
+
+groupshared uint gsBlockHash;
+
+[numthreads(16, 16, 1)]
+void CSContentHash(uint3 tid : SV_DispatchThreadID, uint3 gid : SV_GroupID, uint gi : SV_GroupIndex)
+{
+    if (gi == 0) gsBlockHash = 0;
+    GroupMemoryBarrierWithGroupSync();
+
+    uint w, h;
+    srcTex.GetDimensions(w, h);
+    if (tid.x < w && tid.y < h) {
+        // Texel hashes are position-salted, so the order-free XOR still sees moved content.
+        InterlockedXor(gsBlockHash, HashTexel(srcTex.Load(int3(tid.xy, 0)), tid.xy));
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    if (gi == 0) {
+        const uint idx = latticeN * latticeN + gid.y * blocksX + gid.x;
+        if (fpState[idx] != gsBlockHash) {
+            fpState[idx] = gsBlockHash;
+            InterlockedOr(fpArgs[kArgChanged], 1u);
+        }
+    }
+}
+
+// Mirrors the CPU repeated-frame skip: the passes keep running for settleTicks ticks after the content
+// (or a pass input) last changed, then resolve to zero groups until the next change. Skipped-tick grids
+// get the inverse, so work standing in for the passes runs exactly when they don't.
+[numthreads(1, 1, 1)]
+void CSContentResolve(uint3 tid : SV_DispatchThreadID)
+{
+    const uint changed = fpArgs[kArgChanged];
+    uint ticks = fpArgs[kArgTicks];
+    if (changed != 0 || force != 0) ticks = 0;
+
+    const bool run = (ticks < settleTicks);
+    if (run) ticks += 1;
+
+    [unroll]
+    for (uint i = 0; i < kFingerprintGrids; ++i) {
+        const bool on = (grids[i].z != 0) ? !run : run;
+        fpArgs[i * 3 + 0] = on ? grids[i].x : 0;
+        fpArgs[i * 3 + 1] = on ? grids[i].y : 0;
+        fpArgs[i * 3 + 2] = 1;
+    }
+    fpArgs[kArgChanged] = 0;
+    fpArgs[kArgTicks] = ticks;
+    if (newFrame != 0 && changed != 0) fpArgs[kArgContentNew] += 1;
+    if (!run) fpArgs[kArgSkipped] += 1;
+}
+)HLSL";
+
+// Translates the temporal depth history along with content the capture reports as moved (scrolling).
+// Renderer copies depthPrev into the next ping-pong texture first, then dispatches this once per move
+// and eye view; pixels whose source falls outside the view keep the copied value. With a zero offset
+// over the whole plane it is also the history carry of ticks the content fingerprint skips.
+static const char* kHistoryShiftHlsl = R"HLSL(
+Texture2D<float> histIn     : register(t0);
+RWTexture2D<float> histOut  : register(u0);
+
+cbuffer HistoryShiftParams : register(b0)
+{
+    int4 rect;   // destination pixels [rect.xy, rect.zw) of the history plane
+    int4 view;   // eye view containing rect, [view.xy, view.zw)
+    int2 offset; // history at p comes from p - offset
+    int2 pad0;
+};
+
+[numthreads(16, 16, 1)]
+void CSHistoryShift(uint3 tid : SV_DispatchThreadID)
+{
+    const int2 p = rect.xy + int2(tid.xy);
+    if (any(p >= rect.zw)) return;
+
+    const int2 s = p - offset;
+    if (any(s < view.xy) || any(s >= view.zw)) return;
+    histOut[p] = histIn[s];
+}
+)HLSL";
+
+// Block motion between two compute inputs for frame interpolation (DepthCpu::Kernels Motion*): box-
+// averaged luma planes at 1/4 and 1/16 of the input, a coarse block search, then the fine search seeded
+// by it. Renderer keeps each picture's planes for the next pair, so every pass runs once per new frame.
+static const char* kMotionHlsl = R"HLSL(
+Texture2D srcTex                : register(t0);
+Texture2D<float> lumaA          : register(t1); // CSMotionCoarseLuma: the fine plane to reduce
+Texture2D<float> lumaB          : register(t2);
+Texture2D<float2> coarseField   : register(t3);
+Texture2D<float> depthB         : register(t4); // B's smoothed depth, SBS plane
+
+RWTexture2D<float>  lumaOut     : register(u0);
+RWTexture2D<float2> coarseOut   : register(u1);
+RWTexture2D<float4> fieldOut    : register(u2);
+
+cbuffer MotionParams : register(b0)
+{
+    uint2 srcSize;
+    uint2 fineSize;
+    uint2 coarseSize;
+    uint2 blocks;       // fine blocks
+    uint2 coarseBlocks;
+    uint2 depthSize;    // outWidth x outHeight of the depth plane
+    float2 cropOffset;
+    float2 cropScale;
+};
+
+// DepthCpu::Kernels constants.
+static const uint kMotionLumaScale = 4;
+static const int kMotionBlock = 8;
+static const int kMotionCoarseBlock = 4;
+static const int kMotionCoarseRange = 6;
+static const int kMotionRefineRange = 2;
+static const float kMotionStaticCost = 1.0 / 255.0;
+static const float kMotionLambdaPerPx = 0.0002;
+
+[numthreads(16, 16, 1)]
+void CSMotionLuma(uint3 tid : SV_DispatchThreadID)
+{
+    if (any(tid.xy >= fineSize)) return;
+    float sum = 0.0;
+    for (uint j = 0; j < kMotionLumaScale; ++j) {
+        for (uint i = 0; i < kMotionLumaScale; ++i) {
+            const uint2 p = min(tid.xy * kMotionLumaScale + uint2(i, j), srcSize - 1);
+            sum += dot(srcTex.Load(int3(p, 0)).rgb, float3(0.299, 0.587, 0.114));
+        }
+    }
+    lumaOut[tid.xy] = sum / float(kMotionLumaScale * kMotionLumaScale);
+}
+
+[numthreads(16, 16, 1)]
+void CSMotionCoarseLuma(uint3 tid : SV_DispatchThreadID)
+{
+    if (any(tid.xy >= coarseSize)) return;
+    float sum = 0.0;
+    for (uint j = 0; j < kMotionLumaScale; ++j) {
+        for (uint i = 0; i < kMotionLumaScale; ++i) {
+            sum += lumaA.Load(int3(min(tid.xy * kMotionLumaScale + uint2(i, j), fineSize - 1), 0));
+        }
+    }
+    lumaOut[tid.xy] = sum / float(kMotionLumaScale * kMotionLumaScale);
+}
+
+// Mean |B - A| over the size x size block of B at o (cut at B's edges) against A displaced by d
+// (clamped at A's edges).
+float BlockCost(Texture2D<float> a, Texture2D<float> b, uint2 planeSize, int2 o, int size, int2 d)
+{
+    const int2 hi = int2(planeSize) - 1;
+    const int2 e = min(o + size, int2(planeSize));
+    float sum = 0.0;
+    for (int y = o.y; y < e.y; ++y) {
+        for (int x = o.x; x < e.x; ++x) {
+            sum += abs(b.Load(int3(x, y, 0)) - a.Load(int3(clamp(int2(x, y) + d, int2(0, 0), hi), 0)));
+        }
+    }
+    const int n = max(0, e.x - o.x) * max(0, e.y - o.y);
+    return (n > 0) ? sum / float(n) : 0.0;
+}
+
+void SearchWindow(Texture2D<float> a, Texture2D<float> b, uint2 planeSize, int2 o, int size, int2 c, int range, float lambda,
+                  inout int2 best, inout float bestScore)
+{
+    for (int dy = c.y - range; dy <= c.y + range; ++dy) {
+        for (int dx = c.x - range; dx <= c.x + range; ++dx) {
+            const float score = BlockCost(a, b, planeSize, o, size, int2(dx, dy)) + lambda * float(abs(dx) + abs(dy));
+            if (score < bestScore) {
+                bestScore = score;
+                best = int2(dx, dy);
+            }
+        }
+    }
+}
+
+// Coarse block vector in coarse texels (t1/t2 = coarse luma of A/B).
+[numthreads(8, 8, 1)]
+void CSMotionCoarse(uint3 tid : SV_DispatchThreadID)
+{
+    if (any(tid.xy >= coarseBlocks)) return;
+    const int2 o = int2(tid.xy) * kMotionCoarseBlock;
+    int2 v = int2(0, 0);
+    float best = BlockCost(lumaA, lumaB, coarseSize, o, kMotionCoarseBlock, v);
+    if (best >= kMotionStaticCost) {
+        const float lambda = kMotionLambdaPerPx * float(kMotionLumaScale * kMotionLumaScale);
+        SearchWindow(lumaA, lumaB, coarseSize, o, kMotionCoarseBlock, int2(0, 0), kMotionCoarseRange, lambda, v, best);
+    }
+    coarseOut[tid.xy] = float2(v);
+}
+
+float SubTexel(float cm, float c0, float cp)
+{
+    const float denom = cm - 2.0 * c0 + cp;
+    return (denom <= 1e-6) ? 0.0 : clamp(0.5 * (cm - cp) / denom, -0.5, 0.5);
+}
+
+// Fine block: refine around zero and around its coarse block's vector, sub-texel fit, and B's depth at
+// the block centre (left eye view). Writes (du, dv in source UV, cost, depth).
+[numthreads(8, 8, 1)]
+void CSMotionFine(uint3 tid : SV_DispatchThreadID)
+{
+    if (any(tid.xy >= blocks)) return;
+    const int2 o = int2(tid.xy) * kMotionBlock;
+    float2 d = float2(0.0, 0.0);
+    float cost = BlockCost(lumaA, lumaB, fineSize, o, kMotionBlock, int2(0, 0));
+    if (cost >= kMotionStaticCost) {
+        const float lambda = kMotionLambdaPerPx * float(kMotionLumaScale);
+        int2 v = int2(0, 0);
+        float best = cost;
+        SearchWindow(lumaA, lumaB, fineSize, o, kMotionBlock, int2(0, 0), kMotionRefineRange, lambda, v, best);
+        const uint2 parent = min(tid.xy / 2, coarseBlocks - 1);
+        const int2 s = int2(coarseField.Load(int3(parent, 0))) * int(kMotionLumaScale);
+        if (any(s != 0)) SearchWindow(lumaA, lumaB, fineSize, o, kMotionBlock, s, kMotionRefineRange, lambda, v, best);
+
+        cost = BlockCost(lumaA, lumaB, fineSize, o, kMotionBlock, v);
+        d.x = float(v.x) + SubTexel(BlockCost(lumaA, lumaB, fineSize, o, kMotionBlock, v - int2(1, 0)), cost,
+                                    BlockCost(lumaA, lumaB, fineSize, o, kMotionBlock, v + int2(1, 0)));
+        d.y = float(v.y) + SubTexel(BlockCost(lumaA, lumaB, fineSize, o, kMotionBlock, v - int2(0, 1)), cost,
+                                    BlockCost(lumaA, lumaB, fineSize, o, kMotionBlock, v + int2(0, 1)));
+    }
+
+    // Block centre in the left view's pixels, through the crop.
+    const float2 uv = (float2(tid.xy) + 0.5) * float(kMotionBlock * kMotionLumaScale) / float2(max(srcSize, uint2(1, 1)));
+    const float2 viewSize = float2(max(1u, depthSize.x / 2), max(1u, depthSize.y));
+    const float2 p = saturate((uv - cropOffset) / max(cropScale, 1e-6)) * viewSize - 0.5;
+    const float2 p0 = floor(p);
+    const float2 a = p - p0;
+    const int2 hi = int2(viewSize) - 1;
+    const int2 q0 = clamp(int2(p0), int2(0, 0), hi);
+    const int2 q1 = clamp(int2(p0) + 1, int2(0, 0), hi);
+    const float depth = lerp(lerp(depthB.Load(int3(q0, 0)), depthB.Load(int3(q1.x, q0.y, 0)), a.x),
+                             lerp(depthB.Load(int3(q0.x, q1.y, 0)), depthB.Load(int3(q1, 0)), a.x), a.y);
+
+    fieldOut[tid.xy] = float4(d * float(kMotionLumaScale) / float2(max(srcSize, uint2(1, 1))), cost, depth);
 }
 )HLSL";
 
@@ -337,4 +890,52 @@ bool CompileParallaxSbsCS(ID3DBlob** outCsBlob) {
     return CompileHlsl(kThreePassHlsl, "CSParallaxSbs", "cs_5_0", outCsBlob);
 }
 
+bool CompileDepthFusedCS(ID3DBlob** outCsBlob) {
+    return CompileHlsl(kThreePassHlsl, "CSDepthFused", "cs_5_0", outCsBlob);
+}
+
+bool CompileParallaxFoveatedCS(ID3DBlob** outCsBlob) {
+    return CompileHlsl(kThreePassHlsl, "CSParallaxFoveated", "cs_5_0", outCsBlob);
+}
+
+bool CompileContentLatticeCS(ID3DBlob** outCsBlob) {
+    return CompileHlsl(kContentFingerprintHlsl, "CSContentLattice", "cs_5_0", outCsBlob);
+}
+
+bool CompileContentHashCS(ID3DBlob** outCsBlob) {
+    return CompileHlsl(kContentFingerprintHlsl, "CSContentHash", "cs_5_0", outCsBlob);
+}
+
+bool CompileContentResolveCS(ID3DBlob** outCsBlob) {
+    return CompileHlsl(kContentFingerprintHlsl, "CSContentResolve", "cs_5_0", outCsBlob);
+}
+
+bool CompileHistoryShiftCS(ID3DBlob** outCsBlob) {
+    return CompileHlsl(kHistoryShiftHlsl, "CSHistoryShift", "cs_5_0", outCsBlob);
+}
+
+bool CompileParallaxLayoutCS(ID3DBlob** outCsBlob) {
+    return CompileHlsl(kThreePassHlsl, "CSParallaxLayout", "cs_5_0", outCsBlob);
+}
+
+bool CompileParallaxInterpCS(ID3DBlob** outCsBlob) {
+    return CompileHlsl(kThreePassHlsl, "CSParallaxInterp", "cs_5_0", outCsBlob);
+}
+
+bool CompileMotionLumaCS(ID3DBlob** outCsBlob) {
+    return CompileHlsl(kMotionHlsl, "CSMotionLuma", "cs_5_0", outCsBlob);
+}
+
+bool CompileMotionCoarseLumaCS(ID3DBlob** outCsBlob) {
+    return CompileHlsl(kMotionHlsl, "CSMotionCoarseLuma", "cs_5_0", outCsBlob);
+}
+
+bool CompileMotionCoarseCS(ID3DBlob** outCsBlob) {
+    return CompileHlsl(kMotionHlsl, "CSMotionCoarse", "cs_5_0", outCsBlob);
+}
+
+bool CompileMotionFineCS(ID3DBlob** outCsBlob) {
+    return CompileHlsl(kMotionHlsl, "CSMotionFine", "cs_5_0", outCsBlob);
+}
+
 }
@@ -14,4 +14,30 @@ bool CompileDepthSmoothCS(ID3DBlob** outCsBlob);
 
 bool CompileParallaxSbsCS(ID3DBlob** outCsBlob);
 
+// All three passes in one dispatch (StereoShaderMode::DepthFused).
+bool CompileDepthFusedCS(ID3DBlob** outCsBlob);
+
+// Pass 3 reading foveated depth: full-resolution centre plane + reduced periphery plane (Renderer::SetFoveation).
+bool CompileParallaxFoveatedCS(ID3DBlob** outCsBlob);
+
+// Pass 3 in the output layouts other than half SBS, selected by CSParams.mode3d (Renderer::SetStereoLayout).
+bool CompileParallaxLayoutCS(ID3DBlob** outCsBlob);
+
+// Content fingerprint (duplicate-frame elimination): sparse lattice, full 16x16-block hash refinement,
+// and the single-thread resolve that writes the depth passes' DispatchIndirect args.
+bool CompileContentLatticeCS(ID3DBlob** outCsBlob);
+bool CompileContentHashCS(ID3DBlob** outCsBlob);
+bool CompileContentResolveCS(ID3DBlob** outCsBlob);
+
+// Scroll-aware history: copies depthPrev texels along one capture move rect (CSHistoryShift).
+bool CompileHistoryShiftCS(ID3DBlob** outCsBlob);
+
+// Frame interpolation: pass 3 between two pictures along a block motion field (CSParallaxInterp), and the
+// motion search feeding it: luma planes at 1/4 and 1/16 of the input, coarse then fine block vectors.
+bool CompileParallaxInterpCS(ID3DBlob** outCsBlob);
+bool CompileMotionLumaCS(ID3DBlob** outCsBlob);
+bool CompileMotionCoarseLumaCS(ID3DBlob** outCsBlob);
+bool CompileMotionCoarseCS(ID3DBlob** outCsBlob);
+bool CompileMotionFineCS(ID3DBlob** outCsBlob);
+
 }
@@ -11,6 +11,7 @@ static std::string WStringToString(const std::wstring& wstr) {
 }
 #include "CaptureDXGI.h"
 #include "Log.h"
+#include "Renderer.h"
 
 bool CaptureDXGI::Init(const wchar_t* targetDeviceName) {
     Log::Info("CaptureDXGI::Init called");
@@ -156,6 +157,21 @@ bool CaptureDXGI::GetFrame(ID3D11Texture2D** outTex, INT64* outTimestamp) {
     }
 #endif
 
+    // Move rects come first in the frame metadata; TotalMetadataBufferSize (moves + dirty rects) bounds them.
+    lastMoves_.clear();
+    lastMovesKnown_ = true;
+    if (frameInfo.TotalMetadataBufferSize > 0) {
+        lastMoves_.resize(frameInfo.TotalMetadataBufferSize / sizeof(DXGI_OUTDUPL_MOVE_RECT) + 1);
+        UINT movesBytes = 0;
+        const HRESULT mhr = duplication_->GetFrameMoveRects((UINT)(lastMoves_.size() * sizeof(DXGI_OUTDUPL_MOVE_RECT)), lastMoves_.data(), &movesBytes);
+        if (SUCCEEDED(mhr)) {
+            lastMoves_.resize(movesBytes / sizeof(DXGI_OUTDUPL_MOVE_RECT));
+        } else {
+            lastMoves_.clear();
+            lastMovesKnown_ = false;
+        }
+    }
+
     ID3D11Texture2D* frame = nullptr;
     hr = desktopResource->QueryInterface(__uuidof(ID3D11Texture2D), (void**)&frame);
     desktopResource->Release();
@@ -193,3 +209,12 @@ void CaptureDXGI::Cleanup() {
 
     outputDeviceName_.clear();
 }
+
+bool CaptureDXGI::IsLost() const {
+    const HRESULT hr = lastAcquireHr_.load(std::memory_order_relaxed);
+    return hr == DXGI_ERROR_ACCESS_LOST || hr == DXGI_ERROR_INVALID_CALL || hr == DXGI_ERROR_ACCESS_DENIED;
+}
+
+void CaptureDXGI::ReportStats(Renderer& renderer) const {
+    renderer.SetCaptureStatsDXGI(GetProducedFramesTotal(), GetLastAccumulatedFrames());
+}
@@ -2,33 +2,50 @@
 #include <d3d11.h>
 #include <dxgi1_2.h>
 
+#include <atomic>
 #include <string>
+#include <vector>
 
-class CaptureDXGI {
+#include "FrameSource.h"
+
+class CaptureDXGI : public FrameSource {
 public:
     // If targetDeviceName is null/empty, captures the first enumerated output.
     bool Init(const wchar_t* targetDeviceName = nullptr);
     // Acquires the next desktop frame and returns a texture you can use until you call ReleaseFrame().
     // Returns true and sets outTex and outTimestamp (QPC units) if a frame is available
-    bool GetFrame(ID3D11Texture2D** outTex, INT64* outTimestamp = nullptr);
+    bool GetFrame(ID3D11Texture2D** outTex, INT64* outTimestamp = nullptr) override;
     // Must be called exactly once after each successful GetFrame().
-    void ReleaseFrame();
-    void Cleanup();
+    void ReleaseFrame() override;
+    void Cleanup() override;
+
+    ID3D11Device* GetDevice() const override { return d3dDevice_; }
+    ID3D11DeviceContext* GetContext() const override { return d3dContext_; }
 
-    ID3D11Device* GetDevice() const { return d3dDevice_; }
-    ID3D11DeviceContext* GetContext() const { return d3dContext_; }
+    // ACCESS_LOST / INVALID_CALL / ACCESS_DENIED from AcquireNextFrame (WAIT_TIMEOUT is not a loss).
+    bool IsLost() const override;
+    // AcquireNextFrame already waits for the next desktop update.
+    void WaitForFrame(DWORD /*timeoutMs*/) override {}
+    void ReportStats(Renderer& renderer) const override;
 
     // Diagnostics: capture delivery stats.
     // - ProducedFramesTotal: sum of DXGI_OUTDUPL_FRAME_INFO::AccumulatedFrames (clamped to at least 1 per acquired frame).
     // - LastAccumulatedFrames: value reported by the most recent successful AcquireNextFrame.
-    unsigned long long GetProducedFramesTotal() const { return producedFramesTotal_; }
-    UINT GetLastAccumulatedFrames() const { return lastAccumulatedFrames_; }
+    unsigned long long GetProducedFramesTotal() const { return producedFramesTotal_.load(std::memory_order_relaxed); }
+    UINT GetLastAccumulatedFrames() const override { return lastAccumulatedFrames_.load(std::memory_order_relaxed); }
 
     // Diagnostics: last HRESULT returned by AcquireNextFrame.
     // - S_OK: last acquire succeeded
     // - DXGI_ERROR_WAIT_TIMEOUT: normal "no new frame yet"
     // - other failures (e.g. DXGI_ERROR_ACCESS_LOST) indicate capture is broken and must be restarted.
-    HRESULT GetLastAcquireNextFrameHr() const { return lastAcquireHr_; }
+    HRESULT GetLastAcquireNextFrameHr() const { return lastAcquireHr_.load(std::memory_order_relaxed); }
+    HRESULT GetLastAcquireHr() const override { return lastAcquireHr_.load(std::memory_order_relaxed); }
+
+    // GetFrameMoveRects of the last acquired frame (same thread as GetFrame).
+    bool GetLastMoveRects(std::vector<DXGI_OUTDUPL_MOVE_RECT>& out) const override {
+        out = lastMoves_;
+        return lastMovesKnown_;
+    }
 
     // Device name of the captured output (e.g. "\\.\\DISPLAY1"). Empty if not initialized.
     const std::wstring& GetCapturedOutputDeviceName() const { return outputDeviceName_; }
@@ -44,9 +61,11 @@ private:
     std::wstring outputDeviceName_;
 
     bool frameHeld_ = false;
+    std::vector<DXGI_OUTDUPL_MOVE_RECT> lastMoves_;
+    bool lastMovesKnown_ = false;
 
-    // Diagnostics
-    unsigned long long producedFramesTotal_ = 0;
-    UINT lastAccumulatedFrames_ = 0;
-    HRESULT lastAcquireHr_ = S_OK;
+    // Diagnostics (atomic: read by the HUD while the capture thread acquires)
+    std::atomic<unsigned long long> producedFramesTotal_{ 0 };
+    std::atomic<UINT> lastAccumulatedFrames_{ 0 };
+    std::atomic<HRESULT> lastAcquireHr_{ S_OK };
 };
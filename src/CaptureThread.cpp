@@ -0,0 +1,175 @@
+#include "CaptureThread.h"
+
+#include "Log.h"
+
+#include <d3d11_4.h>
+
+#include <string>
+
+bool CaptureThread::Start(FrameSource* source) {
+    Stop();
+    if (!source || !source->GetDevice() || !source->GetContext()) return false;
+
+    if (!source->CanCaptureOnAnyThread()) {
+        Log::Info("CaptureThread: backend is bound to the UI thread; capturing on the render tick");
+        return false;
+    }
+
+    ID3D11Multithread* mt = nullptr;
+    HRESULT hr = source->GetContext()->QueryInterface(__uuidof(ID3D11Multithread), (void**)&mt);
+    if (FAILED(hr) || !mt) {
+        Log::Error("CaptureThread: ID3D11Multithread not available; capturing on the render tick");
+        return false;
+    }
+    mt->SetMultithreadProtected(TRUE);
+    mt->Release();
+
+    source_ = source;
+    stop_.store(false, std::memory_order_relaxed);
+    lost_.store(false, std::memory_order_relaxed);
+    lastHr_.store(S_OK, std::memory_order_relaxed);
+    producedTotal_ = 0;
+    consumedProducedTotal_ = 0;
+    sequence_ = 0;
+    consumedSequence_ = 0;
+    lastMovesKnown_ = false;
+    lastAccumulatedFrames_ = 0;
+    mailbox_.Reset();
+
+    thread_ = std::thread(&CaptureThread::ThreadMain, this);
+    Log::Info("CaptureThread: started");
+    return true;
+}
+
+void CaptureThread::Stop() {
+    if (thread_.joinable()) {
+        stop_.store(true, std::memory_order_release);
+        thread_.join();
+        Log::Info("CaptureThread: stopped");
+    }
+    ReleaseSlots();
+    source_ = nullptr;
+}
+
+void CaptureThread::Cleanup() {
+    FrameSource* source = source_;
+    Stop();
+    if (source) source->Cleanup();
+}
+
+void CaptureThread::ReleaseSlots() {
+    Slot* slots = mailbox_.Slots();
+    for (int i = 0; i < LatestMailbox<Slot>::kSlotCount; ++i) {
+        if (slots[i].tex) { slots[i].tex->Release(); slots[i].tex = nullptr; }
+        slots[i].timestamp = 0;
+        slots[i].producedTotal = 0;
+        slots[i].sequence = 0;
+        slots[i].moves.clear();
+        slots[i].movesKnown = false;
+    }
+    mailbox_.Reset();
+}
+
+bool CaptureThread::GetFrame(ID3D11Texture2D** outTex, INT64* outTimestamp) {
+    if (!outTex) return false;
+    *outTex = nullptr;
+    if (!source_ || !mailbox_.Take()) return false;
+
+    Slot& slot = mailbox_.Front();
+    if (!slot.tex) return false;
+
+    lastAccumulatedFrames_ = (UINT)(slot.producedTotal - consumedProducedTotal_);
+    consumedProducedTotal_ = slot.producedTotal;
+    // Moves chain only frame to frame: after a replaced (or failed-to-copy) frame they're unknown.
+    lastMovesKnown_ = slot.movesKnown && slot.sequence == consumedSequence_ + 1;
+    lastMoves_ = slot.moves;
+    consumedSequence_ = slot.sequence;
+
+    // The caller releases its reference; the mailbox keeps its own until the slot is rewritten.
+    slot.tex->AddRef();
+    *outTex = slot.tex;
+    if (outTimestamp) *outTimestamp = slot.timestamp;
+    return true;
+}
+
+INT64 CaptureThread::GetTimestampFrequency() const {
+    return source_ ? source_->GetTimestampFrequency() : FrameSource::GetTimestampFrequency();
+}
+
+void CaptureThread::ReportStats(Renderer& renderer) const {
+    if (source_) source_->ReportStats(renderer);
+}
+
+bool CaptureThread::CopyToSlot(Slot& slot, ID3D11Texture2D* src) {
+    D3D11_TEXTURE2D_DESC sd;
+    src->GetDesc(&sd);
+
+    if (slot.tex) {
+        D3D11_TEXTURE2D_DESC cd;
+        slot.tex->GetDesc(&cd);
+        if (cd.Width != sd.Width || cd.Height != sd.Height || cd.Format != sd.Format) {
+            // Size/format change: the render thread may still hold the old texture; it keeps its own reference.
+            slot.tex->Release();
+            slot.tex = nullptr;
+        }
+    }
+
+    if (!slot.tex) {
+        D3D11_TEXTURE2D_DESC td = {};
+        td.Width = sd.Width;
+        td.Height = sd.Height;
+        td.MipLevels = 1;
+        td.ArraySize = 1;
+        td.Format = sd.Format;
+        td.SampleDesc.Count = 1;
+        td.Usage = D3D11_USAGE_DEFAULT;
+        td.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        const HRESULT hr = source_->GetDevice()->CreateTexture2D(&td, nullptr, &slot.tex);
+        if (FAILED(hr) || !slot.tex) {
+            Log::Error("CaptureThread: mailbox texture creation failed for " + std::to_string(sd.Width) + "x" + std::to_string(sd.Height));
+            slot.tex = nullptr;
+            return false;
+        }
+    }
+
+    // Same immediate context as the renderer: the render thread's reads of earlier contents of this
+    // slot were queued before this copy, so no extra GPU synchronization is needed.
+    source_->GetContext()->CopySubresourceRegion(slot.tex, 0, 0, 0, 0, src, 0, nullptr);
+    return true;
+}
+
+void CaptureThread::ThreadMain() {
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL);
+
+    while (!stop_.load(std::memory_order_acquire)) {
+        ID3D11Texture2D* frame = nullptr;
+        INT64 timestamp = 0;
+        if (!source_->GetFrame(&frame, &timestamp)) {
+            lastHr_.store(source_->GetLastAcquireHr(), std::memory_order_relaxed);
+            if (source_->IsLost()) {
+                // Reported through IsLost(); the UI thread stops capture.
+                lost_.store(true, std::memory_order_relaxed);
+                Sleep(kLostBackoffMs);
+            } else {
+                source_->WaitForFrame(kWaitMs);
+            }
+            continue;
+        }
+
+        lastHr_.store(source_->GetLastAcquireHr(), std::memory_order_relaxed);
+        producedTotal_ += source_->GetLastAccumulatedFrames();
+        ++sequence_;
+
+        Slot& slot = mailbox_.Back();
+        slot.movesKnown = source_->GetLastMoveRects(slot.moves);
+        const bool copied = CopyToSlot(slot, frame);
+        source_->ReleaseFrame();
+        frame->Release();
+        if (!copied) continue;
+
+        slot.timestamp = timestamp;
+        slot.producedTotal = producedTotal_;
+        slot.sequence = sequence_;
+        mailbox_.Publish();
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <d3d11.h>
+#include <windows.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "FrameSource.h"
+#include "LatestMailbox.h"
+
+// Runs a capture backend on its own thread and hands the newest frame to the render loop through a
+// lock-free triple-buffered mailbox (LatestMailbox). The thread acquires as soon as the backend has a
+// frame (DXGI's AcquireNextFrame wait, WGC's FrameArrived event), copies it into a mailbox texture and
+// releases the backend frame right away, so neither the acquire wait nor UI message handling sits
+// between the desktop and the render tick. GetFrame() on the render thread never blocks.
+//
+// The backend's immediate context is shared by both threads, so Start() turns on D3D11 multithread
+// protection for the device; GPU work stays ordered through that one context.
+class CaptureThread : public FrameSource {
+public:
+    CaptureThread() = default;
+    ~CaptureThread() override { Stop(); }
+
+    // Starts pulling frames from `source`. False (and nothing started) if the backend is bound to the
+    // calling thread or its device can't be made multithread-safe; keep calling the backend directly then.
+    bool Start(FrameSource* source);
+    // Joins the thread and releases the mailbox textures. The backend itself keeps running.
+    void Stop();
+    bool IsRunning() const { return source_ != nullptr; }
+
+    // Newest published frame, or false if nothing new arrived since the last call.
+    bool GetFrame(ID3D11Texture2D** outTex, INT64* outTimestamp = nullptr) override;
+    // Frames are copies owned by the mailbox; nothing to hand back to the backend.
+    void ReleaseFrame() override {}
+    // Stops the thread and then cleans up the backend.
+    void Cleanup() override;
+
+    ID3D11Device* GetDevice() const override { return source_ ? source_->GetDevice() : nullptr; }
+    ID3D11DeviceContext* GetContext() const override { return source_ ? source_->GetContext() : nullptr; }
+
+    bool IsLost() const override { return lost_.load(std::memory_order_relaxed); }
+    HRESULT GetLastAcquireHr() const override { return lastHr_.load(std::memory_order_relaxed); }
+    // Backend frames produced between the previous and the current GetFrame (frames the mailbox replaced included).
+    UINT GetLastAccumulatedFrames() const override { return lastAccumulatedFrames_; }
+    // Backend moves, as long as the mailbox handed over every frame since the previous GetFrame.
+    bool GetLastMoveRects(std::vector<DXGI_OUTDUPL_MOVE_RECT>& out) const override {
+        out = lastMoves_;
+        return lastMovesKnown_;
+    }
+    INT64 GetTimestampFrequency() const override;
+    void ReportStats(Renderer& renderer) const override;
+
+private:
+    struct Slot {
+        ID3D11Texture2D* tex = nullptr;
+        INT64 timestamp = 0;
+        uint64_t producedTotal = 0; // backend frames produced up to and including this one
+        uint64_t sequence = 0;      // backend GetFrame calls that returned a frame, up to this one
+        std::vector<DXGI_OUTDUPL_MOVE_RECT> moves; // relative to the backend's previous frame
+        bool movesKnown = false;
+    };
+
+    // Backend wait between empty polls; bounds how long Stop() takes.
+    static constexpr DWORD kWaitMs = 8;
+    static constexpr DWORD kLostBackoffMs = 10;
+
+    void ThreadMain();
+    bool CopyToSlot(Slot& slot, ID3D11Texture2D* src);
+    void ReleaseSlots();
+
+    FrameSource* source_ = nullptr;
+    std::thread thread_;
+    std::atomic<bool> stop_{ false };
+    LatestMailbox<Slot> mailbox_;
+
+    // Written by the capture thread.
+    std::atomic<bool> lost_{ false };
+    std::atomic<HRESULT> lastHr_{ S_OK };
+    uint64_t producedTotal_ = 0;
+    uint64_t sequence_ = 0;
+
+    // Render thread only.
+    uint64_t consumedProducedTotal_ = 0;
+    UINT lastAccumulatedFrames_ = 0;
+    uint64_t consumedSequence_ = 0;
+    std::vector<DXGI_OUTDUPL_MOVE_RECT> lastMoves_;
+    bool lastMovesKnown_ = false;
+};
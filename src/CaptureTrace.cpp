@@ -0,0 +1,181 @@
+#include "CaptureTrace.h"
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace CaptureTrace {
+namespace {
+
+constexpr char kMagic[8] = { 'A', 'C', 'T', 'R', 'A', 'C', 'E', '\0' };
+constexpr size_t kRecordSizeV1 = 48; // Record up to thumbIndex
+
+static void SetErr(std::string* err, const std::string& msg) {
+    if (err) *err = msg;
+}
+
+} // namespace
+
+void Recorder::Begin(Backend backend, int64_t qpcFrequency, int64_t timestampFrequency,
+                     uint32_t srcWidth, uint32_t srcHeight, uint32_t thumbWidth, uint32_t thumbHeight,
+                     size_t recordCapacity, size_t thumbCapacity) {
+    Reset();
+    std::memcpy(header_.magic, kMagic, sizeof(kMagic));
+    header_.version = kVersion;
+    header_.backend = (uint32_t)backend;
+    header_.qpcFrequency = qpcFrequency;
+    header_.timestampFrequency = timestampFrequency;
+    header_.srcWidth = srcWidth;
+    header_.srcHeight = srcHeight;
+    header_.thumbWidth = thumbWidth;
+    header_.thumbHeight = thumbHeight;
+
+    records_.resize(recordCapacity ? recordCapacity : 1);
+    if (thumbWidth && thumbHeight && thumbCapacity) {
+        thumbs_.resize(thumbCapacity);
+    }
+    active_ = true;
+}
+
+void Recorder::Reset() {
+    active_ = false;
+    header_ = Header{};
+    records_.clear();
+    records_.shrink_to_fit();
+    thumbs_.clear();
+    thumbs_.shrink_to_fit();
+    nextSeq_ = 0;
+    nextThumbSeq_ = 0;
+}
+
+uint64_t Recorder::Add(const Record& record) {
+    if (!active_) return 0;
+    const uint64_t seq = nextSeq_++;
+    Record& r = records_[seq % records_.size()];
+    r = record;
+    r.thumbIndex = -1;
+    return seq;
+}
+
+void Recorder::AttachThumbnail(uint64_t recordSeq, const uint8_t* bgra, size_t rowPitch) {
+    if (!active_ || thumbs_.empty() || !bgra) return;
+    // Too old: its record has already been overwritten.
+    if (recordSeq >= nextSeq_ || nextSeq_ - recordSeq > records_.size()) return;
+
+    Thumb& t = thumbs_[nextThumbSeq_++ % thumbs_.size()];
+    t.recordSeq = recordSeq;
+    const size_t rowBytes = (size_t)header_.thumbWidth * 4;
+    t.bgra.resize(rowBytes * header_.thumbHeight);
+    for (uint32_t y = 0; y < header_.thumbHeight; ++y) {
+        std::memcpy(t.bgra.data() + y * rowBytes, bgra + y * rowPitch, rowBytes);
+    }
+}
+
+bool Recorder::Save(const std::string& path, std::string* err) const {
+    if (!active_) {
+        SetErr(err, "trace not started");
+        return false;
+    }
+
+    const size_t cap = records_.size();
+    const uint64_t count = (nextSeq_ < cap) ? nextSeq_ : cap;
+    const uint64_t firstSeq = nextSeq_ - count;
+
+    std::vector<Record> out;
+    out.reserve((size_t)count);
+    for (uint64_t s = firstSeq; s < nextSeq_; ++s) {
+        out.push_back(records_[s % cap]);
+    }
+
+    // Keep thumbnails whose record survived, oldest first.
+    std::vector<const Thumb*> keep;
+    const uint64_t thumbCount = (nextThumbSeq_ < thumbs_.size()) ? nextThumbSeq_ : thumbs_.size();
+    for (uint64_t s = nextThumbSeq_ - thumbCount; s < nextThumbSeq_; ++s) {
+        const Thumb& t = thumbs_[s % thumbs_.size()];
+        if (t.recordSeq < firstSeq || t.recordSeq >= nextSeq_) continue;
+        out[(size_t)(t.recordSeq - firstSeq)].thumbIndex = (int32_t)keep.size();
+        keep.push_back(&t);
+    }
+
+    Header h = header_;
+    h.recordCount = (uint32_t)out.size();
+    h.thumbCount = (uint32_t)keep.size();
+    h.droppedRecords = firstSeq;
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        SetErr(err, path + ": cannot create");
+        return false;
+    }
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1;
+    if (ok && !out.empty()) ok = std::fwrite(out.data(), sizeof(Record), out.size(), f) == out.size();
+    for (const Thumb* t : keep) {
+        if (!ok) break;
+        ok = std::fwrite(t->bgra.data(), 1, t->bgra.size(), f) == t->bgra.size();
+    }
+    if (std::fclose(f) != 0) ok = false;
+    if (!ok) SetErr(err, path + ": write failed");
+    return ok;
+}
+
+bool Load(const std::string& path, Trace* out, std::string* err) {
+    if (!out) return false;
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        SetErr(err, path + ": cannot open");
+        return false;
+    }
+
+    Trace t;
+    bool ok = std::fread(&t.header, sizeof(t.header), 1, f) == 1;
+    if (!ok || std::memcmp(t.header.magic, kMagic, sizeof(kMagic)) != 0) {
+        std::fclose(f);
+        SetErr(err, path + ": not a capture trace");
+        return false;
+    }
+    if (t.header.version != kVersion && t.header.version != 1) {
+        std::fclose(f);
+        SetErr(err, path + ": unsupported trace version " + std::to_string(t.header.version));
+        return false;
+    }
+
+    t.records.resize(t.header.recordCount);
+    if (t.header.version == 1) {
+        for (Record& r : t.records) {
+            r = Record{};
+            if (std::fread(&r, kRecordSizeV1, 1, f) != 1) {
+                ok = false;
+                break;
+            }
+        }
+        t.header.version = kVersion;
+    } else if (!t.records.empty()) {
+        ok = std::fread(t.records.data(), sizeof(Record), t.records.size(), f) == t.records.size();
+    }
+
+    const size_t thumbBytes = (size_t)t.header.thumbWidth * t.header.thumbHeight * 4;
+    if (ok && thumbBytes) {
+        t.thumbs.resize(t.header.thumbCount);
+        for (auto& th : t.thumbs) {
+            th.resize(thumbBytes);
+            if (std::fread(th.data(), 1, thumbBytes, f) != thumbBytes) {
+                ok = false;
+                break;
+            }
+        }
+    }
+    std::fclose(f);
+    if (!ok) {
+        SetErr(err, path + ": truncated trace");
+        return false;
+    }
+
+    // Guard replay code against bad indices.
+    for (Record& r : t.records) {
+        if (r.thumbIndex < 0 || r.thumbIndex >= (int32_t)t.thumbs.size()) r.thumbIndex = -1;
+    }
+    *out = std::move(t);
+    return true;
+}
+
+} // namespace CaptureTrace
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Compact binary trace of a capture session (per-frame acquire/render timing plus optional
+// downscaled thumbnails). Recorded in a fixed-size in-memory ring and written on capture stop,
+// so a long session only keeps its last few minutes. SyntheticSource can replay a trace offline.
+//
+// File layout (little-endian): Header, Record[recordCount], thumbnails (thumbCount * thumbWidth * thumbHeight * 4, BGRA8).
+namespace CaptureTrace {
+
+constexpr uint32_t kVersion = 2; // 2: Record::costMs / renderScale (version 1 traces still load, with both 0)
+
+enum class Backend : uint32_t {
+    Dxgi = 0,
+    Wgc = 1,
+    Synthetic = 2,
+};
+
+// Record::flags
+constexpr uint32_t kFlagGotFrame = 1u << 0;
+
+struct Header {
+    char magic[8];               // "ACTRACE\0"
+    uint32_t version;
+    uint32_t backend;            // Backend
+    int64_t qpcFrequency;        // units of pollQpc/acquiredQpc/renderedQpc
+    int64_t timestampFrequency;  // units of sourceTimestamp (QPC for DXGI, 10 MHz for WGC)
+    uint32_t srcWidth;
+    uint32_t srcHeight;
+    uint32_t thumbWidth;         // 0 = no thumbnails
+    uint32_t thumbHeight;
+    uint32_t recordCount;
+    uint32_t thumbCount;
+    uint64_t droppedRecords;     // records overwritten by the ring before the trace was saved
+};
+static_assert(sizeof(Header) == 64, "trace header layout");
+
+struct Record {
+    int64_t pollQpc;          // render loop asked the source for a frame
+    int64_t acquiredQpc;      // GetFrame returned
+    int64_t renderedQpc;      // Render (incl. Present) returned
+    int64_t sourceTimestamp;  // LastPresentTime / SystemRelativeTime (0 if none)
+    int32_t acquireHr;        // last acquire HRESULT (S_OK if the backend has none)
+    uint32_t accumulatedFrames;
+    uint32_t flags;           // kFlag*
+    int32_t thumbIndex;       // index into the trace's thumbnails, -1 = none
+    float costMs;             // pipeline cost of a recent render that ran the depth passes (0 = no new measurement)
+    float renderScale;        // size that render ran at, relative to the source (0 = unknown)
+};
+static_assert(sizeof(Record) == 56, "trace record layout");
+
+struct Trace {
+    Header header{};
+    std::vector<Record> records;
+    std::vector<std::vector<uint8_t>> thumbs; // BGRA8, thumbWidth * thumbHeight * 4 each
+};
+
+bool Load(const std::string& path, Trace* out, std::string* err);
+
+// Ring-buffered recorder. Not thread-safe; owned by the render loop.
+class Recorder {
+public:
+    static constexpr size_t kDefaultRecordCapacity = 36000; // 10 min @ 60 fps (~1.7 MB)
+    static constexpr size_t kDefaultThumbCapacity = 600;    // 10 s @ 60 fps
+
+    void Begin(Backend backend, int64_t qpcFrequency, int64_t timestampFrequency,
+               uint32_t srcWidth, uint32_t srcHeight, uint32_t thumbWidth, uint32_t thumbHeight,
+               size_t recordCapacity = kDefaultRecordCapacity, size_t thumbCapacity = kDefaultThumbCapacity);
+    void Reset();
+    bool IsActive() const { return active_; }
+
+    // Returns the record's sequence number (for AttachThumbnail).
+    uint64_t Add(const Record& record);
+    // Thumbnails usually arrive a frame or two after their record (async GPU readback).
+    void AttachThumbnail(uint64_t recordSeq, const uint8_t* bgra, size_t rowPitch);
+
+    bool Save(const std::string& path, std::string* err) const;
+
+    uint64_t GetRecordCount() const { return nextSeq_; }
+    uint32_t GetThumbWidth() const { return header_.thumbWidth; }
+    uint32_t GetThumbHeight() const { return header_.thumbHeight; }
+
+private:
+    struct Thumb {
+        uint64_t recordSeq = 0;
+        std::vector<uint8_t> bgra;
+    };
+
+    bool active_ = false;
+    Header header_{};
+    std::vector<Record> records_;   // ring, slot = seq % capacity
+    uint64_t nextSeq_ = 0;
+    std::vector<Thumb> thumbs_;     // ring, slot = thumbSeq % capacity
+    uint64_t nextThumbSeq_ = 0;
+};
+
+} // namespace CaptureTrace
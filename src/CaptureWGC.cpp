@@ -1,5 +1,6 @@
 #include "CaptureWGC.h"
 #include "Log.h"
+#include "Renderer.h"
 
 #include <windows.h>
 
@@ -70,12 +71,14 @@ struct CaptureWGC::Impl {
     HWND notifyHwnd = nullptr;
     bool pickInProgress = false;
     Direct3D11CaptureFramePool framePool{ nullptr };
+    bool freeThreadedPool = false;
     GraphicsCaptureSession session{ nullptr };
 
     winrt::event_token frameArrivedToken{};
     std::atomic<unsigned long long> frameArrivedCount{ 0 };
     std::atomic<unsigned long long> frameProducedCount{ 0 };
     std::atomic<unsigned long long> frameConsumedCount{ 0 };
+    unsigned lastDrained = 0;
     std::mutex pendingMutex;
     Direct3D11CaptureFrame pendingFrame{ nullptr };
 
@@ -183,6 +186,7 @@ struct CaptureWGC::Impl {
             framePool.Close();
             framePool = nullptr;
         }
+        freeThreadedPool = false;
         frameArrivedToken = {};
         frameArrivedCount.store(0, std::memory_order_relaxed);
         frameProducedCount.store(0, std::memory_order_relaxed);
@@ -421,6 +425,7 @@ bool CaptureWGC::StartCaptureFromPickedItem() {
                 DirectXPixelFormat::B8G8R8A8UIntNormalized,
                 kFramePoolBufferCount,
                 size);
+            impl_->freeThreadedPool = true;
             Log::Info("CaptureWGC: Using CreateFreeThreaded frame pool");
         } catch (...) {
             impl_->framePool = Direct3D11CaptureFramePool::Create(
@@ -428,6 +433,7 @@ bool CaptureWGC::StartCaptureFromPickedItem() {
                 DirectXPixelFormat::B8G8R8A8UIntNormalized,
                 kFramePoolBufferCount,
                 size);
+            impl_->freeThreadedPool = false;
             Log::Info("CaptureWGC: Using Create (apartment) frame pool");
         }
 
@@ -436,7 +442,7 @@ bool CaptureWGC::StartCaptureFromPickedItem() {
             // IMPORTANT: do not drain the pool here.
             // FrameArrived callbacks can be coalesced/throttled depending on the apartment/threading model,
             // and draining in the callback can cause dropped frames when the buffer count is small.
-            // We drain from GetFrame() on the render tick instead.
+            // We drain from GetFrame() instead (capture thread, or the render tick).
             if (impl_->frameEvent) {
                 SetEvent(impl_->frameEvent);
             }
@@ -609,6 +615,7 @@ bool CaptureWGC::GetFrame(ID3D11Texture2D** outTex, INT64* outTimestamp) {
         return false;
     }
 
+    impl_->lastDrained = drained;
     if (drained > 0) {
         impl_->frameProducedCount.fetch_add((unsigned long long)drained, std::memory_order_relaxed);
     }
@@ -748,6 +755,27 @@ ID3D11DeviceContext* CaptureWGC::GetContext() const {
     return impl_ ? impl_->d3dContext : nullptr;
 }
 
+bool CaptureWGC::CanCaptureOnAnyThread() const {
+    // An apartment-bound pool must be drained on the thread that created it.
+    return impl_ && impl_->freeThreadedPool;
+}
+
+void CaptureWGC::WaitForFrame(DWORD timeoutMs) {
+    if (impl_ && impl_->frameEvent) {
+        WaitForSingleObject(impl_->frameEvent, timeoutMs);
+    } else {
+        Sleep(1);
+    }
+}
+
+UINT CaptureWGC::GetLastAccumulatedFrames() const {
+    return impl_ ? impl_->lastDrained : 0;
+}
+
+void CaptureWGC::ReportStats(Renderer& renderer) const {
+    renderer.SetCaptureStatsWGC(GetFrameArrivedCount(), GetFrameProducedCount(), GetFrameConsumedCount());
+}
+
 HWND CaptureWGC::GetCapturedWindow() const {
     return impl_ ? impl_->targetHwnd : nullptr;
 }
@@ -5,7 +5,9 @@
 #include <string>
 #include <windows.h>
 
-class CaptureWGC {
+#include "FrameSource.h"
+
+class CaptureWGC : public FrameSource {
 public:
     CaptureWGC();
     ~CaptureWGC();
@@ -32,12 +34,22 @@ public:
     bool ResizeTargetWindowClient(UINT clientWidth, UINT clientHeight);
 
     // Returns true and sets outTex and outTimestamp (QPC units) if a frame is available
-    bool GetFrame(ID3D11Texture2D** outTex, INT64* outTimestamp = nullptr);
-    void ReleaseFrame();
-    void Cleanup();
+    bool GetFrame(ID3D11Texture2D** outTex, INT64* outTimestamp = nullptr) override;
+    void ReleaseFrame() override;
+    void Cleanup() override;
+
+    ID3D11Device* GetDevice() const override;
+    ID3D11DeviceContext* GetContext() const override;
+    void ReportStats(Renderer& renderer) const override;
+    // Only with the free-threaded frame pool (the apartment fallback is tied to the UI thread).
+    bool CanCaptureOnAnyThread() const override;
+    // Waits on the FrameArrived event.
+    void WaitForFrame(DWORD timeoutMs) override;
 
-    ID3D11Device* GetDevice() const;
-    ID3D11DeviceContext* GetContext() const;
+    // Frames drained from the pool by the last GetFrame (only the newest is returned).
+    UINT GetLastAccumulatedFrames() const override;
+    // SystemRelativeTime is in 100 ns units.
+    INT64 GetTimestampFrequency() const override { return 10000000; }
 
     // Returns the HWND of the captured window if available, or nullptr otherwise.
     HWND GetCapturedWindow() const;
@@ -0,0 +1,477 @@
+// ArinConvert: headless 2D -> SBS batch converter.
+// Runs image sequences / raw BGRA / Y4M through the CPU DFL-S depth + parallax engine (DepthCpu)
+// with the same stereo parameters the app stores in settings.ini, and reports throughput.
+
+#include "DepthCpu.h"
+#include "FrameIO.h"
+#include "FramePipeline.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+static double SecondsSince(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+static int ClampInt(int v, int lo, int hi) {
+    if (v < lo) return lo;
+    if (v > hi) return hi;
+    return v;
+}
+
+// Subset of AppSettings used by the depth pipeline (same defaults and clamping as Settings.cpp).
+struct StereoSettings {
+    int depthLevel = 10;              // [1,20]
+    int parallaxStrengthPercent = 20; // [0,50]
+    int shaderMode = 0;               // 0=Depth3Pass, 1=DepthFused
+    int depthPrecision = 0;           // DepthCpu::DepthPrecision (0=f32, 1=u16, 2=u8)
+    int foveation = 0;                // 0=off, 2/4 = periphery depth at 1/2 or 1/4 resolution
+    int foveaRadiusPercent = 40;      // [0,150] of the eye view's half-size
+    int foveaFalloffPercent = 20;     // [0,150]
+    int layout = 2;                   // DepthCpu::StereoLayout (1=OU, 2=half SBS, 3=full SBS, 4=2D+depth)
+};
+
+// Reads the [Stereo] section of the app's settings.ini (ANSI or UTF-8; UTF-16 files are not supported).
+static bool LoadStereoSettings(const std::string& path, StereoSettings& s) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string line;
+    std::string section;
+    while (std::getline(in, line)) {
+        if (line.size() >= 3 && (unsigned char)line[0] == 0xEF && (unsigned char)line[1] == 0xBB && (unsigned char)line[2] == 0xBF) {
+            line.erase(0, 3);
+        }
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+        if (line.empty() || line[0] == ';') continue;
+
+        if (line[0] == '[') {
+            section = line.substr(1, line.find(']') - 1);
+            continue;
+        }
+        if (section != "Stereo") continue;
+
+        const size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        const std::string key = line.substr(0, eq);
+        const int v = std::atoi(line.c_str() + eq + 1);
+        if (key == "DepthLevel") s.depthLevel = ClampInt(v, 1, 20);
+        else if (key == "ParallaxStrengthPercent") s.parallaxStrengthPercent = ClampInt(v, 0, 50);
+        else if (key == "ShaderMode") s.shaderMode = ClampInt(v, 0, 1);
+        else if (key == "DepthPrecision") s.depthPrecision = ClampInt(v, 0, 2);
+        else if (key == "Foveation") s.foveation = (v <= 0) ? 0 : (v >= 4 ? 4 : 2);
+        else if (key == "FoveaRadiusPercent") s.foveaRadiusPercent = ClampInt(v, 0, 150);
+        else if (key == "FoveaFalloffPercent") s.foveaFalloffPercent = ClampInt(v, 0, 150);
+        else if (key == "Layout") s.layout = ClampInt(v, 1, 4);
+    }
+    return true;
+}
+
+// WxH, each side 1..FrameIO::kMaxFrameSide. strtoull saturates, so overflowing sides fail the range check.
+static bool ParseSize(const char* s, uint32_t* w, uint32_t* h) {
+    char* end = nullptr;
+    const unsigned long long a = std::strtoull(s, &end, 10);
+    if (end == s || *end != 'x') return false;
+    const char* t = end + 1;
+    const unsigned long long b = std::strtoull(t, &end, 10);
+    if (end == t || *end != '\0' || !FrameIO::IsFrameSizeSupported(a, b)) return false;
+    *w = (uint32_t)a;
+    *h = (uint32_t)b;
+    return true;
+}
+
+static bool ParseSimdLevel(const std::string& name, DepthCpu::SimdLevel* out) {
+    const DepthCpu::SimdLevel all[] = {
+        DepthCpu::SimdLevel::Scalar, DepthCpu::SimdLevel::Sse41, DepthCpu::SimdLevel::Avx2,
+        DepthCpu::SimdLevel::Avx512, DepthCpu::SimdLevel::Neon,
+    };
+    for (DepthCpu::SimdLevel l : all) {
+        if (name == DepthCpu::SimdLevelName(l)) {
+            *out = l;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool ParseDepthPrecision(const std::string& name, int* out) {
+    for (int i = 0; i <= 2; ++i) {
+        if (name == DepthCpu::DepthPrecisionName((DepthCpu::DepthPrecision)i)) {
+            *out = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool ParseLayout(const std::string& name, DepthCpu::StereoLayout* out) {
+    for (int i = 1; i <= 4; ++i) {
+        if (name == DepthCpu::StereoLayoutName((DepthCpu::StereoLayout)i)) {
+            *out = (DepthCpu::StereoLayout)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// --extra-output <layout>[,WxH]=<path>
+struct ExtraOutput {
+    DepthCpu::StereoLayout layout = DepthCpu::StereoLayout::HalfSbs;
+    uint32_t outWidth = 0; // 0 = the main output's canvas
+    uint32_t outHeight = 0;
+    std::string path;
+};
+
+static bool ParseExtraOutput(const std::string& spec, ExtraOutput* out) {
+    const size_t eq = spec.find('=');
+    if (eq == std::string::npos || eq + 1 >= spec.size()) return false;
+    const std::string head = spec.substr(0, eq);
+    const size_t comma = head.find(',');
+    if (!ParseLayout(head.substr(0, comma), &out->layout)) return false;
+    if (comma != std::string::npos && !ParseSize(head.c_str() + comma + 1, &out->outWidth, &out->outHeight)) return false;
+    out->path = spec.substr(eq + 1);
+    return true;
+}
+
+static void PrintUsage() {
+    std::fprintf(stderr,
+        "Usage: ArinConvert [options] <input> <output>\n"
+        "\n"
+        "Converts 2D frames to stereo (half-SBS by default) using the DFL-S depth + parallax pipeline.\n"
+        "\n"
+        "Input/output are picked by extension:\n"
+        "  .ppm .pgm .pam%s   single image, or a sequence with a printf pattern (frames/%%05d.ppm)\n"
+        "  .y4m                 YUV4MPEG2 stream (8-bit 4:2:0 / 4:4:4 / mono)\n"
+        "  .bgra .raw           headerless BGRA8 frames (input needs --size)\n"
+        "  -                    stdin/stdout stream: Y4M, or raw BGRA with --size / --in-format raw / --out-format raw\n"
+        "\n"
+        "Options:\n"
+        "  --settings <ini>     read [Stereo] DepthLevel / ParallaxStrengthPercent / ShaderMode / DepthPrecision / Foveation* / Layout from the app's settings.ini\n"
+        "  --depth <1..20>      depth level (default 10)\n"
+        "  --strength <0..50>   parallax strength percent (default 20)\n"
+        "  --fused              fused single-sweep pipeline (same as ShaderMode=1)\n"
+        "  --per-view           compute depth once per eye view (half-width planes) instead of SBS-wide\n"
+        "  --depth-precision f32|u16|u8   depth/history plane storage (same as DepthPrecision=0/1/2)\n"
+        "  --incremental        only recompute tiles whose source changed or whose depth is still settling\n"
+        "  --scroll-tracking    detect vertical scrolls and move the depth history along with the content\n"
+        "  --letterbox          detect black bars and run depth only on the picture inside them\n"
+        "  --foveate 2|4[,r,f]  full-resolution depth only near each view's centre, 1/2 or 1/4 resolution in the\n"
+        "                       periphery; r / f = radius and falloff in percent of the half-view (default 40,20)\n"
+        "  --interpolate <n>    frame-rate up-conversion: n output frames per input frame, n - 1 of them synthesized\n"
+        "                       from motion and depth between neighbouring frames (the Y4M rate is multiplied by n)\n"
+        "  --layout half-sbs|ou|full-sbs|2d-depth   output layout (same as Layout=2/1/3/4); full-sbs and 2d-depth\n"
+        "                       are twice the output width\n"
+        "  --extra-output <layout>[,WxH]=<path>   also write the picture in another layout / half-SBS canvas\n"
+        "                       size (default: --out-size) from the same depth pass; repeatable, not with\n"
+        "                       --interpolate or --letterbox\n"
+        "  --crop l,t,r,b       normalized source crop\n"
+        "  --parallax-px <px>   explicit parallax in output pixels (overrides depth/strength)\n"
+        "  --size WxH           raw input frame size (up to 16384 per side)\n"
+        "  --out-size WxH       half-SBS canvas size the depth runs at (default: input size)\n"
+        "  --in-format, --out-format image|raw|y4m   override extension detection\n"
+        "  --start <n>          first sequence index (input default: 0 or 1, output default: 0)\n"
+        "  --frames <n>         stop after n frames\n"
+        "  --threads <n>        worker threads (default: all cores)\n"
+        "  --queue <n>          frames buffered between read/render/write (default 3)\n"
+        "  --simd <level>       scalar|sse4.1|avx2|avx512|neon (default: best available)\n"
+        "  --fps <num[/den]>    Y4M output frame rate (default: input rate or 30)\n"
+        "  --y4m-444            write 4:4:4 Y4M instead of 4:2:0\n"
+        "  --bt709              use BT.709 instead of BT.601 for Y4M colour conversion\n"
+        "  --quiet              no progress output\n",
+        FrameIO::HasPngSupport() ? " .png" : "");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    StereoSettings stereo;
+    int depthOverride = -1;
+    int strengthOverride = -1;
+    bool fused = false;
+    bool perView = false;
+    bool incremental = false;
+    bool scrollTracking = false;
+    bool letterbox = false;
+    int precisionOverride = -1;
+    int foveaScale = -1;
+    int foveaRadius = -1;
+    int foveaFalloff = -1;
+    uint32_t interpolate = 1;
+    int layoutOverride = -1;
+    std::vector<ExtraOutput> extraOutputs;
+    StreamParams stream;
+    long maxFrames = -1;
+    size_t queueDepth = FramePipeline::kDefaultQueueDepth;
+    unsigned threads = 0;
+    bool quiet = false;
+    FrameIO::ReaderOptions ropt;
+    FrameIO::WriterOptions wopt;
+    bool fpsGiven = false;
+    std::string inPath, outPath;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto next = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "ArinConvert: %s needs a value\n", name);
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+
+        if (a == "-h" || a == "--help") {
+            PrintUsage();
+            return 0;
+        } else if (a == "--settings") {
+            const char* p = next("--settings");
+            if (!LoadStereoSettings(p, stereo)) {
+                std::fprintf(stderr, "ArinConvert: cannot read settings '%s'\n", p);
+                return 2;
+            }
+        } else if (a == "--depth") {
+            depthOverride = ClampInt(std::atoi(next("--depth")), 1, 20);
+        } else if (a == "--strength") {
+            strengthOverride = ClampInt(std::atoi(next("--strength")), 0, 50);
+        } else if (a == "--fused") {
+            fused = true;
+        } else if (a == "--per-view") {
+            perView = true;
+        } else if (a == "--incremental") {
+            incremental = true;
+        } else if (a == "--scroll-tracking") {
+            scrollTracking = true;
+        } else if (a == "--letterbox") {
+            letterbox = true;
+        } else if (a == "--foveate") {
+            const int n = std::sscanf(next("--foveate"), "%d,%d,%d", &foveaScale, &foveaRadius, &foveaFalloff);
+            if (n != 1 && n != 3) {
+                std::fprintf(stderr, "ArinConvert: --foveate expects scale[,radius,falloff]\n");
+                return 2;
+            }
+            foveaScale = (foveaScale >= 4) ? 4 : 2;
+            if (n == 3) {
+                foveaRadius = ClampInt(foveaRadius, 0, 150);
+                foveaFalloff = ClampInt(foveaFalloff, 0, 150);
+            }
+        } else if (a == "--interpolate") {
+            interpolate = (uint32_t)ClampInt(std::atoi(next("--interpolate")), 1, 16);
+        } else if (a == "--extra-output") {
+            ExtraOutput o;
+            if (!ParseExtraOutput(next("--extra-output"), &o)) {
+                std::fprintf(stderr, "ArinConvert: --extra-output expects <layout>[,WxH]=<path>\n");
+                return 2;
+            }
+            extraOutputs.push_back(o);
+        } else if (a == "--layout") {
+            DepthCpu::StereoLayout layout;
+            if (!ParseLayout(next("--layout"), &layout)) {
+                std::fprintf(stderr, "ArinConvert: --layout expects half-sbs, ou, full-sbs or 2d-depth\n");
+                return 2;
+            }
+            layoutOverride = (int)layout;
+        } else if (a == "--depth-precision") {
+            if (!ParseDepthPrecision(next("--depth-precision"), &precisionOverride)) {
+                std::fprintf(stderr, "ArinConvert: --depth-precision expects f32, u16 or u8\n");
+                return 2;
+            }
+        } else if (a == "--crop") {
+            float* c = stream.crop;
+            if (std::sscanf(next("--crop"), "%f,%f,%f,%f", &c[0], &c[1], &c[2], &c[3]) != 4) {
+                std::fprintf(stderr, "ArinConvert: --crop expects l,t,r,b\n");
+                return 2;
+            }
+        } else if (a == "--parallax-px") {
+            stream.parallaxPx = (float)std::atof(next("--parallax-px"));
+            if (stream.parallaxPx < 0.0f) stream.parallaxPx = 0.0f;
+        } else if (a == "--size") {
+            if (!ParseSize(next("--size"), &ropt.rawWidth, &ropt.rawHeight)) {
+                std::fprintf(stderr, "ArinConvert: --size expects WxH (1..%u per side)\n", FrameIO::kMaxFrameSide);
+                return 2;
+            }
+        } else if (a == "--out-size") {
+            if (!ParseSize(next("--out-size"), &stream.outWidth, &stream.outHeight)) {
+                std::fprintf(stderr, "ArinConvert: --out-size expects WxH (1..%u per side)\n", FrameIO::kMaxFrameSide);
+                return 2;
+            }
+        } else if (a == "--in-format" || a == "--out-format") {
+            FrameIO::Format f;
+            if (!FrameIO::ParseFormat(next(a.c_str()), &f)) {
+                std::fprintf(stderr, "ArinConvert: unknown format for %s\n", a.c_str());
+                return 2;
+            }
+            if (a == "--in-format") ropt.format = f;
+            else wopt.format = f;
+        } else if (a == "--start") {
+            ropt.firstIndex = wopt.firstIndex = std::atoi(next("--start"));
+        } else if (a == "--frames") {
+            maxFrames = std::atol(next("--frames"));
+        } else if (a == "--queue") {
+            queueDepth = (size_t)ClampInt(std::atoi(next("--queue")), 1, 64);
+        } else if (a == "--threads") {
+            threads = (unsigned)std::atoi(next("--threads"));
+        } else if (a == "--simd") {
+            DepthCpu::SimdLevel level;
+            const char* name = next("--simd");
+            if (!ParseSimdLevel(name, &level) || !DepthCpu::SetSimdLevel(level)) {
+                std::fprintf(stderr, "ArinConvert: SIMD level '%s' is not available on this CPU/build\n", name);
+                return 2;
+            }
+        } else if (a == "--fps") {
+            unsigned long n = 0, d = 1;
+            if (std::sscanf(next("--fps"), "%lu/%lu", &n, &d) < 1 || n == 0 || d == 0) {
+                std::fprintf(stderr, "ArinConvert: --fps expects num[/den]\n");
+                return 2;
+            }
+            wopt.fpsNum = (uint32_t)n;
+            wopt.fpsDen = (uint32_t)d;
+            fpsGiven = true;
+        } else if (a == "--y4m-444") {
+            wopt.y4m444 = true;
+        } else if (a == "--bt709") {
+            ropt.matrix = wopt.matrix = FrameIO::YuvMatrix::Bt709;
+        } else if (a == "--quiet") {
+            quiet = true;
+        } else if (!a.empty() && a[0] == '-' && a != "-") {
+            std::fprintf(stderr, "ArinConvert: unknown option %s\n", a.c_str());
+            return 2;
+        } else if (inPath.empty()) {
+            inPath = a;
+        } else if (outPath.empty()) {
+            outPath = a;
+        } else {
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    if (inPath.empty() || outPath.empty()) {
+        PrintUsage();
+        return 2;
+    }
+
+    if (depthOverride >= 0) stereo.depthLevel = depthOverride;
+    if (strengthOverride >= 0) stereo.parallaxStrengthPercent = strengthOverride;
+    if (fused) stereo.shaderMode = 1;
+    if (precisionOverride >= 0) stereo.depthPrecision = precisionOverride;
+    if (foveaScale >= 0) stereo.foveation = foveaScale;
+    if (foveaRadius >= 0) stereo.foveaRadiusPercent = foveaRadius;
+    if (foveaFalloff >= 0) stereo.foveaFalloffPercent = foveaFalloff;
+    if (layoutOverride >= 0) stereo.layout = layoutOverride;
+
+    std::string err;
+    std::unique_ptr<FrameIO::FrameReader> reader = FrameIO::OpenReader(inPath, ropt, &err);
+    if (!reader) {
+        std::fprintf(stderr, "ArinConvert: %s\n", err.c_str());
+        return 1;
+    }
+    if (!fpsGiven && reader->GetFpsNum() != 0) {
+        wopt.fpsNum = reader->GetFpsNum();
+        wopt.fpsDen = reader->GetFpsDen();
+    }
+    if (!fpsGiven) wopt.fpsNum *= interpolate;
+    std::unique_ptr<FrameIO::FrameWriter> writer = FrameIO::OpenWriter(outPath, wopt, &err);
+    if (!writer) {
+        std::fprintf(stderr, "ArinConvert: %s\n", err.c_str());
+        return 1;
+    }
+    std::vector<std::unique_ptr<FrameIO::FrameWriter>> extraWriters;
+    for (const ExtraOutput& o : extraOutputs) {
+        extraWriters.push_back(FrameIO::OpenWriter(o.path, wopt, &err));
+        if (!extraWriters.back()) {
+            std::fprintf(stderr, "ArinConvert: %s\n", err.c_str());
+            return 1;
+        }
+    }
+
+    ThreadPool pool(threads);
+    DepthCpu::Engine engine;
+    engine.SetThreadPool(&pool);
+    engine.SetPipelineMode(stereo.shaderMode == 1 ? DepthCpu::PipelineMode::Fused : DepthCpu::PipelineMode::ThreePass);
+    engine.SetPerViewDepth(perView);
+    engine.SetDepthPrecision((DepthCpu::DepthPrecision)stereo.depthPrecision);
+    engine.SetIncremental(incremental);
+    engine.SetScrollTracking(scrollTracking);
+    engine.SetLetterboxDetection(letterbox);
+    DepthCpu::Foveation fovea;
+    fovea.enabled = stereo.foveation != 0;
+    fovea.peripheryScale = fovea.enabled ? (uint32_t)stereo.foveation : 2u;
+    fovea.radius = stereo.foveaRadiusPercent / 100.0f;
+    fovea.falloff = stereo.foveaFalloffPercent / 100.0f;
+    engine.SetFoveation(fovea);
+    engine.SetLayout((DepthCpu::StereoLayout)stereo.layout);
+
+    stream.depthLevel = stereo.depthLevel;
+    stream.parallaxStrengthPercent = stereo.parallaxStrengthPercent;
+    const DepthCpu::Params params = FramePipeline::ToEngineParams(stream, 0, 0);
+
+    if (!quiet) {
+        std::fprintf(stderr, "ArinConvert: depthLevel=%d parallaxStrengthPercent=%d (parallaxPx=%.2f) mode=%s%s%s%s%s%s depth=%s layout=%s simd=%s threads=%u queue=%zu interpolate=%u\n",
+            stereo.depthLevel, stereo.parallaxStrengthPercent, params.parallaxPx,
+            stereo.shaderMode == 1 ? "fused" : "3pass", perView ? "+per-view" : "", incremental ? "+incremental" : "", scrollTracking ? "+scroll" : "", letterbox ? "+letterbox" : "",
+            fovea.enabled ? (stereo.foveation == 4 ? "+foveated/4" : "+foveated/2") : "",
+            DepthCpu::DepthPrecisionName(engine.GetDepthPrecision()), DepthCpu::StereoLayoutName(engine.GetLayout()), DepthCpu::SimdLevelName(DepthCpu::GetSimdLevel()), pool.GetThreadCount(), queueDepth, interpolate);
+    }
+
+    FramePipeline pipeline(engine);
+    pipeline.SetQueueDepth(queueDepth);
+    pipeline.SetInterpolation(interpolate);
+    for (size_t i = 0; i < extraOutputs.size(); ++i) {
+        pipeline.AddOutput(*extraWriters[i], extraOutputs[i].layout, extraOutputs[i].outWidth, extraOutputs[i].outHeight);
+        if (!quiet) {
+            const std::string canvas = extraOutputs[i].outWidth
+                ? std::to_string(extraOutputs[i].outWidth) + "x" + std::to_string(extraOutputs[i].outHeight) : std::string("main");
+            std::fprintf(stderr, "ArinConvert: extra output %s layout=%s canvas=%s\n", extraOutputs[i].path.c_str(),
+                DepthCpu::StereoLayoutName(extraOutputs[i].layout), canvas.c_str());
+        }
+    }
+    if (!quiet) {
+        const Clock::time_point start = Clock::now();
+        double lastReport = 0.0;
+        pipeline.SetProgressCallback([start, lastReport](long frames) mutable {
+            const double t = SecondsSince(start);
+            if (t - lastReport < 1.0) return;
+            lastReport = t;
+            std::fprintf(stderr, "  %ld frames, %.2f fps\n", frames, (double)frames / t);
+        });
+    }
+
+    const bool ok = pipeline.Run(*reader, *writer, stream, maxFrames);
+    if (!ok) {
+        std::fprintf(stderr, "ArinConvert: %s\n", pipeline.GetError().c_str());
+        return 1;
+    }
+    if (!writer->Finish()) {
+        std::fprintf(stderr, "ArinConvert: %s\n", writer->GetError().c_str());
+        return 1;
+    }
+    for (const std::unique_ptr<FrameIO::FrameWriter>& w : extraWriters) {
+        if (!w->Finish()) {
+            std::fprintf(stderr, "ArinConvert: %s\n", w->GetError().c_str());
+            return 1;
+        }
+    }
+
+    // Stage times overlap; wall time is what bounds throughput, the busiest stage is the bottleneck.
+    const FramePipeline::Stats& st = pipeline.GetStats();
+    if (!quiet) {
+        const double n = st.frames > 0 ? (double)st.frames : 1.0;
+        std::fprintf(stderr, "ArinConvert: %ld frames in %.2fs = %.2f fps (read %.1f ms, render %.1f ms, write %.1f ms per frame)\n",
+            st.frames, st.wallSec, st.wallSec > 0.0 ? (double)st.frames / st.wallSec : 0.0,
+            st.readSec * 1000.0 / n, st.renderSec * 1000.0 / n, st.writeSec * 1000.0 / n);
+        if (!extraOutputs.empty()) {
+            std::fprintf(stderr, "ArinConvert: %zu extra outputs resampled in %.1f ms per frame\n", extraOutputs.size(), st.outputSec * 1000.0 / n);
+        }
+    }
+    return st.frames > 0 ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+#include "DepthBatch.h"
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace DepthCpu {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+static uint64_t OutputPixels(const BatchEngine::Frame& f) {
+    return (uint64_t)f.out.width * f.out.height;
+}
+
+} // namespace
+
+uint32_t BatchEngine::AddStream() {
+    Stream s;
+    s.id = nextId_++;
+    s.engine = std::make_unique<Engine>();
+    streams_.push_back(std::move(s));
+    return streams_.back().id;
+}
+
+void BatchEngine::RemoveStream(uint32_t id) {
+    streams_.erase(std::remove_if(streams_.begin(), streams_.end(), [id](const Stream& s) { return s.id == id; }), streams_.end());
+}
+
+BatchEngine::Stream* BatchEngine::FindStream(uint32_t id) {
+    for (Stream& s : streams_) {
+        if (s.id == id) return &s;
+    }
+    return nullptr;
+}
+
+Engine* BatchEngine::GetEngine(uint32_t id) {
+    Stream* s = FindStream(id);
+    return s ? s->engine.get() : nullptr;
+}
+
+const BatchEngine::StreamStats* BatchEngine::GetStreamStats(uint32_t id) const {
+    for (const Stream& s : streams_) {
+        if (s.id == id) return &s.stats;
+    }
+    return nullptr;
+}
+
+void BatchEngine::ResetStats() {
+    stats_ = Stats();
+    for (Stream& s : streams_) s.stats = StreamStats();
+}
+
+bool BatchEngine::RenderBatch(Frame* frames, size_t count) {
+    if (count == 0) return true;
+    if (!frames) return false;
+
+    batchStreams_.assign(count, nullptr);
+    uint64_t totalPixels = 0;
+    for (size_t i = 0; i < count; ++i) {
+        frames[i].ok = false;
+        frames[i].latencyMs = 0.0;
+        Stream* s = FindStream(frames[i].stream);
+        if (!s || std::find(batchStreams_.begin(), batchStreams_.begin() + i, s) != batchStreams_.begin() + i) return false;
+        batchStreams_[i] = s;
+        totalPixels += OutputPixels(frames[i]);
+    }
+
+    // Largest first: the tiled streams start at once and the packed ones fill in around them.
+    batchOrder_.resize(count);
+    for (size_t i = 0; i < count; ++i) batchOrder_[i] = i;
+    std::stable_sort(batchOrder_.begin(), batchOrder_.end(),
+                     [frames](size_t a, size_t b) { return OutputPixels(frames[a]) > OutputPixels(frames[b]); });
+
+    // A stream is packed when it is small in absolute terms or when whole-stream tasks alone balance:
+    // it is at most 1/(2 * threads) of the batch, so the pool has at least two such tasks per thread.
+    const uint32_t threads = pool_ ? pool_->GetThreadCount() : 1;
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t pixels = OutputPixels(frames[i]);
+        const bool packed = threads <= 1 || pixels < packPixels_ || pixels * 2 * threads <= totalPixels;
+        batchStreams_[i]->engine->SetThreadPool(packed ? nullptr : pool_);
+        batchStreams_[i]->stats.packed = packed;
+    }
+
+    const Clock::time_point t0 = Clock::now();
+    auto run = [&](size_t i) {
+        Frame& f = frames[i];
+        f.ok = batchStreams_[i]->engine->Render(f.src, f.params, f.out);
+        f.latencyMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    };
+    if (threads <= 1) {
+        for (size_t i : batchOrder_) run(i);
+    } else {
+        ThreadPool::TaskGroup group;
+        for (size_t i : batchOrder_) pool_->Submit(group, [&run, i]() { run(i); });
+        pool_->Wait(group);
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    bool ok = true;
+    ++stats_.batches;
+    stats_.seconds += seconds;
+    for (size_t i = 0; i < count; ++i) {
+        const Frame& f = frames[i];
+        StreamStats& st = batchStreams_[i]->stats;
+        if (!f.ok) {
+            ++st.failed;
+            ok = false;
+            continue;
+        }
+        ++st.frames;
+        st.lastLatencyMs = f.latencyMs;
+        st.maxLatencyMs = std::max(st.maxLatencyMs, f.latencyMs);
+        st.sumLatencyMs += f.latencyMs;
+        ++stats_.frames;
+        stats_.pixels += OutputPixels(f);
+    }
+    return ok;
+}
+
+} // namespace DepthCpu
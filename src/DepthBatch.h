@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "DepthCpu.h"
+
+class ThreadPool;
+
+namespace DepthCpu {
+
+// Many independent streams on one pool (server-side conversion). Each stream is its own Engine, so its
+// history ping-pong, letterbox / scroll / interpolation state and settings never mix with another
+// stream's, and RenderBatch() runs one frame of any number of them together.
+//
+// Scheduling: a stream large enough to keep the pool busy on its own is tiled across it like a lone
+// Engine. Smaller ones run whole on one thread each (no per-tile hand-offs on frames too small to
+// split) and are packed around the tiled ones, largest first, so every core has work until the batch
+// drains.
+class BatchEngine {
+public:
+    // Outputs below this many pixels always run whole on one thread.
+    static constexpr uint64_t kDefaultPackPixels = 640 * 360;
+
+    // One frame of a batch. The caller fills stream..out; RenderBatch() sets ok and latencyMs.
+    struct Frame {
+        uint32_t stream = 0; // AddStream() id
+        ImageView src;
+        Params params;
+        ImageRef out;        // as for Engine::Render() (its layout's size)
+
+        bool ok = false;
+        double latencyMs = 0.0; // from the start of RenderBatch() to this frame's completion
+    };
+
+    struct StreamStats {
+        uint64_t frames = 0;
+        uint64_t failed = 0;
+        bool packed = false; // the last frame ran whole on one thread
+        double lastLatencyMs = 0.0;
+        double maxLatencyMs = 0.0;
+        double sumLatencyMs = 0.0;
+
+        double AverageLatencyMs() const { return frames ? sumLatencyMs / (double)frames : 0.0; }
+    };
+
+    // Aggregate over every RenderBatch() since the last ResetStats().
+    struct Stats {
+        uint64_t batches = 0;
+        uint64_t frames = 0;
+        uint64_t pixels = 0;  // output pixels of the frames that rendered
+        double seconds = 0.0; // wall time inside RenderBatch()
+
+        double FramesPerSecond() const { return seconds > 0.0 ? (double)frames / seconds : 0.0; }
+        double MegapixelsPerSecond() const { return seconds > 0.0 ? (double)pixels / seconds / 1e6 : 0.0; }
+    };
+
+    // Pool shared by every stream (not owned; nullptr = everything runs on the caller).
+    explicit BatchEngine(ThreadPool* pool = nullptr) : pool_(pool) {}
+
+    BatchEngine(const BatchEngine&) = delete;
+    BatchEngine& operator=(const BatchEngine&) = delete;
+
+    // New stream with a default Engine; returns its id (never 0).
+    uint32_t AddStream();
+    void RemoveStream(uint32_t id);
+    size_t GetStreamCount() const { return streams_.size(); }
+
+    // The stream's engine for its settings (pipeline mode, precision, layout, ...); nullptr for an
+    // unknown id. RenderBatch() picks its thread pool every frame, so don't set one.
+    Engine* GetEngine(uint32_t id);
+
+    // 0 keeps the default.
+    void SetPackPixels(uint64_t pixels) { packPixels_ = pixels ? pixels : kDefaultPackPixels; }
+    uint64_t GetPackPixels() const { return packPixels_; }
+
+    // Renders one frame of each listed stream. Nothing runs when a stream is unknown or listed twice
+    // (its frames must stay in order); otherwise false if any frame failed.
+    bool RenderBatch(Frame* frames, size_t count);
+
+    // nullptr for an unknown id.
+    const StreamStats* GetStreamStats(uint32_t id) const;
+    const Stats& GetStats() const { return stats_; }
+    void ResetStats();
+
+private:
+    struct Stream {
+        uint32_t id = 0;
+        std::unique_ptr<Engine> engine;
+        StreamStats stats;
+    };
+
+    Stream* FindStream(uint32_t id);
+
+    ThreadPool* pool_ = nullptr;
+    uint64_t packPixels_ = kDefaultPackPixels;
+    std::vector<Stream> streams_;
+    uint32_t nextId_ = 1;
+    Stats stats_;
+
+    // Per-batch scratch: the stream of each frame and the order they are submitted in.
+    std::vector<Stream*> batchStreams_;
+    std::vector<size_t> batchOrder_;
+};
+
+} // namespace DepthCpu
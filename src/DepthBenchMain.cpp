@@ -0,0 +1,1119 @@
+// ArinDepthBench: CPU depth engine micro-benchmark.
+// Renders a moving synthetic frame through DepthCpu::Engine and reports, section by section:
+// - each pipeline configuration (3-pass / fused, SBS-wide / per-view depth, f32 / unorm16 / unorm8):
+//   ms per frame, speedup over the f32 SBS-wide baseline and the size of its depth planes
+// - the pass-1 tone-curve table's worst-case error against the analytic curve (fails above 1/1024)
+// - precision stability: how much the reduced-precision planes change history and output over time
+// - incremental rendering: what it saves, and costs in accuracy, on a mostly static frame
+// - scroll-aware history: how quickly history recovers from a scroll with and without it
+// - letterbox detection: what it saves on a 2.39:1 picture inside a 16:9 frame
+// - foveated depth: savings and error outside the fovea at 1/2 and 1/4 periphery resolution
+// - frame interpolation: error on the skipped frames of a pan against repeating the last frame
+// - output layouts: half-SBS / OU / full-SBS / 2D+depth ms per frame, and one more layout from the same depth
+// - multi-stream batch: several streams of mixed sizes as one batch against one after another
+
+#include "DepthBatch.h"
+#include "DepthCpu.h"
+#include "DepthCpuKernels.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+static bool ParseSize(const char* s, uint32_t* w, uint32_t* h) {
+    unsigned long a = 0, b = 0;
+    if (std::sscanf(s, "%lux%lu", &a, &b) != 2 || a == 0 || b == 0) return false;
+    *w = (uint32_t)a;
+    *h = (uint32_t)b;
+    return true;
+}
+
+static bool ParseSimdLevel(const std::string& name, DepthCpu::SimdLevel* out) {
+    const DepthCpu::SimdLevel all[] = {
+        DepthCpu::SimdLevel::Scalar, DepthCpu::SimdLevel::Sse41, DepthCpu::SimdLevel::Avx2,
+        DepthCpu::SimdLevel::Avx512, DepthCpu::SimdLevel::Neon,
+    };
+    for (DepthCpu::SimdLevel l : all) {
+        if (name == DepthCpu::SimdLevelName(l)) {
+            *out = l;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void PrintUsage() {
+    std::fprintf(stderr,
+        "Usage: ArinDepthBench [options]\n"
+        "\n"
+        "Times the CPU depth engine on a synthetic frame in every pipeline configuration.\n"
+        "\n"
+        "Options:\n"
+        "  --size WxH       source frame size (default 1920x1080)\n"
+        "  --out-size WxH   SBS output size (default: source size)\n"
+        "  --frames <n>     timed frames per configuration (default 60)\n"
+        "  --warmup <n>     untimed frames first (default 5)\n"
+        "  --threads <n>    worker threads (default: all cores)\n"
+        "  --simd <level>   scalar|sse4.1|avx2|avx512|neon (default: best available)\n"
+        "  --depth <1..20>  depth level (default 10)\n"
+        "  --strength <0..50> parallax strength percent (default 20)\n"
+        "  --stability-frames <n> frames per phase of the precision stability report (default 120, 0 = skip)\n"
+        "  --settle-frames <n> untimed frames before timing incremental rendering (default 150, 0 = skip)\n"
+        "  --scroll-frames <n> frames of scrolling in the scroll-aware history report (default 8, 0 = skip)\n"
+        "  --letterbox-frames <n> timed frames of the letterbox detection report (default 30, 0 = skip)\n"
+        "  --foveation-frames <n> timed frames of the foveated depth report (default 30, 0 = skip)\n"
+        "  --interpolation-frames <n> source frames of the frame interpolation report (default 16, 0 = skip)\n"
+        "  --interpolation-step <n> output frames per source frame in that report (default 4)\n"
+        "  --layout-frames <n> timed frames of the output layout report (default 30, 0 = skip)\n"
+        "  --stream-frames <n> timed frames of the multi-stream batch report (default 30, 0 = skip)\n");
+}
+
+// Gradient + drifting checkerboard, so luma gradients (and therefore depth) change every frame.
+static void FillSyntheticFrame(std::vector<uint8_t>& bgra, uint32_t w, uint32_t h, uint32_t frame) {
+    const uint32_t shift = frame * 3;
+    for (uint32_t y = 0; y < h; ++y) {
+        uint8_t* row = bgra.data() + (size_t)y * w * 4;
+        for (uint32_t x = 0; x < w; ++x) {
+            const bool check = (((x + shift) / 32) ^ (y / 32)) & 1;
+            const uint8_t g = (uint8_t)((x * 255) / (w > 1 ? w - 1 : 1));
+            row[x * 4 + 0] = check ? 200 : (uint8_t)(g / 2);
+            row[x * 4 + 1] = (uint8_t)((y * 255) / (h > 1 ? h - 1 : 1));
+            row[x * 4 + 2] = check ? g : 40;
+            row[x * 4 + 3] = 255;
+        }
+    }
+}
+
+// Largest tone LUT error the bench accepts (a quarter of an 8-bit step); beyond it the run fails.
+static constexpr double kToneLutMaxError = 1.0 / 1024.0;
+
+// Max |table - analytic| over a dense sweep of g_soft, for (curve_blend, shaped).
+static void ToneCurveError(double* curveErr, double* shapedErr) {
+    const float* lut = DepthCpu::Kernels::ToneCurveLut();
+    const int steps = 1 << 20;
+    *curveErr = *shapedErr = 0.0;
+    for (int i = 0; i <= steps; ++i) {
+        const float g = (float)i / (float)steps;
+        float c0, s0, c1, s1;
+        DepthCpu::Kernels::ToneCurveAt(g, &c0, &s0);
+        DepthCpu::Kernels::ToneCurveLookup(lut, g, &c1, &s1);
+        *curveErr = std::max(*curveErr, (double)std::fabs(c1 - c0));
+        *shapedErr = std::max(*shapedErr, (double)std::fabs(s1 - s0));
+    }
+}
+
+struct Config {
+    const char* name;
+    DepthCpu::PipelineMode mode;
+    bool perView;
+    DepthCpu::DepthPrecision precision;
+};
+
+static float DepthAt(const void* plane, DepthCpu::DepthPrecision precision, size_t i) {
+    switch (precision) {
+    case DepthCpu::DepthPrecision::Unorm16: return DepthCpu::Kernels::LoadDepth(static_cast<const uint16_t*>(plane)[i]);
+    case DepthCpu::DepthPrecision::Unorm8: return DepthCpu::Kernels::LoadDepth(static_cast<const uint8_t*>(plane)[i]);
+    default: return static_cast<const float*>(plane)[i];
+    }
+}
+
+// Copies `in` with deterministic noise of up to +-2 levels per channel (grain on a still image).
+static void AddGrain(const std::vector<uint8_t>& in, std::vector<uint8_t>& out, uint32_t frame) {
+    uint32_t state = 0x9E3779B9u * (frame + 1);
+    for (size_t i = 0; i < in.size(); ++i) {
+        state = state * 1664525u + 1013904223u;
+        const int v = (int)in[i] + (int)((state >> 24) % 5) - 2;
+        out[i] = (uint8_t)std::min(255, std::max(0, v));
+    }
+}
+
+struct StabilityStats {
+    double histMean = 0.0;  // |history - f32 history| after the still phase
+    double histMax = 0.0;
+    double flicker = 0.0;   // mean |history(t) - history(t-1)| over the still phase's last quarter
+    double outMean = 0.0;   // |output - f32 output| over the moving phase, in 8-bit levels
+    double outMax = 0.0;
+    double outDiffer = 0.0; // fraction of output bytes that differ from f32
+};
+
+// Runs one engine per precision in lockstep: `frames` grainy copies of a still frame, then `frames`
+// moving frames. Depth errors are in 8-bit steps (x255) so the three precisions share a scale.
+static bool MeasureStability(ThreadPool& pool, DepthCpu::PipelineMode mode, const std::vector<std::vector<uint8_t>>& sources,
+                             uint32_t srcW, uint32_t srcH, const DepthCpu::Params& params, int frames, StabilityStats stats[3]) {
+    const uint32_t outW = params.outWidth;
+    const uint32_t outH = params.outHeight;
+    DepthCpu::Engine engines[3];
+    std::vector<uint8_t> outs[3];
+    std::vector<float> lastHist[3];
+    for (int p = 0; p < 3; ++p) {
+        engines[p].SetThreadPool(&pool);
+        engines[p].SetPipelineMode(mode);
+        engines[p].SetDepthPrecision((DepthCpu::DepthPrecision)p);
+        outs[p].resize((size_t)outW * outH * 4);
+        stats[p] = StabilityStats();
+    }
+
+    std::vector<uint8_t> grain(sources[0].size());
+    const int flickerFrom = frames - std::max(1, frames / 4);
+    for (int f = 0; f < 2 * frames; ++f) {
+        const bool still = f < frames;
+        if (still) AddGrain(sources[0], grain, (uint32_t)f);
+        DepthCpu::ImageView src;
+        src.data = still ? grain.data() : sources[f % sources.size()].data();
+        src.width = srcW;
+        src.height = srcH;
+        src.stride = (size_t)srcW * 4;
+
+        for (int p = 0; p < 3; ++p) {
+            DepthCpu::ImageRef out;
+            out.data = outs[p].data();
+            out.width = outW;
+            out.height = outH;
+            out.stride = (size_t)outW * 4;
+            if (!engines[p].Render(src, params, out)) return false;
+        }
+
+        const size_t n = (size_t)engines[0].GetDepthWidth() * engines[0].GetHeight();
+        if (still) {
+            for (int p = 0; p < 3; ++p) {
+                const DepthCpu::DepthPrecision precision = (DepthCpu::DepthPrecision)p;
+                const void* hist = engines[p].GetDepthHistory();
+                const void* ref = engines[0].GetDepthHistory();
+                const bool last = (f == frames - 1);
+                double flicker = 0.0;
+                lastHist[p].resize(n);
+                for (size_t i = 0; i < n; ++i) {
+                    const float h = DepthAt(hist, precision, i);
+                    if (f > flickerFrom) flicker += std::fabs(h - lastHist[p][i]);
+                    lastHist[p][i] = h;
+                    if (last) {
+                        const double e = std::fabs(h - DepthAt(ref, DepthCpu::DepthPrecision::Float32, i)) * 255.0;
+                        stats[p].histMean += e;
+                        stats[p].histMax = std::max(stats[p].histMax, e);
+                    }
+                }
+                if (f > flickerFrom) stats[p].flicker += flicker * 255.0 / (double)n / (double)(frames - 1 - flickerFrom);
+                if (last) stats[p].histMean /= (double)n;
+            }
+        } else {
+            const size_t bytes = outs[0].size();
+            for (int p = 1; p < 3; ++p) {
+                size_t sum = 0, differ = 0;
+                int maxDiff = 0;
+                for (size_t i = 0; i < bytes; ++i) {
+                    const int d = std::abs((int)outs[p][i] - (int)outs[0][i]);
+                    sum += (size_t)d;
+                    differ += (d != 0);
+                    maxDiff = std::max(maxDiff, d);
+                }
+                stats[p].outMean += (double)sum / (double)bytes / (double)frames;
+                stats[p].outDiffer += (double)differ / (double)bytes / (double)frames;
+                stats[p].outMax = std::max(stats[p].outMax, (double)maxDiff);
+            }
+        }
+    }
+    return true;
+}
+
+// Static desktop with one "video" window: frame 0 everywhere except `window`, which shows `moving`.
+static void ComposeWindowFrame(const std::vector<uint8_t>& desktop, const std::vector<uint8_t>& moving, uint32_t w,
+                               const DepthCpu::DirtyRect& window, std::vector<uint8_t>& out) {
+    out = desktop;
+    for (int32_t y = window.top; y < window.bottom; ++y) {
+        const size_t at = ((size_t)y * w + (size_t)window.left) * 4;
+        std::copy_n(moving.begin() + at, (size_t)(window.right - window.left) * 4, out.begin() + at);
+    }
+}
+
+struct IncrementalResult {
+    double ms = 0.0;
+    double tilesPct = 0.0; // mean share of tiles whose pass 2 re-ran
+    double outMean = 0.0;  // |output - full render| on the last frame, 8-bit levels
+    int outMax = 0;
+};
+
+// 0 = full render, 1 = incremental with source hashing, 2 = incremental with the window as the dirty rect.
+static bool MeasureIncremental(ThreadPool& pool, int kind, const std::vector<std::vector<uint8_t>>& frames, uint32_t srcW, uint32_t srcH,
+                               const DepthCpu::DirtyRect& window, const DepthCpu::Params& params, int settle, int timed,
+                               std::vector<uint8_t>& out, IncrementalResult* result) {
+    DepthCpu::Engine engine;
+    engine.SetThreadPool(&pool);
+    engine.SetIncremental(kind == 1);
+    DepthCpu::ImageRef dst;
+    dst.data = out.data();
+    dst.width = params.outWidth;
+    dst.height = params.outHeight;
+    dst.stride = (size_t)params.outWidth * 4;
+
+    auto renderFrame = [&](int f) {
+        DepthCpu::ImageView src;
+        src.data = frames[f % frames.size()].data();
+        src.width = srcW;
+        src.height = srcH;
+        src.stride = (size_t)srcW * 4;
+        return kind == 2 ? engine.RenderDirty(src, params, dst, &window, 1) : engine.Render(src, params, dst);
+    };
+
+    for (int f = 0; f < settle; ++f) {
+        if (!renderFrame(f)) return false;
+    }
+    double tiles = 0.0;
+    const Clock::time_point t0 = Clock::now();
+    for (int f = settle; f < settle + timed; ++f) {
+        if (!renderFrame(f)) return false;
+        const DepthCpu::Engine::IncrementalStats& st = engine.GetIncrementalStats();
+        tiles += (kind == 0 || st.tiles == 0) ? 1.0 : (double)st.smoothTiles / (double)st.tiles;
+    }
+    result->ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count() / timed;
+    result->tilesPct = tiles * 100.0 / timed;
+    return true;
+}
+
+// Document-like page: lines of pseudo-random dark "text" on a light background, 24-row line pitch.
+static void FillDocument(std::vector<uint8_t>& bgra, uint32_t w, uint32_t h) {
+    bgra.assign((size_t)w * h * 4, 235);
+    uint32_t state = 12345u;
+    for (uint32_t y = 0; y < h; ++y) {
+        if ((y % 24) >= 14) continue;
+        uint8_t* row = bgra.data() + (size_t)y * w * 4;
+        for (uint32_t x = 0; x < w; x += 3) {
+            state = state * 1664525u + 1013904223u;
+            if ((state >> 28) >= 6) continue;
+            const uint8_t v = (uint8_t)(30 + ((state >> 20) & 63));
+            for (uint32_t i = x; i < std::min(w, x + 3); ++i) {
+                row[i * 4 + 0] = row[i * 4 + 1] = row[i * 4 + 2] = v;
+            }
+        }
+    }
+}
+
+// Browser-like frame: `header` static rows from `chrome`, then the document scrolled down by `offset` rows.
+static void ComposeScrollFrame(const std::vector<uint8_t>& chrome, const std::vector<uint8_t>& doc, uint32_t w, uint32_t h,
+                               uint32_t header, uint32_t offset, std::vector<uint8_t>& out) {
+    const size_t rowBytes = (size_t)w * 4;
+    out.resize(rowBytes * h);
+    std::copy_n(chrome.begin(), rowBytes * header, out.begin());
+    std::copy_n(doc.begin() + rowBytes * offset, rowBytes * (h - header), out.begin() + rowBytes * header);
+}
+
+struct ScrollResult {
+    double ms = 0.0;         // engine time per scrolling frame (ApplyMoveRects + Render)
+    double stopError = 0.0;  // mean |history when the scroll stops - history once settled again|, 8-bit steps
+    double postMotion = 0.0; // sum over the frames after the scroll of the mean per-frame history change
+    int settleFrames = 0;    // frames after the scroll until the mean history change drops below 0.01 steps
+};
+
+// 0 = history as is, 1 = the exact move rect per frame (what GetFrameMoveRects reports), 2 = scroll tracking.
+static bool MeasureScroll(int kind, const std::vector<uint8_t>& chrome, const std::vector<uint8_t>& doc, uint32_t w, uint32_t h,
+                          uint32_t header, uint32_t step, int settle, int scrollFrames, const DepthCpu::Params& params,
+                          std::vector<uint8_t>& out, ScrollResult* result) {
+    DepthCpu::Engine engine;
+    engine.SetScrollTracking(kind == 2);
+    DepthCpu::ImageRef dst;
+    dst.data = out.data();
+    dst.width = params.outWidth;
+    dst.height = params.outHeight;
+    dst.stride = (size_t)params.outWidth * 4;
+
+    std::vector<uint8_t> frame;
+    double engineMs = 0.0;
+    auto renderAt = [&](uint32_t offset, const DepthCpu::MoveRect* move) {
+        ComposeScrollFrame(chrome, doc, w, h, header, offset, frame);
+        DepthCpu::ImageView src;
+        src.data = frame.data();
+        src.width = w;
+        src.height = h;
+        src.stride = (size_t)w * 4;
+        const Clock::time_point t0 = Clock::now();
+        if (move) engine.ApplyMoveRects(w, h, params, move, 1);
+        const bool ok = engine.Render(src, params, dst);
+        engineMs += std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        return ok;
+    };
+    auto history = [&]() {
+        const float* hist = static_cast<const float*>(engine.GetDepthHistory());
+        return std::vector<float>(hist, hist + (size_t)engine.GetDepthWidth() * engine.GetHeight());
+    };
+    auto meanDiff = [](const std::vector<float>& a, const std::vector<float>& b) {
+        double sum = 0.0;
+        for (size_t i = 0; i < a.size(); ++i) sum += std::fabs(a[i] - b[i]);
+        return sum * 255.0 / (double)a.size();
+    };
+
+    for (int f = 0; f < settle; ++f) {
+        if (!renderAt(0, nullptr)) return false;
+    }
+    DepthCpu::MoveRect m;
+    m.dest.left = 0;
+    m.dest.top = (int32_t)header;
+    m.dest.right = (int32_t)w;
+    m.dest.bottom = (int32_t)(h - step);
+    m.sourceX = 0;
+    m.sourceY = (int32_t)(header + step);
+    engineMs = 0.0;
+    for (int f = 1; f <= scrollFrames; ++f) {
+        if (!renderAt((uint32_t)f * step, kind == 1 ? &m : nullptr)) return false;
+    }
+    result->ms = engineMs / scrollFrames;
+
+    const std::vector<float> atStop = history();
+    std::vector<float> last = atStop;
+    result->settleFrames = settle;
+    for (int f = 1; f <= settle; ++f) {
+        if (!renderAt((uint32_t)scrollFrames * step, nullptr)) return false;
+        std::vector<float> cur = history();
+        const double change = meanDiff(cur, last);
+        result->postMotion += change;
+        if (result->settleFrames == settle && change < 0.01) result->settleFrames = f;
+        last.swap(cur);
+    }
+    result->stopError = meanDiff(atStop, last);
+    return true;
+}
+
+// The synthetic frames scaled into a centred picture of `pictureH` rows, with video-black (16) bars.
+static void ComposeLetterboxFrame(const std::vector<uint8_t>& frame, uint32_t w, uint32_t h, uint32_t pictureH, std::vector<uint8_t>& out) {
+    out.assign((size_t)w * h * 4, 16);
+    const uint32_t top = (h - pictureH) / 2;
+    for (uint32_t y = 0; y < pictureH; ++y) {
+        const uint32_t sy = (uint32_t)(((uint64_t)y * h) / pictureH);
+        std::copy_n(frame.data() + (size_t)sy * w * 4, (size_t)w * 4, out.data() + (size_t)(top + y) * w * 4);
+    }
+    for (size_t i = 3; i < out.size(); i += 4) out[i] = 255;
+}
+
+struct LetterboxResult {
+    double ms = 0.0;
+    double rowsPct = 0.0; // output rows the passes ran on
+};
+
+static bool MeasureLetterbox(ThreadPool& pool, bool detect, const std::vector<std::vector<uint8_t>>& frames, uint32_t srcW, uint32_t srcH,
+                             const DepthCpu::Params& params, int warmup, int timed, std::vector<uint8_t>& out, LetterboxResult* result) {
+    DepthCpu::Engine engine;
+    engine.SetThreadPool(&pool);
+    engine.SetLetterboxDetection(detect);
+    DepthCpu::ImageRef dst;
+    dst.data = out.data();
+    dst.width = params.outWidth;
+    dst.height = params.outHeight;
+    dst.stride = (size_t)params.outWidth * 4;
+    auto renderFrame = [&](int f) {
+        DepthCpu::ImageView src;
+        src.data = frames[(size_t)f % frames.size()].data();
+        src.width = srcW;
+        src.height = srcH;
+        src.stride = (size_t)srcW * 4;
+        return engine.Render(src, params, dst);
+    };
+
+    // Detection needs kLetterboxConfirmFrames before it narrows; only the steady state is timed, from
+    // fresh history on both sides so the outputs compare like for like.
+    for (int f = 0; f < warmup + DepthCpu::Engine::kLetterboxConfirmFrames; ++f) {
+        if (!renderFrame(f)) return false;
+    }
+    engine.ResetHistory();
+    const Clock::time_point t0 = Clock::now();
+    for (int f = 0; f < timed; ++f) {
+        if (!renderFrame(f)) return false;
+    }
+    result->ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count() / timed;
+    result->rowsPct = 100.0 * engine.GetHeight() / params.outHeight;
+    return true;
+}
+
+// Fresh engine, warmup + timed frames; only the timed ones count.
+static bool MeasureFoveation(ThreadPool& pool, const DepthCpu::Foveation& fovea, const std::vector<std::vector<uint8_t>>& frames, uint32_t srcW,
+                             uint32_t srcH, const DepthCpu::Params& params, int warmup, int timed, std::vector<uint8_t>& out, double* ms) {
+    DepthCpu::Engine engine;
+    engine.SetThreadPool(&pool);
+    engine.SetPerViewDepth(true);
+    engine.SetFoveation(fovea);
+    DepthCpu::ImageRef dst;
+    dst.data = out.data();
+    dst.width = params.outWidth;
+    dst.height = params.outHeight;
+    dst.stride = (size_t)params.outWidth * 4;
+    auto renderFrame = [&](int f) {
+        DepthCpu::ImageView src;
+        src.data = frames[(size_t)f % frames.size()].data();
+        src.width = srcW;
+        src.height = srcH;
+        src.stride = (size_t)srcW * 4;
+        return engine.Render(src, params, dst);
+    };
+
+    for (int f = 0; f < warmup; ++f) {
+        if (!renderFrame(f)) return false;
+    }
+    const Clock::time_point t0 = Clock::now();
+    for (int f = 0; f < timed; ++f) {
+        if (!renderFrame(warmup + f)) return false;
+    }
+    *ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count() / timed;
+    return true;
+}
+
+struct LayoutResult {
+    double renderMs = 0.0;   // Render() in the layout: depth passes + resample
+    double resampleMs = 0.0; // RenderLayout() alone on the same depth
+};
+
+// Render() in `layout`, then the cost of one more output from the same depth (RenderLayout).
+static bool MeasureLayout(ThreadPool& pool, DepthCpu::StereoLayout layout, const std::vector<std::vector<uint8_t>>& frames, uint32_t srcW,
+                          uint32_t srcH, const DepthCpu::Params& params, int warmup, int timed, LayoutResult* result) {
+    DepthCpu::Engine engine;
+    engine.SetThreadPool(&pool);
+    engine.SetLayout(layout);
+    uint32_t outW = 0;
+    uint32_t outH = 0;
+    DepthCpu::GetLayoutSize(params, layout, &outW, &outH);
+    std::vector<uint8_t> out((size_t)outW * outH * 4);
+    const DepthCpu::ImageRef dst{ out.data(), outW, outH, (size_t)outW * 4 };
+    auto source = [&](int f) {
+        return DepthCpu::ImageView{ frames[(size_t)f % frames.size()].data(), srcW, srcH, (size_t)srcW * 4 };
+    };
+
+    for (int f = 0; f < warmup; ++f) {
+        if (!engine.Render(source(f), params, dst)) return false;
+    }
+    double renderMs = 0.0;
+    double resampleMs = 0.0;
+    for (int f = 0; f < timed; ++f) {
+        const DepthCpu::ImageView src = source(warmup + f);
+        const Clock::time_point t0 = Clock::now();
+        if (!engine.Render(src, params, dst)) return false;
+        const Clock::time_point t1 = Clock::now();
+        if (!engine.RenderLayout(src, params, layout, dst)) return false;
+        renderMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+        resampleMs += std::chrono::duration<double, std::milli>(Clock::now() - t1).count();
+    }
+    result->renderMs = renderMs / timed;
+    result->resampleMs = resampleMs / timed;
+    return true;
+}
+
+struct StreamsResult {
+    double framesPerSec = 0.0; // stream frames per second over all streams
+    double megapixelsPerSec = 0.0;
+    std::vector<double> avgLatencyMs; // per stream: tick start to its frame's completion
+    std::vector<double> maxLatencyMs;
+    std::vector<bool> packed;
+};
+
+// One frame of every stream per tick, each stream with its own engine (history) and crop: either
+// through BatchEngine or one Engine::Render() after another, each tiled on the pool.
+static bool MeasureStreams(ThreadPool& pool, bool batched, const std::vector<DepthCpu::Params>& streams,
+                           const std::vector<std::vector<uint8_t>>& frames, uint32_t srcW, uint32_t srcH, int warmup, int timed,
+                           StreamsResult* result) {
+    const size_t n = streams.size();
+    std::vector<std::vector<uint8_t>> outs(n);
+    std::vector<DepthCpu::BatchEngine::Frame> batch(n);
+    DepthCpu::BatchEngine engine(&pool);
+    std::vector<std::unique_ptr<DepthCpu::Engine>> engines(n);
+    for (size_t i = 0; i < n; ++i) {
+        const DepthCpu::Params& p = streams[i];
+        outs[i].resize((size_t)p.outWidth * p.outHeight * 4);
+        batch[i].stream = engine.AddStream();
+        batch[i].params = p;
+        batch[i].out = DepthCpu::ImageRef{ outs[i].data(), p.outWidth, p.outHeight, (size_t)p.outWidth * 4 };
+        engines[i] = std::make_unique<DepthCpu::Engine>();
+        engines[i]->SetThreadPool(&pool);
+    }
+
+    std::vector<double> sumMs(n, 0.0);
+    std::vector<double> maxMs(n, 0.0);
+    double totalMs = 0.0;
+    uint64_t pixels = 0;
+    for (int f = 0; f < warmup + timed; ++f) {
+        const DepthCpu::ImageView src{ frames[(size_t)f % frames.size()].data(), srcW, srcH, (size_t)srcW * 4 };
+        for (DepthCpu::BatchEngine::Frame& b : batch) b.src = src;
+
+        const Clock::time_point t0 = Clock::now();
+        if (batched) {
+            if (!engine.RenderBatch(batch.data(), n)) return false;
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                if (!engines[i]->Render(src, batch[i].params, batch[i].out)) return false;
+                batch[i].latencyMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+            }
+        }
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        if (f < warmup) continue;
+
+        totalMs += ms;
+        for (size_t i = 0; i < n; ++i) {
+            sumMs[i] += batch[i].latencyMs;
+            maxMs[i] = std::max(maxMs[i], batch[i].latencyMs);
+            pixels += (uint64_t)batch[i].out.width * batch[i].out.height;
+        }
+    }
+
+    result->framesPerSec = (double)n * timed / (totalMs / 1000.0);
+    result->megapixelsPerSec = (double)pixels / (totalMs / 1000.0) / 1e6;
+    result->avgLatencyMs.resize(n);
+    result->maxLatencyMs = maxMs;
+    result->packed.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        result->avgLatencyMs[i] = sumMs[i] / timed;
+        result->packed[i] = batched && engine.GetStreamStats(batch[i].stream)->packed;
+    }
+    return true;
+}
+
+// Smooth value noise in [0, 1]: hashed lattice values every `cell` pixels, bilinearly interpolated.
+static float ValueNoise(int32_t x, int32_t y, int32_t cell, uint32_t seed) {
+    auto lattice = [seed](int32_t i, int32_t j) {
+        uint32_t v = (uint32_t)i * 0x8DA6B343u ^ (uint32_t)j * 0xD8163841u ^ seed * 0xCB1AB31Fu;
+        v ^= v >> 13;
+        v *= 0x5BD1E995u;
+        v ^= v >> 15;
+        return (float)(v & 0xFFFF) / 65535.0f;
+    };
+    const int32_t cx = (x >= 0 ? x : x - cell + 1) / cell;
+    const int32_t cy = (y >= 0 ? y : y - cell + 1) / cell;
+    const float fx = (float)(x - cx * cell) / (float)cell;
+    const float fy = (float)(y - cy * cell) / (float)cell;
+    const float top = lattice(cx, cy) + fx * (lattice(cx + 1, cy) - lattice(cx, cy));
+    const float bottom = lattice(cx, cy + 1) + fx * (lattice(cx + 1, cy + 1) - lattice(cx, cy + 1));
+    return top + fy * (bottom - top);
+}
+
+// Panning scene at output frame `i`: a textured background moving left 6 px per frame and a textured
+// box (a quarter of each dimension) moving right 8 and down 2 px per frame, wrapping around.
+static void FillPanFrame(std::vector<uint8_t>& bgra, uint32_t w, uint32_t h, uint32_t i) {
+    bgra.resize((size_t)w * h * 4);
+    const uint32_t boxW = w / 4;
+    const uint32_t boxH = h / 4;
+    const uint32_t boxX = (w / 8 + i * 8) % (w - boxW);
+    const uint32_t boxY = (h / 4 + i * 2) % (h - boxH);
+    for (uint32_t y = 0; y < h; ++y) {
+        uint8_t* row = bgra.data() + (size_t)y * w * 4;
+        for (uint32_t x = 0; x < w; ++x) {
+            const bool inBox = x >= boxX && x < boxX + boxW && y >= boxY && y < boxY + boxH;
+            float v;
+            if (inBox) {
+                const int32_t bx = (int32_t)(x - boxX);
+                const int32_t by = (int32_t)(y - boxY);
+                v = 0.55f + 0.45f * (0.6f * ValueNoise(bx, by, 12, 7) + 0.4f * ValueNoise(bx, by, 5, 8));
+            } else {
+                const int32_t bx = (int32_t)x + (int32_t)i * 6;
+                v = 0.45f * (0.7f * ValueNoise(bx, (int32_t)y, 24, 1) + 0.3f * ValueNoise(bx, (int32_t)y, 7, 2));
+            }
+            const uint8_t g = (uint8_t)(v * 255.0f + 0.5f);
+            row[x * 4 + 0] = inBox ? (uint8_t)(g / 2) : g;
+            row[x * 4 + 1] = g;
+            row[x * 4 + 2] = inBox ? g : (uint8_t)(g * 3 / 4);
+            row[x * 4 + 3] = 255;
+        }
+    }
+}
+
+struct InterpolationResult {
+    double motionMs = 0.0; // first RenderInterpolated of a pair (includes the motion search)
+    double frameMs = 0.0;  // the pair's other RenderInterpolated calls
+    double interpMean = 0.0; // |output - ground truth| over the skipped frames, 8-bit levels
+    double repeatMean = 0.0;
+    double interpPsnr = 0.0;
+    double repeatPsnr = 0.0;
+};
+
+// One engine renders every output frame of the panning scene (the ground truth); another renders only
+// every `step`-th one and synthesizes the frames in between. Frames after the first `warmPairs` pairs
+// (depth history converging) are compared with the ground truth, as is repeating the older picture.
+static bool MeasureInterpolation(ThreadPool& pool, uint32_t srcW, uint32_t srcH, const DepthCpu::Params& params, int pairs, int step,
+                                 InterpolationResult* result) {
+    const int warmPairs = 4;
+    DepthCpu::Engine truth;
+    DepthCpu::Engine engine;
+    truth.SetThreadPool(&pool);
+    engine.SetThreadPool(&pool);
+    engine.SetFrameInterpolation(true);
+
+    const size_t outBytes = (size_t)params.outWidth * params.outHeight * 4;
+    std::vector<uint8_t> truthOut(outBytes), pictureOut(outBytes), interpOut(outBytes);
+    std::vector<uint8_t> frames[2];
+    std::vector<uint8_t> mid;
+    auto view = [&](const std::vector<uint8_t>& bgra) {
+        DepthCpu::ImageView v;
+        v.data = bgra.data();
+        v.width = srcW;
+        v.height = srcH;
+        v.stride = (size_t)srcW * 4;
+        return v;
+    };
+    auto ref = [&](std::vector<uint8_t>& bgra) {
+        DepthCpu::ImageRef r;
+        r.data = bgra.data();
+        r.width = params.outWidth;
+        r.height = params.outHeight;
+        r.stride = (size_t)params.outWidth * 4;
+        return r;
+    };
+
+    FillPanFrame(frames[0], srcW, srcH, 0);
+    if (!engine.Render(view(frames[0]), params, ref(pictureOut)) || !truth.Render(view(frames[0]), params, ref(truthOut))) return false;
+
+    double interpSum = 0.0, repeatSum = 0.0, interpSq = 0.0, repeatSq = 0.0, motionMs = 0.0, frameMs = 0.0;
+    size_t compared = 0;
+    std::vector<uint8_t> repeatOut = pictureOut;
+    for (int k = 1; k <= warmPairs + pairs; ++k) {
+        std::vector<uint8_t>& a = frames[(k - 1) & 1];
+        std::vector<uint8_t>& b = frames[k & 1];
+        FillPanFrame(b, srcW, srcH, (uint32_t)(k * step));
+        repeatOut = pictureOut;
+        if (!engine.Render(view(b), params, ref(pictureOut))) return false;
+
+        for (int j = 1; j < step; ++j) {
+            FillPanFrame(mid, srcW, srcH, (uint32_t)((k - 1) * step + j));
+            if (!truth.Render(view(mid), params, ref(truthOut))) return false;
+
+            const Clock::time_point t0 = Clock::now();
+            if (!engine.RenderInterpolated(view(a), view(b), (float)j / (float)step, params, ref(interpOut))) return false;
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+            if (k <= warmPairs) continue;
+            (j == 1 ? motionMs : frameMs) += ms;
+
+            for (size_t i = 0; i < outBytes; ++i) {
+                if ((i & 3) == 3) continue;
+                const double di = std::abs((int)interpOut[i] - (int)truthOut[i]);
+                const double dr = std::abs((int)repeatOut[i] - (int)truthOut[i]);
+                interpSum += di;
+                repeatSum += dr;
+                interpSq += di * di;
+                repeatSq += dr * dr;
+            }
+            compared += outBytes / 4 * 3;
+        }
+        if (!truth.Render(view(b), params, ref(truthOut))) return false;
+    }
+    if (compared == 0) return false;
+
+    auto psnr = [](double sq, size_t n) { return (sq > 0.0) ? 10.0 * std::log10(255.0 * 255.0 / (sq / (double)n)) : 99.0; };
+    result->motionMs = motionMs / pairs;
+    result->frameMs = (step > 2) ? frameMs / ((double)pairs * (step - 2)) : 0.0;
+    result->interpMean = interpSum / (double)compared;
+    result->repeatMean = repeatSum / (double)compared;
+    result->interpPsnr = psnr(interpSq, compared);
+    result->repeatPsnr = psnr(repeatSq, compared);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t srcW = 1920, srcH = 1080;
+    uint32_t outW = 0, outH = 0;
+    int frames = 60;
+    int warmup = 5;
+    unsigned threads = 0;
+    int depthLevel = 10;
+    int strength = 20;
+    int stabilityFrames = 120;
+    int settleFrames = 150;
+    int scrollFrames = 8;
+    int letterboxFrames = 30;
+    int foveationFrames = 30;
+    int interpolationFrames = 16;
+    int interpolationStep = 4;
+    int layoutFrames = 30;
+    int streamFrames = 30;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto next = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "ArinDepthBench: %s needs a value\n", name);
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+
+        if (a == "-h" || a == "--help") {
+            PrintUsage();
+            return 0;
+        } else if (a == "--size") {
+            if (!ParseSize(next("--size"), &srcW, &srcH)) {
+                std::fprintf(stderr, "ArinDepthBench: --size expects WxH\n");
+                return 2;
+            }
+        } else if (a == "--out-size") {
+            if (!ParseSize(next("--out-size"), &outW, &outH)) {
+                std::fprintf(stderr, "ArinDepthBench: --out-size expects WxH\n");
+                return 2;
+            }
+        } else if (a == "--frames") {
+            frames = std::max(1, std::atoi(next("--frames")));
+        } else if (a == "--warmup") {
+            warmup = std::max(0, std::atoi(next("--warmup")));
+        } else if (a == "--threads") {
+            threads = (unsigned)std::atoi(next("--threads"));
+        } else if (a == "--simd") {
+            DepthCpu::SimdLevel level;
+            const char* name = next("--simd");
+            if (!ParseSimdLevel(name, &level) || !DepthCpu::SetSimdLevel(level)) {
+                std::fprintf(stderr, "ArinDepthBench: SIMD level '%s' is not available on this CPU/build\n", name);
+                return 2;
+            }
+        } else if (a == "--depth") {
+            depthLevel = std::atoi(next("--depth"));
+        } else if (a == "--strength") {
+            strength = std::atoi(next("--strength"));
+        } else if (a == "--stability-frames") {
+            stabilityFrames = std::max(0, std::atoi(next("--stability-frames")));
+        } else if (a == "--settle-frames") {
+            settleFrames = std::max(0, std::atoi(next("--settle-frames")));
+        } else if (a == "--scroll-frames") {
+            scrollFrames = std::max(0, std::atoi(next("--scroll-frames")));
+        } else if (a == "--letterbox-frames") {
+            letterboxFrames = std::max(0, std::atoi(next("--letterbox-frames")));
+        } else if (a == "--foveation-frames") {
+            foveationFrames = std::max(0, std::atoi(next("--foveation-frames")));
+        } else if (a == "--interpolation-frames") {
+            interpolationFrames = std::max(0, std::atoi(next("--interpolation-frames")));
+        } else if (a == "--interpolation-step") {
+            interpolationStep = std::max(2, std::atoi(next("--interpolation-step")));
+        } else if (a == "--layout-frames") {
+            layoutFrames = std::max(0, std::atoi(next("--layout-frames")));
+        } else if (a == "--stream-frames") {
+            streamFrames = std::max(0, std::atoi(next("--stream-frames")));
+        } else {
+            std::fprintf(stderr, "ArinDepthBench: unknown option %s\n", a.c_str());
+            PrintUsage();
+            return 2;
+        }
+    }
+    if (outW == 0) {
+        outW = srcW;
+        outH = srcH;
+    }
+
+    // Pre-render the frames so only the engine is timed.
+    const int frameCount = 8;
+    std::vector<std::vector<uint8_t>> sources(frameCount, std::vector<uint8_t>((size_t)srcW * srcH * 4));
+    for (int f = 0; f < frameCount; ++f) FillSyntheticFrame(sources[f], srcW, srcH, (uint32_t)f);
+    std::vector<uint8_t> outBuf((size_t)outW * outH * 4);
+
+    DepthCpu::Params params;
+    params.outWidth = outW;
+    params.outHeight = outH;
+    params.parallaxPx = DepthCpu::ParallaxPxFromSettings(depthLevel, strength);
+
+    ThreadPool pool(threads);
+    std::printf("ArinDepthBench: src=%ux%u out=%ux%u simd=%s threads=%u frames=%d\n",
+        srcW, srcH, outW, outH, DepthCpu::SimdLevelName(DepthCpu::GetSimdLevel()), pool.GetThreadCount(), frames);
+    double curveErr, shapedErr;
+    ToneCurveError(&curveErr, &shapedErr);
+    std::printf("tone LUT: %u entries, max error curve_blend=%.2g shaped=%.2g (bound 1/1024 = %.2g)\n",
+        DepthCpu::Kernels::kToneCurveLutSize, curveErr, shapedErr, kToneLutMaxError);
+    if (!(curveErr <= kToneLutMaxError) || !(shapedErr <= kToneLutMaxError)) {
+        std::fprintf(stderr, "ArinDepthBench: tone LUT error exceeds 1/1024\n");
+        return 1;
+    }
+    std::printf("%-18s %10s %9s %9s %12s\n", "config", "ms/frame", "fps", "speedup", "depth MiB");
+
+    const DepthCpu::PipelineMode threePass = DepthCpu::PipelineMode::ThreePass;
+    const DepthCpu::PipelineMode fused = DepthCpu::PipelineMode::Fused;
+    const Config configs[] = {
+        { "3pass", threePass, false, DepthCpu::DepthPrecision::Float32 },
+        { "3pass+per-view", threePass, true, DepthCpu::DepthPrecision::Float32 },
+        { "3pass u16", threePass, false, DepthCpu::DepthPrecision::Unorm16 },
+        { "3pass u8", threePass, false, DepthCpu::DepthPrecision::Unorm8 },
+        { "fused", fused, false, DepthCpu::DepthPrecision::Float32 },
+        { "fused+per-view", fused, true, DepthCpu::DepthPrecision::Float32 },
+        { "fused u16", fused, false, DepthCpu::DepthPrecision::Unorm16 },
+        { "fused u8", fused, false, DepthCpu::DepthPrecision::Unorm8 },
+    };
+
+    double baselineMs = 0.0;
+    DepthCpu::PipelineMode baselineMode = threePass;
+    for (const Config& c : configs) {
+        DepthCpu::Engine engine;
+        engine.SetThreadPool(&pool);
+        engine.SetPipelineMode(c.mode);
+        engine.SetPerViewDepth(c.perView);
+        engine.SetDepthPrecision(c.precision);
+
+        DepthCpu::ImageRef out;
+        out.data = outBuf.data();
+        out.width = outW;
+        out.height = outH;
+        out.stride = (size_t)outW * 4;
+
+        auto renderFrame = [&](int f) {
+            DepthCpu::ImageView src;
+            src.data = sources[f % frameCount].data();
+            src.width = srcW;
+            src.height = srcH;
+            src.stride = (size_t)srcW * 4;
+            return engine.Render(src, params, out);
+        };
+
+        for (int f = 0; f < warmup; ++f) {
+            if (!renderFrame(f)) {
+                std::fprintf(stderr, "ArinDepthBench: render failed (%s)\n", c.name);
+                return 1;
+            }
+        }
+        const Clock::time_point t0 = Clock::now();
+        for (int f = 0; f < frames; ++f) renderFrame(warmup + f);
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count() / frames;
+
+        // Baseline per pipeline is its first (f32, SBS-wide) row.
+        if (baselineMs == 0.0 || c.mode != baselineMode) {
+            baselineMs = ms;
+            baselineMode = c.mode;
+        }
+
+        // Planes that persist across frames: 2 history planes, plus raw/smooth in 3-pass.
+        const size_t planes = (c.mode == DepthCpu::PipelineMode::ThreePass) ? 4 : 2;
+        const double depthMiB = (double)planes * engine.GetDepthWidth() * engine.GetHeight() *
+            DepthCpu::DepthPrecisionBytes(c.precision) / (1024.0 * 1024.0);
+
+        std::printf("%-18s %10.3f %9.1f %8.2fx %12.2f\n", c.name, ms, 1000.0 / ms, baselineMs / ms, depthMiB);
+    }
+
+    if (stabilityFrames > 0) {
+        std::printf("\nprecision stability vs f32: %d still+grain frames, then %d moving frames\n", stabilityFrames, stabilityFrames);
+        std::printf("  hist: |history - f32| after the still phase (8-bit depth steps); flicker: mean frame-to-frame history change\n");
+        std::printf("  out:  |output - f32| over the moving phase (8-bit levels), and the share of output bytes that differ\n");
+        std::printf("%-10s %-5s %10s %10s %10s %10s %9s %9s\n", "pipeline", "prec", "hist mean", "hist max", "flicker", "out mean", "out max", "out diff");
+        const DepthCpu::PipelineMode modes[] = { threePass, fused };
+        for (DepthCpu::PipelineMode mode : modes) {
+            StabilityStats stats[3];
+            if (!MeasureStability(pool, mode, sources, srcW, srcH, params, stabilityFrames, stats)) {
+                std::fprintf(stderr, "ArinDepthBench: render failed (stability)\n");
+                return 1;
+            }
+            for (int p = 0; p < 3; ++p) {
+                const StabilityStats& st = stats[p];
+                std::printf("%-10s %-5s %10.4f %10.3f %10.4f %10.4f %9.0f %8.3f%%\n", mode == fused ? "fused" : "3pass",
+                    DepthCpu::DepthPrecisionName((DepthCpu::DepthPrecision)p), st.histMean, st.histMax, st.flicker, st.outMean, st.outMax, st.outDiffer * 100.0);
+            }
+        }
+    }
+
+    if (settleFrames > 0) {
+        // A quarter-area window of the drifting checkerboard on an otherwise static frame.
+        DepthCpu::DirtyRect window;
+        window.left = (int32_t)(srcW / 4);
+        window.top = (int32_t)(srcH / 4);
+        window.right = (int32_t)(srcW * 3 / 4);
+        window.bottom = (int32_t)(srcH * 3 / 4);
+        std::vector<std::vector<uint8_t>> windowFrames(frameCount);
+        for (int f = 0; f < frameCount; ++f) ComposeWindowFrame(sources[0], sources[f], srcW, window, windowFrames[f]);
+
+        std::printf("\nincremental: static frame with a moving %dx%d window, %d settle frames, then %d timed\n",
+            window.right - window.left, window.bottom - window.top, settleFrames, frames);
+        std::printf("%-18s %10s %9s %12s %10s %9s\n", "config", "ms/frame", "speedup", "tiles rerun", "out mean", "out max");
+        const char* kindNames[] = { "full", "incremental hash", "incremental rects" };
+        std::vector<uint8_t> reference((size_t)outW * outH * 4);
+        double fullMs = 0.0;
+        for (int kind = 0; kind < 3; ++kind) {
+            IncrementalResult r;
+            std::vector<uint8_t>& kindOut = (kind == 0) ? reference : outBuf;
+            if (!MeasureIncremental(pool, kind, windowFrames, srcW, srcH, window, params, settleFrames, frames, kindOut, &r)) {
+                std::fprintf(stderr, "ArinDepthBench: render failed (%s)\n", kindNames[kind]);
+                return 1;
+            }
+            if (kind == 0) fullMs = r.ms;
+            size_t sum = 0;
+            for (size_t i = 0; i < kindOut.size(); ++i) {
+                const int d = std::abs((int)kindOut[i] - (int)reference[i]);
+                sum += (size_t)d;
+                r.outMax = std::max(r.outMax, d);
+            }
+            r.outMean = (double)sum / (double)kindOut.size();
+            std::printf("%-18s %10.3f %8.2fx %11.1f%% %10.4f %9d\n", kindNames[kind], r.ms, fullMs / r.ms, r.tilesPct, r.outMean, r.outMax);
+        }
+    }
+
+    if (scrollFrames > 0) {
+        // One wheel flick: 12 rows per frame under a static 1/8-height header.
+        const uint32_t header = srcH / 8;
+        const uint32_t step = 12;
+        const uint32_t docH = srcH + (uint32_t)scrollFrames * step;
+        std::vector<uint8_t> doc;
+        FillDocument(doc, srcW, docH);
+        const int settle = std::max(settleFrames, 150);
+
+        std::printf("\nscroll-aware history: %u rows/frame for %d frames under a %u-row header, single thread, 3pass f32\n",
+            step, scrollFrames, header);
+        std::printf("  stop error: |history when the scroll stops - settled history|; post motion: summed mean history change until\n"
+            "  settled (both 8-bit steps); settle: frames until the mean change per frame drops below 0.01 steps\n");
+        std::printf("%-18s %10s %10s %12s %8s\n", "config", "ms/frame", "stop error", "post motion", "settle");
+        const char* scrollNames[] = { "no tracking", "move rects", "row estimator" };
+        for (int kind = 0; kind < 3; ++kind) {
+            ScrollResult r;
+            if (!MeasureScroll(kind, sources[0], doc, srcW, srcH, header, step, settle, scrollFrames, params, outBuf, &r)) {
+                std::fprintf(stderr, "ArinDepthBench: render failed (%s)\n", scrollNames[kind]);
+                return 1;
+            }
+            std::printf("%-18s %10.3f %10.4f %12.4f %8d\n", scrollNames[kind], r.ms, r.stopError, r.postMotion, r.settleFrames);
+        }
+    }
+
+    if (letterboxFrames > 0) {
+        // 2.39:1 picture centred in the source frame.
+        const uint32_t pictureH = std::min(srcH, (uint32_t)std::lround(srcW / 2.39));
+        std::vector<std::vector<uint8_t>> boxed(frameCount);
+        for (int f = 0; f < frameCount; ++f) ComposeLetterboxFrame(sources[f], srcW, srcH, pictureH, boxed[f]);
+
+        std::printf("\nletterbox detection: %ux%u picture in a %ux%u frame, %d timed frames\n", srcW, pictureH, srcW, srcH, letterboxFrames);
+        std::printf("  rows: output rows the passes ran on; out: |output - full render| of the last frame (8-bit levels)\n");
+        std::printf("%-18s %10s %9s %8s %10s %9s\n", "config", "ms/frame", "speedup", "rows", "out mean", "out max");
+        std::vector<uint8_t> reference((size_t)outW * outH * 4);
+        double fullMs = 0.0;
+        for (int detect = 0; detect < 2; ++detect) {
+            LetterboxResult r;
+            std::vector<uint8_t>& kindOut = detect ? outBuf : reference;
+            if (!MeasureLetterbox(pool, detect != 0, boxed, srcW, srcH, params, warmup, letterboxFrames, kindOut, &r)) {
+                std::fprintf(stderr, "ArinDepthBench: render failed (letterbox)\n");
+                return 1;
+            }
+            if (!detect) fullMs = r.ms;
+            size_t sum = 0;
+            int outMax = 0;
+            for (size_t i = 0; i < kindOut.size(); ++i) {
+                const int d = std::abs((int)kindOut[i] - (int)reference[i]);
+                sum += (size_t)d;
+                outMax = std::max(outMax, d);
+            }
+            std::printf("%-18s %10.3f %8.2fx %7.1f%% %10.4f %9d\n", detect ? "letterbox detect" : "full", r.ms, fullMs / r.ms, r.rowsPct,
+                (double)sum / (double)kindOut.size(), outMax);
+        }
+    }
+
+    if (foveationFrames > 0 && (outW % 2) == 0) {
+        const DepthCpu::Foveation defaults;
+        std::printf("\nfoveated depth: radius %.2f, falloff %.2f, %d timed frames, 3pass+per-view f32\n", defaults.radius, defaults.falloff, foveationFrames);
+        std::printf("  depth px: depth-plane pixels computed per view vs full resolution; out: |output - full render| of the last\n"
+            "  frame (8-bit levels), over the whole frame and inside the radius\n");
+        std::printf("%-18s %10s %9s %9s %10s %9s %11s\n", "config", "ms/frame", "speedup", "depth px", "out mean", "out max", "fovea max");
+        std::vector<uint8_t> reference((size_t)outW * outH * 4);
+        double fullMs = 0.0;
+        const uint32_t scales[] = { 0, 2, 4 };
+        for (uint32_t scale : scales) {
+            DepthCpu::Foveation fovea;
+            fovea.enabled = scale != 0;
+            fovea.peripheryScale = fovea.enabled ? scale : 2;
+            std::vector<uint8_t>& kindOut = fovea.enabled ? outBuf : reference;
+            double ms = 0.0;
+            if (!MeasureFoveation(pool, fovea, sources, srcW, srcH, params, warmup, foveationFrames, kindOut, &ms)) {
+                std::fprintf(stderr, "ArinDepthBench: render failed (foveation)\n");
+                return 1;
+            }
+            if (!fovea.enabled) fullMs = ms;
+
+            const DepthCpu::Kernels::FoveaLayout f =
+                DepthCpu::Kernels::MakeFoveaLayout(outW / 2, outH, fovea.radius, fovea.falloff, fovea.peripheryScale);
+            const double depthPct = fovea.enabled ? 100.0 * ((double)f.cw * f.ch + (double)f.pw * f.ph) / ((double)f.viewW * f.viewH) : 100.0;
+            size_t sum = 0;
+            int outMax = 0;
+            int foveaMax = 0;
+            for (uint32_t y = 0; y < outH; ++y) {
+                for (uint32_t x = 0; x < outW; ++x) {
+                    const bool inFovea = DepthCpu::Kernels::FoveaCentreWeight(f, x % f.viewW, y) >= 1.0f;
+                    for (int c = 0; c < 4; ++c) {
+                        const size_t i = ((size_t)y * outW + x) * 4 + c;
+                        const int d = std::abs((int)kindOut[i] - (int)reference[i]);
+                        sum += (size_t)d;
+                        outMax = std::max(outMax, d);
+                        if (inFovea) foveaMax = std::max(foveaMax, d);
+                    }
+                }
+            }
+            char name[32];
+            std::snprintf(name, sizeof(name), fovea.enabled ? "foveated 1/%u" : "full", scale);
+            std::printf("%-18s %10.3f %8.2fx %8.1f%% %10.4f %9d %11d\n", name, ms, fullMs / ms, depthPct,
+                (double)sum / (double)kindOut.size(), outMax, foveaMax);
+        }
+    }
+
+    if (interpolationFrames > 0) {
+        std::printf("\nframe interpolation: panning scene, 1 source frame per %d output frames, %d source frames, 3pass f32\n",
+            interpolationStep, interpolationFrames);
+        std::printf("  error: |output - render of the skipped frame| over the skipped frames (8-bit levels, and PSNR);\n"
+            "  repeat shows the older picture's output instead, like the renderer without interpolation\n");
+        InterpolationResult r;
+        if (!MeasureInterpolation(pool, srcW, srcH, params, interpolationFrames, interpolationStep, &r)) {
+            std::fprintf(stderr, "ArinDepthBench: render failed (interpolation)\n");
+            return 1;
+        }
+        std::printf("%-18s %10s %10s %10s\n", "config", "ms/frame", "err mean", "PSNR dB");
+        std::printf("%-18s %10s %10.3f %10.2f\n", "repeat", "-", r.repeatMean, r.repeatPsnr);
+        std::printf("%-18s %10.3f %10.3f %10.2f\n", "interpolated", r.frameMs, r.interpMean, r.interpPsnr);
+        std::printf("  first synthesized frame of each pair, including the motion search: %.3f ms\n", r.motionMs);
+    }
+
+    if (layoutFrames > 0) {
+        std::printf("\noutput layouts: %d timed frames, 3pass f32; depth is computed for the %ux%u half-SBS canvas in all of them\n",
+            layoutFrames, outW, outH);
+        std::printf("  resample: one more output in the layout from the same depth (RenderLayout)\n");
+        std::printf("%-18s %11s %10s %11s\n", "layout", "size", "ms/frame", "resample ms");
+        const DepthCpu::StereoLayout layouts[] = { DepthCpu::StereoLayout::HalfSbs, DepthCpu::StereoLayout::OverUnder,
+                                                   DepthCpu::StereoLayout::FullSbs, DepthCpu::StereoLayout::ImageDepth };
+        for (DepthCpu::StereoLayout layout : layouts) {
+            LayoutResult r;
+            if (!MeasureLayout(pool, layout, sources, srcW, srcH, params, warmup, layoutFrames, &r)) {
+                std::fprintf(stderr, "ArinDepthBench: render failed (layout)\n");
+                return 1;
+            }
+            uint32_t w = 0;
+            uint32_t h = 0;
+            DepthCpu::GetLayoutSize(params, layout, &w, &h);
+            char size[24];
+            std::snprintf(size, sizeof(size), "%ux%u", w, h);
+            std::printf("%-18s %11s %10.3f %11.3f\n", DepthCpu::StereoLayoutName(layout), size, r.renderMs, r.resampleMs);
+        }
+    }
+
+    if (streamFrames > 0) {
+        // A server mix: one stream at the output size, two at half and four at quarter size, each
+        // with its own crop of the source.
+        std::vector<DepthCpu::Params> streams;
+        const uint32_t divisors[] = { 1, 2, 2, 4, 4, 4, 4 };
+        for (uint32_t d : divisors) {
+            DepthCpu::Params p = params;
+            p.outWidth = std::max(2u, (outW / d) & ~1u);
+            p.outHeight = std::max(2u, (outH / d) & ~1u);
+            const float inset = 0.02f * (float)streams.size();
+            p.cropOffset[0] = inset;
+            p.cropOffset[1] = inset * 0.5f;
+            p.cropScale[0] = 1.0f - inset;
+            p.cropScale[1] = 1.0f - inset * 0.5f;
+            streams.push_back(p);
+        }
+        std::printf("\nmulti-stream batch: %zu streams of mixed sizes, %d timed ticks of one frame each, 3pass f32\n",
+            streams.size(), streamFrames);
+        std::printf("  latency: tick start to the stream's frame being done; packed = ran whole on one thread\n");
+        StreamsResult seq;
+        StreamsResult bat;
+        if (!MeasureStreams(pool, false, streams, sources, srcW, srcH, warmup, streamFrames, &seq) ||
+            !MeasureStreams(pool, true, streams, sources, srcW, srcH, warmup, streamFrames, &bat)) {
+            std::fprintf(stderr, "ArinDepthBench: render failed (streams)\n");
+            return 1;
+        }
+        std::printf("%-18s %10s %10s\n", "schedule", "frames/s", "MP/s");
+        std::printf("%-18s %10.1f %10.1f\n", "one by one", seq.framesPerSec, seq.megapixelsPerSec);
+        std::printf("%-18s %10.1f %10.1f\n", "batched", bat.framesPerSec, bat.megapixelsPerSec);
+        std::printf("%-8s %11s %19s %19s %7s\n", "stream", "size", "one by one avg/max", "batched avg/max", "packed");
+        for (size_t i = 0; i < streams.size(); ++i) {
+            char size[24];
+            std::snprintf(size, sizeof(size), "%ux%u", streams[i].outWidth, streams[i].outHeight);
+            std::printf("%-8zu %11s %9.2f/%9.2f %9.2f/%9.2f %7s\n", i + 1, size, seq.avgLatencyMs[i], seq.maxLatencyMs[i],
+                bat.avgLatencyMs[i], bat.maxLatencyMs[i], bat.packed[i] ? "yes" : "no");
+        }
+    }
+    return 0;
+}
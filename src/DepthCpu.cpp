@@ -0,0 +1,1413 @@
+#include "DepthCpu.h"
+#include "DepthCpuKernels.h"
+#include "DepthCpuSimd.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace DepthCpu {
+
+namespace {
+
+template <typename T>
+T* PlaneAs(std::vector<uint8_t>& plane) { return reinterpret_cast<T*>(plane.data()); }
+
+template <typename T>
+const T* PlaneAs(const std::vector<uint8_t>& plane) { return reinterpret_cast<const T*>(plane.data()); }
+
+// Calls fn(T()) with T the plane element for `precision`.
+template <typename Fn>
+void WithDepthType(DepthPrecision precision, Fn&& fn) {
+    switch (precision) {
+    case DepthPrecision::Unorm16: fn(uint16_t()); break;
+    case DepthPrecision::Unorm8: fn(uint8_t()); break;
+    default: fn(float()); break;
+    }
+}
+
+// Fills `n` elements with the encoding of `v`.
+void FillPlane(std::vector<uint8_t>& plane, size_t n, DepthPrecision precision, float v) {
+    plane.resize(n * DepthPrecisionBytes(precision));
+    WithDepthType(precision, [&](auto zero) {
+        using T = decltype(zero);
+        T e;
+        Kernels::StoreDepth(&e, v);
+        std::fill_n(PlaneAs<T>(plane), n, e);
+    });
+}
+
+// PASS 1 over `r` into a plane of `stride` elements per row. Float planes are written directly;
+// the unorm ones go through a float row chunk and are rounded on the way out.
+void DepthRawToPlane(DepthRawRectFn fn, const Kernels::LumaPlane& luma, const Params& p, const TileRect& r, float* plane, size_t stride) {
+    fn(luma, p, r, plane + (size_t)r.y0 * stride + r.x0, stride);
+}
+
+template <typename T>
+void DepthRawToPlane(DepthRawRectFn fn, const Kernels::LumaPlane& luma, const Params& p, const TileRect& r, T* plane, size_t stride) {
+    constexpr uint32_t kChunk = 256;
+    alignas(64) float row[kChunk];
+    for (uint32_t y = r.y0; y < r.y1; ++y) {
+        T* dst = plane + (size_t)y * stride;
+        for (uint32_t x0 = r.x0; x0 < r.x1; x0 += kChunk) {
+            const uint32_t x1 = std::min(r.x1, x0 + kChunk);
+            fn(luma, p, TileRect{ x0, y, x1, y + 1 }, row, kChunk);
+            for (uint32_t x = x0; x < x1; ++x) Kernels::StoreDepth(dst + x, row[x - x0]);
+        }
+    }
+}
+
+// Incremental mode: per-tile flags (Engine::tileFlags_).
+constexpr uint8_t kTileRaw = 1;     // re-run pass 1 this frame
+constexpr uint8_t kTileSmooth = 2;  // re-run pass 2 this frame
+constexpr uint8_t kTileOut = 4;     // re-run pass 3 this frame
+constexpr uint8_t kTileSettled = 8; // pass 2 last changed history by <= the settle threshold
+
+bool SameParams(const Params& a, const Params& b) {
+    return a.outWidth == b.outWidth && a.outHeight == b.outHeight && a.zoomLevel == b.zoomLevel && a.parallaxPx == b.parallaxPx &&
+        a.cropOffset[0] == b.cropOffset[0] && a.cropOffset[1] == b.cropOffset[1] &&
+        a.cropScale[0] == b.cropScale[0] && a.cropScale[1] == b.cropScale[1];
+}
+
+// 64-bit multiply/xor-shift hash of a BGRA8 block (`bytes` per row, a multiple of 4).
+uint64_t HashBlock(const uint8_t* data, size_t stride, uint32_t bytes, uint32_t rows) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ bytes;
+    for (uint32_t y = 0; y < rows; ++y) {
+        const uint8_t* row = data + (size_t)y * stride;
+        uint32_t i = 0;
+        for (; i + 8 <= bytes; i += 8) {
+            uint64_t v;
+            std::memcpy(&v, row + i, 8);
+            h = (h ^ v) * 0x100000001B3ull;
+            h ^= h >> 29;
+        }
+        if (i < bytes) {
+            uint32_t v;
+            std::memcpy(&v, row + i, 4);
+            h = (h ^ v) * 0x100000001B3ull;
+            h ^= h >> 29;
+        }
+    }
+    return h;
+}
+
+// Scroll tracking: samples per profiled row, largest shift searched, and the fewest changed rows
+// that have to agree on a shift before it is applied.
+constexpr uint32_t kProfileSamples = 64;
+constexpr int32_t kMaxScrollRows = 256;
+constexpr size_t kMinScrollRows = 8;
+
+} // namespace
+
+const float* Kernels::ToneCurveLut() {
+    struct Table {
+        float v[Kernels::kToneCurveLutSize * 2];
+        Table() { Kernels::BuildToneCurveLut(v); }
+    };
+    static const Table table;
+    return table.v;
+}
+
+float ParallaxPxFromSettings(int depthLevel, int parallaxStrengthPercent) {
+    depthLevel = std::min(std::max(depthLevel, 0), 20);
+    parallaxStrengthPercent = std::min(std::max(parallaxStrengthPercent, 0), 50);
+
+    const float t = (float)depthLevel / 20.0f;
+    const float maxShiftPx = 60.0f;
+    const float parallaxStrength = (float)parallaxStrengthPercent / 100.0f;
+    return t * maxShiftPx * parallaxStrength;
+}
+
+const char* DepthPrecisionName(DepthPrecision precision) {
+    switch (precision) {
+    case DepthPrecision::Float32: return "f32";
+    case DepthPrecision::Unorm16: return "u16";
+    case DepthPrecision::Unorm8: return "u8";
+    }
+    return "?";
+}
+
+size_t DepthPrecisionBytes(DepthPrecision precision) {
+    switch (precision) {
+    case DepthPrecision::Unorm16: return sizeof(uint16_t);
+    case DepthPrecision::Unorm8: return sizeof(uint8_t);
+    default: return sizeof(float);
+    }
+}
+
+const char* StereoLayoutName(StereoLayout layout) {
+    switch (layout) {
+    case StereoLayout::OverUnder: return "ou";
+    case StereoLayout::HalfSbs: return "half-sbs";
+    case StereoLayout::FullSbs: return "full-sbs";
+    case StereoLayout::ImageDepth: return "2d-depth";
+    }
+    return "?";
+}
+
+void GetLayoutSize(const Params& params, StereoLayout layout, uint32_t* width, uint32_t* height) {
+    const bool doubleWidth = (layout == StereoLayout::FullSbs || layout == StereoLayout::ImageDepth);
+    *width = doubleWidth ? params.outWidth * 2 : params.outWidth;
+    *height = params.outHeight;
+}
+
+void SetCropNormalized(Params& params, float left, float top, float right, float bottom) {
+    left = Kernels::Saturate(left);
+    top = Kernels::Saturate(top);
+    right = Kernels::Saturate(right);
+    bottom = Kernels::Saturate(bottom);
+    if (right < left) std::swap(left, right);
+    if (bottom < top) std::swap(top, bottom);
+
+    // Avoid degenerate rects (falls back to identity like Renderer::ClearSourceCrop).
+    const float minSize = 1.0f / 4096.0f;
+    if ((right - left) < minSize || (bottom - top) < minSize) {
+        left = top = 0.0f;
+        right = bottom = 1.0f;
+    }
+
+    params.cropOffset[0] = left;
+    params.cropOffset[1] = top;
+    params.cropScale[0] = right - left;
+    params.cropScale[1] = bottom - top;
+}
+
+void BuildRowProfile(const ImageView& src, const DirtyRect& region, std::vector<uint32_t>& profile) {
+    const int32_t x0 = std::max<int32_t>(region.left, 0);
+    const int32_t x1 = std::min<int32_t>(region.right, (int32_t)src.width);
+    const int32_t y0 = std::max<int32_t>(region.top, 0);
+    const int32_t y1 = std::min<int32_t>(region.bottom, (int32_t)src.height);
+    profile.assign((size_t)std::max(0, y1 - y0), 0);
+    if (!src.data || x1 <= x0) return;
+
+    const uint32_t w = (uint32_t)(x1 - x0);
+    const uint32_t samples = std::min(w, kProfileSamples);
+    uint32_t offsets[kProfileSamples];
+    for (uint32_t k = 0; k < samples; ++k) offsets[k] = ((uint32_t)x0 + ((2 * k + 1) * w) / (2 * samples)) * 4;
+
+    for (int32_t y = y0; y < y1; ++y) {
+        const uint8_t* row = src.data + (size_t)y * src.stride;
+        uint32_t sum = 0;
+        for (uint32_t k = 0; k < samples; ++k) {
+            const uint8_t* px = row + offsets[k];
+            sum += (29u * px[0] + 150u * px[1] + 77u * px[2] + 128u) >> 8;
+        }
+        profile[(size_t)(y - y0)] = sum;
+    }
+}
+
+bool EstimateScroll(const std::vector<uint32_t>& prev, const std::vector<uint32_t>& cur, int32_t maxShift, ScrollEstimate* est) {
+    const int32_t n = (int32_t)cur.size();
+    if (!est || n == 0 || prev.size() != cur.size()) return false;
+
+    std::vector<int32_t> changed;
+    for (int32_t y = 0; y < n; ++y) {
+        if (cur[(size_t)y] != prev[(size_t)y]) changed.push_back(y);
+    }
+    if (changed.size() < kMinScrollRows) return false;
+
+    auto matches = [&](int32_t y, int32_t dy) { return y - dy >= 0 && y - dy < n && cur[(size_t)y] == prev[(size_t)(y - dy)]; };
+
+    // Smallest |dy| wins ties (flat rows match any shift).
+    int32_t bestDy = 0;
+    size_t best = 0;
+    maxShift = std::min(maxShift, n - 1);
+    for (int32_t a = 1; a <= maxShift; ++a) {
+        for (int32_t dy : { a, -a }) {
+            size_t count = 0;
+            for (int32_t y : changed) count += matches(y, dy) ? 1 : 0;
+            if (count > best) {
+                best = count;
+                bestDy = dy;
+            }
+        }
+    }
+    if (best < kMinScrollRows || best * 2 < changed.size()) return false;
+
+    est->dy = bestDy;
+    est->top = n;
+    est->bottom = 0;
+    for (int32_t y : changed) {
+        if (!matches(y, bestDy)) continue;
+        est->top = std::min(est->top, y);
+        est->bottom = std::max(est->bottom, y + 1);
+    }
+    return true;
+}
+
+bool FindActiveRect(const ImageView& src, const DirtyRect& region, uint8_t threshold, DirtyRect* active, uint8_t* barBgra) {
+    const int32_t x0 = std::max<int32_t>(region.left, 0);
+    const int32_t x1 = std::min<int32_t>(region.right, (int32_t)src.width);
+    const int32_t y0 = std::max<int32_t>(region.top, 0);
+    const int32_t y1 = std::min<int32_t>(region.bottom, (int32_t)src.height);
+    if (!src.data || !active || x0 >= x1 || y0 >= y1) return false;
+
+    uint64_t barSum[3] = { 0, 0, 0 };
+    uint64_t barCount = 0;
+    // First pixel of row y in [from, to) (stepping by dir) brighter than threshold, or `to`; the dark
+    // pixels passed on the way are bar.
+    auto scan = [&](int32_t y, int32_t from, int32_t to, int32_t dir) {
+        const uint8_t* row = src.data + (size_t)y * src.stride;
+        for (int32_t x = from; x != to; x += dir) {
+            const uint8_t* px = row + (size_t)x * 4;
+            if (((29u * px[0] + 150u * px[1] + 77u * px[2] + 128u) >> 8) > threshold) return x;
+            barSum[0] += px[0];
+            barSum[1] += px[1];
+            barSum[2] += px[2];
+            ++barCount;
+        }
+        return to;
+    };
+    auto reportBar = [&]() {
+        if (!barBgra) return;
+        for (int c = 0; c < 3; ++c) barBgra[c] = barCount ? (uint8_t)((barSum[c] + barCount / 2) / barCount) : 0;
+        barBgra[3] = 255;
+    };
+
+    int32_t top = y0;
+    while (top < y1 && scan(top, x0, x1, 1) == x1) ++top;
+    if (top == y1) {
+        reportBar();
+        return false;
+    }
+    int32_t bottom = y1;
+    while (bottom > top + 1 && scan(bottom - 1, x0, x1, 1) == x1) --bottom;
+
+    // Columns: each row only scans as far in as the bounds found so far.
+    int32_t left = x1;
+    int32_t right = x0;
+    for (int32_t y = top; y < bottom; ++y) {
+        left = scan(y, x0, left, 1);
+        const int32_t stop = std::max(right, left) - 1;
+        const int32_t last = scan(y, x1 - 1, stop, -1);
+        if (last != stop) right = last + 1;
+    }
+
+    active->left = left;
+    active->top = top;
+    active->right = std::max(right, left + 1);
+    active->bottom = bottom;
+    reportBar();
+    return true;
+}
+
+bool Engine::Resize(uint32_t outW, uint32_t outH) {
+    if (outW == 0 || outH == 0) return false;
+    const uint32_t depthW = (perViewDepth_ && (outW % 2) == 0) ? outW / 2 : outW;
+    const size_t n = (size_t)depthW * (size_t)outH;
+    if (outW == width_ && outH == height_ && depthW == depthWidth_ && depthPrev_[0].size() == n * DepthPrecisionBytes(precision_)) return true;
+
+    depthRaw_.clear();
+    depthSmooth_.clear();
+    FillPlane(depthPrev_[0], n, precision_, 0.5f);
+    FillPlane(depthPrev_[1], n, precision_, 0.5f);
+    depthPrevIndex_ = 0;
+    incValid_ = false;
+
+    width_ = outW;
+    height_ = outH;
+    depthWidth_ = depthW;
+    return true;
+}
+
+void Engine::ResetHistory() {
+    // Initialize history to neutral (matches ClearUnorderedAccessViewFloat(0.5) in the renderer).
+    const size_t n = (size_t)depthWidth_ * (size_t)height_;
+    FillPlane(depthPrev_[0], n, precision_, 0.5f);
+    FillPlane(depthPrev_[1], n, precision_, 0.5f);
+    depthPrevIndex_ = 0;
+    incValid_ = false;
+}
+
+void Engine::SetScrollTracking(bool enabled) {
+    scrollTracking_ = enabled;
+    scrollSrcW_ = scrollSrcH_ = 0;
+    lastScroll_ = 0;
+}
+
+// Each move is mapped into every eye view of the depth plane: plane pixel x of a view samples source
+// column (cropOffset + (x + 0.5) / viewW * cropScale) * srcW, so a view pixel belongs to the move when
+// that centre lies in `dest`, and takes the history of the pixel the source offset maps to (rounded;
+// the planes are usually downscaled). Reads come from the untouched incoming plane, so overlapping
+// moves all refer to the previous frame like DXGI's do.
+template <typename T>
+void Engine::ShiftHistoryT(uint32_t srcW, uint32_t srcH, const Params& p, const MoveRect* moves, size_t count, std::vector<TileRect>& shifted) {
+    const uint32_t dw = depthWidth_;
+    const uint32_t h = height_;
+    const int prevIdx = depthPrevIndex_ & 1;
+    const int nextIdx = (depthPrevIndex_ ^ 1) & 1;
+    const T* prev = PlaneAs<T>(depthPrev_[prevIdx]);
+    T* next = PlaneAs<T>(depthPrev_[nextIdx]);
+    std::copy_n(prev, (size_t)dw * h, next);
+
+    struct View { uint32_t x0, w; };
+    const uint32_t leftW = width_ / 2;
+    const View views[2] = { { 0, ViewDepthWidth() != 0 ? dw : leftW }, { leftW, width_ - leftW } };
+    const int viewCount = (ViewDepthWidth() != 0) ? 1 : 2;
+
+    const double srcSpanX = (double)p.cropScale[0] * srcW;
+    const double srcSpanY = (double)p.cropScale[1] * srcH;
+    for (size_t i = 0; i < count; ++i) {
+        const MoveRect& m = moves[i];
+        const double dxSrc = (double)m.dest.left - m.sourceX;
+        const double dySrc = (double)m.dest.top - m.sourceY;
+        auto toY = [&](int32_t sy) { return ((double)sy / srcH - p.cropOffset[1]) / p.cropScale[1] * h; };
+        const int32_t y0 = std::clamp((int32_t)std::ceil(toY(m.dest.top) - 0.5), 0, (int32_t)h);
+        const int32_t y1 = std::clamp((int32_t)std::ceil(toY(m.dest.bottom) - 0.5), 0, (int32_t)h);
+        const int32_t ddy = (int32_t)std::lround(dySrc * h / srcSpanY);
+
+        for (int v = 0; v < viewCount; ++v) {
+            const View& view = views[v];
+            auto toX = [&](int32_t sx) { return ((double)sx / srcW - p.cropOffset[0]) / p.cropScale[0] * view.w; };
+            const int32_t x0 = std::clamp((int32_t)std::ceil(toX(m.dest.left) - 0.5), 0, (int32_t)view.w);
+            const int32_t x1 = std::clamp((int32_t)std::ceil(toX(m.dest.right) - 0.5), 0, (int32_t)view.w);
+            const int32_t ddx = (int32_t)std::lround(dxSrc * view.w / srcSpanX);
+            if (x0 >= x1 || y0 >= y1 || (ddx == 0 && ddy == 0)) continue;
+
+            for (int32_t y = y0; y < y1; ++y) {
+                const int32_t sy = y - ddy;
+                if (sy < 0 || sy >= (int32_t)h) continue;
+                const int32_t sx0 = std::max(x0, ddx);
+                const int32_t sx1 = std::min(x1, (int32_t)view.w + ddx);
+                if (sx0 >= sx1) continue;
+                const T* from = prev + (size_t)sy * dw + view.x0 + (sx0 - ddx);
+                std::copy_n(from, (size_t)(sx1 - sx0), next + (size_t)y * dw + view.x0 + sx0);
+            }
+            shifted.push_back(TileRect{ view.x0 + (uint32_t)x0, (uint32_t)y0, view.x0 + (uint32_t)x1, (uint32_t)y1 });
+        }
+    }
+    depthPrevIndex_ = nextIdx;
+}
+
+bool Engine::ApplyMoveRects(uint32_t srcW, uint32_t srcH, const Params& params, const MoveRect* moves, size_t count) {
+    if (srcW == 0 || srcH == 0) return false;
+    if (!Resize(params.outWidth, params.outHeight)) return false;
+    if (!moves || count == 0) return true;
+
+    std::vector<TileRect> shifted;
+    WithDepthType(precision_, [&](auto zero) { ShiftHistoryT<decltype(zero)>(srcW, srcH, params, moves, count, shifted); });
+
+    // Incremental mode: history under the moves changed, so those tiles are no longer settled.
+    const uint32_t tilesX = (depthWidth_ + tileW_ - 1) / tileW_;
+    const uint32_t tilesY = (height_ + tileH_ - 1) / tileH_;
+    if (incValid_ && tileFlags_.size() == (size_t)tilesX * tilesY) {
+        for (const TileRect& r : shifted) {
+            for (uint32_t ty = r.y0 / tileH_; ty <= (r.y1 - 1) / tileH_; ++ty) {
+                for (uint32_t tx = r.x0 / tileW_; tx <= (r.x1 - 1) / tileW_; ++tx) tileFlags_[(size_t)ty * tilesX + tx] &= (uint8_t)~kTileSettled;
+            }
+        }
+    }
+    return true;
+}
+
+void Engine::TrackScroll(const ImageView& src, const Params& params) {
+    const TileRect sr = Kernels::LumaSourceRect(src.width, src.height, params);
+    DirtyRect region;
+    region.left = (int32_t)sr.x0;
+    region.top = (int32_t)sr.y0;
+    region.right = (int32_t)sr.x1;
+    region.bottom = (int32_t)sr.y1;
+    BuildRowProfile(src, region, scrollProfile_);
+
+    const bool comparable = scrollSrcW_ == src.width && scrollSrcH_ == src.height && scrollRegion_.left == region.left &&
+        scrollRegion_.top == region.top && scrollRegion_.right == region.right && scrollRegion_.bottom == region.bottom;
+    ScrollEstimate est;
+    lastScroll_ = 0;
+    if (comparable && EstimateScroll(scrollProfilePrev_, scrollProfile_, kMaxScrollRows, &est)) {
+        MoveRect m;
+        m.dest.left = region.left;
+        m.dest.right = region.right;
+        m.dest.top = region.top + est.top;
+        m.dest.bottom = region.top + est.bottom;
+        m.sourceX = region.left;
+        m.sourceY = m.dest.top - est.dy;
+        ApplyMoveRects(src.width, src.height, params, &m, 1);
+        lastScroll_ = est.dy;
+    }
+
+    std::swap(scrollProfile_, scrollProfilePrev_);
+    scrollSrcW_ = src.width;
+    scrollSrcH_ = src.height;
+    scrollRegion_ = region;
+}
+
+void Engine::SetPipelineMode(PipelineMode mode) {
+    if (mode == mode_) return;
+    mode_ = mode;
+
+    // Fused mode never touches the intermediate planes; drop them instead of keeping stale copies.
+    if (mode_ == PipelineMode::Fused) {
+        std::vector<uint8_t>().swap(depthRaw_);
+        std::vector<uint8_t>().swap(depthSmooth_);
+    } else {
+        std::vector<float>().swap(fusedRaw_);
+        std::vector<uint8_t>().swap(fusedHist_);
+    }
+}
+
+void Engine::SetPerViewDepth(bool enabled) {
+    if (enabled == perViewDepth_) return;
+    perViewDepth_ = enabled;
+    if (width_ != 0) Resize(width_, height_);
+}
+
+void Engine::SetDepthPrecision(DepthPrecision precision) {
+    if (precision == precision_) return;
+    precision_ = precision;
+    if (width_ != 0) Resize(width_, height_);
+}
+
+void Engine::EnsurePlanes() {
+    const size_t bytes = (size_t)depthWidth_ * (size_t)height_ * DepthPrecisionBytes(precision_);
+    if (depthRaw_.size() != bytes) depthRaw_.assign(bytes, 0);
+    if (depthSmooth_.size() != bytes) depthSmooth_.assign(bytes, 0);
+}
+
+void Engine::SetTileSize(uint32_t tileW, uint32_t tileH) {
+    if (tileW != 0) tileW_ = tileW;
+    if (tileH != 0) tileH_ = tileH;
+    incValid_ = false;
+}
+
+bool Engine::CheckParams(const Params& params) const {
+    return params.outWidth != 0 && params.outHeight != 0 && params.outWidth == width_ && params.outHeight == height_;
+}
+
+void Engine::ForEachTile(uint32_t w, uint32_t h, const std::function<void(const TileRect&)>& fn) {
+    if (!pool_ || pool_->GetThreadCount() <= 1) {
+        fn(TileRect{ 0, 0, w, h });
+        return;
+    }
+    ForEachRect(w, h, tileW_, tileH_, fn);
+}
+
+void Engine::ForEachRect(uint32_t w, uint32_t h, uint32_t rectW, uint32_t rectH, const std::function<void(const TileRect&)>& fn) {
+    if (!pool_ || pool_->GetThreadCount() <= 1) {
+        for (uint32_t y = 0; y < h; y += rectH) {
+            for (uint32_t x = 0; x < w; x += rectW) {
+                fn(TileRect{ x, y, std::min(w, x + rectW), std::min(h, y + rectH) });
+            }
+        }
+        return;
+    }
+
+    ThreadPool::TaskGroup group;
+    for (uint32_t y = 0; y < h; y += rectH) {
+        for (uint32_t x = 0; x < w; x += rectW) {
+            const TileRect r{ x, y, std::min(w, x + rectW), std::min(h, y + rectH) };
+            pool_->Submit(group, [&fn, r]() { fn(r); });
+        }
+    }
+    pool_->Wait(group);
+}
+
+Kernels::LumaPlane Engine::ExtractLuma(const ImageView& src, const Params& params, const std::vector<DirtyRect>* rects) {
+    const TileRect sr = Kernels::LumaSourceRect(src.width, src.height, params);
+    const uint32_t lw = sr.x1 - sr.x0;
+    const uint32_t lh = sr.y1 - sr.y0;
+    if (luma_.size() < (size_t)lw * lh + 1) luma_.resize((size_t)lw * lh + 1); // + 1: see Kernels::LumaPlane
+
+    const LumaRowFn lumaRow = GetKernels().lumaRow;
+    uint16_t* luma = luma_.data();
+    ForEachRect(lw, lh, lw, tileH_, [&](const TileRect& r) {
+        if (!rects) {
+            for (uint32_t y = r.y0; y < r.y1; ++y) {
+                const uint8_t* srcRow = src.data + (size_t)(sr.y0 + y) * src.stride + (size_t)sr.x0 * 4;
+                lumaRow(srcRow, luma + (size_t)y * lw, lw);
+            }
+            return;
+        }
+        // Each band walks the whole list, so overlapping rects never race.
+        // Clipped in signed arithmetic: a rect partly or wholly outside the source must come out empty.
+        for (const DirtyRect& d : *rects) {
+            const int64_t left = std::max<int64_t>(d.left, sr.x0);
+            const int64_t right = std::min<int64_t>(d.right, sr.x1);
+            const int64_t top = std::max<int64_t>(d.top, sr.y0 + r.y0);
+            const int64_t bottom = std::min<int64_t>(d.bottom, sr.y0 + r.y1);
+            if (left >= right || top >= bottom) continue;
+
+            const uint32_t x0 = (uint32_t)left;
+            const uint32_t x1 = (uint32_t)right;
+            for (uint32_t y = (uint32_t)top; y < (uint32_t)bottom; ++y) {
+                const uint8_t* srcRow = src.data + (size_t)y * src.stride + (size_t)x0 * 4;
+                lumaRow(srcRow, luma + (size_t)(y - sr.y0) * lw + (x0 - sr.x0), x1 - x0);
+            }
+        }
+    });
+
+    Kernels::LumaPlane plane;
+    plane.data = luma;
+    plane.stride = lw;
+    plane.width = src.width;
+    plane.height = src.height;
+    plane.x0 = sr.x0;
+    plane.y0 = sr.y0;
+    return plane;
+}
+
+template <typename T>
+void Engine::RunDepthRawT(const ImageView& src, const Params& params) {
+    const Kernels::LumaPlane luma = ExtractLuma(src, params);
+    const DepthRawRectFn depthRawRect = GetKernels().depthRawRect;
+    // Per-view: the left eye's columns are [0, outWidth / 2), so its depth is exactly the plane.
+    T* depthRaw = PlaneAs<T>(depthRaw_);
+    const size_t stride = depthWidth_;
+    ForEachTile(depthWidth_, height_, [&](const TileRect& r) { DepthRawToPlane(depthRawRect, luma, params, r, depthRaw, stride); });
+}
+
+bool Engine::RunDepthRaw(const ImageView& src, const Params& params) {
+    if (!src.data || src.width == 0 || src.height == 0) return false;
+    if (!CheckParams(params)) return false;
+    incValid_ = false;
+
+    EnsurePlanes();
+    WithDepthType(precision_, [&](auto zero) { RunDepthRawT<decltype(zero)>(src, params); });
+    return true;
+}
+
+template <typename T>
+void Engine::RunDepthSmoothT() {
+    const int prevIdx = depthPrevIndex_ & 1;
+    const int nextIdx = (depthPrevIndex_ ^ 1) & 1;
+
+    const T* raw = PlaneAs<T>(depthRaw_);
+    const T* prev = PlaneAs<T>(depthPrev_[prevIdx]);
+    T* prevOut = PlaneAs<T>(depthPrev_[nextIdx]);
+    T* smooth = PlaneAs<T>(depthSmooth_);
+    const uint32_t dw = depthWidth_;
+    const uint32_t h = height_;
+    ForEachTile(dw, h, [&](const TileRect& r) { Kernels::DepthSmoothRect(dw, h, r, raw, prev, prevOut, smooth); });
+
+    depthPrevIndex_ = nextIdx;
+}
+
+bool Engine::RunDepthSmooth(const Params& params) {
+    if (!CheckParams(params)) return false;
+    incValid_ = false;
+    EnsurePlanes();
+    WithDepthType(precision_, [&](auto zero) { RunDepthSmoothT<decltype(zero)>(); });
+    return true;
+}
+
+template <typename T>
+void Engine::RunParallaxSbsT(const ImageView& src, const Params& params, const ImageRef& out) {
+    const T* smooth = PlaneAs<T>(depthSmooth_);
+    const uint32_t dw = depthWidth_;
+    const uint32_t viewDepthW = ViewDepthWidth();
+    ForEachTile(width_, height_, [&](const TileRect& r) { Kernels::ParallaxSbsRect(src, params, r, smooth + (size_t)r.y0 * dw, dw, out, viewDepthW); });
+}
+
+bool Engine::RunParallaxSbs(const ImageView& src, const Params& params, const ImageRef& out) {
+    if (!src.data || src.width == 0 || src.height == 0) return false;
+    if (!CheckParams(params)) return false;
+    if (!out.data || out.width != width_ || out.height != height_) return false;
+    incValid_ = false;
+    EnsurePlanes();
+    WithDepthType(precision_, [&](auto zero) { RunParallaxSbsT<decltype(zero)>(src, params, out); });
+    return true;
+}
+
+// Dependency-driven schedule: every tile starts with pass 1. Pass 2 only reads depthRaw at its own
+// pixel (its neighbours come from last frame's history), so a tile row's pass 2 can start as soon as
+// that row's pass-1 tiles are done; the last pass-1 tile of a row enqueues pass 2 + 3 for the row.
+// Pass 3 likewise only reads depthSmooth at its own pixel, so it is chained onto the same task.
+// Tiles cover the depth plane; with per-view depth each pass-2 tile also writes its mirror in the
+// right eye (same rect shifted by the view width). The luma plane is filled first: pass-1 taps
+// reach across tile borders.
+template <typename T>
+void Engine::RenderTiledT(const ImageView& src, const Params& params, const ImageRef& out) {
+    const uint32_t dw = depthWidth_;
+    const uint32_t viewDepthW = ViewDepthWidth();
+    const uint32_t tilesX = (dw + tileW_ - 1) / tileW_;
+    const uint32_t tilesY = (height_ + tileH_ - 1) / tileH_;
+    if (rowPendingCount_ < tilesY) {
+        rowPending_.reset(new std::atomic<uint32_t>[tilesY]);
+        rowPendingCount_ = tilesY;
+    }
+    for (uint32_t ty = 0; ty < tilesY; ++ty) {
+        rowPending_[ty].store(tilesX, std::memory_order_relaxed);
+    }
+
+    const int prevIdx = depthPrevIndex_ & 1;
+    const int nextIdx = (depthPrevIndex_ ^ 1) & 1;
+
+    const Kernels::LumaPlane luma = ExtractLuma(src, params);
+    const DepthRawRectFn depthRawRect = GetKernels().depthRawRect;
+    T* raw = PlaneAs<T>(depthRaw_);
+    const T* prev = PlaneAs<T>(depthPrev_[prevIdx]);
+    T* prevOut = PlaneAs<T>(depthPrev_[nextIdx]);
+    T* smooth = PlaneAs<T>(depthSmooth_);
+
+    auto tileAt = [this, dw](uint32_t tx, uint32_t ty) {
+        const uint32_t x = tx * tileW_;
+        const uint32_t y = ty * tileH_;
+        return TileRect{ x, y, std::min(dw, x + tileW_), std::min(height_, y + tileH_) };
+    };
+
+    ThreadPool::TaskGroup group;
+    ThreadPool* pool = pool_;
+    for (uint32_t ty = 0; ty < tilesY; ++ty) {
+        for (uint32_t tx = 0; tx < tilesX; ++tx) {
+            pool->Submit(group, [&, tx, ty]() {
+                const TileRect r = tileAt(tx, ty);
+                DepthRawToPlane(depthRawRect, luma, params, r, raw, dw);
+                if (rowPending_[ty].fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+                for (uint32_t sx = 0; sx < tilesX; ++sx) {
+                    pool->Submit(group, [&, sx, ty]() {
+                        const TileRect r = tileAt(sx, ty);
+                        Kernels::DepthSmoothRect(dw, height_, r, raw, prev, prevOut, smooth);
+                        if (!out.data) return;
+                        const T* smoothRows = smooth + (size_t)r.y0 * dw;
+                        Kernels::ParallaxSbsRect(src, params, r, smoothRows, dw, out, viewDepthW);
+                        if (viewDepthW != 0) {
+                            const TileRect mirror{ r.x0 + viewDepthW, r.y0, r.x1 + viewDepthW, r.y1 };
+                            Kernels::ParallaxSbsRect(src, params, mirror, smoothRows, dw, out, viewDepthW);
+                        }
+                    });
+                }
+            });
+        }
+    }
+    pool->Wait(group);
+
+    depthPrevIndex_ = nextIdx;
+}
+
+bool Engine::RenderTiled(const ImageView& src, const Params& params, const ImageRef& out) {
+    if (!src.data || src.width == 0 || src.height == 0) return false;
+    if (!CheckParams(params)) return false;
+    if (out.data && (out.width != width_ || out.height != height_)) return false;
+    EnsurePlanes();
+    WithDepthType(precision_, [&](auto zero) { RenderTiledT<decltype(zero)>(src, params, out); });
+    return true;
+}
+
+// Fused sweep. Bands of rows run independently; within a band each row goes through all three
+// passes before the next row starts, so the only per-frame planes touched are the luma plane
+// (filled up front), the (in-place) history and the output.
+//
+// Pass 2 reads history at y-1, y and y+1, so before overwriting row y we keep its old values
+// in a rolling window (oldUp/oldCur). Neighbouring bands may already have overwritten the rows
+// just outside our band, so each band's first and last history rows are snapshotted up front.
+// All of this is at depth width; only pass 3 spans the full output row. Raw and smoothed depth
+// stay float in the row buffer (only history is stored at precision_), like the fused shader.
+template <typename T>
+void Engine::RenderFusedT(const ImageView& src, const Params& params, const ImageRef& out) {
+    const uint32_t w = depthWidth_;
+    const uint32_t h = height_;
+    const uint32_t viewDepthW = ViewDepthWidth();
+
+    // Keep at least two bands per thread so the pool stays busy on small frames.
+    const uint32_t threads = pool_ ? pool_->GetThreadCount() : 1;
+    uint32_t bandH = kFusedBandH;
+    while (bandH > tileH_ && (h + bandH - 1) / bandH < threads * 2) bandH /= 2;
+    const uint32_t bands = (h + bandH - 1) / bandH;
+
+    // Per band: 1 float raw row, plus 2 halo rows (old first/last) + 2 rolling rows (oldUp, oldCur).
+    const size_t histRowsPerBand = 4;
+    fusedRaw_.resize((size_t)bands * w);
+    fusedHist_.resize((size_t)bands * histRowsPerBand * w * sizeof(T));
+
+    T* hist = PlaneAs<T>(depthPrev_[depthPrevIndex_ & 1]);
+    T* scratch = PlaneAs<T>(fusedHist_);
+    auto haloFirst = [&](uint32_t b) { return scratch + ((size_t)b * histRowsPerBand + 0) * w; };
+    auto haloLast = [&](uint32_t b) { return scratch + ((size_t)b * histRowsPerBand + 1) * w; };
+
+    for (uint32_t b = 0; b < bands; ++b) {
+        const uint32_t y0 = b * bandH;
+        const uint32_t y1 = std::min(h, y0 + bandH);
+        std::copy_n(hist + (size_t)y0 * w, w, haloFirst(b));
+        std::copy_n(hist + (size_t)(y1 - 1) * w, w, haloLast(b));
+    }
+
+    const Kernels::LumaPlane luma = ExtractLuma(src, params);
+    const DepthRawRectFn depthRawRect = GetKernels().depthRawRect;
+
+    ForEachRect(w, h, w, bandH, [&](const TileRect& band) {
+        const uint32_t b = band.y0 / bandH;
+        float* rawRow = fusedRaw_.data() + (size_t)b * w;
+        T* oldUp = scratch + ((size_t)b * histRowsPerBand + 2) * w;
+        T* oldCur = oldUp + w;
+
+        // Old history of the row above the band (row 0 clamps to itself).
+        std::copy_n(b > 0 ? haloLast(b - 1) : haloFirst(0), w, oldUp);
+
+        for (uint32_t y = band.y0; y < band.y1; ++y) {
+            T* histRow = hist + (size_t)y * w;
+            std::copy_n(histRow, w, oldCur);
+
+            const T* oldDown = nullptr;
+            if (y + 1 >= h) oldDown = oldCur;
+            else if (y + 1 == band.y1) oldDown = haloFirst(b + 1);
+            else oldDown = hist + (size_t)(y + 1) * w; // not yet overwritten
+
+            depthRawRect(luma, params, TileRect{ 0, y, w, y + 1 }, rawRow, w);
+
+            // Smoothed depth replaces raw in the (L1-resident) row buffer, then feeds pass 3.
+            for (uint32_t x = 0; x < w; ++x) {
+                const uint32_t xl = (x > 0) ? x - 1 : 0;
+                const uint32_t xr = std::min(w - 1, x + 1);
+                const float d = Kernels::SmoothDepthAt(rawRow[x], Kernels::LoadDepth(oldCur[x]), Kernels::LoadDepth(oldDown[x]),
+                                                       Kernels::LoadDepth(oldUp[x]), Kernels::LoadDepth(oldCur[xr]), Kernels::LoadDepth(oldCur[xl]));
+                Kernels::StoreDepth(histRow + x, d);
+                rawRow[x] = d;
+            }
+            if (out.data) Kernels::ParallaxSbsRect(src, params, TileRect{ 0, y, width_, y + 1 }, rawRow, w, out, viewDepthW);
+
+            std::swap(oldUp, oldCur);
+        }
+    });
+}
+
+bool Engine::RenderFused(const ImageView& src, const Params& params, const ImageRef& out) {
+    if (!src.data || src.width == 0 || src.height == 0) return false;
+    if (!CheckParams(params)) return false;
+    if (out.data && (out.width != width_ || out.height != height_)) return false;
+    WithDepthType(precision_, [&](auto zero) { RenderFusedT<decltype(zero)>(src, params, out); });
+    return true;
+}
+
+void Engine::HashSource(const ImageView& src) {
+    const uint32_t bw = (src.width + kHashTile - 1) / kHashTile;
+    const uint32_t bh = (src.height + kHashTile - 1) / kHashTile;
+    const bool resized = (src.width != hashW_ || src.height != hashH_);
+    if (resized) {
+        srcHash_.assign((size_t)bw * bh, 0);
+        hashW_ = src.width;
+        hashH_ = src.height;
+    }
+    blockChanged_.resize((size_t)bw * bh);
+
+    ForEachRect(bw, bh, bw, 1, [&](const TileRect& r) {
+        for (uint32_t by = r.y0; by < r.y1; ++by) {
+            const uint32_t y0 = by * kHashTile;
+            const uint32_t rows = std::min(src.height, y0 + kHashTile) - y0;
+            for (uint32_t bx = 0; bx < bw; ++bx) {
+                const uint32_t x0 = bx * kHashTile;
+                const uint32_t cols = std::min(src.width, x0 + kHashTile) - x0;
+                const uint64_t hash = HashBlock(src.data + (size_t)y0 * src.stride + (size_t)x0 * 4, src.stride, cols * 4, rows);
+                const size_t i = (size_t)by * bw + bx;
+                blockChanged_[i] = resized || hash != srcHash_[i];
+                srcHash_[i] = hash;
+            }
+        }
+    });
+
+    for (uint32_t by = 0; by < bh; ++by) {
+        for (uint32_t bx = 0; bx < bw; ++bx) {
+            if (!blockChanged_[(size_t)by * bw + bx]) continue;
+            const uint32_t runX = bx;
+            while (bx + 1 < bw && blockChanged_[(size_t)by * bw + bx + 1]) ++bx;
+            DirtyRect d;
+            d.left = (int32_t)(runX * kHashTile);
+            d.top = (int32_t)(by * kHashTile);
+            d.right = (int32_t)std::min(src.width, (bx + 1) * kHashTile);
+            d.bottom = (int32_t)std::min(src.height, (by + 1) * kHashTile);
+            dirty_.push_back(d);
+        }
+    }
+}
+
+// Inverse of the shader's output -> source mapping, widened by each pass's reach:
+// - pass 1 samples one output pixel either side (tap step) with bilinear taps (one source texel);
+// - pass 3 samples the same row, shifted by up to parallaxPx output pixels, with bilinear taps.
+// A texel of slack on top covers float rounding.
+void Engine::MarkDirtyTiles(const DirtyRect& d, uint32_t srcW, uint32_t srcH, const Params& p) {
+    const int64_t left = std::max<int64_t>(d.left, 0);
+    const int64_t top = std::max<int64_t>(d.top, 0);
+    const int64_t right = std::min<int64_t>(d.right, srcW);
+    const int64_t bottom = std::min<int64_t>(d.bottom, srcH);
+    if (left >= right || top >= bottom) return;
+
+    const float scaleU = std::max(p.cropScale[0], 1e-6f);
+    const float scaleV = std::max(p.cropScale[1], 1e-6f);
+
+    // Output rows reading source rows [top, bottom).
+    const float rowsPerTexel = (float)height_ / (scaleV * (float)srcH);
+    auto rowOf = [&](float sy) { return ((sy + 0.5f) / (float)srcH - p.cropOffset[1]) / scaleV * (float)height_ - 0.5f; };
+    const float fy0 = rowOf((float)top) - rowsPerTexel - 2.0f;
+    const float fy1 = rowOf((float)(bottom - 1)) + rowsPerTexel + 2.0f;
+    if (fy1 < 0.0f || fy0 > (float)(height_ - 1)) return;
+    const uint32_t ty0 = (uint32_t)std::max(0.0f, std::floor(fy0)) / tileH_;
+    const uint32_t ty1 = (uint32_t)std::min((float)(height_ - 1), std::ceil(fy1)) / tileH_;
+
+    const uint32_t tilesX = (depthWidth_ + tileW_ - 1) / tileW_;
+    auto mark = [&](uint8_t flag, float fx0, float fx1, uint32_t base, uint32_t viewW) {
+        if (fx1 < 0.0f || fx0 > (float)(viewW - 1)) return;
+        const uint32_t x0 = base + (uint32_t)std::max(0.0f, std::floor(fx0));
+        const uint32_t x1 = base + (uint32_t)std::min((float)(viewW - 1), std::ceil(fx1));
+        for (uint32_t ty = ty0; ty <= ty1; ++ty) {
+            for (uint32_t tx = x0 / tileW_; tx <= x1 / tileW_; ++tx) tileFlags_[(size_t)ty * tilesX + tx] |= flag;
+        }
+    };
+
+    // Per eye: view-local columns reading source columns [left, right). With per-view depth both eyes
+    // land on the same plane columns (and pass 3 writes each tile's mirror), so the left eye suffices.
+    const uint32_t leftW = width_ / 2;
+    const int eyes = (depthWidth_ != width_) ? 1 : 2;
+    for (int eye = 0; eye < eyes; ++eye) {
+        const uint32_t viewW = std::max(1u, eye == 0 ? leftW : width_ - leftW);
+        const uint32_t base = eye == 0 ? 0 : leftW;
+        const float colsPerTexel = (float)viewW / (scaleU * (float)srcW);
+        auto colOf = [&](float sx) { return ((sx + 0.5f) / (float)srcW - p.cropOffset[0]) / scaleU * (float)viewW - 0.5f; };
+        const float fx0 = colOf((float)left) - colsPerTexel - 2.0f;
+        const float fx1 = colOf((float)(right - 1)) + colsPerTexel + 2.0f;
+        mark(kTileRaw, fx0, fx1, base, viewW);
+        mark(kTileOut, fx0 - p.parallaxPx, fx1 + p.parallaxPx, base, viewW);
+    }
+}
+
+// Tiles run all their flagged passes in one task: pass 2 reads depthRaw only at its own pixel and
+// last frame's history (never written this frame) around it, and pass 3 reads depthSmooth only at
+// its own pixel. Skipped tiles are settled, and a settled tile's region is made identical in both
+// history planes, so it does not matter which one the ping-pong reads next frame.
+template <typename T>
+void Engine::RenderIncrementalT(const ImageView& src, const Params& params, const ImageRef& out, const std::vector<DirtyRect>* lumaRects) {
+    const uint32_t dw = depthWidth_;
+    const uint32_t h = height_;
+    const uint32_t viewDepthW = ViewDepthWidth();
+    const uint32_t tilesX = (dw + tileW_ - 1) / tileW_;
+    const uint32_t tilesY = (h + tileH_ - 1) / tileH_;
+
+    const int prevIdx = depthPrevIndex_ & 1;
+    const int nextIdx = (depthPrevIndex_ ^ 1) & 1;
+
+    const Kernels::LumaPlane luma = ExtractLuma(src, params, lumaRects);
+    const DepthRawRectFn depthRawRect = GetKernels().depthRawRect;
+    T* raw = PlaneAs<T>(depthRaw_);
+    T* prev = PlaneAs<T>(depthPrev_[prevIdx]);
+    T* prevOut = PlaneAs<T>(depthPrev_[nextIdx]);
+    T* smooth = PlaneAs<T>(depthSmooth_);
+    const ImageRef cache{ outCache_.data(), width_, h, (size_t)width_ * 4 };
+    const float threshold = settleThreshold_;
+
+    auto tileAt = [this, dw, h](uint32_t tx, uint32_t ty) {
+        const uint32_t x = tx * tileW_;
+        const uint32_t y = ty * tileH_;
+        return TileRect{ x, y, std::min(dw, x + tileW_), std::min(h, y + tileH_) };
+    };
+    auto runTile = [&](uint32_t tx, uint32_t ty) {
+        uint8_t& f = tileFlags_[(size_t)ty * tilesX + tx];
+        const TileRect r = tileAt(tx, ty);
+        if (f & kTileRaw) DepthRawToPlane(depthRawRect, luma, params, r, raw, dw);
+        if (f & kTileSmooth) {
+            const float delta = Kernels::DepthSmoothRect(dw, h, r, raw, prev, prevOut, smooth);
+            f = (delta <= threshold) ? (uint8_t)(f | kTileSettled) : (uint8_t)(f & ~kTileSettled);
+        }
+        if (f & kTileOut) {
+            const T* smoothRows = smooth + (size_t)r.y0 * dw;
+            Kernels::ParallaxSbsRect(src, params, r, smoothRows, dw, cache, viewDepthW);
+            if (viewDepthW != 0) {
+                const TileRect mirror{ r.x0 + viewDepthW, r.y0, r.x1 + viewDepthW, r.y1 };
+                Kernels::ParallaxSbsRect(src, params, mirror, smoothRows, dw, cache, viewDepthW);
+            }
+        }
+    };
+
+    const uint8_t work = kTileRaw | kTileSmooth | kTileOut;
+    if (pool_ && pool_->GetThreadCount() > 1) {
+        ThreadPool::TaskGroup group;
+        for (uint32_t ty = 0; ty < tilesY; ++ty) {
+            for (uint32_t tx = 0; tx < tilesX; ++tx) {
+                if (tileFlags_[(size_t)ty * tilesX + tx] & work) pool_->Submit(group, [&, tx, ty]() { runTile(tx, ty); });
+            }
+        }
+        pool_->Wait(group);
+    } else {
+        for (uint32_t ty = 0; ty < tilesY; ++ty) {
+            for (uint32_t tx = 0; tx < tilesX; ++tx) {
+                if (tileFlags_[(size_t)ty * tilesX + tx] & work) runTile(tx, ty);
+            }
+        }
+    }
+
+    // Tiles that just settled: bring the outgoing history plane up to date.
+    for (uint32_t ty = 0; ty < tilesY; ++ty) {
+        for (uint32_t tx = 0; tx < tilesX; ++tx) {
+            const uint8_t f = tileFlags_[(size_t)ty * tilesX + tx];
+            if (!(f & kTileSmooth) || !(f & kTileSettled)) continue;
+            const TileRect r = tileAt(tx, ty);
+            for (uint32_t y = r.y0; y < r.y1; ++y) std::copy(prevOut + (size_t)y * dw + r.x0, prevOut + (size_t)y * dw + r.x1, prev + (size_t)y * dw + r.x0);
+        }
+    }
+    depthPrevIndex_ = nextIdx;
+
+    const size_t rowBytes = (size_t)width_ * 4;
+    ForEachRect(width_, h, width_, tileH_, [&](const TileRect& r) {
+        for (uint32_t y = r.y0; y < r.y1; ++y) std::memcpy(out.data + (size_t)y * out.stride, cache.data + (size_t)y * cache.stride, rowBytes);
+    });
+}
+
+bool Engine::RenderIncremental(const ImageView& src, const Params& params, const ImageRef& out, bool hashSource) {
+    if (!src.data || src.width == 0 || src.height == 0) return false;
+    if (!CheckParams(params)) return false;
+    if (!out.data || out.width != width_ || out.height != height_) return false;
+    EnsurePlanes();
+
+    const uint32_t tilesX = (depthWidth_ + tileW_ - 1) / tileW_;
+    const uint32_t tilesY = (height_ + tileH_ - 1) / tileH_;
+    const size_t tileCount = (size_t)tilesX * tilesY;
+    const bool full = !incValid_ || tileFlags_.size() != tileCount || src.width != incSrcW_ || src.height != incSrcH_ ||
+        !SameParams(params, incParams_);
+
+    // The hashes must track every frame to stay usable; caller-supplied rects make them stale.
+    if (hashSource) HashSource(src);
+    else hashW_ = hashH_ = 0;
+
+    if (full) {
+        tileFlags_.assign(tileCount, kTileRaw | kTileOut);
+        outCache_.resize((size_t)width_ * height_ * 4);
+    } else {
+        for (uint8_t& f : tileFlags_) f &= kTileSettled;
+        for (const DirtyRect& d : dirty_) MarkDirtyTiles(d, src.width, src.height, params);
+    }
+
+    // Pass 2 wherever pass 1 ran and wherever history may still move: the tile itself or a
+    // neighbour (whose border rows/columns it reads) did not settle last frame.
+    incStats_ = IncrementalStats();
+    incStats_.tiles = (uint32_t)tileCount;
+    for (uint32_t ty = 0; ty < tilesY; ++ty) {
+        for (uint32_t tx = 0; tx < tilesX; ++tx) {
+            uint8_t& f = tileFlags_[(size_t)ty * tilesX + tx];
+            bool moving = (f & kTileRaw) != 0;
+            for (uint32_t ny = (ty > 0 ? ty - 1 : 0); !moving && ny <= std::min(tilesY - 1, ty + 1); ++ny) {
+                for (uint32_t nx = (tx > 0 ? tx - 1 : 0); nx <= std::min(tilesX - 1, tx + 1); ++nx) {
+                    if (!(tileFlags_[(size_t)ny * tilesX + nx] & kTileSettled)) moving = true;
+                }
+            }
+            if (moving) f |= kTileSmooth | kTileOut;
+            incStats_.rawTiles += (f & kTileRaw) ? 1 : 0;
+            incStats_.smoothTiles += (f & kTileSmooth) ? 1 : 0;
+            incStats_.outTiles += (f & kTileOut) ? 1 : 0;
+        }
+    }
+
+    const std::vector<DirtyRect>* lumaRects = full ? nullptr : &dirty_;
+    WithDepthType(precision_, [&](auto zero) { RenderIncrementalT<decltype(zero)>(src, params, out, lumaRects); });
+
+    incParams_ = params;
+    incSrcW_ = src.width;
+    incSrcH_ = src.height;
+    incValid_ = true;
+    return true;
+}
+
+void Engine::SetLetterboxDetection(bool enabled) {
+    letterbox_ = enabled;
+    lbRegion_ = DirtyRect{};
+    lbActive_ = DirtyRect{};
+    lbCandidateFrames_ = 0;
+}
+
+void Engine::UpdateLetterbox(const ImageView& src, const DirtyRect& region) {
+    auto same = [](const DirtyRect& a, const DirtyRect& b) {
+        return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+    };
+    if (!same(region, lbRegion_)) {
+        lbRegion_ = region;
+        lbActive_ = region;
+        lbCandidate_ = region;
+        lbCandidateFrames_ = 0;
+    }
+
+    // A fully dark frame (fade to black) says nothing about the bars: keep the current bounds.
+    DirtyRect found;
+    uint8_t bar[4];
+    if (!FindActiveRect(src, region, kLetterboxThreshold, &found, bar)) return;
+
+    // Content reaching into a bar (subtitles, an aspect change): widen right away.
+    if (found.left < lbActive_.left || found.top < lbActive_.top || found.right > lbActive_.right || found.bottom > lbActive_.bottom) {
+        lbActive_.left = std::min(lbActive_.left, found.left);
+        lbActive_.top = std::min(lbActive_.top, found.top);
+        lbActive_.right = std::max(lbActive_.right, found.right);
+        lbActive_.bottom = std::max(lbActive_.bottom, found.bottom);
+        lbCandidateFrames_ = 0;
+        return;
+    }
+
+    auto near = [](int32_t a, int32_t b) { return std::abs(a - b) <= kLetterboxSlack; };
+    if (near(found.left, lbCandidate_.left) && near(found.top, lbCandidate_.top) && near(found.right, lbCandidate_.right) &&
+        near(found.bottom, lbCandidate_.bottom)) {
+        ++lbCandidateFrames_;
+    } else {
+        lbCandidate_ = found;
+        lbCandidateFrames_ = 1;
+    }
+    if (lbCandidateFrames_ < kLetterboxConfirmFrames) return;
+
+    // Narrow to the confirmed bounds plus slack. Only centred bars are letterboxing; a dark scene
+    // with one lit corner is not.
+    DirtyRect r;
+    r.left = std::max(lbCandidate_.left - kLetterboxSlack, lbActive_.left);
+    r.top = std::max(lbCandidate_.top - kLetterboxSlack, lbActive_.top);
+    r.right = std::min(lbCandidate_.right + kLetterboxSlack, lbActive_.right);
+    r.bottom = std::min(lbCandidate_.bottom + kLetterboxSlack, lbActive_.bottom);
+    auto centred = [](int32_t barA, int32_t barB) { return std::abs(barA - barB) <= (barA + barB) / 4 + 2 * kLetterboxSlack; };
+    if (!centred(r.left - region.left, region.right - r.right) || !centred(r.top - region.top, region.bottom - r.bottom)) return;
+    lbActive_ = r;
+    std::memcpy(lbBarColor_, bar, sizeof(lbBarColor_));
+}
+
+bool Engine::RenderLetterboxed(const ImageView& src, const Params& params, const ImageRef& out, const DirtyRect* rects, size_t count) {
+    const uint32_t w = params.outWidth;
+    const uint32_t h = params.outHeight;
+    if (w == 0 || h == 0 || !out.data || out.width != w || out.height != h) return false;
+
+    DirtyRect region;
+    region.left = std::clamp((int32_t)std::floor(params.cropOffset[0] * src.width), 0, (int32_t)src.width);
+    region.top = std::clamp((int32_t)std::floor(params.cropOffset[1] * src.height), 0, (int32_t)src.height);
+    region.right = std::clamp((int32_t)std::ceil((params.cropOffset[0] + params.cropScale[0]) * src.width), 0, (int32_t)src.width);
+    region.bottom = std::clamp((int32_t)std::ceil((params.cropOffset[1] + params.cropScale[1]) * src.height), 0, (int32_t)src.height);
+    UpdateLetterbox(src, region);
+
+    // Output rows / eye-view columns whose sample centre lies in the picture (the mapping of EyeMapping).
+    auto toY = [&](int32_t sy) { return ((double)sy / src.height - params.cropOffset[1]) / params.cropScale[1] * h; };
+    const uint32_t y0 = (uint32_t)std::clamp((int32_t)std::ceil(toY(lbActive_.top) - 0.5), 0, (int32_t)h);
+    const uint32_t y1 = (uint32_t)std::clamp((int32_t)std::ceil(toY(lbActive_.bottom) - 0.5), (int32_t)y0, (int32_t)h);
+    // Columns only on even widths, where both views span the same source columns, and without the
+    // zoom-out shift clamp (relative to the view width). Parallax pushes the picture's edge columns
+    // into the bars, so those keep a margin of the full shift.
+    const uint32_t viewW = w / 2;
+    uint32_t x0 = 0;
+    uint32_t x1 = viewW;
+    const bool splitViews = (w % 2) == 0 && params.zoomLevel >= 0;
+    if (splitViews) {
+        auto toX = [&](int32_t sx) { return ((double)sx / src.width - params.cropOffset[0]) / params.cropScale[0] * viewW; };
+        const int32_t margin = (int32_t)std::ceil(std::fabs(params.parallaxPx)) + 1;
+        x0 = (uint32_t)std::clamp((int32_t)std::ceil(toX(lbActive_.left) - 0.5) - margin, 0, (int32_t)viewW);
+        x1 = (uint32_t)std::clamp((int32_t)std::ceil(toX(lbActive_.right) - 0.5) + margin, (int32_t)x0, (int32_t)viewW);
+    }
+    const bool cols = splitViews && (x0 > 0 || x1 < viewW);
+    if (!cols && y0 == 0 && y1 == h) return RenderPicture(src, params, out, rects, count);
+
+    auto fill = [&](uint32_t y, uint32_t xa, uint32_t xb) {
+        uint8_t* p = out.data + (size_t)y * out.stride + (size_t)xa * 4;
+        for (uint32_t x = xa; x < xb; ++x, p += 4) std::memcpy(p, lbBarColor_, 4);
+    };
+    const bool visible = y0 < y1 && x0 < x1;
+    if (visible) {
+        // The picture alone: same sample positions as the full frame, on a smaller output.
+        Params sub = params;
+        sub.outHeight = y1 - y0;
+        sub.cropOffset[1] = params.cropOffset[1] + (float)y0 / (float)h * params.cropScale[1];
+        sub.cropScale[1] = params.cropScale[1] * (float)(y1 - y0) / (float)h;
+        ImageRef pic;
+        if (cols) {
+            sub.outWidth = 2 * (x1 - x0);
+            sub.cropOffset[0] = params.cropOffset[0] + (float)x0 / (float)viewW * params.cropScale[0];
+            sub.cropScale[0] = params.cropScale[0] * (float)(x1 - x0) / (float)viewW;
+            lbScratch_.resize((size_t)sub.outWidth * 4 * sub.outHeight);
+            pic = ImageRef{ lbScratch_.data(), sub.outWidth, sub.outHeight, (size_t)sub.outWidth * 4 };
+        } else {
+            pic = ImageRef{ out.data + (size_t)y0 * out.stride, w, sub.outHeight, out.stride };
+        }
+        if (!RenderPicture(src, sub, pic, rects, count)) return false;
+
+        if (cols) {
+            const size_t viewBytes = (size_t)(x1 - x0) * 4;
+            for (uint32_t y = y0; y < y1; ++y) {
+                const uint8_t* row = pic.data + (size_t)(y - y0) * pic.stride;
+                uint8_t* dst = out.data + (size_t)y * out.stride;
+                std::memcpy(dst + (size_t)x0 * 4, row, viewBytes);
+                std::memcpy(dst + (size_t)(viewW + x0) * 4, row + viewBytes, viewBytes);
+                fill(y, 0, x0);
+                fill(y, x1, viewW + x0);
+                fill(y, viewW + x1, w);
+            }
+        }
+    }
+    for (uint32_t y = 0; y < h; ++y) {
+        if (!visible || y < y0 || y >= y1) fill(y, 0, w);
+    }
+    return true;
+}
+
+void Engine::SetFoveation(const Foveation& foveation) {
+    Foveation f = foveation;
+    f.radius = std::clamp(f.radius, 0.0f, 1.5f);
+    f.falloff = std::clamp(f.falloff, 0.0f, 1.5f);
+    f.peripheryScale = (f.peripheryScale >= 4) ? 4u : 2u;
+    if (f.enabled != fovea_.enabled || f.radius != fovea_.radius || f.falloff != fovea_.falloff || f.peripheryScale != fovea_.peripheryScale) {
+        fovCentre_.reset();
+        fovPeriphery_.reset();
+    }
+    fovea_ = f;
+}
+
+template <typename T>
+void Engine::ResolveFoveaT(const Kernels::FoveaLayout& f) {
+    const T* centre = static_cast<const T*>(fovCentre_->GetDepthSmooth());
+    const T* periphery = static_cast<const T*>(fovPeriphery_->GetDepthSmooth());
+    T* smooth = PlaneAs<T>(depthSmooth_);
+    const uint32_t dw = depthWidth_;
+    ForEachTile(dw, height_, [&](const TileRect& r) { Kernels::FoveaResolveRect(f, centre, periphery, r, smooth + (size_t)r.y0 * dw + r.x0, dw); });
+}
+
+bool Engine::RenderFoveated(const ImageView& src, const Params& params, const ImageRef& out) {
+    if (!src.data || src.width == 0 || src.height == 0) return false;
+    if (out.data && (out.width != params.outWidth || out.height != params.outHeight)) return false;
+
+    const Kernels::FoveaLayout f = Kernels::MakeFoveaLayout(params.outWidth / 2, params.outHeight, fovea_.radius, fovea_.falloff, fovea_.peripheryScale);
+    auto runDepth = [&](std::unique_ptr<Engine>& engine, bool centre) {
+        if (!engine) engine = std::make_unique<Engine>();
+        engine->SetPerViewDepth(true);
+        engine->SetDepthPrecision(precision_);
+        engine->SetThreadPool(pool_);
+        engine->SetTileSize(tileW_, tileH_);
+        const Params sub = Kernels::FoveaPlaneParams(params, f, centre);
+        return engine->Resize(sub.outWidth, sub.outHeight) && engine->RunDepthRaw(src, sub) && engine->RunDepthSmooth(sub);
+    };
+    if (!runDepth(fovCentre_, true) || !runDepth(fovPeriphery_, false)) return false;
+
+    // This engine only keeps the resolved plane; the full-size raw / history planes are dropped (a
+    // later non-foveated Render() reallocates them through Resize()).
+    std::vector<uint8_t>().swap(depthRaw_);
+    std::vector<uint8_t>().swap(depthPrev_[0]);
+    std::vector<uint8_t>().swap(depthPrev_[1]);
+    depthPrevIndex_ = 0;
+    incValid_ = false;
+    width_ = params.outWidth;
+    height_ = params.outHeight;
+    depthWidth_ = f.viewW;
+    depthSmooth_.resize((size_t)depthWidth_ * height_ * DepthPrecisionBytes(precision_));
+
+    WithDepthType(precision_, [&](auto zero) {
+        ResolveFoveaT<decltype(zero)>(f);
+        if (out.data) RunParallaxSbsT<decltype(zero)>(src, params, out);
+    });
+    return true;
+}
+
+void Engine::SetFrameInterpolation(bool enabled) {
+    interp_ = enabled;
+    interpPictures_ = 0;
+    if (!enabled) {
+        for (int i = 0; i < 2; ++i) {
+            std::vector<uint8_t>().swap(interpDepth_[i]);
+            std::vector<float>().swap(motionFine_[i]);
+            std::vector<float>().swap(motionCoarse_[i]);
+        }
+        std::vector<int32_t>().swap(motionCoarseField_);
+        std::vector<float>().swap(motionField_);
+    }
+}
+
+const std::vector<uint8_t>& Engine::PictureDepth() const {
+    // History holds the smoothed depth in every schedule; foveation keeps none, its resolved plane is it.
+    const std::vector<uint8_t>& history = depthPrev_[depthPrevIndex_ & 1];
+    return history.empty() ? depthSmooth_ : history;
+}
+
+void Engine::KeepInterpolationDepth(const Params& params) {
+    const std::vector<uint8_t>& depth = PictureDepth();
+
+    const int cur = interpIndex_;
+    const bool sameLayout = interpPictures_ > 0 && SameParams(params, interpParams_[cur]) && interpDepthW_[cur] == depthWidth_ &&
+        interpDepth_[cur].size() == depth.size();
+    const int next = cur ^ 1;
+    interpDepth_[next] = depth;
+    interpParams_[next] = params;
+    interpDepthW_[next] = depthWidth_;
+    interpIndex_ = next;
+    interpPictures_ = sameLayout ? 2 : 1;
+    ++interpSeq_;
+}
+
+template <typename T>
+void Engine::EstimateMotionT(const ImageView& prev, const ImageView& src, const Params& params) {
+    if (motionSeq_ == interpSeq_ && motionSrcW_ == src.width && motionSrcH_ == src.height) return;
+
+    const uint32_t fw = Kernels::MotionPlaneSize(src.width);
+    const uint32_t fh = Kernels::MotionPlaneSize(src.height);
+    const uint32_t cw = Kernels::MotionPlaneSize(fw);
+    const uint32_t ch = Kernels::MotionPlaneSize(fh);
+    const ImageView* pictures[2] = { &prev, &src };
+    Kernels::MotionPlane fine[2];
+    Kernels::MotionPlane coarse[2];
+    for (int i = 0; i < 2; ++i) {
+        motionFine_[i].resize((size_t)fw * fh);
+        motionCoarse_[i].resize((size_t)cw * ch);
+        float* f = motionFine_[i].data();
+        float* c = motionCoarse_[i].data();
+        const ImageView& pic = *pictures[i];
+        ForEachRect(fw, fh, fw, tileH_, [&](const TileRect& r) {
+            for (uint32_t y = r.y0; y < r.y1; ++y) Kernels::MotionLumaRow(pic, y, f + (size_t)y * fw, fw);
+        });
+        fine[i] = Kernels::MotionPlane{ f, fw, fh };
+        ForEachRect(cw, ch, cw, tileH_, [&](const TileRect& r) {
+            for (uint32_t y = r.y0; y < r.y1; ++y) Kernels::MotionCoarseRow(fine[i], y, c + (size_t)y * cw, cw);
+        });
+        coarse[i] = Kernels::MotionPlane{ c, cw, ch };
+    }
+
+    const uint32_t cbx = Kernels::MotionCoarseBlocks(cw);
+    const uint32_t cby = Kernels::MotionCoarseBlocks(ch);
+    motionCoarseField_.resize((size_t)cbx * cby * 2);
+    int32_t* cv = motionCoarseField_.data();
+    ForEachRect(cbx, cby, cbx, 4, [&](const TileRect& r) {
+        for (uint32_t y = r.y0; y < r.y1; ++y) {
+            for (uint32_t x = r.x0; x < r.x1; ++x) {
+                int32_t* v = cv + ((size_t)y * cbx + x) * 2;
+                Kernels::MotionCoarseAt(coarse[0], coarse[1], x, y, &v[0], &v[1]);
+            }
+        }
+    });
+
+    const uint32_t bx = Kernels::MotionBlocks(fw);
+    const uint32_t by = Kernels::MotionBlocks(fh);
+    const uint32_t perCoarse = Kernels::kMotionCoarseBlock * Kernels::kMotionLumaScale / Kernels::kMotionBlock; // fine blocks per coarse block
+    const float toU = (float)Kernels::kMotionLumaScale / (float)src.width;
+    const float toV = (float)Kernels::kMotionLumaScale / (float)src.height;
+    const T* depthB = PlaneAs<T>(interpDepth_[interpIndex_]);
+    const uint32_t depthW = interpDepthW_[interpIndex_];
+    motionField_.resize((size_t)bx * by * 4);
+    float* field = motionField_.data();
+    ForEachRect(bx, by, bx, 4, [&](const TileRect& r) {
+        for (uint32_t y = r.y0; y < r.y1; ++y) {
+            for (uint32_t x = r.x0; x < r.x1; ++x) {
+                const int32_t* v = cv + ((size_t)std::min(y / perCoarse, cby - 1) * cbx + std::min(x / perCoarse, cbx - 1)) * 2;
+                float du;
+                float dv;
+                float cost;
+                Kernels::MotionFineAt(fine[0], fine[1], x, y, v[0], v[1], &du, &dv, &cost);
+                float* e = field + ((size_t)y * bx + x) * 4;
+                e[0] = du * toU;
+                e[1] = dv * toV;
+                e[2] = cost;
+                e[3] = Kernels::MotionBlockDepth(depthB, depthW, params, src.width, src.height, x, y);
+            }
+        }
+    });
+
+    motionSeq_ = interpSeq_;
+    motionSrcW_ = src.width;
+    motionSrcH_ = src.height;
+}
+
+template <typename T>
+void Engine::RenderInterpolatedT(const ImageView& prev, const ImageView& src, float t, const Params& params, const ImageRef& out) {
+    EstimateMotionT<T>(prev, src, params);
+
+    const float blockPx = (float)(Kernels::kMotionBlock * Kernels::kMotionLumaScale);
+    Kernels::MotionField field;
+    field.data = motionField_.data();
+    field.blocksX = Kernels::MotionBlocks(Kernels::MotionPlaneSize(src.width));
+    field.blocksY = Kernels::MotionBlocks(Kernels::MotionPlaneSize(src.height));
+    field.blockU = blockPx / (float)src.width;
+    field.blockV = blockPx / (float)src.height;
+
+    const T* depthA = PlaneAs<T>(interpDepth_[interpIndex_ ^ 1]);
+    const T* depthB = PlaneAs<T>(interpDepth_[interpIndex_]);
+    const uint32_t depthW = interpDepthW_[interpIndex_];
+    const uint32_t viewDepthW = (depthW != params.outWidth) ? depthW : 0;
+    ForEachTile(params.outWidth, params.outHeight, [&](const TileRect& r) {
+        for (uint32_t y = r.y0; y < r.y1; ++y) {
+            uint8_t* outRow = out.data + (size_t)y * out.stride;
+            for (uint32_t x = r.x0; x < r.x1; ++x) {
+                Kernels::InterpolatedSbsAt(prev, src, field, depthA, depthB, depthW, viewDepthW, params, t, x, y, outRow + (size_t)x * 4);
+            }
+        }
+    });
+}
+
+bool Engine::RenderInterpolated(const ImageView& prev, const ImageView& src, float t, const Params& params, const ImageRef& out) {
+    if (!interp_ || interpPictures_ < 2) return false;
+    if (!prev.data || !src.data || src.width == 0 || src.height == 0 || prev.width != src.width || prev.height != src.height) return false;
+    if (!out.data || out.width != params.outWidth || out.height != params.outHeight) return false;
+    // Kept planes must still be readable as precision_ elements (a precision change re-renders first).
+    const size_t bytes = (size_t)interpDepthW_[interpIndex_] * params.outHeight * DepthPrecisionBytes(precision_);
+    if (!SameParams(params, interpParams_[interpIndex_]) || interpDepth_[interpIndex_].size() != bytes) return false;
+
+    t = std::clamp(t, 0.0f, 1.0f);
+    WithDepthType(precision_, [&](auto zero) { RenderInterpolatedT<decltype(zero)>(prev, src, t, params, out); });
+    return true;
+}
+
+template <typename T>
+void Engine::RenderLayoutT(const ImageView& src, const Params& params, StereoLayout layout, const ImageRef& out) {
+    const T* depth = PlaneAs<T>(PictureDepth());
+    const uint32_t dw = depthWidth_;
+    const uint32_t viewDepthW = ViewDepthWidth();
+    if (layout == StereoLayout::HalfSbs && params.outWidth == width_ && params.outHeight == height_) {
+        ForEachTile(width_, height_, [&](const TileRect& r) { Kernels::ParallaxSbsRect(src, params, r, depth + (size_t)r.y0 * dw, dw, out, viewDepthW); });
+        return;
+    }
+    ForEachTile(out.width, out.height, [&](const TileRect& r) {
+        Kernels::LayoutRect(src, params, width_, height_, layout, r, depth, dw, viewDepthW, out);
+    });
+}
+
+bool Engine::RenderLayout(const ImageView& src, const Params& params, StereoLayout layout, const ImageRef& out) {
+    Params mapping = params;
+    mapping.outWidth = pictureParams_.outWidth;
+    mapping.outHeight = pictureParams_.outHeight;
+    if (!picture_ || !SameParams(mapping, pictureParams_)) return false;
+    if (!src.data || src.width == 0 || src.height == 0 || params.outWidth == 0 || params.outHeight == 0) return false;
+    uint32_t w = 0;
+    uint32_t h = 0;
+    GetLayoutSize(params, layout, &w, &h);
+    if (!out.data || out.width != w || out.height != h) return false;
+    if (width_ != pictureParams_.outWidth || height_ != pictureParams_.outHeight) return false;
+    if (PictureDepth().size() != (size_t)depthWidth_ * height_ * DepthPrecisionBytes(precision_)) return false;
+
+    WithDepthType(precision_, [&](auto zero) { RenderLayoutT<decltype(zero)>(src, params, layout, out); });
+    return true;
+}
+
+bool Engine::RenderLayoutPicture(const ImageView& src, const Params& params, const ImageRef& out) {
+    uint32_t w = 0;
+    uint32_t h = 0;
+    GetLayoutSize(params, layout_, &w, &h);
+    if (!src.data || !out.data || out.width != w || out.height != h) return false;
+    return RenderPicture(src, params, ImageRef{}, nullptr, 0) && RenderLayout(src, params, layout_, out);
+}
+
+bool Engine::Render(const ImageView& src, const Params& params, const ImageRef& out) {
+    if (layout_ != StereoLayout::HalfSbs) return RenderLayoutPicture(src, params, out);
+    if (letterbox_ && src.data) return RenderLetterboxed(src, params, out, nullptr, 0);
+    return RenderPicture(src, params, out, nullptr, 0);
+}
+
+bool Engine::RenderDirty(const ImageView& src, const Params& params, const ImageRef& out, const DirtyRect* rects, size_t count) {
+    static const DirtyRect kNone{};
+    if (!rects) rects = &kNone; // distinguishes an empty dirty list from Render()
+    if (layout_ != StereoLayout::HalfSbs) return RenderLayoutPicture(src, params, out);
+    if (letterbox_ && src.data) return RenderLetterboxed(src, params, out, rects, count);
+    return RenderPicture(src, params, out, rects, count);
+}
+
+bool Engine::RenderPicture(const ImageView& src, const Params& params, const ImageRef& out, const DirtyRect* rects, size_t count) {
+    picture_ = false;
+    if (!RenderPasses(src, params, out, rects, count)) return false;
+    picture_ = true;
+    pictureParams_ = params;
+    if (interp_ && out.data) KeepInterpolationDepth(params);
+    return true;
+}
+
+bool Engine::RenderPasses(const ImageView& src, const Params& params, const ImageRef& out, const DirtyRect* rects, size_t count) {
+    if (fovea_.enabled && params.outWidth != 0 && (params.outWidth % 2) == 0) return RenderFoveated(src, params, out);
+    if (!Resize(params.outWidth, params.outHeight)) return false;
+    if (scrollTracking_ && src.data) TrackScroll(src, params);
+    if (rects && out.data) {
+        dirty_.assign(rects, rects + count);
+        return RenderIncremental(src, params, out, false);
+    }
+    if (incremental_ && out.data) {
+        dirty_.clear();
+        return RenderIncremental(src, params, out, true);
+    }
+
+    // Full renders leave the incremental cache (output copy, tile flags) behind.
+    incValid_ = false;
+    if (mode_ == PipelineMode::Fused) return RenderFused(src, params, out);
+    if (pool_ && pool_->GetThreadCount() > 1) return RenderTiled(src, params, out);
+
+    if (!RunDepthRaw(src, params)) return false;
+    if (!RunDepthSmooth(params)) return false;
+    return !out.data || RunParallaxSbs(src, params, out);
+}
+
+} // namespace DepthCpu
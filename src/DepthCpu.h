@@ -0,0 +1,462 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class ThreadPool;
+
+// Portable CPU implementation of the DFL-S 3-pass depth pipeline.
+// Mirrors CSDepthRaw / CSDepthSmooth / CSParallaxSbs from 3PassShader.cpp on plain BGRA8 buffers,
+// so the math can be regression-tested and profiled without a D3D11 device.
+// NOTE: Keep this in sync with kThreePassHlsl; it is the golden model for the shader.
+namespace DepthCpu {
+
+struct TileRect;
+namespace Kernels { struct LumaPlane; struct FoveaLayout; }
+
+// Read-only BGRA8 image (same byte order as DXGI_FORMAT_B8G8R8A8_UNORM).
+struct ImageView {
+    const uint8_t* data = nullptr;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    size_t stride = 0; // bytes per row
+};
+
+// Writable BGRA8 image.
+struct ImageRef {
+    uint8_t* data = nullptr;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    size_t stride = 0; // bytes per row
+};
+
+// Mirrors the CSParams constant buffer consumed by the compute passes.
+struct Params {
+    uint32_t outWidth = 0;
+    uint32_t outHeight = 0;
+    int zoomLevel = 0;
+    float parallaxPx = 0.0f;
+
+    // Source crop in normalized UV (identity by default).
+    float cropOffset[2] = { 0.0f, 0.0f };
+    float cropScale[2] = { 1.0f, 1.0f };
+};
+
+// Output layout of pass 3 (mirrors CSParams::mode3d and Renderer::StereoLayout). The depth planes are
+// the same for all of them: passes 1 and 2 always run for the half-SBS canvas params.outWidth x
+// params.outHeight, and each layout resamples them at its own view size with the same disparity in
+// view UV (parallaxPx is per half-SBS view width).
+enum class StereoLayout {
+    // Left eye on top, right eye below: params.outWidth x params.outHeight (views outWidth x outHeight / 2).
+    OverUnder = 1,
+    // Two half-width views side by side: params.outWidth x params.outHeight.
+    HalfSbs = 2,
+    // Two full-width views side by side: 2 * params.outWidth x params.outHeight.
+    FullSbs = 3,
+    // The unshifted picture and, beside it, its depth as grey (the value the shift scales with):
+    // 2 * params.outWidth x params.outHeight. Lets the player do its own reprojection.
+    ImageDepth = 4,
+};
+
+const char* StereoLayoutName(StereoLayout layout);
+
+// Output image size of `layout` for `params`.
+void GetLayoutSize(const Params& params, StereoLayout layout, uint32_t* width, uint32_t* height);
+
+// Same mapping Renderer::Render uses to derive CSParams::parallaxPx.
+// - depthLevel: [0, 20]
+// - parallaxStrengthPercent: [0, 50]
+float ParallaxPxFromSettings(int depthLevel, int parallaxStrengthPercent);
+
+// Sets cropOffset/cropScale from a normalized source rect (same sanitizing as Renderer::SetSourceCropNormalized).
+void SetCropNormalized(Params& params, float left, float top, float right, float bottom);
+
+// Changed region of a source frame in source pixels, half-open (same layout as the RECTs
+// IDXGIOutputDuplication::GetFrameDirtyRects returns; pass move-rect destinations as dirty too).
+struct DirtyRect {
+    int32_t left = 0;
+    int32_t top = 0;
+    int32_t right = 0;
+    int32_t bottom = 0;
+};
+
+// Moved region of a source frame (same layout as DXGI_OUTDUPL_MOVE_RECT): the pixels now at `dest`
+// were at (sourceX, sourceY) + (x - dest.left, y - dest.top) in the previous frame.
+struct MoveRect {
+    int32_t sourceX = 0;
+    int32_t sourceY = 0;
+    DirtyRect dest;
+};
+
+// Per-row luma signature of `region` (sum of 64 evenly spaced samples' 8-bit luma), for EstimateScroll.
+void BuildRowProfile(const ImageView& src, const DirtyRect& region, std::vector<uint32_t>& profile);
+
+// Vertical scroll between two row profiles of the same region. Looks at the rows whose signature
+// changed, picks the shift (|dy| <= maxShift, positive = content moved down) under which most of them
+// match the previous frame exactly, and reports the span of matching rows as a move of region-relative
+// rows [top, bottom). False when nothing changed or no shift explains at least half of the changed rows.
+struct ScrollEstimate {
+    int32_t dy = 0;
+    int32_t top = 0;
+    int32_t bottom = 0;
+};
+bool EstimateScroll(const std::vector<uint32_t>& prev, const std::vector<uint32_t>& cur, int32_t maxShift, ScrollEstimate* est);
+
+// Picture inside uniform dark borders (letterbox / pillarbox bars) of `region`: the bounding box of the
+// pixels whose 8-bit luma exceeds `threshold`. False (and `active` untouched) when the whole region is
+// dark. `barBgra`, if set, receives the mean colour of the border pixels scanned (black if none).
+bool FindActiveRect(const ImageView& src, const DirtyRect& region, uint8_t threshold, DirtyRect* active, uint8_t* barBgra = nullptr);
+
+// Instruction set used by the runtime-dispatched kernels (see DepthCpuSimd.cpp).
+enum class SimdLevel {
+    Scalar = 0,
+    Sse41,
+    Avx2,
+    Avx512,
+    Neon,
+};
+
+const char* SimdLevelName(SimdLevel level);
+
+// Best level supported by both this build and the running CPU. Selected by default.
+SimdLevel GetBestSimdLevel();
+SimdLevel GetSimdLevel();
+
+// Forces a level (e.g. Scalar to compare against the reference). Returns false if unsupported.
+bool SetSimdLevel(SimdLevel level);
+
+// How Engine::Render schedules the passes (mirrors Renderer::StereoShaderMode).
+enum class PipelineMode {
+    // Three full-frame passes through depthRaw / depthSmooth planes (Depth3Pass).
+    ThreePass = 0,
+    // One sweep over row bands with a rolling window of rows and in-place history (DepthFused).
+    // Produces the same output; GetDepthRaw()/GetDepthSmooth() are not populated.
+    Fused = 1,
+};
+
+// Storage of the depth / history planes (mirrors Renderer::DepthPrecision).
+// Pass 1 always computes in float; the choice only affects what is kept between passes and frames.
+enum class DepthPrecision {
+    Float32 = 0,
+    // [0, 1] rounded to 16 / 8 bits (DXGI_FORMAT_R16_UNORM / R8_UNORM on the GPU).
+    Unorm16 = 1,
+    Unorm8 = 2,
+};
+
+const char* DepthPrecisionName(DepthPrecision precision);
+size_t DepthPrecisionBytes(DepthPrecision precision);
+
+// Foveated depth for headset output (Engine::SetFoveation). Radius and falloff are fractions of the
+// eye view's half-size, measured elliptically from its centre (1 = the view's edge midpoints).
+struct Foveation {
+    bool enabled = false;
+    float radius = 0.4f;
+    float falloff = 0.2f;
+    // Periphery depth resolution divisor: 2 or 4.
+    uint32_t peripheryScale = 2;
+};
+
+class Engine {
+public:
+    // Default tile: one 16-row thread-group band, 128 px wide (a multiple of every SIMD width).
+    static constexpr uint32_t kDefaultTileW = 128;
+    static constexpr uint32_t kDefaultTileH = 16;
+
+    // Upper bound on rows per band in PipelineMode::Fused.
+    static constexpr uint32_t kFusedBandH = 64;
+
+    // Incremental mode: source block size hashed to find changed regions (see SetIncremental).
+    static constexpr uint32_t kHashTile = 32;
+    // Default per-frame history change below which a tile counts as settled (1/64 of an 8-bit depth step).
+    static constexpr float kDefaultSettleThreshold = 1.0f / 16384.0f;
+
+    // Tiles touched by the last incremental frame (depth-plane tiles; out counts each tile once
+    // even when per-view depth also writes its mirror).
+    struct IncrementalStats {
+        uint32_t tiles = 0;
+        uint32_t rawTiles = 0;    // pass 1 re-run (source changed within reach)
+        uint32_t smoothTiles = 0; // pass 2 re-run (pass 1 re-run, or history not settled nearby)
+        uint32_t outTiles = 0;    // pass 3 re-run; the rest of the output is copied from the cache
+    };
+
+    void SetPipelineMode(PipelineMode mode);
+    PipelineMode GetPipelineMode() const { return mode_; }
+
+    // Per-view depth: both halves of the SBS output sample the same cropped source at the same
+    // half-width UVs, so passes 1 and 2 run once at single-eye resolution (outWidth / 2) and both
+    // parallax gathers read that one plane. Halves the depth work and the depth/history memory.
+    // Differs from the SBS-wide planes only at the two seam columns, whose horizontal smoothing
+    // neighbours now clamp to their own view instead of reaching into the other eye.
+    // Odd output widths keep the SBS-wide planes. Resets history when it changes the plane size.
+    void SetPerViewDepth(bool enabled);
+    bool GetPerViewDepth() const { return perViewDepth_; }
+
+    // Resets history when it changes (the planes are reallocated).
+    void SetDepthPrecision(DepthPrecision precision);
+    DepthPrecision GetDepthPrecision() const { return precision_; }
+
+    // Incremental rendering: Render() recomputes only the tiles whose inputs changed since the last
+    // frame, plus the tiles whose temporal EMA has not settled yet (it still moved their history by
+    // more than the settle threshold last frame, here or in a neighbouring tile). All other tiles keep
+    // their cached depth and SBS output. Changes come from RenderDirty(), or from hashing the source
+    // in kHashTile blocks when Render() is called. Always runs the tiled three-pass schedule (its
+    // raw/smooth planes are the cache), whatever the pipeline mode. Output matches a full render to
+    // within the settle threshold.
+    void SetIncremental(bool enabled) { incremental_ = enabled; }
+    bool GetIncremental() const { return incremental_; }
+    void SetSettleThreshold(float maxDelta) { settleThreshold_ = maxDelta; }
+    float GetSettleThreshold() const { return settleThreshold_; }
+    const IncrementalStats& GetIncrementalStats() const { return incStats_; }
+
+    // Scroll-aware history: translates the history planes along with content that moved, so a scrolled
+    // region keeps its converged depth instead of re-converging from misaligned history.
+    // ApplyMoveRects takes the moves of the frame about to be rendered (e.g. GetFrameMoveRects, in
+    // source pixels); call it right before Render(). With scroll tracking, Render()/RenderDirty() find
+    // vertical scrolls themselves from row profiles of the source (EstimateScroll) and apply them the
+    // same way. Incremental callers still report the moved destinations as dirty.
+    bool ApplyMoveRects(uint32_t srcW, uint32_t srcH, const Params& params, const MoveRect* moves, size_t count);
+    void SetScrollTracking(bool enabled);
+    bool GetScrollTracking() const { return scrollTracking_; }
+    // Vertical shift applied by scroll tracking on the last frame (0 = none), in source rows.
+    int32_t GetLastScroll() const { return lastScroll_; }
+
+    // Letterbox / pillarbox detection: Render()/RenderDirty() look for dark bars around the picture and
+    // run the passes only on the output rows (and, for even output widths, eye-view columns) showing
+    // it; the bars are filled with their own colour. Narrower bounds are adopted once FindActiveRect
+    // has reported them for kLetterboxConfirmFrames frames in a row (within kLetterboxSlack pixels);
+    // content reaching into a bar widens them at once. Depth history restarts whenever the picture's
+    // size changes, and the plane accessors below then describe the picture's planes.
+    static constexpr uint8_t kLetterboxThreshold = 24;
+    static constexpr int kLetterboxConfirmFrames = 24;
+    static constexpr int32_t kLetterboxSlack = 2;
+    void SetLetterboxDetection(bool enabled);
+    bool GetLetterboxDetection() const { return letterbox_; }
+    // Source pixels treated as the picture (the whole reachable source while no bars are in use).
+    const DirtyRect& GetLetterboxRect() const { return lbActive_; }
+
+    // Foveated depth: for even output widths, passes 1 and 2 run per view at full resolution only over
+    // the box around the view centre that radius + falloff reaches, and at 1/peripheryScale resolution
+    // over the whole view. The two are resolved into one per-view plane (the centre inside the radius,
+    // the bilinearly upsampled periphery past the falloff, blended across it) that pass 3 reads.
+    // Always three-pass (fused, incremental and scroll tracking do not apply); GetDepthSmooth() is the
+    // resolved plane and raw/history are not populated. Changing the settings restarts the history.
+    void SetFoveation(const Foveation& foveation);
+    const Foveation& GetFoveation() const { return fovea_; }
+
+    // Frame interpolation (view synthesis for sources slower than the display): while enabled, every
+    // Render()/RenderDirty() keeps the picture's smoothed depth, and RenderInterpolated() synthesizes
+    // the SBS output at phase t between the last two rendered pictures. `prev` and `src` must be the
+    // images those two renders received, and `params` what they were called with. Motion is estimated
+    // once per pair (block matching on 1/4-resolution luma, Kernels::MotionFineAt); each output pixel
+    // then warps both pictures and their depth along it before the parallax gather
+    // (Kernels::InterpolatedSbsAt). t = 0 reproduces prev's output and t = 1 src's (in Fused mode to
+    // within the history precision, which its pass 3 bypasses). Returns false
+    // (nothing written) until two pictures were rendered with the same params and plane layout, or
+    // while letterbox bars narrow the picture.
+    void SetFrameInterpolation(bool enabled);
+    bool GetFrameInterpolation() const { return interp_; }
+    bool RenderInterpolated(const ImageView& prev, const ImageView& src, float t, const Params& params, const ImageRef& out);
+
+    // Output layout Render()/RenderDirty() write; `out` must then be GetLayoutSize(params, layout).
+    // Layouts other than HalfSbs run passes 1 and 2 with the usual schedule and resample the planes
+    // with Kernels::LayoutRect instead of pass 3. Letterbox bars, the incremental output cache and
+    // frame interpolation are half-SBS only: the other layouts render the whole picture every frame.
+    void SetLayout(StereoLayout layout) { layout_ = layout; }
+    StereoLayout GetLayout() const { return layout_; }
+
+    // Resamples the depth of the picture the last Render()/RenderDirty() computed into `layout`
+    // without recomputing it, so one depth computation can feed any number of outputs. `src` must be
+    // what that call received and `params` its params, except that outWidth/outHeight may name
+    // another half-SBS canvas: each output can have its own size (the disparity scales with it).
+    // `out` must be GetLayoutSize(params, layout). Returns false (nothing written) before the first
+    // picture, or while letterbox bars narrow it.
+    bool RenderLayout(const ImageView& src, const Params& params, StereoLayout layout, const ImageRef& out);
+
+    // Optional pool for tiled multi-threaded execution (not owned; nullptr = run on the caller).
+    void SetThreadPool(ThreadPool* pool) { pool_ = pool; }
+    ThreadPool* GetThreadPool() const { return pool_; }
+
+    // Tile size used for scheduling; 0 keeps the current value.
+    void SetTileSize(uint32_t tileW, uint32_t tileH);
+
+    // Allocates history buffers (EnsureDepthStereoResources equivalent); the intermediate
+    // depth planes are allocated on first use by the three-pass path.
+    // History is reset to neutral whenever the size or element size changes.
+    bool Resize(uint32_t outW, uint32_t outH);
+    void ResetHistory();
+
+    // Runs all three passes. `out` must be params.outWidth x params.outHeight (in the HalfSbs layout).
+    bool Render(const ImageView& src, const Params& params, const ImageRef& out);
+
+    // Incremental render with the caller's list of changed source rects (an empty list = nothing
+    // changed), regardless of SetIncremental(). `out` may be a different buffer every frame.
+    bool RenderDirty(const ImageView& src, const Params& params, const ImageRef& out, const DirtyRect* rects, size_t count);
+
+    // Individual passes, in renderer order (always three-pass). RunDepthSmooth advances the history ping-pong.
+    bool RunDepthRaw(const ImageView& src, const Params& params);
+    bool RunDepthSmooth(const Params& params);
+    bool RunParallaxSbs(const ImageView& src, const Params& params, const ImageRef& out);
+
+    uint32_t GetWidth() const { return width_; }
+    uint32_t GetHeight() const { return height_; }
+
+    // Width of the depth planes: GetWidth(), or GetWidth() / 2 with per-view depth.
+    uint32_t GetDepthWidth() const { return depthWidth_; }
+
+    // Row-major planes of GetDepthWidth() x GetHeight() (raw/smooth are empty in Fused mode).
+    // Elements are float, uint16_t or uint8_t per GetDepthPrecision() (see Kernels::LoadDepth).
+    const void* GetDepthRaw() const { return depthRaw_.data(); }
+    const void* GetDepthSmooth() const { return depthSmooth_.data(); }
+    const void* GetDepthHistory() const { return depthPrev_[depthPrevIndex_ & 1].data(); }
+
+private:
+    bool CheckParams(const Params& params) const;
+    // Render()/RenderDirty() on the given (possibly letterbox-narrowed) params; rects == nullptr = Render().
+    bool RenderPicture(const ImageView& src, const Params& params, const ImageRef& out, const DirtyRect* rects, size_t count);
+    // out.data == nullptr runs passes 1 and 2 only (the layouts other than HalfSbs).
+    bool RenderPasses(const ImageView& src, const Params& params, const ImageRef& out, const DirtyRect* rects, size_t count);
+    // Render()/RenderDirty() in a layout other than HalfSbs: the depth passes, then RenderLayout().
+    bool RenderLayoutPicture(const ImageView& src, const Params& params, const ImageRef& out);
+    template <typename T> void RenderLayoutT(const ImageView& src, const Params& params, StereoLayout layout, const ImageRef& out);
+    // Smoothed depth of the last picture: the history in every schedule but foveation, whose resolved
+    // plane is depthSmooth_.
+    const std::vector<uint8_t>& PictureDepth() const;
+    // Frame interpolation: copies the smoothed depth of the picture just rendered with `params`.
+    void KeepInterpolationDepth(const Params& params);
+    // Motion field between the two kept pictures (once per pair).
+    template <typename T> void EstimateMotionT(const ImageView& prev, const ImageView& src, const Params& params);
+    template <typename T> void RenderInterpolatedT(const ImageView& prev, const ImageView& src, float t, const Params& params, const ImageRef& out);
+    // Letterbox step: updates lbActive_, renders the picture's part of `out` and fills the bars.
+    bool RenderLetterboxed(const ImageView& src, const Params& params, const ImageRef& out, const DirtyRect* rects, size_t count);
+    void UpdateLetterbox(const ImageView& src, const DirtyRect& region);
+    // Foveation step of RenderPicture(): depth passes on the two child engines, resolve into
+    // depthSmooth_, then pass 3.
+    bool RenderFoveated(const ImageView& src, const Params& params, const ImageRef& out);
+    template <typename T> void ResolveFoveaT(const Kernels::FoveaLayout& f);
+    // Scroll tracking step of Render()/RenderDirty(): profiles the source and applies a found scroll.
+    void TrackScroll(const ImageView& src, const Params& params);
+    template <typename T> void ShiftHistoryT(uint32_t srcW, uint32_t srcH, const Params& params, const MoveRect* moves, size_t count, std::vector<TileRect>& shifted);
+    void EnsurePlanes();
+    // Typed bodies of the public passes / schedules; T is the plane element for precision_.
+    template <typename T> void RunDepthRawT(const ImageView& src, const Params& params);
+    template <typename T> void RunDepthSmoothT();
+    template <typename T> void RunParallaxSbsT(const ImageView& src, const Params& params, const ImageRef& out);
+    template <typename T> void RenderTiledT(const ImageView& src, const Params& params, const ImageRef& out);
+    template <typename T> void RenderFusedT(const ImageView& src, const Params& params, const ImageRef& out);
+    template <typename T> void RenderIncrementalT(const ImageView& src, const Params& params, const ImageRef& out, const std::vector<DirtyRect>* lumaRects);
+    bool RenderTiled(const ImageView& src, const Params& params, const ImageRef& out);
+    bool RenderFused(const ImageView& src, const Params& params, const ImageRef& out);
+    // Changed rects are in dirty_, or found by hashing the source when `hashSource` is set.
+    bool RenderIncremental(const ImageView& src, const Params& params, const ImageRef& out, bool hashSource);
+    // Appends the source blocks whose hash differs from the last call to dirty_ (all of them if the
+    // size changed), merged into runs along each block row.
+    void HashSource(const ImageView& src);
+    // Sets the raw/out flags of the depth tiles whose pass 1 / pass 3 can read source rect `r`.
+    void MarkDirtyTiles(const DirtyRect& r, uint32_t srcW, uint32_t srcH, const Params& params);
+    // Converts the source texels pass 1 can reach to 16-bit luma (once per frame, row-parallel).
+    // With `rects`, only the texels inside them are converted and the rest is kept from the last frame.
+    Kernels::LumaPlane ExtractLuma(const ImageView& src, const Params& params, const std::vector<DirtyRect>* rects = nullptr);
+    // Tiles/rects covering a w x h plane (output or depth).
+    void ForEachTile(uint32_t w, uint32_t h, const std::function<void(const TileRect&)>& fn);
+    void ForEachRect(uint32_t w, uint32_t h, uint32_t rectW, uint32_t rectH, const std::function<void(const TileRect&)>& fn);
+    // ParallaxSbsRect's viewDepthW: the eye width when the planes are per-view, else 0.
+    uint32_t ViewDepthWidth() const { return depthWidth_ != width_ ? depthWidth_ : 0; }
+
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    uint32_t depthWidth_ = 0;
+    bool perViewDepth_ = false;
+    DepthPrecision precision_ = DepthPrecision::Float32;
+
+    // Raw bytes; element type follows precision_.
+    std::vector<uint8_t> depthRaw_;
+    std::vector<uint8_t> depthSmooth_;
+    std::vector<uint8_t> depthPrev_[2];
+    int depthPrevIndex_ = 0;
+
+    // Pass 1 input (see ExtractLuma); sized to the reachable source rect, reused across frames.
+    std::vector<uint16_t> luma_;
+
+    PipelineMode mode_ = PipelineMode::ThreePass;
+    StereoLayout layout_ = StereoLayout::HalfSbs;
+
+    // Params of the last picture the planes hold (RenderLayout).
+    bool picture_ = false;
+    Params pictureParams_;
+
+    // Fused mode: per-band raw row (float) and halo rows + rolling window (history elements).
+    std::vector<float> fusedRaw_;
+    std::vector<uint8_t> fusedHist_;
+
+    ThreadPool* pool_ = nullptr;
+    uint32_t tileW_ = kDefaultTileW;
+    uint32_t tileH_ = kDefaultTileH;
+
+    // Pass-1 tiles still outstanding per tile row (RenderTiled).
+    std::unique_ptr<std::atomic<uint32_t>[]> rowPending_;
+    uint32_t rowPendingCount_ = 0;
+
+    // Incremental mode (see SetIncremental). incValid_ is cleared by anything that leaves the planes,
+    // luma or output cache out of step with the tile flags (resize, history reset, full renders).
+    bool incremental_ = false;
+    bool incValid_ = false;
+    float settleThreshold_ = kDefaultSettleThreshold;
+    Params incParams_;
+    uint32_t incSrcW_ = 0;
+    uint32_t incSrcH_ = 0;
+    std::vector<uint8_t> tileFlags_; // kTile* bits per depth tile, row-major
+    std::vector<uint8_t> outCache_;  // last SBS output, width_ x height_ BGRA8
+    std::vector<uint64_t> srcHash_;  // per kHashTile source block
+    std::vector<uint8_t> blockChanged_;
+    uint32_t hashW_ = 0; // source size srcHash_ was built for (0 = none)
+    uint32_t hashH_ = 0;
+    std::vector<DirtyRect> dirty_;
+    IncrementalStats incStats_;
+
+    // Scroll tracking: row profile of the last frame's reachable source rect (scrollRegion_).
+    bool scrollTracking_ = false;
+    std::vector<uint32_t> scrollProfile_;
+    std::vector<uint32_t> scrollProfilePrev_;
+    DirtyRect scrollRegion_;
+    uint32_t scrollSrcW_ = 0;
+    uint32_t scrollSrcH_ = 0;
+    int32_t lastScroll_ = 0;
+
+    // Letterbox detection: adopted picture rect, the narrower candidate being confirmed, and the
+    // scratch SBS image a pillarboxed picture is rendered to before its views are placed.
+    bool letterbox_ = false;
+    DirtyRect lbRegion_;
+    DirtyRect lbActive_;
+    DirtyRect lbCandidate_;
+    int lbCandidateFrames_ = 0;
+    uint8_t lbBarColor_[4] = { 0, 0, 0, 255 };
+    std::vector<uint8_t> lbScratch_;
+
+    // Frame interpolation: smoothed depth of the last two pictures (interpDepth_[interpIndex_] is the
+    // newer), what they were rendered with, and the motion between them (4 floats per fine block).
+    bool interp_ = false;
+    std::vector<uint8_t> interpDepth_[2];
+    Params interpParams_[2];
+    uint32_t interpDepthW_[2] = { 0, 0 };
+    int interpIndex_ = 0;
+    uint32_t interpPictures_ = 0; // kept pictures whose layout matches the newest (0..2)
+    uint64_t interpSeq_ = 0;      // pictures kept so far; the motion field belongs to motionSeq_
+    uint64_t motionSeq_ = 0;
+    uint32_t motionSrcW_ = 0;
+    uint32_t motionSrcH_ = 0;
+    std::vector<float> motionFine_[2]; // prev, src
+    std::vector<float> motionCoarse_[2];
+    std::vector<int32_t> motionCoarseField_; // 2 ints per coarse block
+    std::vector<float> motionField_;
+
+    // Foveation: per-view engines holding the centre and periphery planes and their history.
+    Foveation fovea_;
+    std::unique_ptr<Engine> fovCentre_;
+    std::unique_ptr<Engine> fovPeriphery_;
+};
+
+} // namespace DepthCpu
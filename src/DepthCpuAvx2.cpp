@@ -0,0 +1,69 @@
+// AVX2 build of the luma and PASS 1 kernels (8 pixels per iteration).
+// Compiled with -mavx2 on GCC/Clang and /arch:AVX2 on MSVC; only called when the CPU reports AVX2.
+
+#include "DepthCpuSimd.h"
+#include "DepthCpuSimdKernel.h"
+
+#include <immintrin.h>
+
+namespace DepthCpu {
+namespace {
+
+struct IsaAvx2 {
+    using F = __m256;
+    using I = __m256i;
+    static constexpr int kLanes = 8;
+
+    static F Set1(float v) { return _mm256_set1_ps(v); }
+    static F Load(const float* p) { return _mm256_loadu_ps(p); }
+    static void Store(float* p, F v) { _mm256_storeu_ps(p, v); }
+
+    static F Add(F a, F b) { return _mm256_add_ps(a, b); }
+    static F Sub(F a, F b) { return _mm256_sub_ps(a, b); }
+    static F Mul(F a, F b) { return _mm256_mul_ps(a, b); }
+    static F Div(F a, F b) { return _mm256_div_ps(a, b); }
+    static F Min(F a, F b) { return _mm256_min_ps(a, b); }
+    static F Max(F a, F b) { return _mm256_max_ps(a, b); }
+    static F Abs(F a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static F Floor(F a) { return _mm256_floor_ps(a); }
+
+    static I SetI(int32_t v) { return _mm256_set1_epi32(v); }
+    static I AddI(I a, I b) { return _mm256_add_epi32(a, b); }
+    static I SubI(I a, I b) { return _mm256_sub_epi32(a, b); }
+    static I MinI(I a, I b) { return _mm256_min_epi32(a, b); }
+    static I MaxI(I a, I b) { return _mm256_max_epi32(a, b); }
+    static I ToInt(F a) { return _mm256_cvttps_epi32(a); }
+    static F ToFloat(I a) { return _mm256_cvtepi32_ps(a); }
+    static F GatherF(const float* base, I idx) { return _mm256_i32gather_ps(base, idx, 4); }
+
+    static void LoadBgra(const uint8_t* p, F& b, F& g, F& r) {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        const __m256i m = _mm256_set1_epi32(0xFF);
+        b = _mm256_cvtepi32_ps(_mm256_and_si256(v, m));
+        g = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(v, 8), m));
+        r = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(v, 16), m));
+    }
+    static void StoreU16(uint16_t* p, F v) {
+        const __m256i i = _mm256_cvttps_epi32(_mm256_add_ps(v, _mm256_set1_ps(0.5f)));
+        const __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(i), _mm256_extracti128_si256(i, 1));
+        _mm_storeu_si128((__m128i*)p, packed);
+    }
+    static void LoadTexelPairs(const uint16_t* row, I x, F& lo, F& hi) {
+        // One 32-bit gather per lane picks up both texels (little-endian: row[x] in the low half).
+        const __m256i v = _mm256_i32gather_epi32((const int*)row, x, 2);
+        lo = _mm256_cvtepi32_ps(_mm256_and_si256(v, _mm256_set1_epi32(0xFFFF)));
+        hi = _mm256_cvtepi32_ps(_mm256_srli_epi32(v, 16));
+    }
+};
+
+} // namespace
+
+void Simd::DepthRawRectAvx2(const Kernels::LumaPlane& luma, const Params& p, const TileRect& r, float* dst, size_t dstStride) {
+    SimdKernel::DepthRawRect<IsaAvx2>(luma, p, r, dst, dstStride);
+}
+
+void Simd::LumaRowAvx2(const uint8_t* bgra, uint16_t* dst, uint32_t n) {
+    SimdKernel::LumaRow<IsaAvx2>(bgra, dst, n);
+}
+
+} // namespace DepthCpu
@@ -0,0 +1,69 @@
+// AVX-512F build of the luma and PASS 1 kernels (16 pixels per iteration).
+// Compiled with -mavx512f on GCC/Clang and /arch:AVX512 on MSVC; only called when the CPU and OS support AVX-512.
+
+#include "DepthCpuSimd.h"
+#include "DepthCpuSimdKernel.h"
+
+#include <immintrin.h>
+
+namespace DepthCpu {
+namespace {
+
+struct IsaAvx512 {
+    using F = __m512;
+    using I = __m512i;
+    static constexpr int kLanes = 16;
+
+    static F Set1(float v) { return _mm512_set1_ps(v); }
+    static F Load(const float* p) { return _mm512_loadu_ps(p); }
+    static void Store(float* p, F v) { _mm512_storeu_ps(p, v); }
+
+    static F Add(F a, F b) { return _mm512_add_ps(a, b); }
+    static F Sub(F a, F b) { return _mm512_sub_ps(a, b); }
+    static F Mul(F a, F b) { return _mm512_mul_ps(a, b); }
+    static F Div(F a, F b) { return _mm512_div_ps(a, b); }
+    static F Min(F a, F b) { return _mm512_min_ps(a, b); }
+    static F Max(F a, F b) { return _mm512_max_ps(a, b); }
+    static F Abs(F a) { return _mm512_abs_ps(a); }
+    static F Floor(F a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+
+    static I SetI(int32_t v) { return _mm512_set1_epi32(v); }
+    static I AddI(I a, I b) { return _mm512_add_epi32(a, b); }
+    static I SubI(I a, I b) { return _mm512_sub_epi32(a, b); }
+    static I MinI(I a, I b) { return _mm512_min_epi32(a, b); }
+    static I MaxI(I a, I b) { return _mm512_max_epi32(a, b); }
+    static I ToInt(F a) { return _mm512_cvttps_epi32(a); }
+    static F ToFloat(I a) { return _mm512_cvtepi32_ps(a); }
+    static F GatherF(const float* base, I idx) { return _mm512_i32gather_ps(idx, base, 4); }
+
+    static void LoadBgra(const uint8_t* p, F& b, F& g, F& r) {
+        const __m512i v = _mm512_loadu_si512(p);
+        const __m512i m = _mm512_set1_epi32(0xFF);
+        b = _mm512_cvtepi32_ps(_mm512_and_si512(v, m));
+        g = _mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srli_epi32(v, 8), m));
+        r = _mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srli_epi32(v, 16), m));
+    }
+    static void StoreU16(uint16_t* p, F v) {
+        // Saturating dword -> word narrowing (vpmovusdw is AVX-512F).
+        const __m512i i = _mm512_max_epi32(_mm512_cvttps_epi32(_mm512_add_ps(v, _mm512_set1_ps(0.5f))), _mm512_setzero_si512());
+        _mm256_storeu_si256((__m256i*)p, _mm512_cvtusepi32_epi16(i));
+    }
+    static void LoadTexelPairs(const uint16_t* row, I x, F& lo, F& hi) {
+        // One 32-bit gather per lane picks up both texels (little-endian: row[x] in the low half).
+        const __m512i v = _mm512_i32gather_epi32(x, (const void*)row, 2);
+        lo = _mm512_cvtepi32_ps(_mm512_and_si512(v, _mm512_set1_epi32(0xFFFF)));
+        hi = _mm512_cvtepi32_ps(_mm512_srli_epi32(v, 16));
+    }
+};
+
+} // namespace
+
+void Simd::DepthRawRectAvx512(const Kernels::LumaPlane& luma, const Params& p, const TileRect& r, float* dst, size_t dstStride) {
+    SimdKernel::DepthRawRect<IsaAvx512>(luma, p, r, dst, dstStride);
+}
+
+void Simd::LumaRowAvx512(const uint8_t* bgra, uint16_t* dst, uint32_t n) {
+    SimdKernel::LumaRow<IsaAvx512>(bgra, dst, n);
+}
+
+} // namespace DepthCpu
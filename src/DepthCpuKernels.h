@@ -0,0 +1,975 @@
+#pragma once
+
+// Internal scalar kernels shared by the CPU depth engine.
+// Each helper is a line-for-line port of the HLSL in 3PassShader.cpp; keep them in sync.
+//
+// NOTE: Everything here has internal linkage (static inline) and avoids std::min/std::max.
+// The SIMD translation units include this header while being compiled with ISA-specific flags;
+// a shared (COMDAT) definition could otherwise leak AVX instructions into scalar callers.
+
+#include "DepthCpu.h"
+
+#include <cmath>
+#include <cstdint>
+
+namespace DepthCpu {
+
+// Half-open pixel rect in output space.
+struct TileRect {
+    uint32_t x0 = 0;
+    uint32_t y0 = 0;
+    uint32_t x1 = 0;
+    uint32_t y1 = 0;
+};
+
+namespace Kernels {
+
+// ------------------------------------------------------------
+// HLSL intrinsics
+// ------------------------------------------------------------
+static inline float Saturate(float v) {
+    if (v < 0.0f) return 0.0f;
+    if (v > 1.0f) return 1.0f;
+    return v;
+}
+
+static inline float MinF(float a, float b) { return (b < a) ? b : a; }
+static inline float MaxF(float a, float b) { return (a < b) ? b : a; }
+static inline int ClampI(int v, int lo, int hi) { return (v < lo) ? lo : ((v > hi) ? hi : v); }
+static inline uint32_t MaxU(uint32_t a, uint32_t b) { return (a < b) ? b : a; }
+static inline uint32_t MinU(uint32_t a, uint32_t b) { return (b < a) ? b : a; }
+
+static inline float Lerp(float a, float b, float t) {
+    return a + t * (b - a);
+}
+
+static inline float Smoothstep(float e0, float e1, float x) {
+    const float t = Saturate((x - e0) / (e1 - e0));
+    return t * t * (3.0f - 2.0f * t);
+}
+
+static inline float Luma(float r, float g, float b) {
+    // Match historical DepthStereoShader coefficients.
+    return r * 0.299f + g * 0.587f + b * 0.114f;
+}
+
+// ------------------------------------------------------------
+// Sampling (D3D11 MIN_MAG_MIP_LINEAR + CLAMP, as created in Renderer::Init)
+// ------------------------------------------------------------
+static inline void SampleBilinear(const ImageView& src, float u, float v, float outRgba[4]) {
+    const float x = u * (float)src.width - 0.5f;
+    const float y = v * (float)src.height - 0.5f;
+    const float fx0 = std::floor(x);
+    const float fy0 = std::floor(y);
+    const float fx = x - fx0;
+    const float fy = y - fy0;
+
+    const int maxX = (int)src.width - 1;
+    const int maxY = (int)src.height - 1;
+    const int x0 = ClampI((int)fx0, 0, maxX);
+    const int y0 = ClampI((int)fy0, 0, maxY);
+    const int x1 = ClampI((int)fx0 + 1, 0, maxX);
+    const int y1 = ClampI((int)fy0 + 1, 0, maxY);
+
+    const uint8_t* r0 = src.data + (size_t)y0 * src.stride;
+    const uint8_t* r1 = src.data + (size_t)y1 * src.stride;
+    const uint8_t* p00 = r0 + (size_t)x0 * 4;
+    const uint8_t* p10 = r0 + (size_t)x1 * 4;
+    const uint8_t* p01 = r1 + (size_t)x0 * 4;
+    const uint8_t* p11 = r1 + (size_t)x1 * 4;
+
+    const float w00 = (1.0f - fx) * (1.0f - fy);
+    const float w10 = fx * (1.0f - fy);
+    const float w01 = (1.0f - fx) * fy;
+    const float w11 = fx * fy;
+
+    // BGRA8 in memory -> RGBA out.
+    static const int kSwizzle[4] = { 2, 1, 0, 3 };
+    for (int c = 0; c < 4; ++c) {
+        const int s = kSwizzle[c];
+        const float v0 = (float)p00[s] * w00 + (float)p10[s] * w10 + (float)p01[s] * w01 + (float)p11[s] * w11;
+        outRgba[c] = v0 * (1.0f / 255.0f);
+    }
+}
+
+// ------------------------------------------------------------
+// Planar luma (pass 1 input)
+// ------------------------------------------------------------
+// Luma of the source at 16 bits: round(Luma() * 257), so 65535 is white and a texel's luma is
+// converted from BGRA once per frame instead of once per bilinear tap (5 taps x 4 texels).
+// Only the texels pass 1 can reach are converted; `data` addresses texel (x0, y0). One more element
+// must be readable past the last texel: the SIMD pass 1 loads texel pairs (x, x + 1) and ignores the
+// second where the edge clamps, including at the plane's last texel.
+struct LumaPlane {
+    const uint16_t* data = nullptr;
+    size_t stride = 0; // elements per row
+    uint32_t width = 0; // full source size (the sampler clamps to it, like the texture)
+    uint32_t height = 0;
+    uint32_t x0 = 0;
+    uint32_t y0 = 0;
+};
+
+static inline uint16_t LumaU16(uint8_t b, uint8_t g, uint8_t r) {
+    return (uint16_t)(Luma((float)r, (float)g, (float)b) * 257.0f + 0.5f);
+}
+
+// `n` BGRA8 pixels -> `n` LumaU16 values.
+static inline void LumaRow(const uint8_t* bgra, uint16_t* dst, uint32_t n) {
+    for (uint32_t i = 0; i < n; ++i) {
+        dst[i] = LumaU16(bgra[i * 4 + 0], bgra[i * 4 + 1], bgra[i * 4 + 2]);
+    }
+}
+
+// Source texels PASS 1 can touch for `p` (crop, plus one tap step and the bilinear footprint, plus
+// a texel of slack for float rounding), clamped to the srcW x srcH image. Half-open.
+static inline TileRect LumaSourceRect(uint32_t srcW, uint32_t srcH, const Params& p) {
+    // The narrower eye (left on odd widths) has the widest tap step.
+    const float stepU = p.cropScale[0] / (float)MaxU(1u, p.outWidth / 2);
+    const float stepV = p.cropScale[1] / (float)MaxU(1u, p.outHeight);
+    const float u0 = p.cropOffset[0] - stepU;
+    const float u1 = p.cropOffset[0] + p.cropScale[0] + stepU;
+    const float v0 = p.cropOffset[1] - stepV;
+    const float v1 = p.cropOffset[1] + p.cropScale[1] + stepV;
+
+    const int maxX = (int)srcW - 1;
+    const int maxY = (int)srcH - 1;
+    TileRect r;
+    r.x0 = (uint32_t)ClampI((int)std::floor(u0 * (float)srcW - 0.5f) - 1, 0, maxX);
+    r.y0 = (uint32_t)ClampI((int)std::floor(v0 * (float)srcH - 0.5f) - 1, 0, maxY);
+    r.x1 = (uint32_t)ClampI((int)std::floor(u1 * (float)srcW - 0.5f) + 2, 0, maxX) + 1;
+    r.y1 = (uint32_t)ClampI((int)std::floor(v1 * (float)srcH - 0.5f) + 2, 0, maxY) + 1;
+    return r;
+}
+
+// Luma(SampleBilinear(...).rgb) read from the luma plane: luma is linear, so weight the texel lumas directly.
+static inline float SampleLuma(const LumaPlane& luma, float u, float v) {
+    const float x = u * (float)luma.width - 0.5f;
+    const float y = v * (float)luma.height - 0.5f;
+    const float fx0 = std::floor(x);
+    const float fy0 = std::floor(y);
+    const float fx = x - fx0;
+    const float fy = y - fy0;
+
+    const int maxX = (int)luma.width - 1;
+    const int maxY = (int)luma.height - 1;
+    const int x0 = ClampI((int)fx0, 0, maxX) - (int)luma.x0;
+    const int y0 = ClampI((int)fy0, 0, maxY) - (int)luma.y0;
+    const int x1 = ClampI((int)fx0 + 1, 0, maxX) - (int)luma.x0;
+    const int y1 = ClampI((int)fy0 + 1, 0, maxY) - (int)luma.y0;
+
+    const uint16_t* r0 = luma.data + (size_t)y0 * luma.stride;
+    const uint16_t* r1 = luma.data + (size_t)y1 * luma.stride;
+    const float l00 = (float)r0[x0];
+    const float l10 = (float)r0[x1];
+    const float l01 = (float)r1[x0];
+    const float l11 = (float)r1[x1];
+
+    const float top = l00 + fx * (l10 - l00);
+    const float bottom = l01 + fx * (l11 - l01);
+    return (top + fy * (bottom - top)) * (1.0f / 65535.0f);
+}
+
+// EyeMapping() from the shader: splits the output width into two half-SBS views.
+struct EyeMap {
+    bool rightEye;
+    uint32_t localX;
+    uint32_t viewW;
+    float u;
+    float v;
+};
+
+static inline EyeMap EyeMapping(const Params& p, uint32_t x, uint32_t y) {
+    const uint32_t leftW = p.outWidth / 2;
+    const uint32_t rightW = p.outWidth - leftW;
+
+    EyeMap m;
+    m.rightEye = (x >= leftW);
+    m.viewW = m.rightEye ? rightW : leftW;
+    m.localX = m.rightEye ? (x - leftW) : x;
+    m.u = ((float)m.localX + 0.5f) / (float)MaxU(1u, m.viewW);
+    m.v = ((float)y + 0.5f) / (float)MaxU(1u, p.outHeight);
+    return m;
+}
+
+// ------------------------------------------------------------
+// PASS 1 tone curve: everything between g_soft and depth_aggression depends on g_soft alone
+// (the 5-layer curve blend and the dark-push shaping), so it is tabulated once and linearly
+// interpolated instead of running 5 pow() + 5 smoothstep() per pixel. g_soft stays in [0, 1]:
+// it only mixes luma taps, mid grey and a 0.92 scale of itself.
+// ------------------------------------------------------------
+// Entries over [0, 1], both ends included. Must match kToneLutSize in 3PassShader.cpp.
+static constexpr uint32_t kToneCurveLutSize = 1024;
+
+// Analytic form (the shader's original CURVE LAYERS / DEPTH SHAPING blocks); used to build the table.
+static inline void ToneCurveAt(float g_soft, float* curveBlend, float* shaped) {
+    const float dark_push = std::pow(1.0f - g_soft, 2.0f);
+
+    const float t = Saturate(g_soft);
+
+    const float b_near1 = std::pow(t, 0.22f);
+    const float b_near2 = std::pow(t, 0.50f);
+    const float b_mid = std::pow(t, 0.90f);
+    const float b_far1 = std::pow(1.0f - t, 1.55f);
+    const float b_far2 = std::pow(1.0f - t, 2.65f);
+
+    const float w_near1 = Smoothstep(0.00f, 0.40f, t);
+    const float w_near2 = Smoothstep(0.10f, 0.60f, t);
+    const float w_mid = Smoothstep(0.20f, 0.80f, t);
+    const float w_far1 = Smoothstep(0.15f, 0.85f, 1.0f - t);
+    const float w_far2 = Smoothstep(0.35f, 1.00f, 1.0f - t);
+
+    const float w_sum = w_near1 + w_near2 + w_mid + w_far1 + w_far2 + 1e-6f;
+
+    const float d_near1 = b_near1;
+    const float d_near2 = b_near2;
+    const float d_mid = b_mid;
+    const float d_far1 = 1.0f - b_far1;
+    const float d_far2 = 1.0f - b_far2;
+
+    const float curve_blend = (
+        d_near1 * w_near1 +
+        d_near2 * w_near2 +
+        d_mid * w_mid +
+        d_far1 * w_far1 +
+        d_far2 * w_far2
+    ) / w_sum;
+
+    // === DEPTH SHAPING USING BLENDED CURVE ===
+    *curveBlend = curve_blend;
+    *shaped = Lerp(curve_blend, dark_push, 1.00f - g_soft);
+}
+
+// Fills kToneCurveLutSize (curveBlend, shaped) pairs; the renderer uploads the same table.
+static inline void BuildToneCurveLut(float* lut) {
+    for (uint32_t i = 0; i < kToneCurveLutSize; ++i) {
+        ToneCurveAt((float)i / (float)(kToneCurveLutSize - 1), &lut[i * 2 + 0], &lut[i * 2 + 1]);
+    }
+}
+
+static inline void ToneCurveLookup(const float* lut, float g_soft, float* curveBlend, float* shaped) {
+    const float x = Saturate(g_soft) * (float)(kToneCurveLutSize - 1);
+    const uint32_t i = MinU((uint32_t)x, kToneCurveLutSize - 2);
+    const float f = x - (float)i;
+    const float* e = lut + (size_t)i * 2;
+    *curveBlend = Lerp(e[0], e[2], f);
+    *shaped = Lerp(e[1], e[3], f);
+}
+
+// The engine's table (built once, in DepthCpu.cpp; shared by the scalar and SIMD kernels).
+const float* ToneCurveLut();
+
+// ------------------------------------------------------------
+// PASS 1 body: depth from the 5 luma taps (centre, left, right, up, down).
+// ------------------------------------------------------------
+static inline float DepthFromLumaTaps(float gC, float gL, float gR, float gU, float gD) {
+    const float c = MaxF(MaxF(std::fabs(gC - gL), std::fabs(gC - gR)), MaxF(std::fabs(gC - gU), std::fabs(gC - gD)));
+
+    // === STRUCTURE PROTECTION MASK ===
+    const float structure = Smoothstep(0.12f, 0.35f, c);
+    const float depth_aggression = Lerp(0.55f, 0.35f, structure);
+
+    // 5-tap cross smoothing
+    const float g_avg = (gC + gL + gR + gU + gD) * 0.2f;
+
+    const float w = 1.0f - Smoothstep(0.05f, 0.25f, c);
+    float g_soft = Lerp(gC, g_avg, w);
+
+    // stronger edge softening
+    const float soften = Smoothstep(0.10f, 0.35f, c);
+    const float g_edge_avg = (gC + gL + gR + gU + gD) * 0.2f;
+    g_soft = Lerp(g_soft, g_edge_avg, soften * 0.90f);
+
+    // toroidal grayscale field
+    const float mid_gray = 0.5f;
+    const float dist = std::fabs(g_soft - mid_gray);
+    const float torus = 1.0f - Smoothstep(0.0f, 0.025f, dist);
+    g_soft = Lerp(g_soft, mid_gray, torus * 0.50f);
+
+    // specular light pop
+    const float highlight = Smoothstep(0.78f, 0.95f, g_soft);
+    const float contrast = Smoothstep(0.12f, 0.32f, c);
+    const float spec_pop = highlight * contrast;
+    g_soft = Lerp(g_soft, g_soft * 0.92f, spec_pop * 0.15f);
+
+    // === CURVE LAYERS (5-layer depth) + DEPTH SHAPING, tabulated (see ToneCurveAt) ===
+    float curve_blend;
+    float depth;
+    ToneCurveLookup(ToneCurveLut(), g_soft, &curve_blend, &depth);
+
+    depth = (depth - 0.5f) * depth_aggression + 0.5f;
+    depth = Lerp(depth, curve_blend, 0.040f);
+    depth = (depth - 0.5f) * depth_aggression + 0.5f;
+
+    // ripple reduction
+    const float lc_soft = Smoothstep(0.030f, 0.004f, c);
+    depth += lc_soft * 0.0000010f;
+
+    // bright noise dampening
+    const float noise_energy = c * g_soft;
+    const float noise_mask = Smoothstep(0.35f, 0.75f, noise_energy);
+    depth = Lerp(depth, depth * 0.20f, noise_mask * 0.18f);
+
+    // flat-region depth boost
+    const float flatness = 1.0f - Smoothstep(0.05f, 0.10f, c);
+    const float boost_flat = Lerp(1.10f, 1.05f, flatness);
+    const float depth_mid = 0.5f;
+    depth = (depth - depth_mid) * boost_flat + depth_mid;
+
+    // non-flat boost
+    const float boost_nonflat = Lerp(1.10f, 1.05f, flatness);
+    depth = (depth - depth_mid) * boost_nonflat + depth_mid;
+
+    return Saturate(depth);
+}
+
+// ------------------------------------------------------------
+// PASS 2 body: temporal EMA + micro-clamp + spatial smoothing against history.
+// v1/v2 are history below/above, h1/h2 are history right/left (edge-clamped).
+// ------------------------------------------------------------
+static inline float SmoothDepthAt(float raw, float prev, float v1, float v2, float h1, float h2) {
+    float depth = Saturate(raw);
+
+    float d = std::pow(depth, 0.65f);
+    const float mid = 0.5f;
+    d = (d - mid) * 2.20f + mid;
+    d = Saturate(d);
+    d = Lerp(d, d * d * (3.0f - 2.0f * d), 0.20f);
+    depth = d;
+
+    // === TEMPORAL MICRO-CLAMP (restores text/UI stability) ===
+    const float blended = Lerp(prev, depth, 0.14f); // EMA
+
+    const float maxDelta = 0.05f; // per-frame clamp
+    float delta = blended - prev;
+    delta = MinF(MaxF(delta, -maxDelta), maxDelta);
+
+    const float temporal = prev + delta; // clamped temporal depth
+
+    const float vert = temporal * 0.50f + (v1 + v2) * 0.25f;
+    const float horiz = vert * 0.95f + (h1 + h2) * 0.025f;
+    return Lerp(vert, horiz, 0.05f);
+}
+
+// ------------------------------------------------------------
+// Depth plane elements (Engine::SetDepthPrecision): float, or [0, 1] as unorm16 / unorm8 with
+// round-to-nearest, like a UNORM UAV store.
+// ------------------------------------------------------------
+static inline float LoadDepth(float v) { return v; }
+static inline float LoadDepth(uint16_t v) { return (float)v * (1.0f / 65535.0f); }
+static inline float LoadDepth(uint8_t v) { return (float)v * (1.0f / 255.0f); }
+static inline void StoreDepth(float* p, float v) { *p = v; }
+static inline void StoreDepth(uint16_t* p, float v) { *p = (uint16_t)(Saturate(v) * 65535.0f + 0.5f); }
+static inline void StoreDepth(uint8_t* p, float v) { *p = (uint8_t)(Saturate(v) * 255.0f + 0.5f); }
+
+// ------------------------------------------------------------
+// Rect kernels. Depth planes are row-major: params.outWidth elements per row, or one eye view
+// (params.outWidth / 2) with per-view depth (see Engine::SetPerViewDepth).
+// ------------------------------------------------------------
+
+// Pass 1 always produces floats. `dst` addresses (r.x0, r.y0) of a plane with `dstStride` floats per row.
+static inline void DepthRawRect(const LumaPlane& luma, const Params& p, const TileRect& r, float* dst, size_t dstStride) {
+    for (uint32_t y = r.y0; y < r.y1; ++y) {
+        float* row = dst + (size_t)(y - r.y0) * dstStride;
+        for (uint32_t x = r.x0; x < r.x1; ++x) {
+            const EyeMap m = EyeMapping(p, x, y);
+
+            const float u0 = p.cropOffset[0] + m.u * p.cropScale[0];
+            const float v0 = p.cropOffset[1] + m.v * p.cropScale[1];
+
+            // Neighbor offsets in *output pixel* space mapped into UV.
+            const float stepU = p.cropScale[0] / (float)MaxU(1u, m.viewW);
+            const float stepV = p.cropScale[1] / (float)MaxU(1u, p.outHeight);
+
+            const float gC = SampleLuma(luma, u0, v0);
+            const float gL = SampleLuma(luma, u0 - stepU, v0);
+            const float gR = SampleLuma(luma, u0 + stepU, v0);
+            const float gU = SampleLuma(luma, u0, v0 - stepV);
+            const float gD = SampleLuma(luma, u0, v0 + stepV);
+
+            row[x - r.x0] = DepthFromLumaTaps(gC, gL, gR, gU, gD);
+        }
+    }
+}
+
+// `r` is in depth-plane space; `w` x `h` is the plane size (neighbours clamp at its edges).
+// T is the plane element (see LoadDepth/StoreDepth). Returns the largest change of stored history
+// over the rect (what incremental mode compares against its settle threshold).
+template <typename T>
+static inline float DepthSmoothRect(uint32_t w, uint32_t h, const TileRect& r, const T* depthRaw, const T* depthPrev, T* depthPrevOut, T* depthSmoothOut) {
+    float maxDelta = 0.0f;
+    for (uint32_t y = r.y0; y < r.y1; ++y) {
+        const T* prevRow = depthPrev + (size_t)y * w;
+        const T* prevUp = depthPrev + (size_t)(y > 0 ? y - 1 : 0) * w;
+        const T* prevDown = depthPrev + (size_t)MinU(h - 1, y + 1) * w;
+        const T* rawRow = depthRaw + (size_t)y * w;
+        T* prevOutRow = depthPrevOut + (size_t)y * w;
+        T* smoothRow = depthSmoothOut + (size_t)y * w;
+        for (uint32_t x = r.x0; x < r.x1; ++x) {
+            const uint32_t xl = (x > 0) ? x - 1 : 0;
+            const uint32_t xr = MinU(w - 1, x + 1);
+            const float d = SmoothDepthAt(LoadDepth(rawRow[x]), LoadDepth(prevRow[x]), LoadDepth(prevDown[x]), LoadDepth(prevUp[x]),
+                                          LoadDepth(prevRow[xr]), LoadDepth(prevRow[xl]));
+            StoreDepth(prevOutRow + x, d);
+            StoreDepth(smoothRow + x, d);
+            maxDelta = MaxF(maxDelta, std::fabs(LoadDepth(prevOutRow[x]) - LoadDepth(prevRow[x])));
+        }
+    }
+    return maxDelta;
+}
+
+static inline void StoreRgba(uint8_t* dstBgra, const float rgba[4]) {
+    auto toByte = [](float v) -> uint8_t {
+        return (uint8_t)(Saturate(v) * 255.0f + 0.5f);
+    };
+    dstBgra[0] = toByte(rgba[2]);
+    dstBgra[1] = toByte(rgba[1]);
+    dstBgra[2] = toByte(rgba[0]);
+    dstBgra[3] = toByte(rgba[3]);
+}
+
+// PASS 3 body for one output pixel; writes BGRA8 to dstBgra.
+static inline void ParallaxSbsAt(const ImageView& src, const Params& p, uint32_t x, uint32_t y, float depthSmooth, uint8_t* dstBgra) {
+    static const float kBlack[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    const EyeMap m = EyeMapping(p, x, y);
+
+    const float depth = Saturate(depthSmooth);
+
+    // Simple shaping (pow(depth, 1.0) in the shader).
+    const float shaped = depth;
+    float shift = p.parallaxPx * shaped;
+
+    // Optional clamp for zoom-out.
+    if (p.zoomLevel < 0) {
+        const float maxShift = (float)MaxU(1u, m.viewW) * 0.10f;
+        shift = MinF(MaxF(shift, -maxShift), maxShift);
+    }
+
+    const float sbsShift = m.rightEye ? -shift : shift;
+    const float shiftedRaw = (float)m.localX + sbsShift;
+
+    const bool hitEdge = (shiftedRaw < 0.0f) || (shiftedRaw > (float)(MaxU(1u, m.viewW) - 1));
+    if (hitEdge) {
+        StoreRgba(dstBgra, kBlack);
+        return;
+    }
+
+    const float u = (shiftedRaw + 0.5f) / (float)MaxU(1u, m.viewW);
+    const float uS = p.cropOffset[0] + u * p.cropScale[0];
+    const float vS = p.cropOffset[1] + m.v * p.cropScale[1];
+    float c[4];
+    SampleBilinear(src, uS, vS, c);
+    StoreRgba(dstBgra, c);
+}
+
+// `depth` addresses row r.y0 (column 0) of a plane with `depthStride` floats per row.
+// With `viewDepthW` != 0 the plane holds a single eye view and output column x reads depth
+// column x - viewDepthW in the right half (per-view depth); 0 = the plane spans the SBS width.
+template <typename T>
+static inline void ParallaxSbsRect(const ImageView& src, const Params& p, const TileRect& r, const T* depth, size_t depthStride, const ImageRef& out, uint32_t viewDepthW = 0) {
+    for (uint32_t y = r.y0; y < r.y1; ++y) {
+        const T* depthRow = depth + (size_t)(y - r.y0) * depthStride;
+        uint8_t* outRow = out.data + (size_t)y * out.stride;
+        for (uint32_t x = r.x0; x < r.x1; ++x) {
+            const uint32_t dx = (viewDepthW != 0 && x >= viewDepthW) ? x - viewDepthW : x;
+            ParallaxSbsAt(src, p, x, y, LoadDepth(depthRow[dx]), outRow + (size_t)x * 4);
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// Foveated depth (Engine::SetFoveation / Renderer::SetFoveation). Each eye view reads two depth
+// planes: a full-resolution one over the centre box and one at 1/scale resolution over the whole
+// view. Distances are elliptical in view-normalized coordinates ([-1, 1] edge to edge), so radius 1
+// touches the view's edges; the centre plane wins inside `radius` and fades out over `falloff`.
+// ------------------------------------------------------------
+struct FoveaLayout {
+    uint32_t viewW = 0;
+    uint32_t viewH = 0;
+    // Centre plane: eye-view pixels [cx0, cx0 + cw) x [cy0, cy0 + ch) at full resolution.
+    uint32_t cx0 = 0;
+    uint32_t cy0 = 0;
+    uint32_t cw = 0;
+    uint32_t ch = 0;
+    // Periphery plane: the whole view at pw x ph.
+    uint32_t pw = 0;
+    uint32_t ph = 0;
+    float radius = 0.0f;
+    float falloff = 0.0f;
+};
+
+static inline FoveaLayout MakeFoveaLayout(uint32_t viewW, uint32_t viewH, float radius, float falloff, uint32_t scale) {
+    FoveaLayout f;
+    f.viewW = viewW;
+    f.viewH = viewH;
+    f.radius = MaxF(radius, 0.0f);
+    f.falloff = MaxF(falloff, 0.0f);
+
+    // Everything the centre plane contributes to lies within radius + falloff; one pixel of slack
+    // keeps the smoothing clamp at the box edge out of the blend.
+    const float e = MinF(1.0f, f.radius + f.falloff);
+    auto span = [e](uint32_t n, uint32_t* x0, uint32_t* len) {
+        const int a = ClampI((int)std::floor((1.0f - e) * 0.5f * (float)n) - 1, 0, (int)n);
+        const int b = ClampI((int)std::ceil((1.0f + e) * 0.5f * (float)n) + 1, a, (int)n);
+        *x0 = (uint32_t)a;
+        *len = (uint32_t)(b - a);
+    };
+    span(viewW, &f.cx0, &f.cw);
+    span(viewH, &f.cy0, &f.ch);
+
+    const uint32_t s = MaxU(1u, scale);
+    f.pw = MaxU(1u, (viewW + s - 1) / s);
+    f.ph = MaxU(1u, (viewH + s - 1) / s);
+    return f;
+}
+
+// Params of the depth passes over one of the planes: the same sample positions as `p` (per-view
+// SBS layout, so outWidth is twice the plane width), with the crop narrowed to the centre box.
+static inline Params FoveaPlaneParams(const Params& p, const FoveaLayout& f, bool centre) {
+    Params sub = p;
+    if (centre) {
+        sub.outWidth = 2 * f.cw;
+        sub.outHeight = f.ch;
+        sub.cropOffset[0] = p.cropOffset[0] + (float)f.cx0 / (float)MaxU(1u, f.viewW) * p.cropScale[0];
+        sub.cropOffset[1] = p.cropOffset[1] + (float)f.cy0 / (float)MaxU(1u, f.viewH) * p.cropScale[1];
+        sub.cropScale[0] = p.cropScale[0] * (float)f.cw / (float)MaxU(1u, f.viewW);
+        sub.cropScale[1] = p.cropScale[1] * (float)f.ch / (float)MaxU(1u, f.viewH);
+    } else {
+        sub.outWidth = 2 * f.pw;
+        sub.outHeight = f.ph;
+    }
+    return sub;
+}
+
+// Weight of the centre plane at eye-view pixel (lx, y): 1 inside the radius, 0 past the falloff.
+static inline float FoveaCentreWeight(const FoveaLayout& f, uint32_t lx, uint32_t y) {
+    const float nx = ((float)lx + 0.5f) / (float)MaxU(1u, f.viewW) * 2.0f - 1.0f;
+    const float ny = ((float)y + 0.5f) / (float)MaxU(1u, f.viewH) * 2.0f - 1.0f;
+    const float r = std::sqrt(nx * nx + ny * ny);
+    if (f.falloff <= 0.0f) return (r < f.radius) ? 1.0f : 0.0f;
+    return 1.0f - Smoothstep(f.radius, f.radius + f.falloff, r);
+}
+
+// Resolves the two planes into one per-view plane over rect `r` (eye-view pixels; `dst` addresses
+// (r.x0, r.y0) with `dstStride` elements per row): the centre plane (cw x ch) inside the radius, the
+// periphery plane (pw x ph, sampled bilinearly at the pixel centre with clamping, like the linear
+// sampler) past the falloff, blended by FoveaCentreWeight in between. Pass 3 then reads it like any
+// per-view plane, so the blend runs once per view pixel rather than once per output pixel.
+template <typename T>
+static inline void FoveaResolveRect(const FoveaLayout& f, const T* centre, const T* periphery, const TileRect& r, T* dst, size_t dstStride) {
+    const float nxScale = 2.0f / (float)MaxU(1u, f.viewW);
+    const float nyScale = 2.0f / (float)MaxU(1u, f.viewH);
+    const float pxScale = (float)f.pw / (float)MaxU(1u, f.viewW);
+    const float pyScale = (float)f.ph / (float)MaxU(1u, f.viewH);
+    const float outer = f.radius + f.falloff;
+    const float inner2 = (f.falloff > 0.0f) ? f.radius * f.radius : -1.0f;
+    const float outer2 = outer * outer;
+
+    for (uint32_t y = r.y0; y < r.y1; ++y) {
+        const float ny = ((float)y + 0.5f) * nyScale - 1.0f;
+        const float ny2 = ny * ny;
+        const T* centreRow = centre + (size_t)ClampI((int)y - (int)f.cy0, 0, (int)f.ch - 1) * f.cw;
+
+        const float py = ((float)y + 0.5f) * pyScale - 0.5f;
+        const float fy0 = std::floor(py);
+        const float fy = py - fy0;
+        const T* p0 = periphery + (size_t)ClampI((int)fy0, 0, (int)f.ph - 1) * f.pw;
+        const T* p1 = periphery + (size_t)ClampI((int)fy0 + 1, 0, (int)f.ph - 1) * f.pw;
+
+        T* row = dst + (size_t)(y - r.y0) * dstStride;
+        for (uint32_t x = r.x0; x < r.x1; ++x) {
+            const float nx = ((float)x + 0.5f) * nxScale - 1.0f;
+            const float d2 = nx * nx + ny2;
+            const T* c = centreRow + ClampI((int)x - (int)f.cx0, 0, (int)f.cw - 1);
+            if (d2 <= inner2) {
+                row[x - r.x0] = *c;
+                continue;
+            }
+
+            const float px = ((float)x + 0.5f) * pxScale - 0.5f;
+            const float fx0 = std::floor(px);
+            const float fx = px - fx0;
+            const int x0 = ClampI((int)fx0, 0, (int)f.pw - 1);
+            const int x1 = ClampI((int)fx0 + 1, 0, (int)f.pw - 1);
+            const float top = Lerp(LoadDepth(p0[x0]), LoadDepth(p0[x1]), fx);
+            const float bottom = Lerp(LoadDepth(p1[x0]), LoadDepth(p1[x1]), fx);
+            float d = Lerp(top, bottom, fy);
+            if (d2 < outer2) {
+                const float w = (f.falloff > 0.0f) ? 1.0f - Smoothstep(f.radius, outer, std::sqrt(d2)) : 1.0f;
+                d = Lerp(d, LoadDepth(*c), w);
+            }
+            StoreDepth(row + (x - r.x0), d);
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// Frame interpolation (Engine::RenderInterpolated / Renderer::SetFrameInterpolation): block motion
+// between two source pictures A (older) and B (newer), then a parallax gather that warps both
+// pictures and their smoothed depth along it to phase t in [0, 1].
+//
+// Motion is searched on box-averaged luma: the fine plane at 1/kMotionLumaScale of the source, the
+// coarse one at 1/kMotionLumaScale of that. A coarse search over +-kMotionCoarseRange seeds a small
+// refinement per fine block (kMotionBlock fine texels), which ends in a parabolic sub-texel fit.
+// Vectors point from a block in B to where its content was in A (A position minus B position).
+// ------------------------------------------------------------
+static constexpr uint32_t kMotionLumaScale = 4;   // fine plane texel = 4x4 source pixels
+static constexpr uint32_t kMotionBlock = 8;       // fine block = 8x8 fine texels (32 source pixels)
+static constexpr uint32_t kMotionCoarseBlock = 4; // coarse block = 4x4 coarse texels (64 source pixels)
+static constexpr int kMotionCoarseRange = 6;      // coarse texels (+-96 source pixels)
+static constexpr int kMotionRefineRange = 2;      // fine texels around each candidate
+// Mean absolute luma difference under which the zero vector is taken without searching.
+static constexpr float kMotionStaticCost = 1.0f / 255.0f;
+// Cost added per source pixel of vector length, so flat regions (where every vector matches) keep still.
+static constexpr float kMotionLambdaPerPx = 0.0002f;
+// Sharpness of the depth guide when block vectors are interpolated (MotionAt).
+static constexpr float kMotionDepthSharpness = 400.0f;
+
+// Row-major float luma in [0, 1], `width` elements per row.
+struct MotionPlane {
+    const float* data = nullptr;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+// Fine blocks of a source picture: 4 floats per block (du, dv in source UV, cost, depth of B at the
+// block centre), row-major.
+struct MotionField {
+    const float* data = nullptr;
+    uint32_t blocksX = 0;
+    uint32_t blocksY = 0;
+    float blockU = 0.0f; // block size in source UV
+    float blockV = 0.0f;
+};
+
+static inline uint32_t MotionPlaneSize(uint32_t n) { return (n + kMotionLumaScale - 1) / kMotionLumaScale; }
+static inline uint32_t MotionBlocks(uint32_t fineN) { return (fineN + kMotionBlock - 1) / kMotionBlock; }
+static inline uint32_t MotionCoarseBlocks(uint32_t coarseN) { return (coarseN + kMotionCoarseBlock - 1) / kMotionCoarseBlock; }
+
+// Fine plane row y: each texel averages the (edge-clamped) kMotionLumaScale^2 source pixels it covers.
+static inline void MotionLumaRow(const ImageView& src, uint32_t y, float* dst, uint32_t w) {
+    const uint32_t s = kMotionLumaScale;
+    for (uint32_t x = 0; x < w; ++x) {
+        float sum = 0.0f;
+        for (uint32_t j = 0; j < s; ++j) {
+            const uint8_t* row = src.data + (size_t)MinU(y * s + j, src.height - 1) * src.stride;
+            for (uint32_t i = 0; i < s; ++i) {
+                const uint8_t* px = row + (size_t)MinU(x * s + i, src.width - 1) * 4;
+                sum += Luma((float)px[2], (float)px[1], (float)px[0]);
+            }
+        }
+        dst[x] = sum * (1.0f / (255.0f * (float)(s * s)));
+    }
+}
+
+// Coarse plane row y from the fine plane, the same way.
+static inline void MotionCoarseRow(const MotionPlane& fine, uint32_t y, float* dst, uint32_t w) {
+    const uint32_t s = kMotionLumaScale;
+    for (uint32_t x = 0; x < w; ++x) {
+        float sum = 0.0f;
+        for (uint32_t j = 0; j < s; ++j) {
+            const float* row = fine.data + (size_t)MinU(y * s + j, fine.height - 1) * fine.width;
+            for (uint32_t i = 0; i < s; ++i) sum += row[MinU(x * s + i, fine.width - 1)];
+        }
+        dst[x] = sum * (1.0f / (float)(s * s));
+    }
+}
+
+// Mean |B - A| over the `size` x `size` block of B at (x0, y0) (cut at B's edges) against A displaced
+// by (dx, dy) (clamped at A's edges).
+static inline float MotionBlockCost(const MotionPlane& a, const MotionPlane& b, int x0, int y0, int size, int dx, int dy) {
+    float sum = 0.0f;
+    int n = 0;
+    for (int y = y0; y < y0 + size && y < (int)b.height; ++y) {
+        const float* rowB = b.data + (size_t)y * b.width;
+        const float* rowA = a.data + (size_t)ClampI(y + dy, 0, (int)a.height - 1) * a.width;
+        for (int x = x0; x < x0 + size && x < (int)b.width; ++x) {
+            sum += std::fabs(rowB[x] - rowA[ClampI(x + dx, 0, (int)a.width - 1)]);
+            ++n;
+        }
+    }
+    return (n > 0) ? sum / (float)n : 0.0f;
+}
+
+// Best integer vector for one block: the window of +-range around (cx, cy), scored by cost plus
+// `lambda` per texel of length. Keeps the current best (*bestX, *bestY, *bestScore) unless beaten.
+static inline void MotionSearchWindow(const MotionPlane& a, const MotionPlane& b, int x0, int y0, int size, int cx, int cy, int range,
+                                      float lambda, int* bestX, int* bestY, float* bestScore) {
+    for (int dy = cy - range; dy <= cy + range; ++dy) {
+        for (int dx = cx - range; dx <= cx + range; ++dx) {
+            const int len = (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+            const float score = MotionBlockCost(a, b, x0, y0, size, dx, dy) + lambda * (float)len;
+            if (score < *bestScore) {
+                *bestScore = score;
+                *bestX = dx;
+                *bestY = dy;
+            }
+        }
+    }
+}
+
+// Coarse block (bx, by): integer vector in coarse texels.
+static inline void MotionCoarseAt(const MotionPlane& a, const MotionPlane& b, uint32_t bx, uint32_t by, int* vx, int* vy) {
+    const int size = (int)kMotionCoarseBlock;
+    const int x0 = (int)bx * size;
+    const int y0 = (int)by * size;
+    *vx = 0;
+    *vy = 0;
+    float best = MotionBlockCost(a, b, x0, y0, size, 0, 0);
+    if (best < kMotionStaticCost) return;
+    const float lambda = kMotionLambdaPerPx * (float)(kMotionLumaScale * kMotionLumaScale);
+    MotionSearchWindow(a, b, x0, y0, size, 0, 0, kMotionCoarseRange, lambda, vx, vy, &best);
+}
+
+// Offset of the minimum of the parabola through (-1, cm), (0, c0), (1, cp), within +-0.5.
+static inline float MotionSubTexel(float cm, float c0, float cp) {
+    const float denom = cm - 2.0f * c0 + cp;
+    if (denom <= 1e-6f) return 0.0f;
+    return MinF(MaxF(0.5f * (cm - cp) / denom, -0.5f), 0.5f);
+}
+
+// Fine block (bx, by) seeded by its coarse block's vector (cvx, cvy): refines around it and around
+// zero, then fits the sub-texel offset. Writes du, dv (fine texels) and the block's mean difference.
+static inline void MotionFineAt(const MotionPlane& a, const MotionPlane& b, uint32_t bx, uint32_t by, int cvx, int cvy, float* du, float* dv, float* cost) {
+    const int size = (int)kMotionBlock;
+    const int x0 = (int)bx * size;
+    const int y0 = (int)by * size;
+    int vx = 0;
+    int vy = 0;
+    const float c00 = MotionBlockCost(a, b, x0, y0, size, 0, 0);
+    *du = 0.0f;
+    *dv = 0.0f;
+    *cost = c00;
+    if (c00 < kMotionStaticCost) return;
+
+    const float lambda = kMotionLambdaPerPx * (float)kMotionLumaScale;
+    float best = c00;
+    MotionSearchWindow(a, b, x0, y0, size, 0, 0, kMotionRefineRange, lambda, &vx, &vy, &best);
+    const int sx = cvx * (int)kMotionLumaScale;
+    const int sy = cvy * (int)kMotionLumaScale;
+    if (sx != 0 || sy != 0) MotionSearchWindow(a, b, x0, y0, size, sx, sy, kMotionRefineRange, lambda, &vx, &vy, &best);
+
+    const float c0 = MotionBlockCost(a, b, x0, y0, size, vx, vy);
+    const float fx = MotionSubTexel(MotionBlockCost(a, b, x0, y0, size, vx - 1, vy), c0, MotionBlockCost(a, b, x0, y0, size, vx + 1, vy));
+    const float fy = MotionSubTexel(MotionBlockCost(a, b, x0, y0, size, vx, vy - 1), c0, MotionBlockCost(a, b, x0, y0, size, vx, vy + 1));
+    *du = (float)vx + fx;
+    *dv = (float)vy + fy;
+    *cost = c0;
+}
+
+// Bilinear sample of one eye view of a depth plane at view pixel coordinates (x, y) (pixel centres at
+// +0.5), clamped to the view: columns [viewX0, viewX0 + viewW) of a plane with `planeW` elements per row.
+template <typename T>
+static inline float SampleDepthView(const T* plane, uint32_t planeW, uint32_t h, uint32_t viewX0, uint32_t viewW, float x, float y) {
+    const float fx = x - 0.5f;
+    const float fy = y - 0.5f;
+    const float x0f = std::floor(fx);
+    const float y0f = std::floor(fy);
+    const float ax = fx - x0f;
+    const float ay = fy - y0f;
+    const int maxX = (int)MaxU(1u, viewW) - 1;
+    const int maxY = (int)h - 1;
+    const int x0 = ClampI((int)x0f, 0, maxX) + (int)viewX0;
+    const int x1 = ClampI((int)x0f + 1, 0, maxX) + (int)viewX0;
+    const T* r0 = plane + (size_t)ClampI((int)y0f, 0, maxY) * planeW;
+    const T* r1 = plane + (size_t)ClampI((int)y0f + 1, 0, maxY) * planeW;
+    const float top = Lerp(LoadDepth(r0[x0]), LoadDepth(r0[x1]), ax);
+    const float bottom = Lerp(LoadDepth(r1[x0]), LoadDepth(r1[x1]), ax);
+    return Lerp(top, bottom, ay);
+}
+
+// Depth of B at fine block (bx, by)'s centre for a srcW x srcH source, read from the left eye view
+// (both views sample the same source UVs); MotionField's fourth component.
+template <typename T>
+static inline float MotionBlockDepth(const T* depthB, uint32_t depthW, const Params& p, uint32_t srcW, uint32_t srcH, uint32_t bx, uint32_t by) {
+    const float blockPx = (float)(kMotionBlock * kMotionLumaScale);
+    const float u = ((float)bx + 0.5f) * blockPx / (float)MaxU(1u, srcW);
+    const float v = ((float)by + 0.5f) * blockPx / (float)MaxU(1u, srcH);
+    const uint32_t viewW = MaxU(1u, p.outWidth / 2);
+    const float x = Saturate((u - p.cropOffset[0]) / MaxF(p.cropScale[0], 1e-6f)) * (float)viewW;
+    const float y = Saturate((v - p.cropOffset[1]) / MaxF(p.cropScale[1], 1e-6f)) * (float)p.outHeight;
+    return SampleDepthView(depthB, depthW, p.outHeight, 0, viewW, x, y);
+}
+
+// Vector at source UV (u, v) for a pixel of depth `depth`: the four surrounding block vectors,
+// bilinearly weighted and down-weighted where their block's depth differs (a foreground block's
+// motion doesn't bleed onto the background beside it). out = (du, dv, cost).
+static inline void MotionAt(const MotionField& f, float u, float v, float depth, float out[3]) {
+    const float bx = u / f.blockU - 0.5f;
+    const float by = v / f.blockV - 0.5f;
+    const float bx0 = std::floor(bx);
+    const float by0 = std::floor(by);
+    const float ax = bx - bx0;
+    const float ay = by - by0;
+    const int maxX = (int)f.blocksX - 1;
+    const int maxY = (int)f.blocksY - 1;
+
+    float sum[3] = { 0.0f, 0.0f, 0.0f };
+    float wSum = 0.0f;
+    for (int j = 0; j < 2; ++j) {
+        for (int i = 0; i < 2; ++i) {
+            const int x = ClampI((int)bx0 + i, 0, maxX);
+            const int y = ClampI((int)by0 + j, 0, maxY);
+            const float* e = f.data + ((size_t)y * f.blocksX + (size_t)x) * 4;
+            const float dd = depth - e[3];
+            const float w = (i ? ax : 1.0f - ax) * (j ? ay : 1.0f - ay) / (1.0f + kMotionDepthSharpness * dd * dd);
+            sum[0] += e[0] * w;
+            sum[1] += e[1] * w;
+            sum[2] += e[2] * w;
+            wSum += w;
+        }
+    }
+    const float inv = (wSum > 0.0f) ? 1.0f / wSum : 0.0f;
+    out[0] = sum[0] * inv;
+    out[1] = sum[1] * inv;
+    out[2] = sum[2] * inv;
+}
+
+// Interpolated PASS 3 for one output pixel at phase t between A (t = 0) and B (t = 1). The depth
+// planes (same layout; `viewDepthW` as in ParallaxSbsRect) hold A's and B's smoothed depth.
+// 1. The pixel's motion is read with B's depth at the pixel as the guide; the depth at t is A's depth
+//    fetched t of the way along the vector and B's (1 - t) of the way back, blended by t.
+// 2. That depth drives the usual parallax shift, and the colour at the shifted position is fetched
+//    the same way from both pictures. Where the two fetches disagree (occlusion, bad vector) or the
+//    block matched poorly, the blend leans to the picture nearer in time instead of ghosting.
+// t = 0 and t = 1 reproduce ParallaxSbsAt on A and B exactly.
+template <typename T>
+static inline void InterpolatedSbsAt(const ImageView& a, const ImageView& b, const MotionField& f, const T* depthA, const T* depthB, uint32_t depthW,
+                                     uint32_t viewDepthW, const Params& p, float t, uint32_t x, uint32_t y, uint8_t* dstBgra) {
+    static const float kBlack[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    const EyeMap m = EyeMapping(p, x, y);
+    const uint32_t viewX0 = (viewDepthW != 0 || !m.rightEye) ? 0u : p.outWidth / 2;
+    const float viewW = (float)MaxU(1u, m.viewW);
+    const float viewH = (float)MaxU(1u, p.outHeight);
+    // Source UV per view pixel.
+    const float pxU = p.cropScale[0] / viewW;
+    const float pxV = p.cropScale[1] / viewH;
+
+    const float lx = (float)m.localX + 0.5f;
+    const float ly = (float)y + 0.5f;
+    const float uS0 = p.cropOffset[0] + m.u * p.cropScale[0];
+    const float vS = p.cropOffset[1] + m.v * p.cropScale[1];
+
+    float mv[3];
+    MotionAt(f, uS0, vS, SampleDepthView(depthB, depthW, p.outHeight, viewX0, m.viewW, lx, ly), mv);
+    const float mx = mv[0] / pxU;
+    const float my = mv[1] / pxV;
+    const float dA = SampleDepthView(depthA, depthW, p.outHeight, viewX0, m.viewW, lx + t * mx, ly + t * my);
+    const float dB = SampleDepthView(depthB, depthW, p.outHeight, viewX0, m.viewW, lx - (1.0f - t) * mx, ly - (1.0f - t) * my);
+    const float depth = Saturate(Lerp(dA, dB, t));
+
+    float shift = p.parallaxPx * depth;
+    if (p.zoomLevel < 0) {
+        const float maxShift = viewW * 0.10f;
+        shift = MinF(MaxF(shift, -maxShift), maxShift);
+    }
+    const float shiftedRaw = (float)m.localX + (m.rightEye ? -shift : shift);
+    if ((shiftedRaw < 0.0f) || (shiftedRaw > viewW - 1.0f)) {
+        StoreRgba(dstBgra, kBlack);
+        return;
+    }
+
+    const float uS = p.cropOffset[0] + (shiftedRaw + 0.5f) / viewW * p.cropScale[0];
+    MotionAt(f, uS, vS, depth, mv);
+    float cA[4];
+    float cB[4];
+    SampleBilinear(a, uS + t * mv[0], vS + t * mv[1], cA);
+    SampleBilinear(b, uS - (1.0f - t) * mv[0], vS - (1.0f - t) * mv[1], cB);
+
+    const float mismatch = std::fabs(Luma(cA[0], cA[1], cA[2]) - Luma(cB[0], cB[1], cB[2]));
+    const float k = MaxF(Smoothstep(0.08f, 0.25f, mismatch), Smoothstep(0.04f, 0.12f, mv[2]));
+    const float wB = Lerp(t, (t < 0.5f) ? 0.0f : 1.0f, k);
+    float c[4];
+    for (int i = 0; i < 4; ++i) c[i] = cA[i] * (1.0f - wB) + cB[i] * wB;
+    StoreRgba(dstBgra, c);
+}
+
+// ------------------------------------------------------------
+// PASS 3 in any output layout at any size (Engine::SetLayout / RenderLayout, CSParallaxLayout). The
+// planes hold the depth of the half-SBS canvas depthCanvasW x depthH (`depthW` elements per row;
+// `viewDepthW` as in ParallaxSbsRect); the output is `layout` for the canvas p.outWidth x p.outHeight.
+// Each output view samples its eye's half bilinearly at its own UV. The shift is parallaxPx per
+// half-SBS depth view width, scaled to the output view width, so the disparity in view UV (and the
+// zoom-out clamp) is the same in every layout and size. HalfSbs at the depth canvas size itself goes
+// through ParallaxSbsRect.
+// ------------------------------------------------------------
+template <typename T>
+static inline void LayoutAt(const ImageView& src, const Params& p, uint32_t depthCanvasW, uint32_t depthH, StereoLayout layout,
+                            const T* depth, uint32_t depthW, uint32_t viewDepthW, uint32_t x, uint32_t y, uint8_t* dstBgra) {
+    static const float kBlack[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    const uint32_t w = p.outWidth;
+    const uint32_t h = p.outHeight;
+
+    bool rightEye = false;
+    uint32_t localX = x;
+    uint32_t localY = y;
+    uint32_t viewW = w;
+    uint32_t viewH = h;
+    if (layout == StereoLayout::OverUnder) {
+        const uint32_t topH = h / 2;
+        rightEye = (y >= topH);
+        localY = rightEye ? y - topH : y;
+        viewH = rightEye ? h - topH : topH;
+    } else if (layout == StereoLayout::HalfSbs) {
+        const uint32_t outLeftW = w / 2;
+        rightEye = (x >= outLeftW);
+        localX = rightEye ? x - outLeftW : x;
+        viewW = rightEye ? w - outLeftW : outLeftW;
+    } else {
+        rightEye = (x >= w);
+        localX = rightEye ? x - w : x;
+    }
+    const float viewWf = (float)MaxU(1u, viewW);
+    const float u = ((float)localX + 0.5f) / viewWf;
+    const float v = ((float)localY + 0.5f) / (float)MaxU(1u, viewH);
+    const float vS = p.cropOffset[1] + v * p.cropScale[1];
+
+    // 2D + depth reads the left eye's half for both of its images (they show the same source UVs).
+    const bool depthRight = rightEye && layout != StereoLayout::ImageDepth;
+    const uint32_t leftW = depthCanvasW / 2;
+    const uint32_t depthViewW = depthRight ? depthCanvasW - leftW : leftW;
+    const uint32_t depthX0 = (depthRight && viewDepthW == 0) ? leftW : 0u;
+    const float depthViewWf = (float)MaxU(1u, depthViewW);
+    const float d = Saturate(SampleDepthView(depth, depthW, depthH, depthX0, depthViewW, u * depthViewWf, v * (float)depthH));
+
+    float c[4];
+    if (layout == StereoLayout::ImageDepth) {
+        if (rightEye) {
+            c[0] = c[1] = c[2] = d;
+            c[3] = 1.0f;
+        } else {
+            SampleBilinear(src, p.cropOffset[0] + u * p.cropScale[0], vS, c);
+        }
+        StoreRgba(dstBgra, c);
+        return;
+    }
+
+    float shift = p.parallaxPx * d;
+    if (p.zoomLevel < 0) {
+        const float maxShift = depthViewWf * 0.10f;
+        shift = MinF(MaxF(shift, -maxShift), maxShift);
+    }
+    shift *= viewWf / depthViewWf;
+
+    const float shiftedRaw = (float)localX + (rightEye ? -shift : shift);
+    if ((shiftedRaw < 0.0f) || (shiftedRaw > viewWf - 1.0f)) {
+        StoreRgba(dstBgra, kBlack);
+        return;
+    }
+    SampleBilinear(src, p.cropOffset[0] + (shiftedRaw + 0.5f) / viewWf * p.cropScale[0], vS, c);
+    StoreRgba(dstBgra, c);
+}
+
+// LayoutAt over output rect `r`; `depth` addresses the whole plane.
+template <typename T>
+static inline void LayoutRect(const ImageView& src, const Params& p, uint32_t depthCanvasW, uint32_t depthH, StereoLayout layout, const TileRect& r,
+                              const T* depth, uint32_t depthW, uint32_t viewDepthW, const ImageRef& out) {
+    for (uint32_t y = r.y0; y < r.y1; ++y) {
+        uint8_t* outRow = out.data + (size_t)y * out.stride;
+        for (uint32_t x = r.x0; x < r.x1; ++x) {
+            LayoutAt(src, p, depthCanvasW, depthH, layout, depth, depthW, viewDepthW, x, y, outRow + (size_t)x * 4);
+        }
+    }
+}
+
+} // namespace Kernels
+} // namespace DepthCpu
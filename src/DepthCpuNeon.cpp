@@ -0,0 +1,78 @@
+// NEON build of the luma and PASS 1 kernels (4 pixels per iteration). AArch64 only (vcvtnq).
+
+#include "DepthCpuSimd.h"
+#include "DepthCpuSimdKernel.h"
+
+#include <arm_neon.h>
+#include <cstring>
+
+namespace DepthCpu {
+namespace {
+
+struct IsaNeon {
+    using F = float32x4_t;
+    using I = int32x4_t;
+    static constexpr int kLanes = 4;
+
+    static F Set1(float v) { return vdupq_n_f32(v); }
+    static F Load(const float* p) { return vld1q_f32(p); }
+    static void Store(float* p, F v) { vst1q_f32(p, v); }
+
+    static F Add(F a, F b) { return vaddq_f32(a, b); }
+    static F Sub(F a, F b) { return vsubq_f32(a, b); }
+    static F Mul(F a, F b) { return vmulq_f32(a, b); }
+    static F Div(F a, F b) { return vdivq_f32(a, b); }
+    static F Min(F a, F b) { return vminq_f32(a, b); }
+    static F Max(F a, F b) { return vmaxq_f32(a, b); }
+    static F Abs(F a) { return vabsq_f32(a); }
+    static F Floor(F a) { return vrndmq_f32(a); }
+
+    static I SetI(int32_t v) { return vdupq_n_s32(v); }
+    static I AddI(I a, I b) { return vaddq_s32(a, b); }
+    static I SubI(I a, I b) { return vsubq_s32(a, b); }
+    static I MinI(I a, I b) { return vminq_s32(a, b); }
+    static I MaxI(I a, I b) { return vmaxq_s32(a, b); }
+    static I ToInt(F a) { return vcvtq_s32_f32(a); }
+    static F ToFloat(I a) { return vcvtq_f32_s32(a); }
+    static F GatherF(const float* base, I idx) {
+        // No gather: one lane load per element.
+        F v = vld1q_dup_f32(base + vgetq_lane_s32(idx, 0));
+        v = vld1q_lane_f32(base + vgetq_lane_s32(idx, 1), v, 1);
+        v = vld1q_lane_f32(base + vgetq_lane_s32(idx, 2), v, 2);
+        return vld1q_lane_f32(base + vgetq_lane_s32(idx, 3), v, 3);
+    }
+
+    static void LoadBgra(const uint8_t* p, F& b, F& g, F& r) {
+        const uint32x4_t v = vld1q_u32((const uint32_t*)p);
+        const uint32x4_t m = vdupq_n_u32(0xFFu);
+        b = vcvtq_f32_u32(vandq_u32(v, m));
+        g = vcvtq_f32_u32(vandq_u32(vshrq_n_u32(v, 8), m));
+        r = vcvtq_f32_u32(vandq_u32(vshrq_n_u32(v, 16), m));
+    }
+    static void StoreU16(uint16_t* p, F v) {
+        vst1_u16(p, vqmovn_u32(vcvtq_u32_f32(vaddq_f32(v, vdupq_n_f32(0.5f)))));
+    }
+    static void LoadTexelPairs(const uint16_t* row, I x, F& lo, F& hi) {
+        // No gather: one 32-bit load per lane, each picking up both texels (row[x] in the low half).
+        uint32_t pairs[4];
+        std::memcpy(&pairs[0], row + vgetq_lane_s32(x, 0), sizeof(uint32_t));
+        std::memcpy(&pairs[1], row + vgetq_lane_s32(x, 1), sizeof(uint32_t));
+        std::memcpy(&pairs[2], row + vgetq_lane_s32(x, 2), sizeof(uint32_t));
+        std::memcpy(&pairs[3], row + vgetq_lane_s32(x, 3), sizeof(uint32_t));
+        const uint32x4_t v = vld1q_u32(pairs);
+        lo = vcvtq_f32_u32(vandq_u32(v, vdupq_n_u32(0xFFFFu)));
+        hi = vcvtq_f32_u32(vshrq_n_u32(v, 16));
+    }
+};
+
+} // namespace
+
+void Simd::DepthRawRectNeon(const Kernels::LumaPlane& luma, const Params& p, const TileRect& r, float* dst, size_t dstStride) {
+    SimdKernel::DepthRawRect<IsaNeon>(luma, p, r, dst, dstStride);
+}
+
+void Simd::LumaRowNeon(const uint8_t* bgra, uint16_t* dst, uint32_t n) {
+    SimdKernel::LumaRow<IsaNeon>(bgra, dst, n);
+}
+
+} // namespace DepthCpu
@@ -0,0 +1,135 @@
+#include "DepthCpuSimd.h"
+
+#include <atomic>
+
+#if defined(AC_SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace DepthCpu {
+namespace {
+
+void DepthRawRectScalar(const Kernels::LumaPlane& luma, const Params& p, const TileRect& r, float* dst, size_t dstStride) {
+    Kernels::DepthRawRect(luma, p, r, dst, dstStride);
+}
+
+void LumaRowScalar(const uint8_t* bgra, uint16_t* dst, uint32_t n) {
+    Kernels::LumaRow(bgra, dst, n);
+}
+
+const KernelTable kScalar = { SimdLevel::Scalar, 1, &DepthRawRectScalar, &LumaRowScalar };
+#if defined(AC_SIMD_X86)
+const KernelTable kSse41 = { SimdLevel::Sse41, 4, &Simd::DepthRawRectSse41, &Simd::LumaRowSse41 };
+const KernelTable kAvx2 = { SimdLevel::Avx2, 8, &Simd::DepthRawRectAvx2, &Simd::LumaRowAvx2 };
+const KernelTable kAvx512 = { SimdLevel::Avx512, 16, &Simd::DepthRawRectAvx512, &Simd::LumaRowAvx512 };
+#endif
+#if defined(AC_SIMD_NEON)
+const KernelTable kNeon = { SimdLevel::Neon, 4, &Simd::DepthRawRectNeon, &Simd::LumaRowNeon };
+#endif
+
+#if defined(AC_SIMD_X86)
+struct CpuFeatures {
+    bool sse41 = false;
+    bool avx2 = false;
+    bool avx512f = false;
+};
+
+CpuFeatures DetectCpuFeatures() {
+    CpuFeatures f;
+#if defined(_MSC_VER)
+    int info[4] = {};
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    f.sse41 = (info[2] & (1 << 19)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || maxLeaf < 7) return f;
+
+    // The OS must save YMM (and ZMM/opmask for AVX-512) state across context switches.
+    const unsigned long long xcr0 = _xgetbv(0);
+    const bool osYmm = (xcr0 & 0x6) == 0x6;
+    const bool osZmm = (xcr0 & 0xE6) == 0xE6;
+
+    __cpuidex(info, 7, 0);
+    f.avx2 = osYmm && (info[1] & (1 << 5)) != 0;
+    f.avx512f = osZmm && (info[1] & (1 << 16)) != 0;
+#else
+    // libgcc / compiler-rt also check XCR0 for OS support.
+    __builtin_cpu_init();
+    f.sse41 = __builtin_cpu_supports("sse4.1") != 0;
+    f.avx2 = __builtin_cpu_supports("avx2") != 0;
+    f.avx512f = __builtin_cpu_supports("avx512f") != 0;
+#endif
+    return f;
+}
+#endif
+
+const KernelTable* TableFor(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Scalar: return &kScalar;
+#if defined(AC_SIMD_X86)
+    case SimdLevel::Sse41:
+    case SimdLevel::Avx2:
+    case SimdLevel::Avx512: {
+        static const CpuFeatures f = DetectCpuFeatures();
+        if (level == SimdLevel::Sse41 && f.sse41) return &kSse41;
+        if (level == SimdLevel::Avx2 && f.avx2) return &kAvx2;
+        if (level == SimdLevel::Avx512 && f.avx512f) return &kAvx512;
+        return nullptr;
+    }
+#endif
+#if defined(AC_SIMD_NEON)
+    case SimdLevel::Neon: return &kNeon;
+#endif
+    default: return nullptr;
+    }
+}
+
+const KernelTable* BestTable() {
+    static const SimdLevel kOrder[] = { SimdLevel::Avx512, SimdLevel::Avx2, SimdLevel::Sse41, SimdLevel::Neon };
+    for (SimdLevel level : kOrder) {
+        if (const KernelTable* t = TableFor(level)) return t;
+    }
+    return &kScalar;
+}
+
+std::atomic<const KernelTable*>& Selected() {
+    static std::atomic<const KernelTable*> selected{ BestTable() };
+    return selected;
+}
+
+} // namespace
+
+const KernelTable& GetKernels() {
+    return *Selected().load(std::memory_order_acquire);
+}
+
+const char* SimdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Scalar: return "scalar";
+    case SimdLevel::Sse41: return "sse4.1";
+    case SimdLevel::Avx2: return "avx2";
+    case SimdLevel::Avx512: return "avx512";
+    case SimdLevel::Neon: return "neon";
+    }
+    return "unknown";
+}
+
+SimdLevel GetBestSimdLevel() {
+    return BestTable()->level;
+}
+
+SimdLevel GetSimdLevel() {
+    return GetKernels().level;
+}
+
+bool SetSimdLevel(SimdLevel level) {
+    const KernelTable* t = TableFor(level);
+    if (!t) return false;
+    Selected().store(t, std::memory_order_release);
+    return true;
+}
+
+} // namespace DepthCpu
@@ -0,0 +1,43 @@
+#pragma once
+
+// Internal runtime-dispatched kernel table for the CPU depth engine.
+// Each ISA lives in its own translation unit built with matching compiler flags
+// (DepthCpuSse41.cpp / DepthCpuAvx2.cpp / DepthCpuAvx512.cpp / DepthCpuNeon.cpp);
+// only the kernels for the target architecture are compiled in.
+
+#include "DepthCpu.h"
+#include "DepthCpuKernels.h"
+
+namespace DepthCpu {
+
+// PASS 1 over `r`; `dst` addresses (r.x0, r.y0) of a float plane with `dstStride` floats per row.
+using DepthRawRectFn = void (*)(const Kernels::LumaPlane& luma, const Params& p, const TileRect& r, float* dst, size_t dstStride);
+// `n` BGRA8 pixels -> 16-bit luma (Kernels::LumaRow).
+using LumaRowFn = void (*)(const uint8_t* bgra, uint16_t* dst, uint32_t n);
+
+struct KernelTable {
+    SimdLevel level = SimdLevel::Scalar;
+    int lanes = 1;
+    DepthRawRectFn depthRawRect = nullptr;
+    LumaRowFn lumaRow = nullptr;
+};
+
+// Currently selected table (never null; scalar if nothing better is available).
+const KernelTable& GetKernels();
+
+namespace Simd {
+#if defined(AC_SIMD_X86)
+void DepthRawRectSse41(const Kernels::LumaPlane& luma, const Params& p, const TileRect& r, float* dst, size_t dstStride);
+void LumaRowSse41(const uint8_t* bgra, uint16_t* dst, uint32_t n);
+void DepthRawRectAvx2(const Kernels::LumaPlane& luma, const Params& p, const TileRect& r, float* dst, size_t dstStride);
+void LumaRowAvx2(const uint8_t* bgra, uint16_t* dst, uint32_t n);
+void DepthRawRectAvx512(const Kernels::LumaPlane& luma, const Params& p, const TileRect& r, float* dst, size_t dstStride);
+void LumaRowAvx512(const uint8_t* bgra, uint16_t* dst, uint32_t n);
+#endif
+#if defined(AC_SIMD_NEON)
+void DepthRawRectNeon(const Kernels::LumaPlane& luma, const Params& p, const TileRect& r, float* dst, size_t dstStride);
+void LumaRowNeon(const uint8_t* bgra, uint16_t* dst, uint32_t n);
+#endif
+} // namespace Simd
+
+} // namespace DepthCpu
@@ -0,0 +1,267 @@
+#pragma once
+
+// Generic SIMD bodies of the luma extraction and PASS 1 (CSDepthRaw), instantiated once per ISA.
+// Include from the per-ISA translation units only, after defining a TU-local `Isa` wrapper:
+//
+//   struct Isa {
+//       using F = <native float vector>;
+//       using I = <native int32 vector, kLanes wide>;
+//       static constexpr int kLanes;
+//       static F Set1(float); static F Load(const float*); static void Store(float*, F);
+//       static F Add/Sub/Mul/Div/Min/Max(F, F); static F Abs(F); static F Floor(F);
+//       static I SetI(int32_t); static I AddI/SubI/MinI/MaxI(I, I);
+//       static I ToInt(F);   // truncate
+//       static F ToFloat(I);
+//       static F GatherF(const float* base, I idx);              // base[idx] per lane
+//       static void LoadBgra(const uint8_t* p, F& b, F& g, F& r); // kLanes BGRA8 pixels, as floats
+//       static void StoreU16(uint16_t* p, F v);                   // + 0.5 then truncate (as Kernels::LumaU16), saturate
+//       static void LoadTexelPairs(const uint16_t* row, I x, F& lo, F& hi); // row[x], row[x + 1] per lane
+//   };
+//
+// Everything here is static (or templated on the TU-local Isa) so nothing compiled with
+// ISA-specific flags can be merged into scalar code by the linker.
+//
+// The pow()-heavy tone curve is a table lookup (Kernels::ToneCurveLut) with the same index / fraction
+// math as Kernels::ToneCurveLookup, so both paths read the same entries.
+
+#include "DepthCpuKernels.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace DepthCpu {
+namespace SimdKernel {
+
+template <class Isa>
+static inline typename Isa::F SaturateV(typename Isa::F v) {
+    return Isa::Min(Isa::Max(v, Isa::Set1(0.0f)), Isa::Set1(1.0f));
+}
+
+template <class Isa>
+static inline typename Isa::F LerpV(typename Isa::F a, typename Isa::F b, typename Isa::F t) {
+    return Isa::Add(a, Isa::Mul(t, Isa::Sub(b, a)));
+}
+
+// Kernels::ToneCurveLookup, kLanes at a time: the four interleaved entries around each lane's index
+// are fetched with GatherF.
+template <class Isa>
+static inline void ToneCurveLookupV(const float* lut, typename Isa::F g_soft, typename Isa::F& curveBlend,
+                                    typename Isa::F& shaped) {
+    using F = typename Isa::F;
+    using I = typename Isa::I;
+    const F x = Isa::Mul(SaturateV<Isa>(g_soft), Isa::Set1((float)(Kernels::kToneCurveLutSize - 1)));
+    const I i = Isa::MinI(Isa::ToInt(x), Isa::SetI((int32_t)Kernels::kToneCurveLutSize - 2));
+    const F f = Isa::Sub(x, Isa::ToFloat(i));
+    const I e = Isa::AddI(i, i); // entry pairs are interleaved (curveBlend, shaped)
+    curveBlend = LerpV<Isa>(Isa::GatherF(lut, e), Isa::GatherF(lut + 2, e), f);
+    shaped = LerpV<Isa>(Isa::GatherF(lut + 1, e), Isa::GatherF(lut + 3, e), f);
+}
+
+// Edges are compile-time constants in the shader, so fold 1/(e1-e0) into a multiply.
+template <class Isa>
+static inline typename Isa::F SmoothstepV(float e0, float e1, typename Isa::F x) {
+    using F = typename Isa::F;
+    const F t = SaturateV<Isa>(Isa::Mul(Isa::Sub(x, Isa::Set1(e0)), Isa::Set1(1.0f / (e1 - e0))));
+    return Isa::Mul(Isa::Mul(t, t), Isa::Sub(Isa::Set1(3.0f), Isa::Mul(Isa::Set1(2.0f), t)));
+}
+
+// Vector port of Kernels::DepthFromLumaTaps; keep the two in lockstep.
+template <class Isa>
+static inline typename Isa::F DepthFromLumaTapsV(typename Isa::F gC, typename Isa::F gL, typename Isa::F gR, typename Isa::F gU, typename Isa::F gD) {
+    using F = typename Isa::F;
+    const F one = Isa::Set1(1.0f);
+    const F half = Isa::Set1(0.5f);
+
+    const F c = Isa::Max(Isa::Max(Isa::Abs(Isa::Sub(gC, gL)), Isa::Abs(Isa::Sub(gC, gR))),
+                         Isa::Max(Isa::Abs(Isa::Sub(gC, gU)), Isa::Abs(Isa::Sub(gC, gD))));
+
+    // === STRUCTURE PROTECTION MASK ===
+    const F structure = SmoothstepV<Isa>(0.12f, 0.35f, c);
+    const F depth_aggression = LerpV<Isa>(Isa::Set1(0.55f), Isa::Set1(0.35f), structure);
+
+    // 5-tap cross smoothing
+    const F g_avg = Isa::Mul(Isa::Add(Isa::Add(Isa::Add(Isa::Add(gC, gL), gR), gU), gD), Isa::Set1(0.2f));
+
+    const F w = Isa::Sub(one, SmoothstepV<Isa>(0.05f, 0.25f, c));
+    F g_soft = LerpV<Isa>(gC, g_avg, w);
+
+    // stronger edge softening (g_edge_avg == g_avg)
+    const F soften = SmoothstepV<Isa>(0.10f, 0.35f, c);
+    g_soft = LerpV<Isa>(g_soft, g_avg, Isa::Mul(soften, Isa::Set1(0.90f)));
+
+    // toroidal grayscale field
+    const F dist = Isa::Abs(Isa::Sub(g_soft, half));
+    const F torus = Isa::Sub(one, SmoothstepV<Isa>(0.0f, 0.025f, dist));
+    g_soft = LerpV<Isa>(g_soft, half, Isa::Mul(torus, Isa::Set1(0.50f)));
+
+    // specular light pop
+    const F highlight = SmoothstepV<Isa>(0.78f, 0.95f, g_soft);
+    const F contrast = SmoothstepV<Isa>(0.12f, 0.32f, c);
+    const F spec_pop = Isa::Mul(highlight, contrast);
+    g_soft = LerpV<Isa>(g_soft, Isa::Mul(g_soft, Isa::Set1(0.92f)), Isa::Mul(spec_pop, Isa::Set1(0.15f)));
+
+    // === CURVE LAYERS + DEPTH SHAPING: lookup in the shared table ===
+    F curve_blend, depth;
+    ToneCurveLookupV<Isa>(Kernels::ToneCurveLut(), g_soft, curve_blend, depth);
+
+    depth = Isa::Add(Isa::Mul(Isa::Sub(depth, half), depth_aggression), half);
+    depth = LerpV<Isa>(depth, curve_blend, Isa::Set1(0.040f));
+    depth = Isa::Add(Isa::Mul(Isa::Sub(depth, half), depth_aggression), half);
+
+    // ripple reduction
+    const F lc_soft = SmoothstepV<Isa>(0.030f, 0.004f, c);
+    depth = Isa::Add(depth, Isa::Mul(lc_soft, Isa::Set1(0.0000010f)));
+
+    // bright noise dampening
+    const F noise_mask = SmoothstepV<Isa>(0.35f, 0.75f, Isa::Mul(c, g_soft));
+    depth = LerpV<Isa>(depth, Isa::Mul(depth, Isa::Set1(0.20f)), Isa::Mul(noise_mask, Isa::Set1(0.18f)));
+
+    // flat-region + non-flat boost (same factor applied twice, as in the shader)
+    const F flatness = Isa::Sub(one, SmoothstepV<Isa>(0.05f, 0.10f, c));
+    const F boost = LerpV<Isa>(Isa::Set1(1.10f), Isa::Set1(1.05f), flatness);
+    depth = Isa::Add(Isa::Mul(Isa::Sub(depth, half), boost), half);
+    depth = Isa::Add(Isa::Mul(Isa::Sub(depth, half), boost), half);
+
+    return SaturateV<Isa>(depth);
+}
+
+// Vector port of Kernels::LumaRow (same multiply/add order as Kernels::Luma).
+template <class Isa>
+static void LumaRow(const uint8_t* bgra, uint16_t* dst, uint32_t n) {
+    using F = typename Isa::F;
+    constexpr int L = Isa::kLanes;
+    const F kR = Isa::Set1(0.299f);
+    const F kG = Isa::Set1(0.587f);
+    const F kB = Isa::Set1(0.114f);
+    const F kScale = Isa::Set1(257.0f);
+
+    uint32_t x = 0;
+    for (; x + L <= n; x += L) {
+        F b, g, r;
+        Isa::LoadBgra(bgra + (size_t)x * 4, b, g, r);
+        const F l = Isa::Add(Isa::Add(Isa::Mul(r, kR), Isa::Mul(g, kG)), Isa::Mul(b, kB));
+        Isa::StoreU16(dst + x, Isa::Mul(l, kScale));
+    }
+    Kernels::LumaRow(bgra + (size_t)x * 4, dst + x, n - x);
+}
+
+// Source rows and vertical weight of a bilinear tap at v (as Kernels::SampleLuma). Pass 1 samples
+// three such rows per output row, the same for every pixel of it.
+struct TapRows {
+    const uint16_t* r0;
+    const uint16_t* r1;
+    float fy;
+};
+
+static inline TapRows TapRowsAt(const Kernels::LumaPlane& luma, float v) {
+    const float y = v * (float)luma.height - 0.5f;
+    const float fy0 = std::floor(y);
+    const int maxY = (int)luma.height - 1;
+    const int y0 = Kernels::ClampI((int)fy0, 0, maxY) - (int)luma.y0;
+    const int y1 = Kernels::ClampI((int)fy0 + 1, 0, maxY) - (int)luma.y0;
+
+    TapRows t;
+    t.r0 = luma.data + (size_t)y0 * luma.stride;
+    t.r1 = luma.data + (size_t)y1 * luma.stride;
+    t.fy = y - fy0;
+    return t;
+}
+
+// Per-lane left texel (plane column) and horizontal weight of a bilinear tap at u.
+template <class Isa>
+struct TapCols {
+    typename Isa::I x;
+    typename Isa::F fx;
+};
+
+template <class Isa>
+static inline TapCols<Isa> TapColsAt(const Kernels::LumaPlane& luma, typename Isa::F u) {
+    using F = typename Isa::F;
+    using I = typename Isa::I;
+    const F x = Isa::Sub(Isa::Mul(u, Isa::Set1((float)luma.width)), Isa::Set1(0.5f));
+    const F fx0 = Isa::Floor(x);
+    const I i0 = Isa::ToInt(fx0);
+    const I lo = Isa::SetI(0);
+    const I hi = Isa::SetI((int32_t)luma.width - 1);
+    const I x0 = Isa::MinI(Isa::MaxI(i0, lo), hi);
+    const I x1 = Isa::MinI(Isa::MaxI(Isa::AddI(i0, Isa::SetI(1)), lo), hi);
+
+    TapCols<Isa> c;
+    c.x = Isa::SubI(x0, Isa::SetI((int32_t)luma.x0));
+    // x1 is x0 + 1, or x0 where the edge clamps both: then the pair's second texel must not count.
+    c.fx = Isa::Mul(Isa::Sub(x, fx0), Isa::ToFloat(Isa::SubI(x1, x0)));
+    return c;
+}
+
+// Kernels::SampleLuma for kLanes taps on the same rows; the same float operations in the same order.
+template <class Isa>
+static inline typename Isa::F SampleLumaV(const TapRows& rows, const TapCols<Isa>& c) {
+    using F = typename Isa::F;
+    F l00, l10, l01, l11;
+    Isa::LoadTexelPairs(rows.r0, c.x, l00, l10);
+    Isa::LoadTexelPairs(rows.r1, c.x, l01, l11);
+    const F top = Isa::Add(l00, Isa::Mul(c.fx, Isa::Sub(l10, l00)));
+    const F bottom = Isa::Add(l01, Isa::Mul(c.fx, Isa::Sub(l11, l01)));
+    return Isa::Mul(Isa::Add(top, Isa::Mul(Isa::Set1(rows.fy), Isa::Sub(bottom, top))), Isa::Set1(1.0f / 65535.0f));
+}
+
+// PASS 1 over a rect, Isa::kLanes pixels per iteration. Same mapping and addressing as
+// Kernels::DepthRawRect (`dst` is (r.x0, r.y0)): each eye view's span of the rect is one linear run
+// of u, and every tap row of an output row is shared by its pixels, so only the columns are per lane.
+template <class Isa>
+static void DepthRawRect(const Kernels::LumaPlane& luma, const Params& p, const TileRect& r, float* dst, size_t dstStride) {
+    using F = typename Isa::F;
+    constexpr int L = Isa::kLanes;
+    alignas(64) static const float kIota[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+    static_assert(L <= 16, "kIota covers up to 16 lanes");
+    alignas(64) float tail[L];
+
+    const uint32_t leftW = p.outWidth / 2;
+    const float stepV = p.cropScale[1] / (float)Kernels::MaxU(1u, p.outHeight);
+
+    for (uint32_t y = r.y0; y < r.y1; ++y) {
+        float* row = dst + (size_t)(y - r.y0) * dstStride;
+        const float v = ((float)y + 0.5f) / (float)Kernels::MaxU(1u, p.outHeight);
+        const float v0 = p.cropOffset[1] + v * p.cropScale[1];
+        const TapRows rowsC = TapRowsAt(luma, v0);
+        const TapRows rowsU = TapRowsAt(luma, v0 - stepV);
+        const TapRows rowsD = TapRowsAt(luma, v0 + stepV);
+
+        for (int eye = 0; eye < 2; ++eye) {
+            const uint32_t viewX0 = eye ? leftW : 0;
+            const uint32_t viewW = eye ? p.outWidth - leftW : leftW;
+            const uint32_t x0 = Kernels::MaxU(r.x0, viewX0);
+            const uint32_t x1 = Kernels::MinU(r.x1, viewX0 + viewW);
+            if (x0 >= x1) continue;
+
+            const F viewWf = Isa::Set1((float)Kernels::MaxU(1u, viewW));
+            const F stepU = Isa::Set1(p.cropScale[0] / (float)Kernels::MaxU(1u, viewW));
+            const F lastX = Isa::Set1((float)(x1 - 1 - viewX0));
+
+            for (uint32_t x = x0; x < x1; x += L) {
+                const uint32_t n = Kernels::MinU((uint32_t)L, x1 - x);
+
+                // Partial vectors repeat the last valid pixel so every lane stays finite.
+                const F localX = Isa::Min(Isa::Add(Isa::Set1((float)(x - viewX0)), Isa::Load(kIota)), lastX);
+                const F u = Isa::Div(Isa::Add(localX, Isa::Set1(0.5f)), viewWf);
+                const F u0 = Isa::Add(Isa::Set1(p.cropOffset[0]), Isa::Mul(u, Isa::Set1(p.cropScale[0])));
+
+                const TapCols<Isa> colsC = TapColsAt<Isa>(luma, u0);
+                const TapCols<Isa> colsL = TapColsAt<Isa>(luma, Isa::Sub(u0, stepU));
+                const TapCols<Isa> colsR = TapColsAt<Isa>(luma, Isa::Add(u0, stepU));
+
+                const F d = DepthFromLumaTapsV<Isa>(SampleLumaV<Isa>(rowsC, colsC), SampleLumaV<Isa>(rowsC, colsL), SampleLumaV<Isa>(rowsC, colsR),
+                                                    SampleLumaV<Isa>(rowsU, colsC), SampleLumaV<Isa>(rowsD, colsC));
+                if (n == (uint32_t)L) {
+                    Isa::Store(row + (x - r.x0), d);
+                } else {
+                    Isa::Store(tail, d);
+                    std::memcpy(row + (x - r.x0), tail, n * sizeof(float));
+                }
+            }
+        }
+    }
+}
+
+} // namespace SimdKernel
+} // namespace DepthCpu
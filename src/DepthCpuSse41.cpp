@@ -0,0 +1,79 @@
+// SSE4.1 build of the luma and PASS 1 kernels (4 pixels per iteration).
+// Compiled with -msse4.1 on GCC/Clang; MSVC x64 needs no flag.
+
+#include "DepthCpuSimd.h"
+#include "DepthCpuSimdKernel.h"
+
+#include <smmintrin.h>
+#include <cstring>
+
+namespace DepthCpu {
+namespace {
+
+struct IsaSse41 {
+    using F = __m128;
+    using I = __m128i;
+    static constexpr int kLanes = 4;
+
+    static F Set1(float v) { return _mm_set1_ps(v); }
+    static F Load(const float* p) { return _mm_loadu_ps(p); }
+    static void Store(float* p, F v) { _mm_storeu_ps(p, v); }
+
+    static F Add(F a, F b) { return _mm_add_ps(a, b); }
+    static F Sub(F a, F b) { return _mm_sub_ps(a, b); }
+    static F Mul(F a, F b) { return _mm_mul_ps(a, b); }
+    static F Div(F a, F b) { return _mm_div_ps(a, b); }
+    static F Min(F a, F b) { return _mm_min_ps(a, b); }
+    static F Max(F a, F b) { return _mm_max_ps(a, b); }
+    static F Abs(F a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static F Floor(F a) { return _mm_floor_ps(a); }
+
+    static I SetI(int32_t v) { return _mm_set1_epi32(v); }
+    static I AddI(I a, I b) { return _mm_add_epi32(a, b); }
+    static I SubI(I a, I b) { return _mm_sub_epi32(a, b); }
+    static I MinI(I a, I b) { return _mm_min_epi32(a, b); }
+    static I MaxI(I a, I b) { return _mm_max_epi32(a, b); }
+    static I ToInt(F a) { return _mm_cvttps_epi32(a); }
+    static F ToFloat(I a) { return _mm_cvtepi32_ps(a); }
+    static F GatherF(const float* base, I idx) {
+        // No gather before AVX2: four scalar loads.
+        return _mm_setr_ps(base[_mm_cvtsi128_si32(idx)], base[_mm_extract_epi32(idx, 1)],
+                           base[_mm_extract_epi32(idx, 2)], base[_mm_extract_epi32(idx, 3)]);
+    }
+
+    static void LoadBgra(const uint8_t* p, F& b, F& g, F& r) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)p);
+        const __m128i m = _mm_set1_epi32(0xFF);
+        b = _mm_cvtepi32_ps(_mm_and_si128(v, m));
+        g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 8), m));
+        r = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 16), m));
+    }
+    static void StoreU16(uint16_t* p, F v) {
+        const __m128i i = _mm_cvttps_epi32(_mm_add_ps(v, _mm_set1_ps(0.5f)));
+        _mm_storel_epi64((__m128i*)p, _mm_packus_epi32(i, i));
+    }
+    static void LoadTexelPairs(const uint16_t* row, I x, F& lo, F& hi) {
+        // No gather before AVX2: four 32-bit loads, each picking up both texels of its lane.
+        const __m128i v = _mm_setr_epi32(LoadPair(row, _mm_cvtsi128_si32(x)), LoadPair(row, _mm_extract_epi32(x, 1)),
+                                         LoadPair(row, _mm_extract_epi32(x, 2)), LoadPair(row, _mm_extract_epi32(x, 3)));
+        lo = _mm_cvtepi32_ps(_mm_and_si128(v, _mm_set1_epi32(0xFFFF)));
+        hi = _mm_cvtepi32_ps(_mm_srli_epi32(v, 16));
+    }
+    static int LoadPair(const uint16_t* row, int x) {
+        int v;
+        std::memcpy(&v, row + x, sizeof(v));
+        return v;
+    }
+};
+
+} // namespace
+
+void Simd::DepthRawRectSse41(const Kernels::LumaPlane& luma, const Params& p, const TileRect& r, float* dst, size_t dstStride) {
+    SimdKernel::DepthRawRect<IsaSse41>(luma, p, r, dst, dstStride);
+}
+
+void Simd::LumaRowSse41(const uint8_t* bgra, uint16_t* dst, uint32_t n) {
+    SimdKernel::LumaRow<IsaSse41>(bgra, dst, n);
+}
+
+} // namespace DepthCpu
@@ -0,0 +1,778 @@
+#include "FrameIO.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#if defined(AC_HAVE_LIBPNG)
+#include <png.h>
+#endif
+
+namespace FrameIO {
+namespace {
+
+static std::string ToLower(std::string s) {
+    for (char& c : s) c = (char)std::tolower((unsigned char)c);
+    return s;
+}
+
+static std::string Extension(const std::string& path) {
+    const size_t dot = path.find_last_of('.');
+    const size_t slash = path.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return std::string();
+    return ToLower(path.substr(dot + 1));
+}
+
+static Format FormatFromPath(const std::string& path) {
+    const std::string ext = Extension(path);
+    if (ext == "y4m") return Format::Y4m;
+    if (ext == "bgra" || ext == "raw") return Format::RawBgra;
+    return Format::Image;
+}
+
+// Pipes hand over whole frames; a large stdio buffer keeps read/write syscalls per frame low.
+static constexpr size_t kStreamBufferBytes = 1u << 20;
+
+static bool IsStdStreamPath(const std::string& path) {
+    return path == "-";
+}
+
+// Must run before the first read/write on `f`.
+static FILE* PrepareStream(FILE* f) {
+#if defined(_WIN32)
+    if (f == stdin || f == stdout) _setmode(_fileno(f), _O_BINARY);
+#endif
+    std::setvbuf(f, nullptr, _IOFBF, kStreamBufferBytes);
+    return f;
+}
+
+static void SetErr(std::string* err, const std::string& msg) {
+    if (err) *err = msg;
+}
+
+static uint8_t ClampByte(int v) {
+    return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+// ------------------------------------------------------------
+// Netpbm (PGM/PPM/PAM)
+// ------------------------------------------------------------
+
+// Next whitespace-delimited token of a P5/P6 header, skipping '#' comments.
+static bool ReadPnmToken(FILE* f, std::string& tok) {
+    tok.clear();
+    int c = std::fgetc(f);
+    for (;;) {
+        while (c != EOF && std::isspace(c)) c = std::fgetc(f);
+        if (c == '#') {
+            while (c != EOF && c != '\n') c = std::fgetc(f);
+            continue;
+        }
+        break;
+    }
+    while (c != EOF && !std::isspace(c)) {
+        tok.push_back((char)c);
+        c = std::fgetc(f);
+    }
+    // The single whitespace after the last header token has been consumed.
+    return !tok.empty();
+}
+
+static bool ReadPnmUInt(FILE* f, uint32_t* out) {
+    std::string tok;
+    if (!ReadPnmToken(f, tok)) return false;
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long v = std::strtoul(tok.c_str(), &end, 10);
+    if (!end || *end != '\0' || errno == ERANGE || v > UINT32_MAX) return false;
+    *out = (uint32_t)v;
+    return true;
+}
+
+static std::string FrameSizeError(const char* what) {
+    return std::string(what) + " frame size out of range (each side 1.." + std::to_string(kMaxFrameSide) + ")";
+}
+
+static bool ReadLine(FILE* f, std::string& line) {
+    line.clear();
+    int c = 0;
+    while ((c = std::fgetc(f)) != EOF && c != '\n') line.push_back((char)c);
+    return c != EOF || !line.empty();
+}
+
+static bool ReadNetpbm(FILE* f, Frame& out, std::string* err) {
+    char magic[3] = {};
+    if (std::fread(magic, 1, 2, f) != 2 || magic[0] != 'P') {
+        SetErr(err, "not a Netpbm file");
+        return false;
+    }
+
+    unsigned long w = 0, h = 0;
+    uint32_t depth = 0, maxval = 0;
+    if (magic[1] == '5' || magic[1] == '6') {
+        depth = (magic[1] == '5') ? 1 : 3;
+        uint32_t w32 = 0, h32 = 0;
+        if (!ReadPnmUInt(f, &w32) || !ReadPnmUInt(f, &h32) || !ReadPnmUInt(f, &maxval)) {
+            SetErr(err, "bad PGM/PPM header");
+            return false;
+        }
+        w = w32;
+        h = h32;
+    } else if (magic[1] == '7') {
+        std::string line;
+        ReadLine(f, line); // rest of the magic line
+        bool ended = false;
+        while (ReadLine(f, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            char key[32] = {};
+            unsigned long v = 0;
+            if (line == "ENDHDR") {
+                ended = true;
+                break;
+            }
+            if (std::sscanf(line.c_str(), "%31s %lu", key, &v) == 2) {
+                // Out-of-range DEPTH / MAXVAL saturate so the checks below reject them.
+                if (std::strcmp(key, "WIDTH") == 0) w = v;
+                else if (std::strcmp(key, "HEIGHT") == 0) h = v;
+                else if (std::strcmp(key, "DEPTH") == 0) depth = (uint32_t)std::min<unsigned long>(v, UINT32_MAX);
+                else if (std::strcmp(key, "MAXVAL") == 0) maxval = (uint32_t)std::min<unsigned long>(v, UINT32_MAX);
+            }
+        }
+        if (!ended) {
+            SetErr(err, "bad PAM header");
+            return false;
+        }
+    } else {
+        SetErr(err, "unsupported Netpbm type (need P5, P6 or P7)");
+        return false;
+    }
+
+    if (w == 0 || h == 0 || depth < 1 || depth > 4 || maxval == 0 || maxval > 65535) {
+        SetErr(err, "unsupported Netpbm dimensions/depth/maxval");
+        return false;
+    }
+    if (!IsFrameSizeSupported(w, h)) {
+        SetErr(err, FrameSizeError("Netpbm"));
+        return false;
+    }
+
+    const size_t bytesPerSample = (maxval < 256) ? 1 : 2;
+    std::vector<uint8_t> row((size_t)w * depth * bytesPerSample);
+    out.Resize(w, h);
+
+    for (uint32_t y = 0; y < h; ++y) {
+        if (std::fread(row.data(), 1, row.size(), f) != row.size()) {
+            SetErr(err, "truncated Netpbm data");
+            return false;
+        }
+        uint8_t* dst = out.bgra.data() + (size_t)y * out.Stride();
+        for (uint32_t x = 0; x < w; ++x) {
+            uint32_t s[4] = { 0, 0, 0, maxval };
+            for (uint32_t c = 0; c < depth; ++c) {
+                const size_t i = ((size_t)x * depth + c) * bytesPerSample;
+                s[c] = (bytesPerSample == 1) ? row[i] : (((uint32_t)row[i] << 8) | row[i + 1]);
+            }
+            uint32_t r = s[0], g = s[0], b = s[0], a = maxval;
+            if (depth == 2) a = s[1];
+            if (depth >= 3) { g = s[1]; b = s[2]; }
+            if (depth == 4) a = s[3];
+
+            auto to8 = [maxval](uint32_t v) -> uint8_t { return (uint8_t)((v * 255u + maxval / 2) / maxval); };
+            dst[(size_t)x * 4 + 0] = to8(b);
+            dst[(size_t)x * 4 + 1] = to8(g);
+            dst[(size_t)x * 4 + 2] = to8(r);
+            dst[(size_t)x * 4 + 3] = to8(a);
+        }
+    }
+    return true;
+}
+
+static bool WriteNetpbm(FILE* f, const Frame& frame, bool pam) {
+    if (pam) {
+        std::fprintf(f, "P7\nWIDTH %u\nHEIGHT %u\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n", frame.width, frame.height);
+    } else {
+        std::fprintf(f, "P6\n%u %u\n255\n", frame.width, frame.height);
+    }
+
+    const uint32_t depth = pam ? 4 : 3;
+    std::vector<uint8_t> row((size_t)frame.width * depth);
+    for (uint32_t y = 0; y < frame.height; ++y) {
+        const uint8_t* src = frame.bgra.data() + (size_t)y * frame.Stride();
+        for (uint32_t x = 0; x < frame.width; ++x) {
+            uint8_t* d = row.data() + (size_t)x * depth;
+            d[0] = src[(size_t)x * 4 + 2];
+            d[1] = src[(size_t)x * 4 + 1];
+            d[2] = src[(size_t)x * 4 + 0];
+            if (pam) d[3] = src[(size_t)x * 4 + 3];
+        }
+        if (std::fwrite(row.data(), 1, row.size(), f) != row.size()) return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// YUV <-> BGRA (8-bit, limited range)
+// ------------------------------------------------------------
+struct YuvCoeffs {
+    // RGB from YUV: R = y*ky + v*rv, G = y*ky + u*gu + v*gv, B = y*ky + u*bu (all >> 8)
+    int ky, rv, gu, gv, bu;
+    // YUV from RGB (>> 8)
+    int yr, yg, yb, ur, ug, ub, vr, vg, vb;
+};
+
+static const YuvCoeffs& Coeffs(YuvMatrix m) {
+    static const YuvCoeffs k601 = { 298, 409, -100, -208, 516, 66, 129, 25, -38, -74, 112, 112, -94, -18 };
+    static const YuvCoeffs k709 = { 298, 459, -55, -136, 541, 47, 157, 16, -26, -87, 112, 112, -102, -10 };
+    return (m == YuvMatrix::Bt709) ? k709 : k601;
+}
+
+static void YuvToBgra(const YuvCoeffs& k, int y, int u, int v, uint8_t* dst) {
+    const int c = (y - 16) * k.ky;
+    const int d = u - 128;
+    const int e = v - 128;
+    dst[0] = ClampByte((c + k.bu * d + 128) >> 8);
+    dst[1] = ClampByte((c + k.gu * d + k.gv * e + 128) >> 8);
+    dst[2] = ClampByte((c + k.rv * e + 128) >> 8);
+    dst[3] = 255;
+}
+
+static uint8_t LumaFromRgb(const YuvCoeffs& k, int r, int g, int b) {
+    return ClampByte(((k.yr * r + k.yg * g + k.yb * b + 128) >> 8) + 16);
+}
+
+static void ChromaFromRgb(const YuvCoeffs& k, int r, int g, int b, uint8_t* u, uint8_t* v) {
+    *u = ClampByte(((k.ur * r + k.ug * g + k.ub * b + 128) >> 8) + 128);
+    *v = ClampByte(((k.vr * r + k.vg * g + k.vb * b + 128) >> 8) + 128);
+}
+
+// ------------------------------------------------------------
+// Readers
+// ------------------------------------------------------------
+class ImageSequenceReader : public FrameReader {
+public:
+    ImageSequenceReader(const std::string& pattern, int firstIndex)
+        : pattern_(pattern), sequence_(IsSequencePattern(pattern)), index_(firstIndex) {
+        if (sequence_ && index_ < 0) {
+            // Accept sequences numbered from 0 or from 1.
+            FILE* probe = std::fopen(FormatSequencePath(pattern_, 0).c_str(), "rb");
+            index_ = probe ? 0 : 1;
+            if (probe) std::fclose(probe);
+        }
+    }
+
+    bool ReadFrame(Frame& out) override {
+        if (done_) return false;
+        const std::string path = sequence_ ? FormatSequencePath(pattern_, index_) : pattern_;
+
+        if (sequence_ && readAny_) {
+            // A missing next file ends the sequence.
+            FILE* probe = std::fopen(path.c_str(), "rb");
+            if (!probe) {
+                done_ = true;
+                return false;
+            }
+            std::fclose(probe);
+        }
+
+        std::string err;
+        if (!ReadImage(path, out, &err)) {
+            error_ = path + ": " + err;
+            done_ = true;
+            return false;
+        }
+        readAny_ = true;
+        ++index_;
+        if (!sequence_) done_ = true;
+        return true;
+    }
+
+private:
+    std::string pattern_;
+    bool sequence_ = false;
+    int index_ = 0;
+    bool readAny_ = false;
+    bool done_ = false;
+};
+
+class StreamReaderBase : public FrameReader {
+public:
+    StreamReaderBase(FILE* f, bool owns) : file_(f), owns_(owns) {}
+    ~StreamReaderBase() override {
+        if (file_ && owns_) std::fclose(file_);
+    }
+
+protected:
+    // Reads exactly n bytes; a clean EOF before the first byte is not an error.
+    bool ReadExact(uint8_t* dst, size_t n) {
+        const size_t got = std::fread(dst, 1, n, file_);
+        if (got == n) return true;
+        if (got != 0 || !std::feof(file_)) error_ = "truncated frame";
+        return false;
+    }
+
+    FILE* file_ = nullptr;
+    bool owns_ = false;
+};
+
+class RawBgraReader : public StreamReaderBase {
+public:
+    RawBgraReader(FILE* f, bool owns, uint32_t w, uint32_t h) : StreamReaderBase(f, owns), w_(w), h_(h) {}
+
+    bool ReadFrame(Frame& out) override {
+        out.Resize(w_, h_);
+        return ReadExact(out.bgra.data(), out.bgra.size());
+    }
+
+private:
+    uint32_t w_ = 0;
+    uint32_t h_ = 0;
+};
+
+class Y4mReader : public StreamReaderBase {
+public:
+    Y4mReader(FILE* f, bool owns, YuvMatrix matrix) : StreamReaderBase(f, owns), coeffs_(Coeffs(matrix)) {}
+
+    bool ParseHeader(std::string* err) {
+        std::string line;
+        if (!ReadLine(file_, line) || line.compare(0, 10, "YUV4MPEG2 ") != 0) {
+            SetErr(err, "not a YUV4MPEG2 stream");
+            return false;
+        }
+
+        std::string chroma = "420jpeg";
+        unsigned long long w = 0, h = 0; // saturated by strtoull, so the range check sees overflows
+        size_t pos = 10;
+        while (pos < line.size()) {
+            const size_t end = std::min(line.find(' ', pos), line.size());
+            const std::string tok = line.substr(pos, end - pos);
+            pos = end + 1;
+            if (tok.empty()) continue;
+            switch (tok[0]) {
+            case 'W': w = std::strtoull(tok.c_str() + 1, nullptr, 10); break;
+            case 'H': h = std::strtoull(tok.c_str() + 1, nullptr, 10); break;
+            case 'F': {
+                unsigned long n = 0, d = 0;
+                if (std::sscanf(tok.c_str() + 1, "%lu:%lu", &n, &d) == 2 && n && d) {
+                    fpsNum_ = (uint32_t)n;
+                    fpsDen_ = (uint32_t)d;
+                }
+                break;
+            }
+            case 'C': chroma = tok.substr(1); break;
+            default: break;
+            }
+        }
+
+        if (chroma == "420jpeg" || chroma == "420paldv" || chroma == "420mpeg2" || chroma == "420") {
+            subX_ = subY_ = 2;
+        } else if (chroma == "444") {
+            subX_ = subY_ = 1;
+        } else if (chroma == "mono") {
+            mono_ = true;
+        } else {
+            SetErr(err, "unsupported Y4M chroma C" + chroma + " (need 420*, 444 or mono, 8-bit)");
+            return false;
+        }
+        if (w == 0 || h == 0) {
+            SetErr(err, "Y4M header missing W/H");
+            return false;
+        }
+        if (!IsFrameSizeSupported(w, h)) {
+            SetErr(err, FrameSizeError("Y4M"));
+            return false;
+        }
+        w_ = (uint32_t)w;
+        h_ = (uint32_t)h;
+
+        const size_t cw = mono_ ? 0 : (w_ + subX_ - 1) / subX_;
+        const size_t ch = mono_ ? 0 : (h_ + subY_ - 1) / subY_;
+        planes_.resize((size_t)w_ * h_ + 2 * cw * ch);
+        return true;
+    }
+
+    bool ReadFrame(Frame& out) override {
+        std::string line;
+        if (!ReadLine(file_, line)) return false; // end of stream
+        if (line.compare(0, 5, "FRAME") != 0) {
+            error_ = "bad Y4M frame marker";
+            return false;
+        }
+        if (!ReadExact(planes_.data(), planes_.size())) {
+            if (error_.empty()) error_ = "truncated frame";
+            return false;
+        }
+
+        out.Resize(w_, h_);
+        const uint8_t* yp = planes_.data();
+        const size_t cw = mono_ ? 0 : (w_ + subX_ - 1) / subX_;
+        const size_t ch = mono_ ? 0 : (h_ + subY_ - 1) / subY_;
+        const uint8_t* up = yp + (size_t)w_ * h_;
+        const uint8_t* vp = up + cw * ch;
+
+        for (uint32_t y = 0; y < h_; ++y) {
+            uint8_t* dst = out.bgra.data() + (size_t)y * out.Stride();
+            const uint8_t* yRow = yp + (size_t)y * w_;
+            const uint8_t* uRow = mono_ ? nullptr : up + (size_t)(y / subY_) * cw;
+            const uint8_t* vRow = mono_ ? nullptr : vp + (size_t)(y / subY_) * cw;
+            for (uint32_t x = 0; x < w_; ++x) {
+                const int u = mono_ ? 128 : uRow[x / subX_];
+                const int v = mono_ ? 128 : vRow[x / subX_];
+                YuvToBgra(coeffs_, yRow[x], u, v, dst + (size_t)x * 4);
+            }
+        }
+        return true;
+    }
+
+private:
+    const YuvCoeffs& coeffs_;
+    uint32_t w_ = 0;
+    uint32_t h_ = 0;
+    uint32_t subX_ = 2;
+    uint32_t subY_ = 2;
+    bool mono_ = false;
+    std::vector<uint8_t> planes_;
+};
+
+// ------------------------------------------------------------
+// Writers
+// ------------------------------------------------------------
+class ImageSequenceWriter : public FrameWriter {
+public:
+    ImageSequenceWriter(const std::string& pattern, int firstIndex)
+        : pattern_(pattern), sequence_(IsSequencePattern(pattern)), index_(firstIndex) {}
+
+    bool WriteFrame(const Frame& frame) override {
+        if (!sequence_ && written_ > 0) {
+            error_ = "output '" + pattern_ + "' is a single image; use a %d pattern for multiple frames";
+            return false;
+        }
+        const std::string path = sequence_ ? FormatSequencePath(pattern_, index_) : pattern_;
+        std::string err;
+        if (!WriteImage(path, frame, &err)) {
+            error_ = path + ": " + err;
+            return false;
+        }
+        ++index_;
+        ++written_;
+        return true;
+    }
+
+private:
+    std::string pattern_;
+    bool sequence_ = false;
+    int index_ = 0;
+    int written_ = 0;
+};
+
+class StreamWriterBase : public FrameWriter {
+public:
+    StreamWriterBase(FILE* f, bool owns) : file_(f), owns_(owns) {}
+    ~StreamWriterBase() override {
+        if (file_ && owns_) std::fclose(file_);
+    }
+
+    bool Finish() override {
+        if (file_ && std::fflush(file_) != 0) {
+            error_ = "flush failed";
+            return false;
+        }
+        return true;
+    }
+
+protected:
+    bool WriteAll(const void* data, size_t n) {
+        if (std::fwrite(data, 1, n, file_) == n) return true;
+        error_ = "write failed";
+        return false;
+    }
+
+    FILE* file_ = nullptr;
+    bool owns_ = false;
+};
+
+class RawBgraWriter : public StreamWriterBase {
+public:
+    using StreamWriterBase::StreamWriterBase;
+
+    bool WriteFrame(const Frame& frame) override {
+        return WriteAll(frame.bgra.data(), frame.bgra.size());
+    }
+};
+
+class Y4mWriter : public StreamWriterBase {
+public:
+    Y4mWriter(FILE* f, bool owns, const WriterOptions& opt)
+        : StreamWriterBase(f, owns), coeffs_(Coeffs(opt.matrix)), fpsNum_(opt.fpsNum ? opt.fpsNum : 30), fpsDen_(opt.fpsDen ? opt.fpsDen : 1), is444_(opt.y4m444) {}
+
+    bool WriteFrame(const Frame& frame) override {
+        if (w_ == 0) {
+            w_ = frame.width;
+            h_ = frame.height;
+            char header[128];
+            std::snprintf(header, sizeof(header), "YUV4MPEG2 W%u H%u F%u:%u Ip A1:1 C%s\n", w_, h_, fpsNum_, fpsDen_, is444_ ? "444" : "420jpeg");
+            if (!WriteAll(header, std::strlen(header))) return false;
+        } else if (frame.width != w_ || frame.height != h_) {
+            error_ = "Y4M frame size changed mid-stream";
+            return false;
+        }
+
+        const uint32_t sub = is444_ ? 1 : 2;
+        const size_t cw = (w_ + sub - 1) / sub;
+        const size_t ch = (h_ + sub - 1) / sub;
+        planes_.resize((size_t)w_ * h_ + 2 * cw * ch);
+        uint8_t* yp = planes_.data();
+        uint8_t* up = yp + (size_t)w_ * h_;
+        uint8_t* vp = up + cw * ch;
+
+        for (uint32_t y = 0; y < h_; ++y) {
+            const uint8_t* src = frame.bgra.data() + (size_t)y * frame.Stride();
+            for (uint32_t x = 0; x < w_; ++x) {
+                const uint8_t* p = src + (size_t)x * 4;
+                yp[(size_t)y * w_ + x] = LumaFromRgb(coeffs_, p[2], p[1], p[0]);
+            }
+        }
+
+        // Chroma from the average RGB of each sub x sub block.
+        for (size_t cy = 0; cy < ch; ++cy) {
+            for (size_t cx = 0; cx < cw; ++cx) {
+                int r = 0, g = 0, b = 0, n = 0;
+                for (uint32_t dy = 0; dy < sub; ++dy) {
+                    const size_t y = cy * sub + dy;
+                    if (y >= h_) break;
+                    for (uint32_t dx = 0; dx < sub; ++dx) {
+                        const size_t x = cx * sub + dx;
+                        if (x >= w_) break;
+                        const uint8_t* p = frame.bgra.data() + y * frame.Stride() + x * 4;
+                        r += p[2];
+                        g += p[1];
+                        b += p[0];
+                        ++n;
+                    }
+                }
+                ChromaFromRgb(coeffs_, (r + n / 2) / n, (g + n / 2) / n, (b + n / 2) / n, &up[cy * cw + cx], &vp[cy * cw + cx]);
+            }
+        }
+
+        static const char kFrame[] = "FRAME\n";
+        return WriteAll(kFrame, sizeof(kFrame) - 1) && WriteAll(planes_.data(), planes_.size());
+    }
+
+private:
+    const YuvCoeffs& coeffs_;
+    uint32_t fpsNum_ = 30;
+    uint32_t fpsDen_ = 1;
+    bool is444_ = false;
+    uint32_t w_ = 0;
+    uint32_t h_ = 0;
+    std::vector<uint8_t> planes_;
+};
+
+} // namespace
+
+bool HasPngSupport() {
+#if defined(AC_HAVE_LIBPNG)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ParseFormat(const std::string& name, Format* out) {
+    const std::string n = ToLower(name);
+    if (n == "auto") *out = Format::Auto;
+    else if (n == "image" || n == "ppm" || n == "png" || n == "pam") *out = Format::Image;
+    else if (n == "raw" || n == "bgra") *out = Format::RawBgra;
+    else if (n == "y4m") *out = Format::Y4m;
+    else return false;
+    return true;
+}
+
+bool ReadImage(const std::string& path, Frame& out, std::string* err) {
+    const std::string ext = Extension(path);
+    if (ext == "png") {
+#if defined(AC_HAVE_LIBPNG)
+        png_image image;
+        std::memset(&image, 0, sizeof(image));
+        image.version = PNG_IMAGE_VERSION;
+        if (!png_image_begin_read_from_file(&image, path.c_str())) {
+            SetErr(err, image.message);
+            return false;
+        }
+        if (!IsFrameSizeSupported(image.width, image.height)) {
+            SetErr(err, FrameSizeError("PNG"));
+            png_image_free(&image);
+            return false;
+        }
+        image.format = PNG_FORMAT_BGRA;
+        out.Resize(image.width, image.height);
+        if (!png_image_finish_read(&image, nullptr, out.bgra.data(), (png_int_32)out.Stride(), nullptr)) {
+            SetErr(err, image.message);
+            png_image_free(&image);
+            return false;
+        }
+        return true;
+#else
+        SetErr(err, "PNG support not built in (libpng not found at configure time)");
+        return false;
+#endif
+    }
+
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        SetErr(err, "cannot open");
+        return false;
+    }
+    const bool ok = ReadNetpbm(f, out, err);
+    std::fclose(f);
+    return ok;
+}
+
+bool WriteImage(const std::string& path, const Frame& frame, std::string* err) {
+    const std::string ext = Extension(path);
+    if (ext == "png") {
+#if defined(AC_HAVE_LIBPNG)
+        png_image image;
+        std::memset(&image, 0, sizeof(image));
+        image.version = PNG_IMAGE_VERSION;
+        image.width = frame.width;
+        image.height = frame.height;
+        image.format = PNG_FORMAT_BGRA;
+        if (!png_image_write_to_file(&image, path.c_str(), 0, frame.bgra.data(), (png_int_32)frame.Stride(), nullptr)) {
+            SetErr(err, image.message);
+            return false;
+        }
+        return true;
+#else
+        SetErr(err, "PNG support not built in (libpng not found at configure time)");
+        return false;
+#endif
+    }
+
+    if (ext != "ppm" && ext != "pam") {
+        SetErr(err, "unsupported image extension (use .ppm, .pam" + std::string(HasPngSupport() ? " or .png)" : ")"));
+        return false;
+    }
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        SetErr(err, "cannot create");
+        return false;
+    }
+    bool ok = WriteNetpbm(f, frame, ext == "pam");
+    if (std::fclose(f) != 0) ok = false;
+    if (!ok) SetErr(err, "write failed");
+    return ok;
+}
+
+bool IsSequencePattern(const std::string& pattern) {
+    return pattern.find('%') != std::string::npos;
+}
+
+std::string FormatSequencePath(const std::string& pattern, int index) {
+    if (!IsSequencePattern(pattern)) return pattern;
+    char buf[4096];
+    std::snprintf(buf, sizeof(buf), pattern.c_str(), index);
+    return buf;
+}
+
+std::unique_ptr<FrameReader> OpenStreamReader(FILE* file, bool ownsFile, const ReaderOptions& opt, std::string* err) {
+    if (!file) {
+        SetErr(err, "no input stream");
+        return nullptr;
+    }
+
+    if (opt.format == Format::RawBgra) {
+        if (opt.rawWidth == 0 || opt.rawHeight == 0) {
+            if (ownsFile) std::fclose(file);
+            SetErr(err, "raw BGRA input needs a frame size (--size WxH)");
+            return nullptr;
+        }
+        if (!IsFrameSizeSupported(opt.rawWidth, opt.rawHeight)) {
+            if (ownsFile) std::fclose(file);
+            SetErr(err, FrameSizeError("raw BGRA"));
+            return nullptr;
+        }
+        return std::make_unique<RawBgraReader>(file, ownsFile, opt.rawWidth, opt.rawHeight);
+    }
+
+    if (opt.format == Format::Y4m) {
+        auto r = std::make_unique<Y4mReader>(file, ownsFile, opt.matrix);
+        if (!r->ParseHeader(err)) return nullptr;
+        return r;
+    }
+
+    if (ownsFile) std::fclose(file);
+    SetErr(err, "streams must be raw BGRA or Y4M");
+    return nullptr;
+}
+
+std::unique_ptr<FrameReader> OpenReader(const std::string& path, const ReaderOptions& opt, std::string* err) {
+    ReaderOptions o = opt;
+    if (IsStdStreamPath(path)) {
+        if (o.format == Format::Auto) o.format = (o.rawWidth && o.rawHeight) ? Format::RawBgra : Format::Y4m;
+        if (o.format == Format::Image) {
+            SetErr(err, "stdin must be raw BGRA or Y4M");
+            return nullptr;
+        }
+        return OpenStreamReader(PrepareStream(stdin), false, o, err);
+    }
+
+    if (o.format == Format::Auto) o.format = FormatFromPath(path);
+
+    if (o.format == Format::Image) {
+        return std::make_unique<ImageSequenceReader>(path, o.firstIndex);
+    }
+
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        SetErr(err, path + ": cannot open");
+        return nullptr;
+    }
+    return OpenStreamReader(PrepareStream(f), true, o, err);
+}
+
+std::unique_ptr<FrameWriter> OpenStreamWriter(FILE* file, bool ownsFile, const WriterOptions& opt, std::string* err) {
+    if (!file) {
+        SetErr(err, "no output stream");
+        return nullptr;
+    }
+    if (opt.format == Format::RawBgra) return std::make_unique<RawBgraWriter>(file, ownsFile);
+    if (opt.format == Format::Y4m) return std::make_unique<Y4mWriter>(file, ownsFile, opt);
+
+    if (ownsFile) std::fclose(file);
+    SetErr(err, "streams must be raw BGRA or Y4M");
+    return nullptr;
+}
+
+std::unique_ptr<FrameWriter> OpenWriter(const std::string& path, const WriterOptions& opt, std::string* err) {
+    WriterOptions o = opt;
+    if (IsStdStreamPath(path)) {
+        if (o.format == Format::Auto) o.format = Format::Y4m;
+        if (o.format == Format::Image) {
+            SetErr(err, "stdout must be raw BGRA or Y4M");
+            return nullptr;
+        }
+        return OpenStreamWriter(PrepareStream(stdout), false, o, err);
+    }
+
+    if (o.format == Format::Auto) o.format = FormatFromPath(path);
+
+    if (o.format == Format::Image) {
+        return std::make_unique<ImageSequenceWriter>(path, o.firstIndex);
+    }
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        SetErr(err, path + ": cannot create");
+        return nullptr;
+    }
+    return OpenStreamWriter(PrepareStream(f), true, o, err);
+}
+
+} // namespace FrameIO
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Portable frame readers/writers for the offline converter (no Windows dependencies).
+// All frames are BGRA8 (DXGI_FORMAT_B8G8R8A8_UNORM byte order), tightly packed.
+namespace FrameIO {
+
+// Largest frame side the readers accept (headers, --size); larger or overflowing sizes are rejected
+// with an error instead of attempting the allocation.
+static constexpr uint32_t kMaxFrameSide = 16384;
+
+inline bool IsFrameSizeSupported(unsigned long long w, unsigned long long h) {
+    return w != 0 && h != 0 && w <= kMaxFrameSide && h <= kMaxFrameSide;
+}
+
+struct Frame {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> bgra; // width * height * 4
+
+    size_t Stride() const { return (size_t)width * 4; }
+    void Resize(uint32_t w, uint32_t h) {
+        width = w;
+        height = h;
+        bgra.resize((size_t)w * h * 4);
+    }
+};
+
+enum class Format {
+    Auto = 0,   // from the file extension
+    Image,      // single image or numbered sequence (.ppm/.pgm/.pam, .png when built with libpng)
+    RawBgra,    // headerless BGRA8 stream; frame size must be given
+    Y4m,        // YUV4MPEG2 stream (8-bit 4:2:0 / 4:4:4 / mono in, 4:2:0 / 4:4:4 out)
+};
+
+// YUV <-> RGB matrix for Y4M (limited range). Y4M headers do not carry it.
+enum class YuvMatrix {
+    Bt601 = 0,
+    Bt709,
+};
+
+bool HasPngSupport();
+bool ParseFormat(const std::string& name, Format* out);
+
+// Single images (format from extension).
+bool ReadImage(const std::string& path, Frame& out, std::string* err);
+bool WriteImage(const std::string& path, const Frame& frame, std::string* err);
+
+// Expands a printf-style sequence pattern ("frames/%05d.png"); patterns without '%' are returned as-is.
+std::string FormatSequencePath(const std::string& pattern, int index);
+bool IsSequencePattern(const std::string& pattern);
+
+struct ReaderOptions {
+    Format format = Format::Auto;
+    uint32_t rawWidth = 0;   // RawBgra only
+    uint32_t rawHeight = 0;
+    int firstIndex = -1;     // sequences: -1 = try 0, then 1
+    YuvMatrix matrix = YuvMatrix::Bt601;
+};
+
+struct WriterOptions {
+    Format format = Format::Auto;
+    int firstIndex = 0;      // sequences
+    uint32_t fpsNum = 30;    // Y4M header
+    uint32_t fpsDen = 1;
+    bool y4m444 = false;     // Y4M: C444 instead of C420jpeg
+    YuvMatrix matrix = YuvMatrix::Bt601;
+};
+
+class FrameReader {
+public:
+    virtual ~FrameReader() = default;
+
+    // False at end of stream or on error (GetError() is non-empty on error).
+    virtual bool ReadFrame(Frame& out) = 0;
+
+    // Source frame rate if known (Y4M), else 0/0.
+    uint32_t GetFpsNum() const { return fpsNum_; }
+    uint32_t GetFpsDen() const { return fpsDen_; }
+    const std::string& GetError() const { return error_; }
+
+protected:
+    uint32_t fpsNum_ = 0;
+    uint32_t fpsDen_ = 0;
+    std::string error_;
+};
+
+class FrameWriter {
+public:
+    virtual ~FrameWriter() = default;
+    virtual bool WriteFrame(const Frame& frame) = 0;
+    virtual bool Finish() { return true; }
+    const std::string& GetError() const { return error_; }
+
+protected:
+    std::string error_;
+};
+
+// Path "-" is stdin/stdout (Auto picks Y4M, or raw BGRA on input when rawWidth/rawHeight are set).
+// Named pipes (mkfifo / \\.\pipe\name) open like regular files; give the format explicitly if the name has no extension.
+// `file` variants stream over an already-open FILE* (e.g. a pipe); `ownsFile` closes it on destruction.
+std::unique_ptr<FrameReader> OpenReader(const std::string& path, const ReaderOptions& opt, std::string* err);
+std::unique_ptr<FrameReader> OpenStreamReader(FILE* file, bool ownsFile, const ReaderOptions& opt, std::string* err);
+std::unique_ptr<FrameWriter> OpenWriter(const std::string& path, const WriterOptions& opt, std::string* err);
+std::unique_ptr<FrameWriter> OpenStreamWriter(FILE* file, bool ownsFile, const WriterOptions& opt, std::string* err);
+
+} // namespace FrameIO
@@ -0,0 +1,36 @@
+#include "FramePacer.h"
+
+FramePacer::Decision FramePacer::Next(int64_t nowTicks, double intervalSec) {
+    Decision d;
+
+    const int64_t intervalTicks = (intervalSec > 0.0) ? (int64_t)(intervalSec * (double)ticksPerSecond_) : 0;
+    if (intervalTicks <= 0) {
+        // Unlimited: render as fast as possible, but still yield to the message queue.
+        d.action = Action::RenderAndYield;
+        return d;
+    }
+
+    if (!scheduled_) {
+        nextFrameTicks_ = nowTicks + intervalTicks;
+        scheduled_ = true;
+    }
+
+    if (nowTicks >= nextFrameTicks_) {
+        nextFrameTicks_ += intervalTicks;
+        // If we fell far behind, resync instead of trying to "catch up".
+        if (nowTicks - nextFrameTicks_ > intervalTicks * kResyncIntervals) {
+            nextFrameTicks_ = nowTicks + intervalTicks;
+            ++resyncCount_;
+        }
+        d.action = Action::Render;
+        return d;
+    }
+
+    const int64_t remaining = nextFrameTicks_ - nowTicks;
+    uint32_t timeoutMs = (uint32_t)((remaining * 1000LL) / ticksPerSecond_);
+    // Avoid a long oversleep; wake at least every 1ms.
+    if (timeoutMs > 1) timeoutMs -= 1;
+    d.action = Action::Wait;
+    d.waitMs = timeoutMs;
+    return d;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+// Render-loop pacing policy of the WinMain message loop, kept free of Win32 calls so the same
+// decisions can be driven by a simulated clock (PacingSim / ArinPacingSim).
+// The clock is injected: every call passes the current time in ticks of the caller's clock
+// (QPC in the app), and the caller performs the returned action (render or wait).
+class FramePacer {
+public:
+    enum class Action {
+        Render,          // render now, then ask again immediately
+        RenderAndYield,  // unlimited frame rate: render, then only poll the message queue (0 ms wait)
+        Wait,            // sleep up to waitMs (message arrival may end it early), then ask again
+    };
+
+    struct Decision {
+        Action action = Action::Wait;
+        uint32_t waitMs = 0;
+    };
+
+    // Fell further behind than this many intervals -> resync instead of trying to catch up.
+    static constexpr int kResyncIntervals = 4;
+
+    explicit FramePacer(int64_t ticksPerSecond = 0) : ticksPerSecond_(ticksPerSecond) {}
+
+    void SetTicksPerSecond(int64_t ticksPerSecond) { ticksPerSecond_ = ticksPerSecond; }
+    int64_t GetTicksPerSecond() const { return ticksPerSecond_; }
+
+    // Forgets the schedule (capture stopped / paused); the next frame is due one interval after the next call.
+    void Reset() { scheduled_ = false; nextFrameTicks_ = 0; }
+
+    // intervalSec <= 0 means unlimited (Renderer::GetFrameInterval()).
+    Decision Next(int64_t nowTicks, double intervalSec);
+
+    bool IsScheduled() const { return scheduled_; }
+    int64_t GetNextFrameTicks() const { return nextFrameTicks_; }
+    uint64_t GetResyncCount() const { return resyncCount_; }
+
+private:
+    int64_t ticksPerSecond_ = 0;
+    int64_t nextFrameTicks_ = 0;
+    bool scheduled_ = false;
+    uint64_t resyncCount_ = 0;
+};
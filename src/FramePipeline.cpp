@@ -0,0 +1,210 @@
+#include "FramePipeline.h"
+
+#include "BoundedQueue.h"
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using FramePtr = std::unique_ptr<FrameIO::Frame>;
+
+// A rendered frame and the extra outputs resampled from its depth (FramePipeline::AddOutput order).
+struct OutFrames {
+    FrameIO::Frame frame;
+    std::vector<FrameIO::Frame> outputs;
+};
+using OutPtr = std::unique_ptr<OutFrames>;
+
+static double SecondsSince(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+} // namespace
+
+DepthCpu::Params FramePipeline::ToEngineParams(const StreamParams& params, uint32_t inWidth, uint32_t inHeight) {
+    DepthCpu::Params p;
+    p.outWidth = params.outWidth ? params.outWidth : inWidth;
+    p.outHeight = params.outHeight ? params.outHeight : inHeight;
+    p.parallaxPx = (params.parallaxPx >= 0.0f)
+        ? params.parallaxPx
+        : DepthCpu::ParallaxPxFromSettings(params.depthLevel, params.parallaxStrengthPercent);
+    DepthCpu::SetCropNormalized(p, params.crop[0], params.crop[1], params.crop[2], params.crop[3]);
+    return p;
+}
+
+void FramePipeline::AddOutput(FrameIO::FrameWriter& writer, DepthCpu::StereoLayout layout, uint32_t outWidth, uint32_t outHeight) {
+    Output o;
+    o.writer = &writer;
+    o.layout = layout;
+    o.outWidth = outWidth;
+    o.outHeight = outHeight;
+    outputs_.push_back(o);
+}
+
+void FramePipeline::Fail(const std::string& msg) {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    if (error_.empty()) error_ = msg;
+    abort_.store(true, std::memory_order_relaxed);
+}
+
+bool FramePipeline::Run(FrameIO::FrameReader& reader, FrameIO::FrameWriter& writer, const StreamParams& params, long maxFrames) {
+    stats_ = Stats{};
+    error_.clear();
+    abort_.store(false, std::memory_order_relaxed);
+
+    // Free lists hold recycled buffers; the other two carry frames between stages. Interpolation keeps
+    // the previous input and the current output on the worker, so each list gets one buffer more.
+    const bool interpolate = interpFactor_ > 1;
+    if (!outputs_.empty() && (interpolate || engine_.GetLetterboxDetection())) {
+        error_ = "extra outputs do not support interpolation or letterbox detection";
+        return false;
+    }
+    const size_t spare = interpolate ? 1 : 0;
+    BoundedQueue<FramePtr> freeIn(queueDepth_ + spare);
+    BoundedQueue<FramePtr> decoded(queueDepth_);
+    BoundedQueue<OutPtr> freeOut(queueDepth_ + spare);
+    BoundedQueue<OutPtr> rendered(queueDepth_);
+    for (size_t i = 0; i < queueDepth_ + spare; ++i) {
+        freeIn.Push(std::make_unique<FrameIO::Frame>());
+        OutPtr o = std::make_unique<OutFrames>();
+        o->outputs.resize(outputs_.size());
+        freeOut.Push(std::move(o));
+    }
+    engine_.SetFrameInterpolation(interpolate);
+
+    auto abortAll = [&](const std::string& msg) {
+        Fail(msg);
+        freeIn.Close();
+        decoded.Close();
+        freeOut.Close();
+        rendered.Close();
+    };
+
+    const Clock::time_point start = Clock::now();
+
+    std::thread readerThread([&] {
+        long n = 0;
+        double sec = 0.0;
+        FramePtr f;
+        while ((maxFrames < 0 || n < maxFrames) && freeIn.Pop(f)) {
+            const Clock::time_point t0 = Clock::now();
+            const bool ok = reader.ReadFrame(*f);
+            sec += SecondsSince(t0);
+            if (!ok) {
+                if (!reader.GetError().empty()) abortAll(reader.GetError());
+                break;
+            }
+            if (!decoded.Push(std::move(f))) break;
+            ++n;
+        }
+        stats_.readSec = sec;
+        decoded.Close();
+    });
+
+    std::thread writerThread([&] {
+        long n = 0;
+        double sec = 0.0;
+        OutPtr f;
+        while (rendered.Pop(f)) {
+            if (abort_.load(std::memory_order_relaxed)) break;
+            const Clock::time_point t0 = Clock::now();
+            FrameIO::FrameWriter* failed = writer.WriteFrame(f->frame) ? nullptr : &writer;
+            for (size_t i = 0; !failed && i < outputs_.size(); ++i) {
+                if (!outputs_[i].writer->WriteFrame(f->outputs[i])) failed = outputs_[i].writer;
+            }
+            sec += SecondsSince(t0);
+            if (failed) {
+                abortAll(failed->GetError());
+                break;
+            }
+            ++n;
+            if (progress_) progress_(n);
+            if (!freeOut.Push(std::move(f))) break;
+        }
+        stats_.writeSec = sec;
+        stats_.frames = n;
+    });
+
+    // Worker: this thread drives the engine (which fans out to its own ThreadPool, if any).
+    {
+        double sec = 0.0;
+        double outputSec = 0.0;
+        FramePtr in;
+        OutPtr out;
+        FramePtr prev;                 // interpolation: the previous input frame
+        std::vector<uint8_t> prevOut;  // and its output, repeated where synthesis is not possible
+        while (decoded.Pop(in)) {
+            if (abort_.load(std::memory_order_relaxed) || !freeOut.Pop(out)) break;
+
+            const DepthCpu::Params p = ToEngineParams(params, in->width, in->height);
+            uint32_t outW = 0;
+            uint32_t outH = 0;
+            DepthCpu::GetLayoutSize(p, engine_.GetLayout(), &outW, &outH);
+            out->frame.Resize(outW, outH);
+
+            const Clock::time_point t0 = Clock::now();
+            const DepthCpu::ImageView src{ in->bgra.data(), in->width, in->height, in->Stride() };
+            const DepthCpu::ImageRef dst{ out->frame.bgra.data(), out->frame.width, out->frame.height, out->frame.Stride() };
+            const bool ok = engine_.Render(src, p, dst);
+            sec += SecondsSince(t0);
+            if (!ok) {
+                abortAll("render failed");
+                break;
+            }
+
+            bool outputsOk = true;
+            const Clock::time_point t2 = Clock::now();
+            for (size_t i = 0; outputsOk && i < outputs_.size(); ++i) {
+                DepthCpu::Params op = p;
+                if (outputs_[i].outWidth) op.outWidth = outputs_[i].outWidth;
+                if (outputs_[i].outHeight) op.outHeight = outputs_[i].outHeight;
+                FrameIO::Frame& o = out->outputs[i];
+                uint32_t ow = 0;
+                uint32_t oh = 0;
+                DepthCpu::GetLayoutSize(op, outputs_[i].layout, &ow, &oh);
+                o.Resize(ow, oh);
+                const DepthCpu::ImageRef odst{ o.bgra.data(), o.width, o.height, o.Stride() };
+                outputsOk = engine_.RenderLayout(src, op, outputs_[i].layout, odst);
+            }
+            outputSec += SecondsSince(t2);
+            if (!outputsOk) {
+                abortAll("extra output failed");
+                break;
+            }
+
+            if (interpolate) {
+                const bool samePrev = prev && prev->width == in->width && prev->height == in->height && prevOut.size() == out->frame.bgra.size();
+                for (uint32_t j = 1; samePrev && j < interpFactor_; ++j) {
+                    OutPtr mid;
+                    if (!freeOut.Pop(mid)) break;
+                    mid->frame.Resize(outW, outH);
+                    const Clock::time_point t1 = Clock::now();
+                    const DepthCpu::ImageView a{ prev->bgra.data(), prev->width, prev->height, prev->Stride() };
+                    const DepthCpu::ImageRef m{ mid->frame.bgra.data(), mid->frame.width, mid->frame.height, mid->frame.Stride() };
+                    if (!engine_.RenderInterpolated(a, src, (float)j / (float)interpFactor_, p, m)) mid->frame.bgra = prevOut;
+                    sec += SecondsSince(t1);
+                    if (!rendered.Push(std::move(mid))) break;
+                }
+                prevOut = out->frame.bgra;
+                std::swap(prev, in);
+            }
+
+            if ((in && !freeIn.Push(std::move(in))) || !rendered.Push(std::move(out))) break;
+        }
+        stats_.renderSec = sec;
+        stats_.outputSec = outputSec;
+        // Unblock the reader if the worker stopped early.
+        freeIn.Close();
+        rendered.Close();
+    }
+
+    readerThread.join();
+    writerThread.join();
+    stats_.wallSec = SecondsSince(start);
+    return error_.empty();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "DepthCpu.h"
+#include "FrameIO.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Stereo parameters for a conversion run: the same inputs Renderer::Render works from
+// (source crop rect, depth level, parallax in output pixels).
+struct StreamParams {
+    // Normalized source crop (left, top, right, bottom).
+    float crop[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+    int depthLevel = 10;              // [1,20]
+    int parallaxStrengthPercent = 20; // [0,50]
+    float parallaxPx = -1.0f;         // < 0: derive from depthLevel/parallaxStrengthPercent
+
+    // Half-SBS canvas size (the output size in that layout, see DepthCpu::GetLayoutSize); 0 = same as the input frame.
+    uint32_t outWidth = 0;
+    uint32_t outHeight = 0;
+};
+
+// Overlapped read -> render -> write over FrameIO streams.
+// A reader thread and a writer thread run beside the calling (worker) thread, which drives
+// DepthCpu::Engine; frames are recycled through bounded queues so memory stays at a few
+// frames regardless of stream length, and a slow consumer back-pressures the decoder side.
+class FramePipeline {
+public:
+    struct Stats {
+        long frames = 0;
+        double readSec = 0.0;   // time inside FrameReader::ReadFrame
+        double renderSec = 0.0; // time inside Engine::Render / RenderInterpolated
+        double outputSec = 0.0; // time inside Engine::RenderLayout for the extra outputs
+        double writeSec = 0.0;  // time inside FrameWriter::WriteFrame (all outputs)
+        double wallSec = 0.0;
+    };
+
+    static constexpr size_t kDefaultQueueDepth = 3;
+
+    explicit FramePipeline(DepthCpu::Engine& engine) : engine_(engine) {}
+
+    // Frames in flight per stage boundary (minimum 1).
+    void SetQueueDepth(size_t depth) { queueDepth_ = depth ? depth : 1; }
+
+    // Frame-rate up-conversion: after the first input frame, every input frame is written as `factor`
+    // frames, the first factor - 1 synthesized between it and the previous input
+    // (Engine::RenderInterpolated, enabled on the engine by Run()). Where the engine cannot synthesize
+    // (e.g. letterbox bars narrowed the picture), the previous output is repeated. 1 = off.
+    void SetInterpolation(uint32_t factor) { interpFactor_ = factor ? factor : 1; }
+    uint32_t GetInterpolation() const { return interpFactor_; }
+
+    // Extra output fed from the same depth pass as the main one: after each Engine::Render the worker
+    // resamples the picture's depth into `layout` at its own half-SBS canvas size (0 = the main
+    // output's; see Engine::RenderLayout), and the writer thread writes it after the main frame. Not
+    // with interpolation or letterbox detection. `writer` must outlive Run(), which does not call its
+    // Finish() either.
+    void AddOutput(FrameIO::FrameWriter& writer, DepthCpu::StereoLayout layout, uint32_t outWidth, uint32_t outHeight);
+    size_t GetOutputCount() const { return outputs_.size(); }
+
+    // Called on the writer thread after each frame is written.
+    void SetProgressCallback(std::function<void(long framesWritten)> cb) { progress_ = std::move(cb); }
+
+    // Runs until the reader ends, `maxFrames` (< 0 = unlimited) frames are done, or a stage fails.
+    // Does not call writer.Finish().
+    bool Run(FrameIO::FrameReader& reader, FrameIO::FrameWriter& writer, const StreamParams& params, long maxFrames);
+
+    const Stats& GetStats() const { return stats_; }
+    const std::string& GetError() const { return error_; }
+
+    static DepthCpu::Params ToEngineParams(const StreamParams& params, uint32_t inWidth, uint32_t inHeight);
+
+private:
+    struct Output {
+        FrameIO::FrameWriter* writer = nullptr;
+        DepthCpu::StereoLayout layout = DepthCpu::StereoLayout::HalfSbs;
+        uint32_t outWidth = 0;
+        uint32_t outHeight = 0;
+    };
+
+    void Fail(const std::string& msg);
+
+    DepthCpu::Engine& engine_;
+    size_t queueDepth_ = kDefaultQueueDepth;
+    std::function<void(long)> progress_;
+    uint32_t interpFactor_ = 1;
+    std::vector<Output> outputs_;
+
+    Stats stats_;
+    std::mutex errorMutex_;
+    std::string error_;
+    std::atomic<bool> abort_{ false };
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <d3d11.h>
+#include <dxgi1_2.h>
+
+#include <vector>
+
+class Renderer;
+
+// Common interface of the capture backends the render loop pulls frames from
+// (CaptureDXGI, CaptureWGC, SyntheticSource).
+class FrameSource {
+public:
+    virtual ~FrameSource() = default;
+
+    // Returns true and sets outTex (caller releases it) and outTimestamp (backend clock units) if a new frame is available.
+    virtual bool GetFrame(ID3D11Texture2D** outTex, INT64* outTimestamp = nullptr) = 0;
+    // Must be called exactly once after each successful GetFrame().
+    virtual void ReleaseFrame() = 0;
+    virtual void Cleanup() = 0;
+
+    virtual ID3D11Device* GetDevice() const = 0;
+    virtual ID3D11DeviceContext* GetContext() const = 0;
+
+    // True once the source is permanently broken and capture must be restarted.
+    virtual bool IsLost() const { return false; }
+
+    // Per-acquire details for the capture trace (CaptureTrace.h).
+    virtual HRESULT GetLastAcquireHr() const { return S_OK; }
+    // Frames the source produced since the previous successful GetFrame (1 when keeping up).
+    virtual UINT GetLastAccumulatedFrames() const { return 1; }
+    // Regions of the last GetFrame's frame that moved relative to the frame the previous GetFrame returned
+    // (scrolling, window drags), in source pixels. False when the backend can't tell.
+    virtual bool GetLastMoveRects(std::vector<DXGI_OUTDUPL_MOVE_RECT>& out) const {
+        out.clear();
+        return false;
+    }
+    // Ticks per second of GetFrame's outTimestamp.
+    virtual INT64 GetTimestampFrequency() const {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        return f.QuadPart;
+    }
+
+    // Capture-thread support (CaptureThread.h).
+    // False if GetFrame/ReleaseFrame must stay on the thread that started the capture.
+    virtual bool CanCaptureOnAnyThread() const { return true; }
+    // Blocks up to timeoutMs until a new frame may be available (after GetFrame returned false).
+    virtual void WaitForFrame(DWORD timeoutMs) { Sleep(timeoutMs < 1 ? timeoutMs : 1); }
+
+    // Pushes backend delivery counters to the HUD (Cap: ...). Called from the render thread while a
+    // capture thread may be inside GetFrame, so the counters it reads must be atomic.
+    virtual void ReportStats(Renderer& renderer) const = 0;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Single-producer / single-consumer "latest value" mailbox over three slots (triple buffering).
+// The producer always owns one slot to fill (Back), the consumer one slot to read (Front), and the
+// third holds the newest published value. Publish and Take never block or spin: a value the consumer
+// did not take in time is simply replaced by the next one.
+// Slots are reused, so T should hold resources that are rewritten in place (textures, buffers).
+template <typename T>
+class LatestMailbox {
+public:
+    // Producer: slot to fill before Publish().
+    T& Back() { return slots_[back_]; }
+    // Producer: makes Back() the newest value and hands the producer a free slot.
+    void Publish() {
+        back_ = (uint8_t)(middle_.exchange((uint8_t)(back_ | kFresh), std::memory_order_acq_rel) & kIndexMask);
+    }
+
+    // Consumer: true if a newer value was published since the last Take(); it is then in Front().
+    bool Take() {
+        if (!(middle_.load(std::memory_order_relaxed) & kFresh)) return false;
+        front_ = (uint8_t)(middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask);
+        return true;
+    }
+    // Consumer: the value returned by the last successful Take().
+    T& Front() { return slots_[front_]; }
+
+    // All three slots, e.g. to release resources. Only when neither side is running.
+    T* Slots() { return slots_; }
+    static constexpr int kSlotCount = 3;
+    // Forgets published values. Only when neither side is running.
+    void Reset() {
+        back_ = 0;
+        middle_.store(1, std::memory_order_relaxed);
+        front_ = 2;
+    }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;
+
+    T slots_[kSlotCount];
+    // Producer, shared and consumer indices on separate cache lines.
+    alignas(64) uint8_t back_ = 0;
+    alignas(64) std::atomic<uint8_t> middle_{ 1 };
+    alignas(64) uint8_t front_ = 2;
+};
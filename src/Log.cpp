@@ -2,6 +2,7 @@
 #include <fstream>
 #include <iostream>
 #include <ctime>
+#include <mutex>
 
 #include <windows.h>
 
@@ -32,7 +33,11 @@ namespace Log {
         return out;
     }
 
+    // Capture threads and WGC callbacks log too.
+    static std::mutex s_logMutex;
+
     void ToFile(const std::string& msg) {
+        std::lock_guard<std::mutex> lock(s_logMutex);
         static bool firstWrite = true;
         std::ofstream ofs;
         if (firstWrite) {
@@ -0,0 +1,352 @@
+#include "OutputSink.h"
+
+#include "Log.h"
+
+#include <cstring>
+#include <string>
+
+namespace {
+
+// FrameIO opens narrow paths (fopen), which Windows reads in the ANSI code page.
+static std::string WideToAnsi(const std::wstring& w) {
+    if (w.empty()) return std::string();
+    const int len = WideCharToMultiByte(CP_ACP, 0, w.c_str(), (int)w.size(), nullptr, 0, nullptr, nullptr);
+    if (len <= 0) return std::string();
+    std::string out;
+    out.resize((size_t)len);
+    WideCharToMultiByte(CP_ACP, 0, w.c_str(), (int)w.size(), out.data(), len, nullptr, nullptr);
+    return out;
+}
+
+} // namespace
+
+const char* OutputSink::KindName(Kind kind) {
+    switch (kind) {
+    case Kind::Window: return "window";
+    case Kind::SharedMemory: return "shared-memory";
+    case Kind::File: return "file";
+    }
+    return "?";
+}
+
+bool OutputSink::Open(ID3D11Device* device, const Desc& desc) {
+    Close();
+    if (!device) return false;
+    desc_ = desc;
+    device_ = device;
+    device_->AddRef();
+
+    if (desc_.kind == Kind::Window) {
+        if (!desc_.window || !IsWindow(desc_.window)) {
+            Log::Error("OutputSink: window sink without a window");
+            Close();
+            return false;
+        }
+
+        IDXGIDevice* dxgiDevice = nullptr;
+        IDXGIAdapter* adapter = nullptr;
+        IDXGIFactory* factory = nullptr;
+        HRESULT hr = device_->QueryInterface(__uuidof(IDXGIDevice), (void**)&dxgiDevice);
+        if (SUCCEEDED(hr)) hr = dxgiDevice->GetAdapter(&adapter);
+        if (SUCCEEDED(hr)) hr = adapter->GetParent(__uuidof(IDXGIFactory), (void**)&factory);
+        if (adapter) adapter->Release();
+        if (dxgiDevice) dxgiDevice->Release();
+        if (FAILED(hr) || !factory) {
+            Log::Error("OutputSink: no DXGI factory for the window sink");
+            Close();
+            return false;
+        }
+
+        RECT rc = {};
+        GetClientRect(desc_.window, &rc);
+        DXGI_SWAP_CHAIN_DESC scd = {};
+        scd.BufferCount = 1;
+        scd.BufferDesc.Width = (rc.right > rc.left) ? (UINT)(rc.right - rc.left) : 1;
+        scd.BufferDesc.Height = (rc.bottom > rc.top) ? (UINT)(rc.bottom - rc.top) : 1;
+        scd.BufferDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+        scd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        scd.OutputWindow = desc_.window;
+        scd.SampleDesc.Count = 1;
+        scd.Windowed = TRUE;
+        scd.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+        hr = factory->CreateSwapChain(device_, &scd, &swapChain_);
+        factory->Release();
+        if (FAILED(hr) || !swapChain_) {
+            Log::Error("OutputSink: CreateSwapChain failed for the window sink");
+            Close();
+            return false;
+        }
+        // The app handles Alt+Enter for its own windows.
+        factory = nullptr;
+        if (SUCCEEDED(swapChain_->GetParent(__uuidof(IDXGIFactory), (void**)&factory)) && factory) {
+            factory->MakeWindowAssociation(desc_.window, DXGI_MWA_NO_ALT_ENTER);
+            factory->Release();
+        }
+    } else if (desc_.kind == Kind::File) {
+        FrameIO::WriterOptions opt;
+        opt.fpsNum = desc_.fps ? desc_.fps : 60;
+        opt.fpsDen = 1;
+        std::string err;
+        writer_ = FrameIO::OpenWriter(WideToAnsi(desc_.name), opt, &err);
+        if (!writer_) {
+            Log::Error("OutputSink: cannot open file sink: " + err);
+            Close();
+            return false;
+        }
+        fileQueue_ = std::make_unique<BoundedQueue<std::unique_ptr<FrameIO::Frame>>>(kFileQueueDepth);
+        writeFailed_.store(false, std::memory_order_relaxed);
+        writerThread_ = std::thread([this] { WriterLoop(); });
+    } else if (desc_.name.empty()) {
+        Log::Error("OutputSink: shared-memory sink without a mapping name");
+        Close();
+        return false;
+    }
+
+    Log::Info(std::string("OutputSink: opened ") + KindName(desc_.kind) + " sink, layout " + std::to_string(desc_.layout) +
+              ", canvas " + (desc_.width ? std::to_string(desc_.width) + "x" + std::to_string(desc_.height) : std::string("render resolution")));
+    return true;
+}
+
+void OutputSink::Close() {
+    if (fileQueue_) fileQueue_->Close();
+    if (writerThread_.joinable()) writerThread_.join();
+    if (writer_) {
+        if (!writer_->Finish()) Log::Error("OutputSink: " + writer_->GetError());
+        writer_.reset();
+    }
+    fileQueue_.reset();
+
+    if (swapRtv_) { swapRtv_->Release(); swapRtv_ = nullptr; }
+    if (swapChain_) { swapChain_->Release(); swapChain_ = nullptr; }
+    swapW_ = swapH_ = 0;
+    ReleaseOffscreenTarget();
+    ReleaseMapping();
+
+    if (device_) {
+        Log::Info(std::string("OutputSink: closed ") + KindName(desc_.kind) + " sink (" + std::to_string(delivered_) + " frames, " +
+                  std::to_string(dropped_) + " dropped)");
+        device_->Release();
+        device_ = nullptr;
+    }
+    delivered_ = dropped_ = 0;
+}
+
+bool OutputSink::EnsureWindowTarget() {
+    RECT rc = {};
+    if (!IsWindow(desc_.window) || IsIconic(desc_.window) || !GetClientRect(desc_.window, &rc)) return false;
+    const UINT w = (UINT)(rc.right - rc.left);
+    const UINT h = (UINT)(rc.bottom - rc.top);
+    if (w == 0 || h == 0) return false;
+    if (swapRtv_ && w == swapW_ && h == swapH_) return true;
+
+    if (swapRtv_) { swapRtv_->Release(); swapRtv_ = nullptr; }
+    HRESULT hr = swapChain_->ResizeBuffers(0, w, h, DXGI_FORMAT_UNKNOWN, 0);
+    ID3D11Texture2D* backBuffer = nullptr;
+    if (SUCCEEDED(hr)) hr = swapChain_->GetBuffer(0, __uuidof(ID3D11Texture2D), (void**)&backBuffer);
+    if (SUCCEEDED(hr)) hr = device_->CreateRenderTargetView(backBuffer, nullptr, &swapRtv_);
+    if (backBuffer) backBuffer->Release();
+    if (FAILED(hr) || !swapRtv_) {
+        Log::Error("OutputSink: window sink back buffer resize failed");
+        return false;
+    }
+    swapW_ = w;
+    swapH_ = h;
+    return true;
+}
+
+bool OutputSink::EnsureOffscreenTarget(UINT width, UINT height) {
+    if (rtRtv_ && width == rtW_ && height == rtH_) return true;
+    ReleaseOffscreenTarget();
+
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = width;
+    desc.Height = height;
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_RENDER_TARGET;
+    HRESULT hr = device_->CreateTexture2D(&desc, nullptr, &rtTex_);
+    if (SUCCEEDED(hr)) hr = device_->CreateRenderTargetView(rtTex_, nullptr, &rtRtv_);
+
+    D3D11_TEXTURE2D_DESC sdesc = desc;
+    sdesc.BindFlags = 0;
+    sdesc.Usage = D3D11_USAGE_STAGING;
+    sdesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    for (Slot& s : slots_) {
+        if (SUCCEEDED(hr)) hr = device_->CreateTexture2D(&sdesc, nullptr, &s.staging);
+    }
+    if (FAILED(hr)) {
+        Log::Error("OutputSink: readback texture creation failed");
+        ReleaseOffscreenTarget();
+        return false;
+    }
+    rtW_ = width;
+    rtH_ = height;
+    return true;
+}
+
+void OutputSink::ReleaseOffscreenTarget() {
+    for (Slot& s : slots_) {
+        if (s.staging) { s.staging->Release(); s.staging = nullptr; }
+        s.pending = false;
+    }
+    if (rtRtv_) { rtRtv_->Release(); rtRtv_ = nullptr; }
+    if (rtTex_) { rtTex_->Release(); rtTex_ = nullptr; }
+    rtW_ = rtH_ = 0;
+    nextSlot_ = 0;
+}
+
+ID3D11RenderTargetView* OutputSink::BeginFrame(UINT frameW, UINT frameH, UINT* targetW, UINT* targetH) {
+    if (!device_ || frameW == 0 || frameH == 0) return nullptr;
+
+    if (desc_.kind == Kind::Window) {
+        if (!swapChain_ || !EnsureWindowTarget()) return nullptr;
+        *targetW = swapW_;
+        *targetH = swapH_;
+        return swapRtv_;
+    }
+
+    if (desc_.kind == Kind::File && writeFailed_.load(std::memory_order_relaxed)) return nullptr;
+    // A size change drops the readbacks still in flight with the old textures.
+    if (!EnsureOffscreenTarget(frameW, frameH)) return nullptr;
+    if (slots_[nextSlot_].pending) {
+        ++dropped_;
+        return nullptr;
+    }
+    *targetW = rtW_;
+    *targetH = rtH_;
+    return rtRtv_;
+}
+
+void OutputSink::EndFrame(ID3D11DeviceContext* ctx) {
+    if (!ctx || !device_) return;
+
+    if (desc_.kind == Kind::Window) {
+        // Never wait for this window's vblank: the main output paces the loop.
+        if (swapChain_ && SUCCEEDED(swapChain_->Present(0, 0))) ++delivered_;
+        return;
+    }
+
+    Slot& slot = slots_[nextSlot_];
+    if (!rtTex_ || slot.pending) return;
+    ctx->CopyResource(slot.staging, rtTex_);
+    slot.pending = true;
+    nextSlot_ = (nextSlot_ + 1) % kSlots;
+}
+
+void OutputSink::Poll(ID3D11DeviceContext* ctx) {
+    if (!ctx || desc_.kind == Kind::Window) return;
+    for (int i = 0; i < kSlots; ++i) {
+        Slot& slot = slots_[(nextSlot_ + i) % kSlots];
+        if (!slot.pending) continue;
+
+        D3D11_MAPPED_SUBRESOURCE mapped = {};
+        const HRESULT hr = ctx->Map(slot.staging, 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+        if (hr == DXGI_ERROR_WAS_STILL_DRAWING) break;
+        if (SUCCEEDED(hr)) {
+            Deliver(static_cast<const uint8_t*>(mapped.pData), mapped.RowPitch);
+            ctx->Unmap(slot.staging, 0);
+        }
+        slot.pending = false;
+    }
+}
+
+bool OutputSink::EnsureMapping(size_t bytes) {
+    if (header_ && bytes <= capacity_) return true;
+    ReleaseMapping();
+
+    const size_t total = sizeof(SharedSinkHeader) + bytes;
+    mapping_ = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD)((uint64_t)total >> 32), (DWORD)(total & 0xFFFFFFFFu),
+                                  desc_.name.c_str());
+    if (!mapping_) {
+        if (!mappingError_) Log::Error("OutputSink: CreateFileMapping failed (" + std::to_string((unsigned long)GetLastError()) + ")");
+        mappingError_ = true;
+        return false;
+    }
+    // A reader that still holds the mapping keeps it (and its size) alive under the same name: reuse it
+    // if it is ours and large enough, else wait for the readers to let go of it.
+    const bool existed = (GetLastError() == ERROR_ALREADY_EXISTS);
+    header_ = static_cast<SharedSinkHeader*>(MapViewOfFile(mapping_, FILE_MAP_WRITE, 0, 0, existed ? sizeof(SharedSinkHeader) : total));
+    if (header_ && existed) {
+        const bool fits = header_->magic == kSharedSinkMagic && header_->capacity >= bytes;
+        const size_t existingBytes = fits ? header_->capacity : 0;
+        UnmapViewOfFile(header_);
+        header_ = fits ? static_cast<SharedSinkHeader*>(MapViewOfFile(mapping_, FILE_MAP_WRITE, 0, 0, sizeof(SharedSinkHeader) + existingBytes)) : nullptr;
+        if (header_) {
+            capacity_ = existingBytes;
+            mappingError_ = false;
+            return true;
+        }
+    }
+    if (!header_) {
+        if (!mappingError_) Log::Error("OutputSink: shared memory '" + WideToAnsi(desc_.name) + "' is in use with a smaller size or by another program");
+        mappingError_ = true;
+        ReleaseMapping();
+        return false;
+    }
+    memset(header_, 0, sizeof(SharedSinkHeader));
+    header_->magic = kSharedSinkMagic;
+    header_->version = kSharedSinkVersion;
+    header_->capacity = (uint32_t)bytes;
+    capacity_ = bytes;
+    mappingError_ = false;
+    return true;
+}
+
+void OutputSink::ReleaseMapping() {
+    if (header_) { UnmapViewOfFile(header_); header_ = nullptr; }
+    if (mapping_) { CloseHandle(mapping_); mapping_ = nullptr; }
+    capacity_ = 0;
+}
+
+void OutputSink::Deliver(const uint8_t* data, UINT rowPitch) {
+    const size_t rowBytes = (size_t)rtW_ * 4;
+
+    if (desc_.kind == Kind::SharedMemory) {
+        if (!EnsureMapping(rowBytes * rtH_)) {
+            ++dropped_;
+            return;
+        }
+        LARGE_INTEGER qpc = {};
+        QueryPerformanceCounter(&qpc);
+        InterlockedIncrement64(&header_->sequence);
+        header_->width = rtW_;
+        header_->height = rtH_;
+        header_->stride = (uint32_t)rowBytes;
+        header_->layout = (uint32_t)desc_.layout;
+        header_->qpc = qpc.QuadPart;
+        uint8_t* pixels = reinterpret_cast<uint8_t*>(header_ + 1);
+        for (UINT y = 0; y < rtH_; ++y) {
+            memcpy(pixels + (size_t)y * rowBytes, data + (size_t)y * rowPitch, rowBytes);
+        }
+        InterlockedIncrement64(&header_->sequence);
+        ++delivered_;
+        return;
+    }
+
+    // File: the writer thread encodes; a full queue (slow disk / encoder) drops the frame.
+    std::unique_ptr<FrameIO::Frame> frame = std::make_unique<FrameIO::Frame>();
+    frame->Resize(rtW_, rtH_);
+    for (UINT y = 0; y < rtH_; ++y) {
+        memcpy(frame->bgra.data() + (size_t)y * rowBytes, data + (size_t)y * rowPitch, rowBytes);
+    }
+    if (fileQueue_ && fileQueue_->TryPush(frame)) {
+        ++delivered_;
+    } else {
+        ++dropped_;
+    }
+}
+
+void OutputSink::WriterLoop() {
+    std::unique_ptr<FrameIO::Frame> frame;
+    while (fileQueue_->Pop(frame)) {
+        if (!writer_->WriteFrame(*frame)) {
+            Log::Error("OutputSink: " + writer_->GetError());
+            writeFailed_.store(true, std::memory_order_relaxed);
+            fileQueue_->Close();
+            break;
+        }
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <d3d11.h>
+#include <dxgi.h>
+#include <windows.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "BoundedQueue.h"
+#include "FrameIO.h"
+
+// Start of a SharedMemory sink's file mapping, followed by `height` rows of `stride` bytes of BGRA8.
+// `sequence` is odd while a frame is being written and even once it is complete: a reader copies the
+// pixels between two reads of the same even value. The mapping is created at the first frame and
+// re-created when a frame outgrows `capacity` (readers must reopen it; while one still holds the
+// old mapping, frames that don't fit are dropped).
+struct SharedSinkHeader {
+    uint32_t magic;        // kSharedSinkMagic
+    uint32_t version;      // kSharedSinkVersion
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    uint32_t layout;       // Renderer::StereoLayout
+    uint32_t capacity;     // pixel bytes the mapping holds
+    uint32_t pad0;
+    volatile LONG64 sequence;
+    int64_t qpc;           // QueryPerformanceCounter when the frame was read back
+};
+static const uint32_t kSharedSinkMagic = 0x42535241; // "ARSB"
+static const uint32_t kSharedSinkVersion = 1;
+
+// One extra output of the renderer (Renderer::AddOutputSink). The renderer resamples the frame into
+// the sink's layout and canvas size and draws it into BeginFrame()'s target; EndFrame() presents it
+// (Window) or queues a readback (SharedMemory, File) that Poll() delivers a frame or two later
+// without waiting on the GPU (D3D11_MAP_FLAG_DO_NOT_WAIT, like TraceThumbnailer).
+class OutputSink {
+public:
+    enum class Kind {
+        Window = 0,    // swap chain on `window`, sized to its client area (the frame is scaled to it)
+        SharedMemory,  // named file mapping (SharedSinkHeader + pixels), e.g. for a streaming encoder
+        File,          // FrameIO writer on its own thread (.y4m, .bgra/.raw, image sequences)
+    };
+
+    struct Desc {
+        Kind kind = Kind::Window;
+        int layout = 2;         // Renderer::StereoLayout
+        UINT width = 0;         // half-SBS canvas of this output (see DepthCpu::GetLayoutSize); 0 = the render resolution
+        UINT height = 0;
+        HWND window = nullptr;  // Window
+        std::wstring name;      // SharedMemory: mapping name; File: output path (format from its extension)
+        UINT fps = 60;          // File: nominal Y4M rate (frames are written as new frames arrive)
+    };
+
+    static const char* KindName(Kind kind);
+
+    OutputSink() = default;
+    ~OutputSink() { Close(); }
+    OutputSink(const OutputSink&) = delete;
+    OutputSink& operator=(const OutputSink&) = delete;
+
+    bool Open(ID3D11Device* device, const Desc& desc);
+    void Close();
+
+    const Desc& GetDesc() const { return desc_; }
+
+    // Render target for a frameW x frameH frame and the size to draw it at: the window's back buffer
+    // (resized to the client area) or an offscreen BGRA8 texture of the frame's size. Null when there
+    // is nowhere to draw (minimized window, or every readback slot still in flight: the frame is dropped).
+    ID3D11RenderTargetView* BeginFrame(UINT frameW, UINT frameH, UINT* targetW, UINT* targetH);
+    // Presents the frame (Window) or queues its readback (SharedMemory, File).
+    void EndFrame(ID3D11DeviceContext* ctx);
+    // Delivers finished readbacks, oldest first; stops at the first one the GPU hasn't finished.
+    void Poll(ID3D11DeviceContext* ctx);
+
+    uint64_t GetFramesDelivered() const { return delivered_; }
+    uint64_t GetFramesDropped() const { return dropped_; }
+
+private:
+    static constexpr int kSlots = 3;
+    static constexpr size_t kFileQueueDepth = 4;
+
+    struct Slot {
+        ID3D11Texture2D* staging = nullptr;
+        bool pending = false;
+    };
+
+    bool EnsureWindowTarget();
+    bool EnsureOffscreenTarget(UINT width, UINT height);
+    void ReleaseOffscreenTarget();
+    bool EnsureMapping(size_t bytes);
+    void ReleaseMapping();
+    void Deliver(const uint8_t* data, UINT rowPitch);
+    void WriterLoop();
+
+    ID3D11Device* device_ = nullptr;
+    Desc desc_;
+
+    // Window
+    IDXGISwapChain* swapChain_ = nullptr;
+    ID3D11RenderTargetView* swapRtv_ = nullptr;
+    UINT swapW_ = 0;
+    UINT swapH_ = 0;
+
+    // SharedMemory / File: the frame is drawn into rtTex_ and read back through the slots.
+    ID3D11Texture2D* rtTex_ = nullptr;
+    ID3D11RenderTargetView* rtRtv_ = nullptr;
+    UINT rtW_ = 0;
+    UINT rtH_ = 0;
+    Slot slots_[kSlots];
+    int nextSlot_ = 0;
+
+    HANDLE mapping_ = nullptr;
+    SharedSinkHeader* header_ = nullptr;
+    size_t capacity_ = 0;
+    bool mappingError_ = false; // logged once until a mapping works again
+
+    std::unique_ptr<FrameIO::FrameWriter> writer_;
+    std::unique_ptr<BoundedQueue<std::unique_ptr<FrameIO::Frame>>> fileQueue_;
+    std::thread writerThread_;
+    std::atomic<bool> writeFailed_{ false };
+
+    uint64_t delivered_ = 0;
+    uint64_t dropped_ = 0;
+};
@@ -0,0 +1,397 @@
+#include "PacingSim.h"
+
+#include "CaptureTrace.h"
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace PacingSim {
+namespace {
+
+struct Shown {
+    int64_t arrival;
+    int64_t visible;
+};
+
+static int64_t MsToTicks(double ms) {
+    return (int64_t)std::llround(ms * (double)kTicksPerSecond / 1000.0);
+}
+
+static double TicksToMs(int64_t ticks) {
+    return (double)ticks * 1000.0 / (double)kTicksPerSecond;
+}
+
+// Nearest-rank percentile of an already sorted vector.
+static double Percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t idx = (size_t)std::ceil(p / 100.0 * (double)sorted.size());
+    if (idx > 0) --idx;
+    if (idx >= sorted.size()) idx = sorted.size() - 1;
+    return sorted[idx];
+}
+
+// Fills the rate/judder/latency fields from the counters and the shown-frame samples.
+static void Summarize(const std::vector<Shown>& shown, Result* r) {
+    if (r->seconds > 0.0) {
+        r->rendersPerSec = (double)r->renders / r->seconds;
+        r->wakeupsPerSec = (double)r->wakeups / r->seconds;
+    }
+    if (r->renders) r->repeatPercent = 100.0 * (double)r->repeats / (double)r->renders;
+    if (r->contentFrames) r->dropPercent = 100.0 * (double)r->dropped / (double)r->contentFrames;
+
+    std::vector<double> latency;
+    latency.reserve(shown.size());
+    for (const Shown& s : shown) latency.push_back(TicksToMs(s.visible - s.arrival));
+    std::sort(latency.begin(), latency.end());
+    r->latencyP50Ms = Percentile(latency, 50.0);
+    r->latencyP95Ms = Percentile(latency, 95.0);
+    r->latencyP99Ms = Percentile(latency, 99.0);
+    r->latencyMaxMs = latency.empty() ? 0.0 : latency.back();
+
+    std::vector<double> judder;
+    double sumSq = 0.0;
+    for (size_t i = 1; i < shown.size(); ++i) {
+        const int64_t onScreen = shown[i].visible - shown[i - 1].visible;
+        const int64_t content = shown[i].arrival - shown[i - 1].arrival;
+        const double e = TicksToMs(onScreen - content);
+        sumSq += e * e;
+        judder.push_back(std::fabs(e));
+    }
+    std::sort(judder.begin(), judder.end());
+    r->judderRmsMs = judder.empty() ? 0.0 : std::sqrt(sumSq / (double)judder.size());
+    r->judderP99Ms = Percentile(judder, 99.0);
+}
+
+} // namespace
+
+bool ParseArrivalSpec(const std::string& spec, ArrivalModel* out) {
+    ArrivalModel m;
+    size_t pos = 0;
+    bool first = true;
+    while (pos <= spec.size()) {
+        size_t comma = spec.find(',', pos);
+        if (comma == std::string::npos) comma = spec.size();
+        const std::string part = spec.substr(pos, comma - pos);
+        pos = comma + 1;
+        if (part.empty()) {
+            if (comma == spec.size()) break;
+            continue;
+        }
+
+        char* end = nullptr;
+        if (first) {
+            first = false;
+            m.hz = std::strtod(part.c_str(), &end);
+            if (*end != '\0' || m.hz <= 0.0) return false;
+        } else if (part.rfind("jitter=", 0) == 0) {
+            m.jitterMs = std::strtod(part.c_str() + 7, &end);
+            if (*end != '\0' || m.jitterMs < 0.0) return false;
+        } else if (part.rfind("burst=", 0) == 0) {
+            m.burst = (int)std::strtol(part.c_str() + 6, &end, 10);
+            if (*end != '\0' || m.burst < 1) return false;
+        } else {
+            return false;
+        }
+    }
+    if (first) return false;
+    *out = m;
+    return true;
+}
+
+std::string DescribeArrivals(const ArrivalModel& m) {
+    char buf[96];
+    int n = std::snprintf(buf, sizeof(buf), "%gHz", m.hz);
+    if (m.jitterMs > 0.0) n += std::snprintf(buf + n, sizeof(buf) - n, " jitter=%gms", m.jitterMs);
+    if (m.burst > 1) std::snprintf(buf + n, sizeof(buf) - n, " burst=%d", m.burst);
+    return buf;
+}
+
+std::vector<int64_t> GenerateArrivals(const ArrivalModel& m, double durationSec, uint32_t seed) {
+    std::vector<int64_t> out;
+    if (m.hz <= 0.0 || durationSec <= 0.0) return out;
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> jitter(-m.jitterMs, m.jitterMs);
+
+    const double periodMs = 1000.0 / m.hz;
+    const int burst = std::max(1, m.burst);
+    const int64_t end = (int64_t)(durationSec * (double)kTicksPerSecond);
+
+    for (long long group = 0;; ++group) {
+        // A burst holds back `burst` frames and delivers them together, keeping the average rate.
+        double groupMs = (double)(group * burst + burst - 1) * periodMs;
+        if (MsToTicks(groupMs) >= end) break;
+        if (m.jitterMs > 0.0) groupMs += jitter(rng);
+        for (int i = 0; i < burst; ++i) {
+            const int64_t t = MsToTicks(groupMs + (burst > 1 ? (double)i * m.burstSpacingMs : 0.0));
+            if (t >= 0 && t < end) out.push_back(t);
+        }
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+Result Run(const std::vector<int64_t>& arrivals, const LoopModel& loop) {
+    Result r;
+    FramePacer pacer(kTicksPerSecond);
+
+    std::mt19937 rng(loop.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    const int64_t end = (int64_t)(loop.durationSec * (double)kTicksPerSecond);
+    const int64_t overhead = std::max<int64_t>(1, MsToTicks(loop.loopOverheadUs / 1000.0));
+    const int64_t granularity = MsToTicks(loop.timerGranularityMs);
+    const int64_t vblank = (loop.displayHz > 0.0) ? (int64_t)((double)kTicksPerSecond / loop.displayHz) : 0;
+
+    std::vector<Shown> shown;
+    size_t nextArrival = 0; // first frame not yet rendered or skipped
+    int64_t t = 0;
+
+    while (t < end) {
+        t += overhead;
+        const FramePacer::Decision d = pacer.Next(t, loop.renderIntervalSec);
+
+        if (d.action == FramePacer::Action::Wait) {
+            ++r.wakeups;
+            if (d.waitMs > 0) {
+                int64_t wake = t + MsToTicks((double)d.waitMs);
+                if (granularity > 0) wake = ((wake + granularity - 1) / granularity) * granularity;
+                wake += MsToTicks(loop.wakeSlopMs * unit(rng));
+                t = std::max(t, wake);
+            }
+            continue;
+        }
+
+        // RenderOneFrame: take the newest frame that has arrived (older pending ones are lost).
+        size_t k = nextArrival;
+        while (k < arrivals.size() && arrivals[k] <= t) ++k;
+        const bool got = k > nextArrival;
+        if (got) {
+            r.dropped += (k - 1) - nextArrival;
+        } else {
+            ++r.repeats;
+        }
+        ++r.renders;
+
+        const double costMs = loop.renderCostMs + loop.renderCostJitterMs * (2.0 * unit(rng) - 1.0);
+        t += std::max<int64_t>(0, MsToTicks(costMs));
+
+        if (got) {
+            int64_t visible = t;
+            if (vblank > 0) visible = ((visible + vblank - 1) / vblank) * vblank;
+            shown.push_back({ arrivals[k - 1], visible });
+            nextArrival = k;
+        }
+
+        if (d.action == FramePacer::Action::RenderAndYield) ++r.wakeups;
+    }
+
+    r.seconds = (double)t / (double)kTicksPerSecond;
+    r.contentFrames = (uint64_t)(std::lower_bound(arrivals.begin(), arrivals.end(), t) - arrivals.begin());
+    r.framesShown = shown.size();
+    r.resyncs = pacer.GetResyncCount();
+    Summarize(shown, &r);
+    return r;
+}
+
+bool LoadTraceArrivals(const std::string& path, std::vector<int64_t>* arrivals, Result* recorded, std::string* err) {
+    CaptureTrace::Trace trace;
+    if (!CaptureTrace::Load(path, &trace, err)) return false;
+
+    const CaptureTrace::Header& h = trace.header;
+    if (h.qpcFrequency <= 0 || trace.records.empty()) {
+        if (err) *err = "trace has no records";
+        return false;
+    }
+
+    // Everything on the QPC clock first: DXGI present times are QPC, WGC's are 100 ns of the same counter.
+    auto arrivalQpc = [&](const CaptureTrace::Record& rec) -> int64_t {
+        if (rec.sourceTimestamp > 0 && h.timestampFrequency > 0) {
+            return (int64_t)((long double)rec.sourceTimestamp * (long double)h.qpcFrequency / (long double)h.timestampFrequency);
+        }
+        return rec.acquiredQpc;
+    };
+    auto toSim = [&](int64_t qpc, int64_t base) -> int64_t {
+        return (int64_t)((long double)(qpc - base) * (long double)kTicksPerSecond / (long double)h.qpcFrequency);
+    };
+
+    int64_t base = -1;
+    int64_t lastArrival = -1;
+    std::vector<Shown> shown;
+    Result r;
+
+    arrivals->clear();
+    for (const CaptureTrace::Record& rec : trace.records) {
+        ++r.renders;
+        const int64_t a = (rec.flags & CaptureTrace::kFlagGotFrame) ? arrivalQpc(rec) : -1;
+        // Same present timestamp again = the source repeated its last frame.
+        if (a < 0 || a <= lastArrival) {
+            ++r.repeats;
+            continue;
+        }
+        if (base < 0) base = a;
+        lastArrival = a;
+        arrivals->push_back(toSim(a, base));
+        shown.push_back({ toSim(a, base), toSim(rec.renderedQpc, base) });
+        if (rec.accumulatedFrames > 1) r.dropped += rec.accumulatedFrames - 1;
+    }
+    if (arrivals->empty()) {
+        if (err) *err = "trace has no captured frames";
+        return false;
+    }
+
+    if (recorded) {
+        r.seconds = (double)(trace.records.back().renderedQpc - trace.records.front().pollQpc) / (double)h.qpcFrequency;
+        r.framesShown = shown.size();
+        r.contentFrames = r.framesShown + r.dropped;
+        Summarize(shown, &r);
+        *recorded = r;
+    }
+    return true;
+}
+
+bool ParseCostSpec(const std::string& spec, CostModel* out) {
+    CostModel m;
+    size_t pos = 0;
+    bool first = true;
+    while (pos <= spec.size()) {
+        size_t comma = spec.find(',', pos);
+        if (comma == std::string::npos) comma = spec.size();
+        const std::string part = spec.substr(pos, comma - pos);
+        pos = comma + 1;
+        if (part.empty()) {
+            if (comma == spec.size()) break;
+            continue;
+        }
+
+        char* end = nullptr;
+        if (first) {
+            first = false;
+            m.baseMs = std::strtod(part.c_str(), &end);
+            if (*end != '\0' || m.baseMs <= 0.0) return false;
+        } else if (part.rfind("fixed=", 0) == 0) {
+            m.fixedMs = std::strtod(part.c_str() + 6, &end);
+            if (*end != '\0' || m.fixedMs < 0.0) return false;
+        } else if (part.rfind("jitter=", 0) == 0) {
+            m.jitterMs = std::strtod(part.c_str() + 7, &end);
+            if (*end != '\0' || m.jitterMs < 0.0) return false;
+        } else if (part.rfind("spike=", 0) == 0) {
+            char tail = 0;
+            if (std::sscanf(part.c_str() + 6, "%lfx%lf/%lf%c", &m.spikeFactor, &m.spikeSec, &m.spikePeriodSec, &tail) != 3 ||
+                m.spikeFactor <= 0.0 || m.spikeSec <= 0.0 || m.spikePeriodSec < m.spikeSec) {
+                return false;
+            }
+        } else if (part.rfind("ramp=", 0) == 0) {
+            m.rampToMs = std::strtod(part.c_str() + 5, &end);
+            if (*end != '\0' || m.rampToMs <= 0.0) return false;
+        } else {
+            return false;
+        }
+    }
+    if (first || m.fixedMs > m.baseMs) return false;
+    *out = m;
+    return true;
+}
+
+std::string DescribeCosts(const CostModel& m) {
+    char buf[128];
+    int n = std::snprintf(buf, sizeof(buf), "%.1fms", m.baseMs);
+    if (m.rampToMs > 0.0) n += std::snprintf(buf + n, sizeof(buf) - n, "->%.1fms", m.rampToMs);
+    if (m.jitterMs > 0.0) n += std::snprintf(buf + n, sizeof(buf) - n, " +/-%g", m.jitterMs);
+    if (m.spikePeriodSec > 0.0) std::snprintf(buf + n, sizeof(buf) - n, " spike %gx%gs/%gs", m.spikeFactor, m.spikeSec, m.spikePeriodSec);
+    return buf;
+}
+
+std::vector<double> GenerateCosts(const CostModel& m, double fps, double durationSec, uint32_t seed) {
+    std::vector<double> out;
+    if (fps <= 0.0 || durationSec <= 0.0) return out;
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> jitter(-m.jitterMs, m.jitterMs);
+
+    const size_t frames = (size_t)(durationSec * fps);
+    out.reserve(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        const double t = (double)i / fps;
+        double base = m.baseMs;
+        if (m.rampToMs > 0.0) base += (m.rampToMs - m.baseMs) * t / durationSec;
+        // Spikes load the GPU we share with the game: the size-dependent part gets slower.
+        double variable = base - m.fixedMs;
+        if (m.spikePeriodSec > 0.0 && std::fmod(t, m.spikePeriodSec) >= m.spikePeriodSec - m.spikeSec) variable *= m.spikeFactor;
+        out.push_back(std::max(0.01, m.fixedMs + variable + jitter(rng)));
+    }
+    return out;
+}
+
+GovernorResult RunGovernor(const std::vector<double>& fullCostMs, double fixedMs, double budgetMs,
+                           const ResolutionGovernor::Config& config, int latencyFrames, bool governor) {
+    GovernorResult r;
+    ResolutionGovernor gov(config);
+    gov.Reset(config.maxScale);
+
+    struct Sample {
+        double costMs;
+        double scale;
+    };
+    std::vector<Sample> inFlight; // oldest first
+    std::vector<double> loads;
+    loads.reserve(fullCostMs.size());
+    double sumScale = 0.0;
+    double sumPixels = 0.0;
+    uint64_t over = 0;
+    r.minScale = governor ? config.maxScale : 1.0;
+
+    for (double full : fullCostMs) {
+        const double s = governor ? gov.GetScale() : 1.0;
+        const double fixed = std::min(fixedMs, full);
+        const double cost = fixed + (full - fixed) * s * s;
+        loads.push_back(budgetMs > 0.0 ? cost / budgetMs : 0.0);
+        if (budgetMs > 0.0 && cost > budgetMs) ++over;
+        sumScale += s;
+        sumPixels += s * s;
+        r.minScale = std::min(r.minScale, s);
+
+        if (!governor) continue;
+        inFlight.push_back({ cost, s });
+        if ((int)inFlight.size() > latencyFrames) {
+            gov.AddSample(inFlight.front().costMs, inFlight.front().scale, budgetMs);
+            inFlight.erase(inFlight.begin());
+        }
+    }
+
+    r.frames = fullCostMs.size();
+    r.changes = gov.GetChangeCount();
+    if (r.frames) {
+        r.overBudgetPercent = 100.0 * (double)over / (double)r.frames;
+        r.meanScale = sumScale / (double)r.frames;
+        r.meanPixelPercent = 100.0 * sumPixels / (double)r.frames;
+    }
+    std::sort(loads.begin(), loads.end());
+    r.loadP50 = Percentile(loads, 50.0);
+    r.loadP99 = Percentile(loads, 99.0);
+    return r;
+}
+
+bool LoadTraceCosts(const std::string& path, double fixedMs, std::vector<double>* fullCostMs, std::string* err) {
+    CaptureTrace::Trace trace;
+    if (!CaptureTrace::Load(path, &trace, err)) return false;
+
+    fullCostMs->clear();
+    for (const CaptureTrace::Record& rec : trace.records) {
+        if (rec.costMs <= 0.0f || rec.renderScale <= 0.0f) continue;
+        const double s = rec.renderScale;
+        const double fixed = std::min(fixedMs, (double)rec.costMs);
+        fullCostMs->push_back(fixed + ((double)rec.costMs - fixed) / (s * s));
+    }
+    if (fullCostMs->empty()) {
+        if (err) *err = "trace has no cost samples (recorded before trace version 2?)";
+        return false;
+    }
+    return true;
+}
+
+} // namespace PacingSim
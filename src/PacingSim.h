@@ -0,0 +1,118 @@
+#pragma once
+
+#include "ResolutionGovernor.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Offline model of the app's render loop: FramePacer decisions, Windows timer-granularity waits,
+// render cost and a capture source whose frames arrive on a given schedule. Used by ArinPacingSim
+// to measure judder, repeats, latency and wakeups without a display. Portable (no Windows dependencies).
+namespace PacingSim {
+
+// Simulation clock (10 MHz, like WGC timestamps; close to typical QPC resolution).
+constexpr int64_t kTicksPerSecond = 10000000;
+
+// Capture arrival distribution: content presented at `hz`, optionally jittered or delivered in bursts.
+struct ArrivalModel {
+    double hz = 60.0;
+    double jitterMs = 0.0;       // uniform +/- around the ideal present time
+    int burst = 1;               // frames delivered back-to-back per burst (same average rate)
+    double burstSpacingMs = 0.25;
+};
+
+// Parses "HZ[,jitter=MS][,burst=N]" (e.g. "90,jitter=2", "120,burst=3").
+bool ParseArrivalSpec(const std::string& spec, ArrivalModel* out);
+std::string DescribeArrivals(const ArrivalModel& m);
+
+// Sorted arrival times (ticks) over [0, durationSec).
+std::vector<int64_t> GenerateArrivals(const ArrivalModel& m, double durationSec, uint32_t seed);
+
+struct LoopModel {
+    double renderIntervalSec = 1.0 / 60.0; // app frame cap (Renderer::GetFrameInterval(); 0 = unlimited)
+    double renderCostMs = 2.0;             // RenderOneFrame incl. Present
+    double renderCostJitterMs = 0.5;       // uniform +/-
+    double timerGranularityMs = 1.0;       // waits end on timer ticks (timeBeginPeriod(1) while capturing)
+    double wakeSlopMs = 0.3;               // extra uniform [0, slop] scheduler delay after a timed wait
+    double loopOverheadUs = 5.0;           // one pass through the loop (PeekMessage, QPC, ...)
+    double displayHz = 0.0;                // >0: a rendered frame becomes visible at the next vblank
+    double durationSec = 30.0;
+    uint32_t seed = 1;
+};
+
+struct Result {
+    double seconds = 0.0;
+    uint64_t renders = 0;
+    uint64_t wakeups = 0;        // waits the loop returned from (incl. 0 ms polls)
+    uint64_t contentFrames = 0;  // frames the source delivered
+    uint64_t framesShown = 0;    // distinct content frames rendered
+    uint64_t repeats = 0;        // renders that found no new frame
+    uint64_t dropped = 0;        // frames replaced by a newer one before they were rendered
+    uint64_t resyncs = 0;
+
+    double rendersPerSec = 0.0;
+    double wakeupsPerSec = 0.0;
+    double repeatPercent = 0.0;
+    double dropPercent = 0.0;
+
+    // Judder: per consecutive pair of shown frames, (on-screen interval) - (content interval).
+    double judderRmsMs = 0.0;
+    double judderP99Ms = 0.0;
+
+    // Content arrival -> visible.
+    double latencyP50Ms = 0.0;
+    double latencyP95Ms = 0.0;
+    double latencyP99Ms = 0.0;
+    double latencyMaxMs = 0.0;
+};
+
+// Runs FramePacer + the loop model against `arrivals` (ticks, sorted).
+Result Run(const std::vector<int64_t>& arrivals, const LoopModel& loop);
+
+// Arrival times (present timestamps of new frames) from a capture trace (CaptureTrace.h), rebased to 0.
+// If `recorded` is non-null it receives the same metrics measured from the trace's own render times.
+bool LoadTraceArrivals(const std::string& path, std::vector<int64_t>* arrivals, Result* recorded, std::string* err);
+
+// ---- Render-resolution governor (ResolutionGovernor) ----
+
+// Full-resolution pipeline cost per frame: what each frame would cost at scale 1. `fixedMs` of it doesn't
+// depend on the render size; the rest scales with the pixel count.
+struct CostModel {
+    double baseMs = 8.0;
+    double fixedMs = 0.5;
+    double jitterMs = 0.5;       // uniform +/- per frame
+    double spikeFactor = 1.0;    // cost multiplier while a spike lasts (a game loading the GPU)
+    double spikeSec = 0.0;
+    double spikePeriodSec = 0.0; // one spike starts every period (0 = none)
+    double rampToMs = 0.0;       // >0: the base cost moves linearly to this by the end of the run
+};
+
+// Parses "MS[,fixed=MS][,jitter=MS][,spike=FACTORxSEC/PERIOD][,ramp=MS]" (e.g. "9,spike=1.8x3/10", "6,ramp=16").
+bool ParseCostSpec(const std::string& spec, CostModel* out);
+std::string DescribeCosts(const CostModel& m);
+
+// One full-resolution cost per frame of `durationSec` at `fps`.
+std::vector<double> GenerateCosts(const CostModel& m, double fps, double durationSec, uint32_t seed);
+
+struct GovernorResult {
+    uint64_t frames = 0;
+    double overBudgetPercent = 0.0; // frames whose cost exceeded the frame interval
+    double meanScale = 0.0;
+    double meanPixelPercent = 0.0;  // mean of scale^2
+    double minScale = 0.0;
+    uint64_t changes = 0;
+    double loadP50 = 0.0;           // cost / frame interval
+    double loadP99 = 0.0;
+};
+
+// Renders `fullCostMs` (one entry per frame) at the governor's scale; each frame's cost reaches the governor
+// `latencyFrames` frames later, as GPU timestamp queries do. governor=false holds scale 1 for comparison.
+GovernorResult RunGovernor(const std::vector<double>& fullCostMs, double fixedMs, double budgetMs,
+                           const ResolutionGovernor::Config& config, int latencyFrames, bool governor);
+
+// Full-resolution costs from the cost samples of a capture trace (CaptureTrace::Record::costMs, version 2+),
+// scaled up from the size each one was rendered at with the same cost model.
+bool LoadTraceCosts(const std::string& path, double fixedMs, std::vector<double>* fullCostMs, std::string* err);
+
+} // namespace PacingSim
@@ -0,0 +1,252 @@
+// ArinPacingSim: frame-pacing simulator for the app's QPC render loop.
+// Drives the real pacing policy (FramePacer) with a simulated clock against capture arrival
+// distributions (steady, jittered, bursty, or a recorded capture trace) and reports judder,
+// repeat/drop rates, latency percentiles and loop wakeups per second.
+// With --governor it instead replays per-frame pipeline costs (synthetic patterns or the cost samples
+// of a recorded trace) through the Auto render-resolution policy (ResolutionGovernor).
+
+#include "FramePacer.h"
+#include "PacingSim.h"
+#include "ResolutionGovernor.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+static void PrintUsage() {
+    std::fprintf(stderr,
+        "Usage: ArinPacingSim [options]\n"
+        "\n"
+        "Simulates the capture render loop (FramePacer + timer waits + render cost) against capture\n"
+        "arrival patterns and prints one row per pattern.\n"
+        "\n"
+        "Options:\n"
+        "  --fps <n>              app frame cap as in the tray menu: 60, 72, 90, 120, 0 = unlimited (default 60)\n"
+        "  --source <spec>        arrival pattern \"HZ[,jitter=MS][,burst=N]\"; repeatable\n"
+        "                         (default: 60/72/90/120 Hz, each steady, jitter=2 and burst=3)\n"
+        "  --trace <file>         use the present times of a capture trace (.actrace) and also report the recorded session\n"
+        "  --cost-ms <ms>         render cost per frame (default 2)\n"
+        "  --cost-jitter-ms <ms>  +/- render cost variation (default 0.5)\n"
+        "  --timer-ms <ms>        wait granularity (default 1 = timeBeginPeriod(1); 15.625 = Windows default)\n"
+        "  --slop-ms <ms>         extra scheduler delay after a timed wait, uniform 0..ms (default 0.3)\n"
+        "  --display-hz <hz>      frames become visible at the next vblank (default: when rendered)\n"
+        "  --duration <sec>       simulated time per row (default 30)\n"
+        "  --seed <n>             random seed (default 1)\n"
+        "\n"
+        "  --governor             simulate the Auto render resolution instead: per-frame pipeline cost against the\n"
+        "                         --fps frame interval, at full resolution and under the governor\n"
+        "  --cost <spec>          full-resolution cost pattern \"MS[,fixed=MS][,jitter=MS][,spike=FxSEC/PERIOD][,ramp=MS]\"\n"
+        "                         (repeatable; default: a steady, a spiking and a ramping load near the frame interval)\n"
+        "  --fixed-ms <ms>        cost part that doesn't shrink with the render size, for --trace costs (default 0.5)\n"
+        "  --latency <frames>     frames until a cost measurement reaches the governor (default 2)\n"
+        "  (with --governor, --trace replays the trace's recorded cost samples)\n");
+}
+
+static void PrintGovernorHeader() {
+    std::printf("%-34s %-9s %7s %7s %8s %7s %7s %7s %7s\n",
+        "cost", "mode", "over%", "scale", "pixels%", "minSc", "changes", "loadP50", "loadP99");
+}
+
+static void PrintGovernorRow(const std::string& name, const char* mode, const PacingSim::GovernorResult& r) {
+    std::printf("%-34s %-9s %7.2f %7.3f %8.1f %7.3f %7llu %7.2f %7.2f\n",
+        name.c_str(), mode, r.overBudgetPercent, r.meanScale, r.meanPixelPercent, r.minScale,
+        (unsigned long long)r.changes, r.loadP50, r.loadP99);
+}
+
+static int RunGovernorRows(double fps, const std::vector<PacingSim::CostModel>& costModels, const std::string& tracePath,
+                           double fixedMs, int latencyFrames, double durationSec, uint32_t seed) {
+    if (fps <= 0.0) {
+        std::fprintf(stderr, "ArinPacingSim: --governor needs a frame cap (--fps > 0)\n");
+        return 2;
+    }
+    std::vector<double> traceCosts;
+    if (!tracePath.empty()) {
+        std::string err;
+        if (!PacingSim::LoadTraceCosts(tracePath, fixedMs, &traceCosts, &err)) {
+            std::fprintf(stderr, "ArinPacingSim: %s: %s\n", tracePath.c_str(), err.c_str());
+            return 1;
+        }
+    }
+
+    const double budgetMs = 1000.0 / fps;
+    const ResolutionGovernor::Config config;
+    std::printf("governor: cap=%d (%.2fms) target=%.2f down>%.2fx%d up<%.2fx%d scale %.2f..%.2f latency=%d frames\n",
+        (int)fps, budgetMs, config.targetLoad, config.downLoad, config.downFrames, config.upLoad, config.upFrames,
+        config.minScale, config.maxScale, latencyFrames);
+    std::printf("(over%% = frames whose cost exceeded the frame interval; load = cost / frame interval; scale is linear)\n\n");
+    PrintGovernorHeader();
+
+    auto runBoth = [&](const std::string& name, const std::vector<double>& costs, double fixed) {
+        PrintGovernorRow(name, "full", PacingSim::RunGovernor(costs, fixed, budgetMs, config, latencyFrames, false));
+        PrintGovernorRow(name, "governor", PacingSim::RunGovernor(costs, fixed, budgetMs, config, latencyFrames, true));
+    };
+
+    if (!traceCosts.empty()) {
+        runBoth("trace", traceCosts, fixedMs);
+        if (costModels.empty()) return 0;
+    }
+
+    std::vector<PacingSim::CostModel> models = costModels;
+    if (models.empty()) {
+        PacingSim::CostModel m;
+        m.baseMs = budgetMs * 0.7;
+        models.push_back(m);
+        m.baseMs = budgetMs * 1.3;
+        models.push_back(m);
+        m.baseMs = budgetMs * 0.7;
+        m.spikeFactor = 2.0;
+        m.spikeSec = 3.0;
+        m.spikePeriodSec = 10.0;
+        models.push_back(m);
+        m.spikeFactor = 1.0;
+        m.spikeSec = m.spikePeriodSec = 0.0;
+        m.baseMs = budgetMs * 0.4;
+        m.rampToMs = budgetMs * 2.0;
+        models.push_back(m);
+    }
+    for (const PacingSim::CostModel& m : models) {
+        runBoth(PacingSim::DescribeCosts(m), PacingSim::GenerateCosts(m, fps, durationSec, seed), m.fixedMs);
+    }
+    return 0;
+}
+
+static void PrintHeader() {
+    std::printf("%-26s %8s %8s %8s %7s %7s %8s %8s %7s %7s %7s %7s\n",
+        "source", "render/s", "wake/s", "repeat%", "drop%", "resync",
+        "judRMS", "judP99", "latP50", "latP95", "latP99", "latMax");
+}
+
+static void PrintRow(const std::string& name, const PacingSim::Result& r, bool haveWakeups) {
+    char wake[16];
+    if (haveWakeups) std::snprintf(wake, sizeof(wake), "%8.0f", r.wakeupsPerSec);
+    else std::snprintf(wake, sizeof(wake), "%8s", "-");
+    std::printf("%-26s %8.1f %s %8.1f %7.1f %7llu %8.2f %8.2f %7.2f %7.2f %7.2f %7.2f\n",
+        name.c_str(), r.rendersPerSec, wake, r.repeatPercent, r.dropPercent, (unsigned long long)r.resyncs,
+        r.judderRmsMs, r.judderP99Ms, r.latencyP50Ms, r.latencyP95Ms, r.latencyP99Ms, r.latencyMaxMs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    PacingSim::LoopModel loop;
+    double fps = 60.0;
+    std::vector<PacingSim::ArrivalModel> sources;
+    std::string tracePath;
+    bool governor = false;
+    std::vector<PacingSim::CostModel> costModels;
+    double fixedMs = 0.5;
+    int latencyFrames = 2;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto next = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "ArinPacingSim: %s needs a value\n", name);
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+
+        if (a == "-h" || a == "--help") {
+            PrintUsage();
+            return 0;
+        } else if (a == "--fps") {
+            fps = std::atof(next("--fps"));
+            if (fps < 0.0) fps = 0.0;
+        } else if (a == "--source") {
+            PacingSim::ArrivalModel m;
+            const char* spec = next("--source");
+            if (!PacingSim::ParseArrivalSpec(spec, &m)) {
+                std::fprintf(stderr, "ArinPacingSim: bad --source '%s' (expected HZ[,jitter=MS][,burst=N])\n", spec);
+                return 2;
+            }
+            sources.push_back(m);
+        } else if (a == "--trace") {
+            tracePath = next("--trace");
+        } else if (a == "--cost-ms") {
+            loop.renderCostMs = std::atof(next("--cost-ms"));
+        } else if (a == "--cost-jitter-ms") {
+            loop.renderCostJitterMs = std::atof(next("--cost-jitter-ms"));
+        } else if (a == "--timer-ms") {
+            loop.timerGranularityMs = std::atof(next("--timer-ms"));
+        } else if (a == "--slop-ms") {
+            loop.wakeSlopMs = std::atof(next("--slop-ms"));
+        } else if (a == "--display-hz") {
+            loop.displayHz = std::atof(next("--display-hz"));
+        } else if (a == "--duration") {
+            loop.durationSec = std::atof(next("--duration"));
+        } else if (a == "--seed") {
+            loop.seed = (uint32_t)std::strtoul(next("--seed"), nullptr, 10);
+        } else if (a == "--governor") {
+            governor = true;
+        } else if (a == "--cost") {
+            PacingSim::CostModel m;
+            const char* spec = next("--cost");
+            if (!PacingSim::ParseCostSpec(spec, &m)) {
+                std::fprintf(stderr, "ArinPacingSim: bad --cost '%s' (expected MS[,fixed=MS][,jitter=MS][,spike=FxSEC/PERIOD][,ramp=MS])\n", spec);
+                return 2;
+            }
+            costModels.push_back(m);
+        } else if (a == "--fixed-ms") {
+            fixedMs = std::atof(next("--fixed-ms"));
+            if (fixedMs < 0.0) fixedMs = 0.0;
+        } else if (a == "--latency") {
+            latencyFrames = std::atoi(next("--latency"));
+            if (latencyFrames < 0) latencyFrames = 0;
+        } else {
+            std::fprintf(stderr, "ArinPacingSim: unknown option '%s'\n", a.c_str());
+            PrintUsage();
+            return 2;
+        }
+    }
+    if (loop.durationSec <= 0.0) {
+        std::fprintf(stderr, "ArinPacingSim: --duration must be > 0\n");
+        return 2;
+    }
+    if (governor) return RunGovernorRows(fps, costModels, tracePath, fixedMs, latencyFrames, loop.durationSec, loop.seed);
+    loop.renderIntervalSec = (fps > 0.0) ? 1.0 / fps : 0.0;
+
+    std::printf("cap=%s cost=%.2f+/-%.2fms timer=%.3fms slop=%.2fms display=%s duration=%.0fs resync>%d intervals\n",
+        fps > 0.0 ? std::to_string((int)fps).c_str() : "unlimited",
+        loop.renderCostMs, loop.renderCostJitterMs, loop.timerGranularityMs, loop.wakeSlopMs,
+        loop.displayHz > 0.0 ? (std::to_string((int)loop.displayHz) + "Hz").c_str() : "immediate",
+        loop.durationSec, FramePacer::kResyncIntervals);
+    std::printf("(times in ms; judder = on-screen interval minus content interval per shown frame)\n\n");
+    PrintHeader();
+
+    if (!tracePath.empty()) {
+        std::vector<int64_t> arrivals;
+        PacingSim::Result recorded;
+        std::string err;
+        if (!PacingSim::LoadTraceArrivals(tracePath, &arrivals, &recorded, &err)) {
+            std::fprintf(stderr, "ArinPacingSim: %s: %s\n", tracePath.c_str(), err.c_str());
+            return 1;
+        }
+        PrintRow("trace (recorded)", recorded, false);
+        PrintRow("trace (simulated)", PacingSim::Run(arrivals, loop), true);
+        if (sources.empty()) return 0;
+    }
+
+    if (sources.empty()) {
+        const double rates[] = { 60.0, 72.0, 90.0, 120.0 };
+        for (double hz : rates) {
+            PacingSim::ArrivalModel m;
+            m.hz = hz;
+            sources.push_back(m);
+            m.jitterMs = 2.0;
+            sources.push_back(m);
+            m.jitterMs = 0.0;
+            m.burst = 3;
+            sources.push_back(m);
+        }
+    }
+
+    for (const PacingSim::ArrivalModel& m : sources) {
+        const std::vector<int64_t> arrivals = PacingSim::GenerateArrivals(m, loop.durationSec, loop.seed);
+        PrintRow(PacingSim::DescribeArrivals(m), PacingSim::Run(arrivals, loop), true);
+    }
+    return 0;
+}
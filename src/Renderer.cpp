@@ -6,9 +6,11 @@
 #include <winrt/base.h>
 #include <d3dcompiler.h>
 #include "3PassShader.h"
+#include "DepthCpuKernels.h"
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <vector>
 #ifndef AC_SRC_OVER
 #define AC_SRC_OVER 0x00
 #endif
@@ -248,6 +250,19 @@ void Renderer::UpdateRateStats(bool gotNewFrame) {
     presentFps_ = (elapsed > 0.0) ? (ratePresentCount_ / elapsed) : 0.0;
     newFrameFps_ = (elapsed > 0.0) ? (rateNewFrameCount_ / elapsed) : 0.0;
 
+    // Ticks the fingerprint resolved to zero thread groups were dispatched (counted as runs) but did no work.
+    if (contentNewTotal_ < rateLastContentNew_) rateLastContentNew_ = contentNewTotal_;
+    if (fpSkippedTotal_ < rateLastFpSkipped_) rateLastFpSkipped_ = fpSkippedTotal_;
+    const int gpuSkipped = (int)(fpSkippedTotal_ - rateLastFpSkipped_);
+    const int depthRuns = (rateDepthRunCount_ > gpuSkipped) ? (rateDepthRunCount_ - gpuSkipped) : 0;
+    depthRunFps_ = (elapsed > 0.0) ? (depthRuns / elapsed) : 0.0;
+    depthSkipFps_ = (elapsed > 0.0) ? ((rateDepthSkipCount_ + gpuSkipped) / elapsed) : 0.0;
+    interpFps_ = (elapsed > 0.0) ? (rateInterpCount_ / elapsed) : 0.0;
+    contentNewFps_ = (elapsed > 0.0) ? (double)(contentNewTotal_ - rateLastContentNew_) / elapsed : 0.0;
+    depthSkippedTotal_ += (unsigned long long)gpuSkipped;
+    rateLastContentNew_ = contentNewTotal_;
+    rateLastFpSkipped_ = fpSkippedTotal_;
+
     // Update capture delivery rates using monotonically increasing totals.
     if (captureStatsBackend_ == CaptureBackendStats::DXGI) {
         if (dxgiProducedTotal_ < rateLastDxgiProduced_) rateLastDxgiProduced_ = dxgiProducedTotal_;
@@ -267,6 +282,9 @@ void Renderer::UpdateRateStats(bool gotNewFrame) {
 
     ratePresentCount_ = 0;
     rateNewFrameCount_ = 0;
+    rateDepthRunCount_ = 0;
+    rateDepthSkipCount_ = 0;
+    rateInterpCount_ = 0;
     rateLastQpc_ = nowQpc;
 }
 
@@ -304,25 +322,38 @@ void Renderer::EnsureOverlayFont(UINT dpi) {
     overlayDpi_ = dpi;
 }
 
-void Renderer::EnsureDepthStereoResources(UINT outW, UINT outH) {
-    if (!device_) return;
-    if (outW == 0 || outH == 0) return;
+static const char* DxgiFormatName(DXGI_FORMAT fmt);
 
-    auto supportsTypedUavStore = [&](DXGI_FORMAT fmt) -> bool {
-        if (!device_) return false;
-        UINT support1 = 0;
-        if (FAILED(device_->CheckFormatSupport(fmt, &support1))) return false;
-        if ((support1 & D3D11_FORMAT_SUPPORT_SHADER_SAMPLE) == 0) return false;
+static bool SupportsTypedUavStore(ID3D11Device* device, DXGI_FORMAT fmt) {
+    if (!device) return false;
+    UINT support1 = 0;
+    if (FAILED(device->CheckFormatSupport(fmt, &support1))) return false;
+    if ((support1 & D3D11_FORMAT_SUPPORT_SHADER_SAMPLE) == 0) return false;
 
-        // Prefer checking support2 for explicit typed UAV store capability (D3D11.1+), but don't require it.
-        D3D11_FEATURE_DATA_FORMAT_SUPPORT2 support2{};
-        support2.InFormat = fmt;
-        if (SUCCEEDED(device_->CheckFeatureSupport(D3D11_FEATURE_FORMAT_SUPPORT2, &support2, sizeof(support2)))) {
-            if ((support2.OutFormatSupport2 & D3D11_FORMAT_SUPPORT2_UAV_TYPED_STORE) == 0) return false;
-        }
+    // Prefer checking support2 for explicit typed UAV store capability (D3D11.1+), but don't require it.
+    D3D11_FEATURE_DATA_FORMAT_SUPPORT2 support2{};
+    support2.InFormat = fmt;
+    if (SUCCEEDED(device->CheckFeatureSupport(D3D11_FEATURE_FORMAT_SUPPORT2, &support2, sizeof(support2)))) {
+        if ((support2.OutFormatSupport2 & D3D11_FORMAT_SUPPORT2_UAV_TYPED_STORE) == 0) return false;
+    }
 
-        return true;
-    };
+    return true;
+}
+
+void Renderer::EnsureDepthStereoResources(UINT outW, UINT outH, const DepthCpu::Kernels::FoveaLayout* fovea) {
+    if (!device_) return;
+    if (outW == 0 || outH == 0) return;
+
+    UINT foveaKey[6] = { 0, 0, 0, 0, 0, 0 };
+    if (fovea) {
+        foveaKey[0] = fovea->cx0;
+        foveaKey[1] = fovea->cy0;
+        foveaKey[2] = fovea->cw;
+        foveaKey[3] = fovea->ch;
+        foveaKey[4] = fovea->pw;
+        foveaKey[5] = fovea->ph;
+    }
+    const bool wantFovea = (foveaKey[4] != 0);
 
     const bool okExisting = (
         depthRawTex_ && depthRawSrv_ && depthRawUav_ &&
@@ -330,7 +361,9 @@ void Renderer::EnsureDepthStereoResources(UINT outW, UINT outH) {
         depthPrevTex_[0] && depthPrevSrv_[0] && depthPrevUav_[0] &&
         depthPrevTex_[1] && depthPrevSrv_[1] && depthPrevUav_[1] &&
         stereoOutTex_ && stereoOutSrv_ && stereoOutUav_ &&
-        depthOutW_ == outW && depthOutH_ == outH
+        depthOutW_ == outW && depthOutH_ == outH && depthOutPrecision_ == depthPrecision_ &&
+        memcmp(depthOutFovea_, foveaKey, sizeof(foveaKey)) == 0 &&
+        (!wantFovea || (foveaRawUav_ && foveaSmoothSrv_ && foveaPrevSrv_[0] && foveaPrevSrv_[1]))
     );
     if (okExisting) return;
 
@@ -349,24 +382,37 @@ void Renderer::EnsureDepthStereoResources(UINT outW, UINT outH) {
     }
     depthPrevIndex_ = 0;
     depthFrame_ = 0.0f;
+    ReleaseFoveaResources();
 
     if (stereoOutSrv_) { stereoOutSrv_->Release(); stereoOutSrv_ = nullptr; }
     if (stereoOutUav_) { stereoOutUav_->Release(); stereoOutUav_ = nullptr; }
     if (stereoOutTex_) { stereoOutTex_->Release(); stereoOutTex_ = nullptr; }
     depthOutW_ = depthOutH_ = 0;
+    memset(depthOutFovea_, 0, sizeof(depthOutFovea_));
 
-    auto createDepthTex = [&](const char* name, ID3D11Texture2D** outTex, ID3D11ShaderResourceView** outSrv, ID3D11UnorderedAccessView** outUav) -> bool {
+    // Depth/history format. All passes read these through SRVs and only store through the UAVs,
+    // so UNORM formats just need typed UAV store support.
+    DXGI_FORMAT depthFormat = DXGI_FORMAT_R32_FLOAT;
+    if (depthPrecision_ == DepthPrecision::Unorm16) depthFormat = DXGI_FORMAT_R16_UNORM;
+    else if (depthPrecision_ == DepthPrecision::Unorm8) depthFormat = DXGI_FORMAT_R8_UNORM;
+    if (depthFormat != DXGI_FORMAT_R32_FLOAT && !SupportsTypedUavStore(device_, depthFormat)) {
+        Log::Info(std::string("EnsureDepthStereoResources: ") + DxgiFormatName(depthFormat) + " not supported for UAV stores, using R32_FLOAT");
+        depthFormat = DXGI_FORMAT_R32_FLOAT;
+    }
+
+    auto createDepthTex = [&](const char* name, ID3D11Texture2D** outTex, ID3D11ShaderResourceView** outSrv, ID3D11UnorderedAccessView** outUav,
+                              UINT texW = 0, UINT texH = 0) -> bool {
         if (!outTex || !outSrv || !outUav) return false;
         *outTex = nullptr;
         *outSrv = nullptr;
         *outUav = nullptr;
 
         D3D11_TEXTURE2D_DESC td{};
-        td.Width = outW;
-        td.Height = outH;
+        td.Width = texW ? texW : outW;
+        td.Height = texH ? texH : outH;
         td.MipLevels = 1;
         td.ArraySize = 1;
-        td.Format = DXGI_FORMAT_R32_FLOAT;
+        td.Format = depthFormat;
         td.SampleDesc.Count = 1;
         td.Usage = D3D11_USAGE_DEFAULT;
         td.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
@@ -404,85 +450,216 @@ void Renderer::EnsureDepthStereoResources(UINT outW, UINT outH) {
     if (!createDepthTex("depthPrev0", &depthPrevTex_[0], &depthPrevSrv_[0], &depthPrevUav_[0])) return;
     if (!createDepthTex("depthPrev1", &depthPrevTex_[1], &depthPrevSrv_[1], &depthPrevUav_[1])) return;
 
+    // Foveation periphery planes: both eye views side by side at reduced resolution.
+    if (wantFovea) {
+        const UINT fw = 2 * foveaKey[4];
+        const UINT fh = foveaKey[5];
+        if (!createDepthTex("foveaRaw", &foveaRawTex_, &foveaRawSrv_, &foveaRawUav_, fw, fh) ||
+            !createDepthTex("foveaSmooth", &foveaSmoothTex_, &foveaSmoothSrv_, &foveaSmoothUav_, fw, fh) ||
+            !createDepthTex("foveaPrev0", &foveaPrevTex_[0], &foveaPrevSrv_[0], &foveaPrevUav_[0], fw, fh) ||
+            !createDepthTex("foveaPrev1", &foveaPrevTex_[1], &foveaPrevSrv_[1], &foveaPrevUav_[1], fw, fh)) {
+            ReleaseFoveaResources();
+            return;
+        }
+    }
+
     // Output SBS image with UAV+SRV.
-    {
-        auto tryCreateStereoOut = [&](DXGI_FORMAT fmt) -> bool {
-            ID3D11Texture2D* tex = nullptr;
-            ID3D11ShaderResourceView* srv = nullptr;
-            ID3D11UnorderedAccessView* uav = nullptr;
-
-            D3D11_TEXTURE2D_DESC td{};
-            td.Width = outW;
-            td.Height = outH;
-            td.MipLevels = 1;
-            td.ArraySize = 1;
-            td.Format = fmt;
-            td.SampleDesc.Count = 1;
-            td.Usage = D3D11_USAGE_DEFAULT;
-            td.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+    if (!CreateComputeOutput(outW, outH, &stereoOutTex_, &stereoOutSrv_, &stereoOutUav_)) {
+        Log::Error("EnsureDepthStereoResources: failed to create stereoOut (no compatible format)");
+        return;
+    }
+
+    depthOutW_ = outW;
+    depthOutH_ = outH;
+    depthOutPrecision_ = depthPrecision_;
+    memcpy(depthOutFovea_, foveaKey, sizeof(foveaKey));
 
-            HRESULT hr = device_->CreateTexture2D(&td, nullptr, &tex);
-            if (FAILED(hr) || !tex) return false;
+    // Initialize history to neutral.
+    depthSettleTicks_ = 0;
+    fpStateValid_ = false; // forces the GPU-side settle count to restart as well
+    if (context_) {
+        const float clearVal[4] = { 0.5f, 0.5f, 0.5f, 0.5f };
+        if (depthPrevUav_[0]) context_->ClearUnorderedAccessViewFloat(depthPrevUav_[0], clearVal);
+        if (depthPrevUav_[1]) context_->ClearUnorderedAccessViewFloat(depthPrevUav_[1], clearVal);
+        if (foveaPrevUav_[0]) context_->ClearUnorderedAccessViewFloat(foveaPrevUav_[0], clearVal);
+        if (foveaPrevUav_[1]) context_->ClearUnorderedAccessViewFloat(foveaPrevUav_[1], clearVal);
+    }
+}
 
-            D3D11_SHADER_RESOURCE_VIEW_DESC sd{};
-            sd.Format = td.Format;
-            sd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-            sd.Texture2D.MipLevels = 1;
-            hr = device_->CreateShaderResourceView(tex, &sd, &srv);
-            if (FAILED(hr) || !srv) {
-                tex->Release();
-                return false;
-            }
+bool Renderer::CreateComputeOutput(UINT width, UINT height, ID3D11Texture2D** outTex, ID3D11ShaderResourceView** outSrv, ID3D11UnorderedAccessView** outUav) {
+    *outTex = nullptr;
+    *outSrv = nullptr;
+    *outUav = nullptr;
 
-            D3D11_UNORDERED_ACCESS_VIEW_DESC ud{};
-            ud.Format = td.Format;
-            ud.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D;
-            ud.Texture2D.MipSlice = 0;
-            hr = device_->CreateUnorderedAccessView(tex, &ud, &uav);
-            if (FAILED(hr) || !uav) {
-                srv->Release();
-                tex->Release();
-                return false;
-            }
+    auto tryCreate = [&](DXGI_FORMAT fmt) -> bool {
+        ID3D11Texture2D* tex = nullptr;
+        ID3D11ShaderResourceView* srv = nullptr;
+        ID3D11UnorderedAccessView* uav = nullptr;
 
-            stereoOutTex_ = tex;
-            stereoOutSrv_ = srv;
-            stereoOutUav_ = uav;
-            return true;
-        };
+        D3D11_TEXTURE2D_DESC td{};
+        td.Width = width;
+        td.Height = height;
+        td.MipLevels = 1;
+        td.ArraySize = 1;
+        td.Format = fmt;
+        td.SampleDesc.Count = 1;
+        td.Usage = D3D11_USAGE_DEFAULT;
+        td.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
 
-        // Prefer float formats for UAV writes if possible.
-        const DXGI_FORMAT candidates[] = {
-            DXGI_FORMAT_R16G16B16A16_FLOAT,
-            DXGI_FORMAT_R32G32B32A32_FLOAT,
-            DXGI_FORMAT_R8G8B8A8_UNORM,
-        };
+        HRESULT hr = device_->CreateTexture2D(&td, nullptr, &tex);
+        if (FAILED(hr) || !tex) return false;
 
-        for (DXGI_FORMAT fmt : candidates) {
-            // Keep the support check as a fast pre-filter, but rely on actual Create* calls.
-            if (fmt != DXGI_FORMAT_R8G8B8A8_UNORM && !supportsTypedUavStore(fmt)) {
-                continue;
-            }
-            if (tryCreateStereoOut(fmt)) {
-                break;
-            }
+        D3D11_SHADER_RESOURCE_VIEW_DESC sd{};
+        sd.Format = td.Format;
+        sd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+        sd.Texture2D.MipLevels = 1;
+        hr = device_->CreateShaderResourceView(tex, &sd, &srv);
+        if (FAILED(hr) || !srv) {
+            tex->Release();
+            return false;
+        }
+
+        D3D11_UNORDERED_ACCESS_VIEW_DESC ud{};
+        ud.Format = td.Format;
+        ud.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D;
+        ud.Texture2D.MipSlice = 0;
+        hr = device_->CreateUnorderedAccessView(tex, &ud, &uav);
+        if (FAILED(hr) || !uav) {
+            srv->Release();
+            tex->Release();
+            return false;
+        }
+
+        *outTex = tex;
+        *outSrv = srv;
+        *outUav = uav;
+        return true;
+    };
+
+    // Prefer float formats for UAV writes if possible.
+    const DXGI_FORMAT candidates[] = {
+        DXGI_FORMAT_R16G16B16A16_FLOAT,
+        DXGI_FORMAT_R32G32B32A32_FLOAT,
+        DXGI_FORMAT_R8G8B8A8_UNORM,
+    };
+
+    for (DXGI_FORMAT fmt : candidates) {
+        // Keep the support check as a fast pre-filter, but rely on actual Create* calls.
+        if (fmt != DXGI_FORMAT_R8G8B8A8_UNORM && !SupportsTypedUavStore(device_, fmt)) {
+            continue;
         }
+        if (tryCreate(fmt)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Renderer::EnsureLayoutOutput(UINT computeW, UINT computeH) {
+    if (!device_ || computeW == 0 || computeH == 0) return false;
+    const bool doubleWidth = (stereoLayout_ == StereoLayout::FullSbs || stereoLayout_ == StereoLayout::ImageDepth);
+    const UINT w = doubleWidth ? computeW * 2 : computeW;
+    if (layoutOutTex_ && layoutOutSrv_ && layoutOutUav_ && layoutOutW_ == w && layoutOutH_ == computeH) return true;
+
+    if (layoutOutSrv_) { layoutOutSrv_->Release(); layoutOutSrv_ = nullptr; }
+    if (layoutOutUav_) { layoutOutUav_->Release(); layoutOutUav_ = nullptr; }
+    if (layoutOutTex_) { layoutOutTex_->Release(); layoutOutTex_ = nullptr; }
+    layoutOutW_ = layoutOutH_ = 0;
+
+    if (!CreateComputeOutput(w, computeH, &layoutOutTex_, &layoutOutSrv_, &layoutOutUav_)) {
+        Log::Error("EnsureLayoutOutput: failed to create layoutOut (no compatible format)");
+        return false;
+    }
+    layoutOutW_ = w;
+    layoutOutH_ = computeH;
+    return true;
+}
 
-        if (!stereoOutTex_ || !stereoOutSrv_ || !stereoOutUav_) {
-            Log::Error("EnsureDepthStereoResources: failed to create stereoOut (no compatible format)");
+bool Renderer::EnsureSinkOutput(SinkSlot& slot, UINT canvasW, UINT canvasH) {
+    if (!device_ || canvasW == 0 || canvasH == 0) return false;
+    const int layout = slot.sink->GetDesc().layout;
+    const bool doubleWidth = (layout == (int)StereoLayout::FullSbs || layout == (int)StereoLayout::ImageDepth);
+    const UINT w = doubleWidth ? canvasW * 2 : canvasW;
+    if (slot.outTex && slot.outSrv && slot.outUav && slot.outW == w && slot.outH == canvasH) return true;
+
+    ReleaseSinkOutput(slot);
+    if (!CreateComputeOutput(w, canvasH, &slot.outTex, &slot.outSrv, &slot.outUav)) {
+        Log::Error("EnsureSinkOutput: failed to create the sink output (no compatible format)");
+        return false;
+    }
+    slot.outW = w;
+    slot.outH = canvasH;
+    return true;
+}
+
+void Renderer::ReleaseSinkOutput(SinkSlot& slot) {
+    if (slot.outSrv) { slot.outSrv->Release(); slot.outSrv = nullptr; }
+    if (slot.outUav) { slot.outUav->Release(); slot.outUav = nullptr; }
+    if (slot.outTex) { slot.outTex->Release(); slot.outTex = nullptr; }
+    slot.outW = slot.outH = 0;
+    slot.fresh = false;
+}
+
+int Renderer::AddOutputSink(const OutputSink::Desc& desc) {
+    if (!device_ || sinks_.size() >= kMaxOutputSinks) return 0;
+    OutputSink::Desc d = desc;
+    if (d.layout < (int)StereoLayout::OverUnder || d.layout > (int)StereoLayout::ImageDepth) d.layout = (int)StereoLayout::HalfSbs;
+
+    SinkSlot slot;
+    slot.sink = std::make_unique<OutputSink>();
+    if (!slot.sink->Open(device_, d)) return 0;
+    slot.id = nextSinkId_++;
+    sinks_.push_back(std::move(slot));
+    return sinks_.back().id;
+}
+
+void Renderer::RemoveOutputSink(int id) {
+    for (size_t i = 0; i < sinks_.size(); ++i) {
+        if (sinks_[i].id == id) {
+            ReleaseSinkOutput(sinks_[i]);
+            sinks_.erase(sinks_.begin() + i);
             return;
         }
     }
+}
 
-    depthOutW_ = outW;
-    depthOutH_ = outH;
+void Renderer::RemoveAllOutputSinks() {
+    for (SinkSlot& slot : sinks_) {
+        ReleaseSinkOutput(slot);
+    }
+    sinks_.clear();
+}
 
-    // Initialize history to neutral.
-    if (context_) {
-        const float clearVal[4] = { 0.5f, 0.5f, 0.5f, 0.5f };
-        if (depthPrevUav_[0]) context_->ClearUnorderedAccessViewFloat(depthPrevUav_[0], clearVal);
-        if (depthPrevUav_[1]) context_->ClearUnorderedAccessViewFloat(depthPrevUav_[1], clearVal);
+void Renderer::ReleaseFoveaResources() {
+    if (foveaRawSrv_) { foveaRawSrv_->Release(); foveaRawSrv_ = nullptr; }
+    if (foveaRawUav_) { foveaRawUav_->Release(); foveaRawUav_ = nullptr; }
+    if (foveaRawTex_) { foveaRawTex_->Release(); foveaRawTex_ = nullptr; }
+
+    if (foveaSmoothSrv_) { foveaSmoothSrv_->Release(); foveaSmoothSrv_ = nullptr; }
+    if (foveaSmoothUav_) { foveaSmoothUav_->Release(); foveaSmoothUav_ = nullptr; }
+    if (foveaSmoothTex_) { foveaSmoothTex_->Release(); foveaSmoothTex_ = nullptr; }
+
+    for (int i = 0; i < 2; ++i) {
+        if (foveaPrevSrv_[i]) { foveaPrevSrv_[i]->Release(); foveaPrevSrv_[i] = nullptr; }
+        if (foveaPrevUav_[i]) { foveaPrevUav_[i]->Release(); foveaPrevUav_[i] = nullptr; }
+        if (foveaPrevTex_[i]) { foveaPrevTex_[i]->Release(); foveaPrevTex_[i] = nullptr; }
     }
+    foveaPrevIndex_ = 0;
+}
+
+void Renderer::SetFoveation(int peripheryScale, int radiusPercent, int falloffPercent) {
+    foveaScale_ = (peripheryScale <= 0) ? 0 : (peripheryScale >= 4 ? 4 : 2);
+    foveaRadiusPercent_ = (radiusPercent < 0) ? 0 : (radiusPercent > 150 ? 150 : radiusPercent);
+    foveaFalloffPercent_ = (falloffPercent < 0) ? 0 : (falloffPercent > 150 ? 150 : falloffPercent);
+}
+
+void Renderer::SetFrameInterpolation(bool enabled) {
+    if (enabled == interpEnabled_) return;
+    interpEnabled_ = enabled;
+    interpPictures_ = 0;
+    interpIntervalSec_ = 0.0;
+    interpSteady_ = false;
+    depthSettleTicks_ = 0; // stereoOut may hold an interpolated frame; let the passes rewrite it
 }
 
 void Renderer::SetRenderResolutionIndex(int idx) {
@@ -495,6 +672,96 @@ void Renderer::SetRenderResolutionIndex(int idx) {
     if (downRtv_) { downRtv_->Release(); downRtv_ = nullptr; }
     if (downTex_) { downTex_->Release(); downTex_ = nullptr; }
     downW_ = downH_ = 0;
+    // Auto starts from the capture's own size and shrinks within a few frames if that doesn't hold.
+    if (renderResIndex_ == kRenderResolutionAuto) {
+        resGovernor_.Reset(1.0);
+    }
+}
+
+bool Renderer::TakePipelineCostSample(float* costMs, float* renderScale) {
+    if (!costSampleNew_) return false;
+    costSampleNew_ = false;
+    if (costMs) *costMs = (float)lastCostMs_;
+    if (renderScale) *renderScale = (float)lastCostScale_;
+    return true;
+}
+
+Renderer::GpuTimerSlot* Renderer::BeginGpuTimer() {
+    if (!device_ || !context_ || gpuTimersFailed_) return nullptr;
+    if (!gpuTimers_[0].disjoint) {
+        D3D11_QUERY_DESC dq = {};
+        bool ok = true;
+        for (GpuTimerSlot& t : gpuTimers_) {
+            dq.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+            ok = ok && SUCCEEDED(device_->CreateQuery(&dq, &t.disjoint));
+            dq.Query = D3D11_QUERY_TIMESTAMP;
+            ok = ok && SUCCEEDED(device_->CreateQuery(&dq, &t.begin));
+            ok = ok && SUCCEEDED(device_->CreateQuery(&dq, &t.end));
+        }
+        if (!ok) {
+            Log::Error("Renderer: timestamp queries unavailable; Auto render resolution keeps its size");
+            ReleaseGpuTimers();
+            gpuTimersFailed_ = true;
+            return nullptr;
+        }
+    }
+
+    // More frames in flight than slots: leave this one unmeasured rather than wait for the GPU.
+    GpuTimerSlot& t = gpuTimers_[gpuTimerNext_];
+    if (t.pending) return nullptr;
+    context_->Begin(t.disjoint);
+    context_->End(t.begin);
+    return &t;
+}
+
+void Renderer::EndGpuTimer(GpuTimerSlot* slot, bool sampled, double scale) {
+    if (!slot) return;
+    context_->End(slot->end);
+    context_->End(slot->disjoint);
+    slot->pending = true;
+    slot->sampled = sampled;
+    slot->autoRes = (renderResIndex_ == kRenderResolutionAuto);
+    slot->scale = scale;
+    gpuTimerNext_ = (gpuTimerNext_ + 1) % kGpuTimerSlots;
+}
+
+void Renderer::CollectGpuTimers() {
+    if (!context_ || !gpuTimers_[0].disjoint) return;
+    // Oldest first; once one isn't ready, the newer ones aren't either.
+    for (int n = 0; n < kGpuTimerSlots; ++n) {
+        GpuTimerSlot& t = gpuTimers_[(gpuTimerNext_ + n) % kGpuTimerSlots];
+        if (!t.pending) continue;
+
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT dj = {};
+        UINT64 t0 = 0, t1 = 0;
+        if (context_->GetData(t.disjoint, &dj, sizeof(dj), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            context_->GetData(t.begin, &t0, sizeof(t0), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            context_->GetData(t.end, &t1, sizeof(t1), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) {
+            break;
+        }
+        t.pending = false;
+        if (!t.sampled || dj.Disjoint || dj.Frequency == 0 || t1 <= t0) continue;
+
+        lastCostMs_ = (double)(t1 - t0) * 1000.0 / (double)dj.Frequency;
+        lastCostScale_ = t.scale;
+        costSampleNew_ = true;
+        if (t.autoRes && renderResIndex_ == kRenderResolutionAuto &&
+            resGovernor_.AddSample(lastCostMs_, t.scale, GetFrameInterval() * 1000.0)) {
+            Log::Info("Renderer: auto render resolution " + std::to_string((int)std::lround(resGovernor_.GetScale() * 100.0)) +
+                "% (" + std::to_string((int)std::lround(lastCostMs_ * 1000.0)) + " us at " +
+                std::to_string((int)std::lround(t.scale * 100.0)) + "%)");
+        }
+    }
+}
+
+void Renderer::ReleaseGpuTimers() {
+    for (GpuTimerSlot& t : gpuTimers_) {
+        if (t.disjoint) { t.disjoint->Release(); t.disjoint = nullptr; }
+        if (t.begin) { t.begin->Release(); t.begin = nullptr; }
+        if (t.end) { t.end->Release(); t.end = nullptr; }
+        t.pending = false;
+    }
+    gpuTimerNext_ = 0;
 }
 
 void Renderer::SetStereoDepthLevel(int level) {
@@ -638,7 +905,8 @@ cbuffer CursorCB : register(b2) {
     float cursorSizePx;
     float cursorEnabled;
 
-    // If 1, fold output U (frac(u*2)) so cursor appears in both halves when presenting a pre-SBS texture.
+    // Fold for presenting a pre-stereo texture: 1 = fold U (frac(u*2)) so the cursor appears in both
+    // halves (SBS), 2 = fold V (over-under), 3 = left half only (2D + depth).
     float cursorFoldU;
     float cursorPad1;
     float cursorPad2;
@@ -649,7 +917,7 @@ cbuffer MenuCB : register(b3) {
     // Normalized destination rect in output UV: (l, t, r, b)
     float4 menuRect;
     float menuEnabled;
-    // If 1, fold output U (frac(u*2)) so overlay appears in both halves when presenting a pre-SBS texture.
+    // Fold for presenting a pre-stereo texture, as cursorFoldU.
     float menuFoldU;
     float menuPad2;
     float menuPad3;
@@ -658,8 +926,13 @@ cbuffer MenuCB : register(b3) {
 float4 ApplySoftwareCursor(float4 baseColor, float2 uv) {
     if (cursorEnabled < 0.5) return baseColor;
 
-    // Optional fold for full-screen SBS textures.
-    if (cursorFoldU > 0.5) {
+    // Optional fold for full-screen stereo textures.
+    if (cursorFoldU > 2.5) {
+        if (uv.x >= 0.5) return baseColor;
+        uv.x *= 2.0;
+    } else if (cursorFoldU > 1.5) {
+        uv.y = frac(uv.y * 2.0);
+    } else if (cursorFoldU > 0.5) {
         uv.x = frac(uv.x * 2.0);
     }
 
@@ -696,7 +969,12 @@ float4 ApplySoftwareCursor(float4 baseColor, float2 uv) {
 
 float4 ApplyMenuOverlay(float4 baseColor, float2 uv) {
     if (menuEnabled < 0.5) return baseColor;
-    if (menuFoldU > 0.5) {
+    if (menuFoldU > 2.5) {
+        if (uv.x >= 0.5) return baseColor;
+        uv.x *= 2.0;
+    } else if (menuFoldU > 1.5) {
+        uv.y = frac(uv.y * 2.0);
+    } else if (menuFoldU > 0.5) {
         uv.x = frac(uv.x * 2.0);
     }
 
@@ -840,10 +1118,379 @@ static const char* DxgiFormatName(DXGI_FORMAT fmt) {
     case DXGI_FORMAT_R16G16B16A16_FLOAT: return "R16G16B16A16_FLOAT";
     case DXGI_FORMAT_R32G32B32A32_FLOAT: return "R32G32B32A32_FLOAT";
     case DXGI_FORMAT_R32_FLOAT: return "R32_FLOAT";
+    case DXGI_FORMAT_R16_UNORM: return "R16_UNORM";
+    case DXGI_FORMAT_R8_UNORM: return "R8_UNORM";
     default: return "(other)";
     }
 }
 
+void Renderer::EnsureContentFingerprintResources(UINT inW, UINT inH) {
+    if (!device_) return;
+    if (inW == 0 || inH == 0) return;
+    if (fpStateBuf_ && fpInW_ == inW && fpInH_ == inH) return;
+
+    if (fpStateUav_) { fpStateUav_->Release(); fpStateUav_ = nullptr; }
+    if (fpStateBuf_) { fpStateBuf_->Release(); fpStateBuf_ = nullptr; }
+    fpInW_ = fpInH_ = 0;
+    fpStateValid_ = false;
+
+    // Lattice samples followed by one hash per 16x16 block (CSContentHash).
+    const UINT count = kFingerprintLattice * kFingerprintLattice + DivRoundUp(inW, 16) * DivRoundUp(inH, 16);
+
+    D3D11_BUFFER_DESC bd{};
+    bd.ByteWidth = count * sizeof(UINT);
+    bd.Usage = D3D11_USAGE_DEFAULT;
+    bd.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+    HRESULT hr = device_->CreateBuffer(&bd, nullptr, &fpStateBuf_);
+    if (SUCCEEDED(hr)) {
+        D3D11_UNORDERED_ACCESS_VIEW_DESC ud{};
+        ud.Format = DXGI_FORMAT_R32_UINT;
+        ud.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+        ud.Buffer.FirstElement = 0;
+        ud.Buffer.NumElements = count;
+        hr = device_->CreateUnorderedAccessView(fpStateBuf_, &ud, &fpStateUav_);
+    }
+    if (FAILED(hr) || !fpStateUav_) {
+        Log::Error("Renderer::EnsureContentFingerprintResources: fingerprint state creation failed");
+        if (fpStateBuf_) { fpStateBuf_->Release(); fpStateBuf_ = nullptr; }
+        return;
+    }
+
+    fpInW_ = inW;
+    fpInH_ = inH;
+}
+
+void Renderer::CollectContentFingerprintStats() {
+    if (!context_) return;
+    // Oldest first; stop at the first readback the GPU hasn't finished.
+    for (int i = 0; i < kFingerprintReadbackSlots; ++i) {
+        const int slot = (fpReadbackNext_ + i) % kFingerprintReadbackSlots;
+        if (!fpReadbackPending_[slot]) continue;
+
+        D3D11_MAPPED_SUBRESOURCE mapped{};
+        const HRESULT hr = context_->Map(fpReadback_[slot], 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+        if (hr == DXGI_ERROR_WAS_STILL_DRAWING) break;
+        if (SUCCEEDED(hr) && mapped.pData) {
+            const UINT* args = static_cast<const UINT*>(mapped.pData);
+            contentNewTotal_ = args[kFingerprintArgContentNew];
+            fpSkippedTotal_ = args[kFingerprintArgSkipped];
+            context_->Unmap(fpReadback_[slot], 0);
+        }
+        fpReadbackPending_[slot] = false;
+    }
+}
+
+void Renderer::SetSourceMoveRects(const DXGI_OUTDUPL_MOVE_RECT* moves, UINT count, bool known) {
+    pendingMoves_.clear();
+    pendingMovesKnown_ = known;
+    if (known && moves) pendingMoves_.assign(moves, moves + count);
+}
+
+// b0 of CSHistoryShift.
+struct HistoryShiftParams {
+    INT rect[4];
+    INT view[4];
+    INT offset[2];
+    INT pad0[2];
+};
+
+// Mirrors DepthCpu::Engine::ApplyMoveRects on the full-width (two eye) history plane: view pixel x
+// samples source column (cropOffset + (x + 0.5) / viewW * cropScale) * srcW, so it belongs to a move
+// when that centre lies in the move's destination, and takes the history of the pixel the move's
+// offset maps to (rounded; the plane is usually downscaled).
+bool Renderer::ShiftDepthHistory(UINT computeW, UINT computeH) {
+    if (!csHistoryShift_ || !historyShiftCb_ || pendingMoves_.empty() || srcW_ == 0 || srcH_ == 0) return false;
+    if (pendingMoves_.size() > kMaxHistoryMoves) return false; // window drags etc.: not worth translating
+
+    // Moves are in captured-desktop pixels; the downscaled input already has the crop applied, but the
+    // mapping from the desktop is the same either way.
+    const float cropOffset[2] = { cropEnabled_ ? cropLeft_ : 0.0f, cropEnabled_ ? cropTop_ : 0.0f };
+    const float cropScale[2] = { cropEnabled_ ? (cropRight_ - cropLeft_) : 1.0f, cropEnabled_ ? (cropBottom_ - cropTop_) : 1.0f };
+    if (cropScale[0] <= 0.0f || cropScale[1] <= 0.0f) return false;
+
+    const UINT leftW = computeW / 2;
+    const UINT viewX0[2] = { 0, leftW };
+    const UINT viewW[2] = { leftW, computeW - leftW };
+    const double spanX = (double)cropScale[0] * srcW_;
+    const double spanY = (double)cropScale[1] * srcH_;
+
+    const int prevIdx = depthPrevIndex_ & 1;
+    const int nextIdx = (depthPrevIndex_ ^ 1) & 1;
+    context_->CopyResource(depthPrevTex_[nextIdx], depthPrevTex_[prevIdx]);
+
+    context_->CSSetShader(csHistoryShift_, nullptr, 0);
+    context_->CSSetShaderResources(0, 1, &depthPrevSrv_[prevIdx]);
+    context_->CSSetUnorderedAccessViews(0, 1, &depthPrevUav_[nextIdx], nullptr);
+    context_->CSSetConstantBuffers(0, 1, &historyShiftCb_);
+
+    for (const DXGI_OUTDUPL_MOVE_RECT& m : pendingMoves_) {
+        auto toY = [&](LONG sy) { return ((double)sy / srcH_ - cropOffset[1]) / cropScale[1] * computeH; };
+        const INT y0 = std::clamp((INT)std::ceil(toY(m.DestinationRect.top) - 0.5), 0, (INT)computeH);
+        const INT y1 = std::clamp((INT)std::ceil(toY(m.DestinationRect.bottom) - 0.5), 0, (INT)computeH);
+        const INT dy = (INT)std::lround(((double)m.DestinationRect.top - m.SourcePoint.y) * computeH / spanY);
+
+        for (int v = 0; v < 2; ++v) {
+            auto toX = [&](LONG sx) { return ((double)sx / srcW_ - cropOffset[0]) / cropScale[0] * viewW[v]; };
+            const INT x0 = std::clamp((INT)std::ceil(toX(m.DestinationRect.left) - 0.5), 0, (INT)viewW[v]);
+            const INT x1 = std::clamp((INT)std::ceil(toX(m.DestinationRect.right) - 0.5), 0, (INT)viewW[v]);
+            const INT dx = (INT)std::lround(((double)m.DestinationRect.left - m.SourcePoint.x) * viewW[v] / spanX);
+            if (x0 >= x1 || y0 >= y1 || (dx == 0 && dy == 0)) continue;
+
+            HistoryShiftParams hp{};
+            hp.rect[0] = (INT)viewX0[v] + x0;
+            hp.rect[1] = y0;
+            hp.rect[2] = (INT)viewX0[v] + x1;
+            hp.rect[3] = y1;
+            hp.view[0] = (INT)viewX0[v];
+            hp.view[1] = 0;
+            hp.view[2] = (INT)(viewX0[v] + viewW[v]);
+            hp.view[3] = (INT)computeH;
+            hp.offset[0] = dx;
+            hp.offset[1] = dy;
+
+            D3D11_MAPPED_SUBRESOURCE mapped{};
+            if (FAILED(context_->Map(historyShiftCb_, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)) || !mapped.pData) continue;
+            memcpy(mapped.pData, &hp, sizeof(hp));
+            context_->Unmap(historyShiftCb_, 0);
+            context_->Dispatch(DivRoundUp((UINT)(x1 - x0), 16), DivRoundUp((UINT)(y1 - y0), 16), 1);
+        }
+    }
+
+    UnbindCSUav(context_, 0);
+    UnbindCSResource(context_, 0);
+    depthPrevIndex_ = nextIdx;
+    ++historyShiftTotal_;
+    return true;
+}
+
+// The passes' ping-pong flips on the CPU whether or not the resolve gave them any groups; on a skipped
+// tick this copy makes the slot they would have written equal to the one they would have read.
+void Renderer::CarryDepthHistory(ID3D11ShaderResourceView* from, ID3D11UnorderedAccessView* to, UINT width, UINT height) {
+    HistoryShiftParams hp{};
+    hp.rect[2] = (INT)width;
+    hp.rect[3] = (INT)height;
+    hp.view[2] = (INT)width;
+    hp.view[3] = (INT)height;
+
+    D3D11_MAPPED_SUBRESOURCE mapped{};
+    if (FAILED(context_->Map(historyShiftCb_, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)) || !mapped.pData) return;
+    memcpy(mapped.pData, &hp, sizeof(hp));
+    context_->Unmap(historyShiftCb_, 0);
+
+    context_->CSSetShader(csHistoryShift_, nullptr, 0);
+    context_->CSSetConstantBuffers(0, 1, &historyShiftCb_);
+    context_->CSSetShaderResources(0, 1, &from);
+    context_->CSSetUnorderedAccessViews(0, 1, &to, nullptr);
+    // The carry grid covers the full-size plane; smaller planes drop the rest at the rect check.
+    context_->DispatchIndirect(fpArgsBuf_, kFingerprintGridCarry * 3 * sizeof(UINT));
+
+    UnbindCSUav(context_, 0);
+    UnbindCSResource(context_, 0);
+}
+
+bool Renderer::EnsureInterpolationResources(ID3D11Texture2D* input) {
+    if (!device_ || !input || !depthPrevTex_[0]) return false;
+
+    D3D11_TEXTURE2D_DESC inDesc{};
+    input->GetDesc(&inDesc);
+    D3D11_TEXTURE2D_DESC depthDesc{};
+    depthPrevTex_[0]->GetDesc(&depthDesc);
+
+    if (interpSrcTex_[0] && interpSrcTex_[1] && interpDepthTex_ && motionLumaUav_[0] && motionLumaUav_[1] &&
+        motionCoarseLumaUav_[0] && motionCoarseLumaUav_[1] && motionCoarseUav_ && motionFieldUav_) {
+        D3D11_TEXTURE2D_DESC a{};
+        D3D11_TEXTURE2D_DESC b{};
+        interpSrcTex_[0]->GetDesc(&a);
+        interpDepthTex_->GetDesc(&b);
+        if (a.Width == inDesc.Width && a.Height == inDesc.Height && a.Format == inDesc.Format && a.MipLevels == inDesc.MipLevels &&
+            b.Width == depthDesc.Width && b.Height == depthDesc.Height && b.Format == depthDesc.Format) {
+            return true;
+        }
+    }
+    ReleaseInterpolationResources();
+
+    auto createTex = [&](const char* name, const D3D11_TEXTURE2D_DESC& td, ID3D11Texture2D** outTex, ID3D11ShaderResourceView** outSrv,
+                         ID3D11UnorderedAccessView** outUav) -> bool {
+        HRESULT hr = device_->CreateTexture2D(&td, nullptr, outTex);
+        if (FAILED(hr) || !*outTex) {
+            Log::Error(std::string("EnsureInterpolationResources: CreateTexture2D(") + name + ") failed");
+            return false;
+        }
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC sd{};
+        sd.Format = td.Format;
+        sd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+        sd.Texture2D.MipLevels = 1;
+        hr = device_->CreateShaderResourceView(*outTex, &sd, outSrv);
+        if (FAILED(hr) || !*outSrv) {
+            Log::Error(std::string("EnsureInterpolationResources: CreateShaderResourceView(") + name + ") failed");
+            return false;
+        }
+        if (!outUav) return true;
+
+        D3D11_UNORDERED_ACCESS_VIEW_DESC ud{};
+        ud.Format = td.Format;
+        ud.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D;
+        ud.Texture2D.MipSlice = 0;
+        hr = device_->CreateUnorderedAccessView(*outTex, &ud, outUav);
+        if (FAILED(hr) || !*outUav) {
+            Log::Error(std::string("EnsureInterpolationResources: CreateUnorderedAccessView(") + name + ") failed");
+            return false;
+        }
+        return true;
+    };
+    auto planeDesc = [](UINT w, UINT h, DXGI_FORMAT fmt) {
+        D3D11_TEXTURE2D_DESC td{};
+        td.Width = w;
+        td.Height = h;
+        td.MipLevels = 1;
+        td.ArraySize = 1;
+        td.Format = fmt;
+        td.SampleDesc.Count = 1;
+        td.Usage = D3D11_USAGE_DEFAULT;
+        td.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+        return td;
+    };
+
+    // Copies of the compute input and of the history: same layout, read-only.
+    D3D11_TEXTURE2D_DESC srcDesc = inDesc;
+    srcDesc.Usage = D3D11_USAGE_DEFAULT;
+    srcDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    srcDesc.CPUAccessFlags = 0;
+    srcDesc.MiscFlags = 0;
+    D3D11_TEXTURE2D_DESC histDesc = depthDesc;
+    histDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+    const UINT fineW = DepthCpu::Kernels::MotionPlaneSize(inDesc.Width);
+    const UINT fineH = DepthCpu::Kernels::MotionPlaneSize(inDesc.Height);
+    const UINT coarseW = DepthCpu::Kernels::MotionPlaneSize(fineW);
+    const UINT coarseH = DepthCpu::Kernels::MotionPlaneSize(fineH);
+    const D3D11_TEXTURE2D_DESC fineDesc = planeDesc(fineW, fineH, DXGI_FORMAT_R32_FLOAT);
+    const D3D11_TEXTURE2D_DESC coarseDesc = planeDesc(coarseW, coarseH, DXGI_FORMAT_R32_FLOAT);
+    const D3D11_TEXTURE2D_DESC coarseFieldDesc = planeDesc(DepthCpu::Kernels::MotionCoarseBlocks(coarseW), DepthCpu::Kernels::MotionCoarseBlocks(coarseH),
+                                                           DXGI_FORMAT_R32G32_FLOAT);
+    const D3D11_TEXTURE2D_DESC fieldDesc = planeDesc(DepthCpu::Kernels::MotionBlocks(fineW), DepthCpu::Kernels::MotionBlocks(fineH),
+                                                     DXGI_FORMAT_R32G32B32A32_FLOAT);
+
+    if (!createTex("interpSrc0", srcDesc, &interpSrcTex_[0], &interpSrcSrv_[0], nullptr) ||
+        !createTex("interpSrc1", srcDesc, &interpSrcTex_[1], &interpSrcSrv_[1], nullptr) ||
+        !createTex("interpDepth", histDesc, &interpDepthTex_, &interpDepthSrv_, nullptr) ||
+        !createTex("motionLuma0", fineDesc, &motionLumaTex_[0], &motionLumaSrv_[0], &motionLumaUav_[0]) ||
+        !createTex("motionLuma1", fineDesc, &motionLumaTex_[1], &motionLumaSrv_[1], &motionLumaUav_[1]) ||
+        !createTex("motionCoarseLuma0", coarseDesc, &motionCoarseLumaTex_[0], &motionCoarseLumaSrv_[0], &motionCoarseLumaUav_[0]) ||
+        !createTex("motionCoarseLuma1", coarseDesc, &motionCoarseLumaTex_[1], &motionCoarseLumaSrv_[1], &motionCoarseLumaUav_[1]) ||
+        !createTex("motionCoarse", coarseFieldDesc, &motionCoarseTex_, &motionCoarseSrv_, &motionCoarseUav_) ||
+        !createTex("motionField", fieldDesc, &motionFieldTex_, &motionFieldSrv_, &motionFieldUav_)) {
+        ReleaseInterpolationResources();
+        return false;
+    }
+    return true;
+}
+
+void Renderer::ReleaseInterpolationResources() {
+    for (int i = 0; i < 2; ++i) {
+        if (interpSrcSrv_[i]) { interpSrcSrv_[i]->Release(); interpSrcSrv_[i] = nullptr; }
+        if (interpSrcTex_[i]) { interpSrcTex_[i]->Release(); interpSrcTex_[i] = nullptr; }
+        if (motionLumaSrv_[i]) { motionLumaSrv_[i]->Release(); motionLumaSrv_[i] = nullptr; }
+        if (motionLumaUav_[i]) { motionLumaUav_[i]->Release(); motionLumaUav_[i] = nullptr; }
+        if (motionLumaTex_[i]) { motionLumaTex_[i]->Release(); motionLumaTex_[i] = nullptr; }
+        if (motionCoarseLumaSrv_[i]) { motionCoarseLumaSrv_[i]->Release(); motionCoarseLumaSrv_[i] = nullptr; }
+        if (motionCoarseLumaUav_[i]) { motionCoarseLumaUav_[i]->Release(); motionCoarseLumaUav_[i] = nullptr; }
+        if (motionCoarseLumaTex_[i]) { motionCoarseLumaTex_[i]->Release(); motionCoarseLumaTex_[i] = nullptr; }
+    }
+    if (interpDepthSrv_) { interpDepthSrv_->Release(); interpDepthSrv_ = nullptr; }
+    if (interpDepthTex_) { interpDepthTex_->Release(); interpDepthTex_ = nullptr; }
+    if (motionCoarseSrv_) { motionCoarseSrv_->Release(); motionCoarseSrv_ = nullptr; }
+    if (motionCoarseUav_) { motionCoarseUav_->Release(); motionCoarseUav_ = nullptr; }
+    if (motionCoarseTex_) { motionCoarseTex_->Release(); motionCoarseTex_ = nullptr; }
+    if (motionFieldSrv_) { motionFieldSrv_->Release(); motionFieldSrv_ = nullptr; }
+    if (motionFieldUav_) { motionFieldUav_->Release(); motionFieldUav_ = nullptr; }
+    if (motionFieldTex_) { motionFieldTex_->Release(); motionFieldTex_ = nullptr; }
+    interpIndex_ = 0;
+    interpPictures_ = 0;
+    interpPending_ = false;
+}
+
+// Mirrors DepthCpu::Engine::EstimateMotionT; each picture's luma planes are kept for the next pair, so a
+// new frame only reduces its own.
+bool Renderer::EstimateMotion(UINT computeW, UINT computeH, const float crop[4], bool search) {
+    if (!motionCb_ || !csMotionLuma_ || !csMotionCoarseLuma_ || !csMotionCoarse_ || !csMotionFine_) return false;
+
+    struct MotionParams {
+        UINT srcSize[2];
+        UINT fineSize[2];
+        UINT coarseSize[2];
+        UINT blocks[2];
+        UINT coarseBlocks[2];
+        UINT depthSize[2];
+        float cropOffset[2];
+        float cropScale[2];
+    };
+    MotionParams mp{};
+    mp.srcSize[0] = computeW;
+    mp.srcSize[1] = computeH;
+    mp.fineSize[0] = DepthCpu::Kernels::MotionPlaneSize(computeW);
+    mp.fineSize[1] = DepthCpu::Kernels::MotionPlaneSize(computeH);
+    mp.coarseSize[0] = DepthCpu::Kernels::MotionPlaneSize(mp.fineSize[0]);
+    mp.coarseSize[1] = DepthCpu::Kernels::MotionPlaneSize(mp.fineSize[1]);
+    mp.blocks[0] = DepthCpu::Kernels::MotionBlocks(mp.fineSize[0]);
+    mp.blocks[1] = DepthCpu::Kernels::MotionBlocks(mp.fineSize[1]);
+    mp.coarseBlocks[0] = DepthCpu::Kernels::MotionCoarseBlocks(mp.coarseSize[0]);
+    mp.coarseBlocks[1] = DepthCpu::Kernels::MotionCoarseBlocks(mp.coarseSize[1]);
+    mp.depthSize[0] = computeW;
+    mp.depthSize[1] = computeH;
+    mp.cropOffset[0] = crop[0];
+    mp.cropOffset[1] = crop[1];
+    mp.cropScale[0] = crop[2];
+    mp.cropScale[1] = crop[3];
+
+    D3D11_MAPPED_SUBRESOURCE mapped{};
+    if (FAILED(context_->Map(motionCb_, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)) || !mapped.pData) return false;
+    memcpy(mapped.pData, &mp, sizeof(mp));
+    context_->Unmap(motionCb_, 0);
+    context_->CSSetConstantBuffers(0, 1, &motionCb_);
+
+    const int b = interpIndex_ & 1;
+    const int a = b ^ 1;
+
+    // Luma planes of B (reads t0=picture; writes u0), then the coarse plane (reads t1=fine; writes u0).
+    context_->CSSetShader(csMotionLuma_, nullptr, 0);
+    context_->CSSetShaderResources(0, 1, &interpSrcSrv_[b]);
+    context_->CSSetUnorderedAccessViews(0, 1, &motionLumaUav_[b], nullptr);
+    context_->Dispatch(DivRoundUp(mp.fineSize[0], 16), DivRoundUp(mp.fineSize[1], 16), 1);
+    UnbindCSUav(context_, 0);
+    UnbindCSResource(context_, 0);
+
+    context_->CSSetShader(csMotionCoarseLuma_, nullptr, 0);
+    context_->CSSetShaderResources(1, 1, &motionLumaSrv_[b]);
+    context_->CSSetUnorderedAccessViews(0, 1, &motionCoarseLumaUav_[b], nullptr);
+    context_->Dispatch(DivRoundUp(mp.coarseSize[0], 16), DivRoundUp(mp.coarseSize[1], 16), 1);
+    UnbindCSUav(context_, 0);
+    UnbindCSResource(context_, 1);
+
+    if (!search) return true;
+
+    // Coarse search (reads t1/t2=coarse luma of A/B; writes u1).
+    ID3D11ShaderResourceView* coarseSrvs[2] = { motionCoarseLumaSrv_[a], motionCoarseLumaSrv_[b] };
+    context_->CSSetShader(csMotionCoarse_, nullptr, 0);
+    context_->CSSetShaderResources(1, 2, coarseSrvs);
+    context_->CSSetUnorderedAccessViews(1, 1, &motionCoarseUav_, nullptr);
+    context_->Dispatch(DivRoundUp(mp.coarseBlocks[0], 8), DivRoundUp(mp.coarseBlocks[1], 8), 1);
+    UnbindCSUav(context_, 1);
+    UnbindCSResource(context_, 1);
+    UnbindCSResource(context_, 2);
+
+    // Fine search (reads t1/t2=fine luma of A/B, t3=coarse field, t4=B's depth; writes u2).
+    ID3D11ShaderResourceView* fineSrvs[4] = { motionLumaSrv_[a], motionLumaSrv_[b], motionCoarseSrv_, depthPrevSrv_[depthPrevIndex_ & 1] };
+    context_->CSSetShader(csMotionFine_, nullptr, 0);
+    context_->CSSetShaderResources(1, 4, fineSrvs);
+    context_->CSSetUnorderedAccessViews(2, 1, &motionFieldUav_, nullptr);
+    context_->Dispatch(DivRoundUp(mp.blocks[0], 8), DivRoundUp(mp.blocks[1], 8), 1);
+    UnbindCSUav(context_, 2);
+    for (UINT slot = 1; slot <= 4; ++slot) UnbindCSResource(context_, slot);
+    return true;
+}
+
 bool Renderer::Init(HWND hWnd, UINT width, UINT height, DXGI_FORMAT format, ID3D11Device* device, ID3D11DeviceContext* context) {
 
     Log::Info("Renderer::Init called");
@@ -1004,6 +1651,96 @@ bool Renderer::Init(HWND hWnd, UINT width, UINT height, DXGI_FORMAT format, ID3D
         if (!csDepthRaw_ || !csDepthSmooth_ || !csParallaxSbs_) {
             Log::Info("Renderer::Init: Depth stereo compute shaders not available.");
         }
+
+        csBlob = nullptr;
+        if (ThreePassShader::CompileDepthFusedCS(&csBlob) && csBlob) {
+            hr = device_->CreateComputeShader(csBlob->GetBufferPointer(), csBlob->GetBufferSize(), nullptr, &csDepthFused_);
+            csBlob->Release();
+        }
+        if (!csDepthFused_) {
+            Log::Info("Renderer::Init: Fused depth compute shader not available (falls back to 3-pass).");
+        }
+
+        csBlob = nullptr;
+        if (ThreePassShader::CompileParallaxFoveatedCS(&csBlob) && csBlob) {
+            hr = device_->CreateComputeShader(csBlob->GetBufferPointer(), csBlob->GetBufferSize(), nullptr, &csParallaxFoveated_);
+            csBlob->Release();
+        }
+        if (!csParallaxFoveated_) {
+            Log::Info("Renderer::Init: Foveated parallax shader not available (depth stays at full resolution).");
+        }
+
+        csBlob = nullptr;
+        if (ThreePassShader::CompileParallaxLayoutCS(&csBlob) && csBlob) {
+            hr = device_->CreateComputeShader(csBlob->GetBufferPointer(), csBlob->GetBufferSize(), nullptr, &csParallaxLayout_);
+            csBlob->Release();
+        }
+        if (!csParallaxLayout_) {
+            Log::Info("Renderer::Init: Layout parallax shader not available (output stays half SBS).");
+        }
+
+        csBlob = nullptr;
+        if (ThreePassShader::CompileContentLatticeCS(&csBlob) && csBlob) {
+            hr = device_->CreateComputeShader(csBlob->GetBufferPointer(), csBlob->GetBufferSize(), nullptr, &csContentLattice_);
+            csBlob->Release();
+        }
+
+        csBlob = nullptr;
+        if (ThreePassShader::CompileContentHashCS(&csBlob) && csBlob) {
+            hr = device_->CreateComputeShader(csBlob->GetBufferPointer(), csBlob->GetBufferSize(), nullptr, &csContentHash_);
+            csBlob->Release();
+        }
+
+        csBlob = nullptr;
+        if (ThreePassShader::CompileContentResolveCS(&csBlob) && csBlob) {
+            hr = device_->CreateComputeShader(csBlob->GetBufferPointer(), csBlob->GetBufferSize(), nullptr, &csContentResolve_);
+            csBlob->Release();
+        }
+        if (!csContentLattice_ || !csContentResolve_) {
+            Log::Info("Renderer::Init: Content fingerprint shaders not available (every new frame runs the depth passes).");
+        }
+
+        csBlob = nullptr;
+        if (ThreePassShader::CompileHistoryShiftCS(&csBlob) && csBlob) {
+            hr = device_->CreateComputeShader(csBlob->GetBufferPointer(), csBlob->GetBufferSize(), nullptr, &csHistoryShift_);
+            csBlob->Release();
+        }
+        if (!csHistoryShift_) {
+            Log::Info("Renderer::Init: History shift shader not available (scrolled content re-converges its depth).");
+        }
+
+        csBlob = nullptr;
+        if (ThreePassShader::CompileParallaxInterpCS(&csBlob) && csBlob) {
+            hr = device_->CreateComputeShader(csBlob->GetBufferPointer(), csBlob->GetBufferSize(), nullptr, &csParallaxInterp_);
+            csBlob->Release();
+        }
+
+        csBlob = nullptr;
+        if (ThreePassShader::CompileMotionLumaCS(&csBlob) && csBlob) {
+            hr = device_->CreateComputeShader(csBlob->GetBufferPointer(), csBlob->GetBufferSize(), nullptr, &csMotionLuma_);
+            csBlob->Release();
+        }
+
+        csBlob = nullptr;
+        if (ThreePassShader::CompileMotionCoarseLumaCS(&csBlob) && csBlob) {
+            hr = device_->CreateComputeShader(csBlob->GetBufferPointer(), csBlob->GetBufferSize(), nullptr, &csMotionCoarseLuma_);
+            csBlob->Release();
+        }
+
+        csBlob = nullptr;
+        if (ThreePassShader::CompileMotionCoarseCS(&csBlob) && csBlob) {
+            hr = device_->CreateComputeShader(csBlob->GetBufferPointer(), csBlob->GetBufferSize(), nullptr, &csMotionCoarse_);
+            csBlob->Release();
+        }
+
+        csBlob = nullptr;
+        if (ThreePassShader::CompileMotionFineCS(&csBlob) && csBlob) {
+            hr = device_->CreateComputeShader(csBlob->GetBufferPointer(), csBlob->GetBufferSize(), nullptr, &csMotionFine_);
+            csBlob->Release();
+        }
+        if (!csParallaxInterp_ || !csMotionLuma_ || !csMotionCoarseLuma_ || !csMotionCoarse_ || !csMotionFine_) {
+            Log::Info("Renderer::Init: Frame interpolation shaders not available (slow sources repeat frames).");
+        }
     }
 
     D3D11_INPUT_ELEMENT_DESC il[] = {
@@ -1070,6 +1807,118 @@ bool Renderer::Init(HWND hWnd, UINT width, UINT height, DXGI_FORMAT format, ID3D
         }
     }
 
+    // PASS 1 tone-curve table (t3), built by the CPU engine's generator so both paths share one curve.
+    {
+        static_assert(DepthCpu::Kernels::kToneCurveLutSize == 1024, "keep kToneLutSize in 3PassShader.cpp in sync");
+        std::vector<float> lut(DepthCpu::Kernels::kToneCurveLutSize * 2);
+        DepthCpu::Kernels::BuildToneCurveLut(lut.data());
+
+        D3D11_BUFFER_DESC bd{};
+        bd.ByteWidth = (UINT)(lut.size() * sizeof(float));
+        bd.Usage = D3D11_USAGE_IMMUTABLE;
+        bd.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        D3D11_SUBRESOURCE_DATA init{};
+        init.pSysMem = lut.data();
+        HRESULT lhr = device_->CreateBuffer(&bd, &init, &toneLutBuf_);
+        if (SUCCEEDED(lhr) && toneLutBuf_) {
+            D3D11_SHADER_RESOURCE_VIEW_DESC sd{};
+            sd.Format = DXGI_FORMAT_R32G32_FLOAT;
+            sd.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+            sd.Buffer.FirstElement = 0;
+            sd.Buffer.NumElements = DepthCpu::Kernels::kToneCurveLutSize;
+            lhr = device_->CreateShaderResourceView(toneLutBuf_, &sd, &toneLutSrv_);
+        }
+        if (FAILED(lhr) || !toneLutSrv_) {
+            Log::Error("Renderer::Init: tone-curve table creation failed; depth stereo disabled");
+        }
+    }
+
+    // Content fingerprint params (b0 of the fingerprint shaders), indirect args + counters, and their readback ring.
+    {
+        D3D11_BUFFER_DESC cbd{};
+        cbd.ByteWidth = 32 + kFingerprintGrids * 16; // must be multiple of 16
+        cbd.Usage = D3D11_USAGE_DYNAMIC;
+        cbd.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        cbd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        HRESULT fhr = device_->CreateBuffer(&cbd, nullptr, &fpParamsCb_);
+
+        UINT initArgs[kFingerprintArgCount] = {};
+        for (UINT i = 0; i < kFingerprintGrids; ++i) initArgs[i * 3 + 2] = 1;
+        D3D11_BUFFER_DESC ad{};
+        ad.ByteWidth = sizeof(initArgs);
+        ad.Usage = D3D11_USAGE_DEFAULT;
+        ad.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+        ad.MiscFlags = D3D11_RESOURCE_MISC_DRAWINDIRECT_ARGS;
+        D3D11_SUBRESOURCE_DATA init{};
+        init.pSysMem = initArgs;
+        if (SUCCEEDED(fhr)) fhr = device_->CreateBuffer(&ad, &init, &fpArgsBuf_);
+        if (SUCCEEDED(fhr)) {
+            D3D11_UNORDERED_ACCESS_VIEW_DESC ud{};
+            ud.Format = DXGI_FORMAT_R32_UINT;
+            ud.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+            ud.Buffer.FirstElement = 0;
+            ud.Buffer.NumElements = kFingerprintArgCount;
+            fhr = device_->CreateUnorderedAccessView(fpArgsBuf_, &ud, &fpArgsUav_);
+        }
+
+        D3D11_BUFFER_DESC rd{};
+        rd.ByteWidth = sizeof(initArgs);
+        rd.Usage = D3D11_USAGE_STAGING;
+        rd.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+        for (int i = 0; i < kFingerprintReadbackSlots && SUCCEEDED(fhr); ++i) {
+            fhr = device_->CreateBuffer(&rd, nullptr, &fpReadback_[i]);
+        }
+        if (FAILED(fhr)) {
+            Log::Error("Renderer::Init: content fingerprint buffers failed; duplicate-frame elimination disabled");
+            if (fpArgsUav_) { fpArgsUav_->Release(); fpArgsUav_ = nullptr; }
+        }
+    }
+
+    // Foveation params (b1 of CSParallaxFoveated).
+    {
+        D3D11_BUFFER_DESC cbd{};
+        cbd.ByteWidth = 32; // must be multiple of 16
+        cbd.Usage = D3D11_USAGE_DYNAMIC;
+        cbd.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        cbd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        if (FAILED(device_->CreateBuffer(&cbd, nullptr, &foveaCb_))) {
+            Log::Error("Renderer::Init: foveation params buffer failed; foveated depth disabled");
+            foveaCb_ = nullptr;
+        }
+    }
+
+    // History shift params (b0 of CSHistoryShift).
+    {
+        D3D11_BUFFER_DESC cbd{};
+        cbd.ByteWidth = 48; // must be multiple of 16
+        cbd.Usage = D3D11_USAGE_DYNAMIC;
+        cbd.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        cbd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        if (FAILED(device_->CreateBuffer(&cbd, nullptr, &historyShiftCb_))) {
+            Log::Error("Renderer::Init: history shift params buffer failed; scroll-aware history disabled");
+            historyShiftCb_ = nullptr;
+        }
+    }
+
+    // Frame interpolation params (b0 of the CSMotion* passes, b2 of CSParallaxInterp).
+    {
+        D3D11_BUFFER_DESC cbd{};
+        cbd.ByteWidth = 64; // must be multiple of 16
+        cbd.Usage = D3D11_USAGE_DYNAMIC;
+        cbd.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        cbd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        if (FAILED(device_->CreateBuffer(&cbd, nullptr, &motionCb_))) {
+            motionCb_ = nullptr;
+        }
+        cbd.ByteWidth = 32;
+        if (FAILED(device_->CreateBuffer(&cbd, nullptr, &interpCb_))) {
+            interpCb_ = nullptr;
+        }
+        if (!motionCb_ || !interpCb_) {
+            Log::Error("Renderer::Init: frame interpolation params buffers failed; frame interpolation disabled");
+        }
+    }
+
     srcW_ = srcH_ = 0;
     srcFmt_ = DXGI_FORMAT_UNKNOWN;
 
@@ -1197,6 +2046,12 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
 
     const float clearBlack[4] = {0.0f, 0.0f, 0.0f, 1.0f};
 
+    // GPU time of this frame's work (Auto render resolution, capture traces); earlier frames' results feed
+    // the governor before this frame picks its size.
+    CollectGpuTimers();
+    GpuTimerSlot* gpuTimer = BeginGpuTimer();
+    bool pipelineRan = false;
+
     // --- Repeat frame detection: use timestamp-based method ---
     // The caller should call UpdateRepeat(frameTimestamp) before Render.
     // Log backbuffer and srcTex size/format (throttled)
@@ -1241,6 +2096,7 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
     if (srcTex) {
         gotNewFrame = true;
         downDirty_ = true;
+        depthSettleTicks_ = 0;
 
         // Track the current source size/format even if we don't allocate srcCopy_.
         srcW_ = srcDesc.Width;
@@ -1290,6 +2146,7 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
     }
 
     // Update per-frame diagnostics rates once per presented frame.
+    CollectContentFingerprintStats();
     UpdateRateStats(gotNewFrame);
 
     auto updateStereoCb = [&](float uOffset, float eyeSign, float parallaxStrength) {
@@ -1346,7 +2203,8 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
         }
     };
 
-    auto updateCursorCb = [&](bool foldU) {
+    // fold: 0 = none, else the cursorFoldU / menuFoldU mode.
+    auto updateCursorCb = [&](int fold) {
         if (!cursorCb_) return;
         struct CursorCB {
             float x01;
@@ -1363,7 +2221,7 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
         cb.y01 = softwareCursorY01_;
         cb.sizePx = 24.0f;
         cb.enabled = softwareCursorEnabled_ ? 1.0f : 0.0f;
-        cb.foldU = foldU ? 1.0f : 0.0f;
+        cb.foldU = (float)fold;
 
         D3D11_MAPPED_SUBRESOURCE mapped{};
         if (SUCCEEDED(context_->Map(cursorCb_, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)) && mapped.pData) {
@@ -1372,7 +2230,7 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
         }
     };
 
-    auto updateMenuCb = [&](bool foldU) {
+    auto updateMenuCb = [&](int fold) {
         if (!menuCb_) return;
         struct MenuCB {
             float l;
@@ -1390,7 +2248,7 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
         cb.r = menuRight01_;
         cb.b = menuBottom01_;
         cb.enabled = (menuOverlayEnabled_ && menuSrv_) ? 1.0f : 0.0f;
-        cb.foldU = foldU ? 1.0f : 0.0f;
+        cb.foldU = (float)fold;
         D3D11_MAPPED_SUBRESOURCE mapped{};
         if (SUCCEEDED(context_->Map(menuCb_, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)) && mapped.pData) {
             memcpy(mapped.pData, &cb, sizeof(cb));
@@ -1433,11 +2291,15 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
             { 3840, 2160 },
         };
 
-        const int idx = (renderResIndex_ >= 0 && renderResIndex_ < (int)(sizeof(kPresets) / sizeof(kPresets[0]))) ? renderResIndex_ : 0;
-        const Preset p = kPresets[idx];
-
         UINT wantW = 0, wantH = 0;
-        computeDownscaleSize(srcW_, srcH_, p.w, p.h, &wantW, &wantH);
+        if (renderResIndex_ == kRenderResolutionAuto) {
+            const double s = resGovernor_.GetScale();
+            computeDownscaleSize(srcW_, srcH_, (UINT)std::lround(srcW_ * s), (UINT)std::lround(srcH_ * s), &wantW, &wantH);
+        } else {
+            const int idx = (renderResIndex_ >= 0 && renderResIndex_ < (int)(sizeof(kPresets) / sizeof(kPresets[0]))) ? renderResIndex_ : 0;
+            const Preset p = kPresets[idx];
+            computeDownscaleSize(srcW_, srcH_, p.w, p.h, &wantW, &wantH);
+        }
 
         if (wantW > 0 && wantH > 0) {
             const bool needCreate = (!downTex_ || !downRtv_ || !downSrv_ || downW_ != wantW || downH_ != wantH || downDirty_);
@@ -1526,7 +2388,7 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
                 }
                 updateCropCb(true);
                 updateStereoCb(0.0f, 0.0f, 0.0f);
-                updateCursorCb(false);
+                updateCursorCb(0);
 
                 context_->PSSetShaderResources(0, 1, &downSrcSrv);
                 context_->Draw(3, 0);
@@ -1539,6 +2401,7 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
                 context_->OMSetRenderTargets(0, nullptr, nullptr);
 
                 downDirty_ = false;
+                pipelineRan = true;
             }
 
             if (downSrv_) {
@@ -1553,13 +2416,17 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
     bool presentingDownscaled = (srvToPresent && downSrv_ && (srvToPresent == downSrv_));
 
     bool depthStereoPresented = false;
-    const bool wantDepthCompute = (stereoShaderMode_ == StereoShaderMode::Depth3Pass);
+    int presentFold = 1; // cursor / menu fold of the presented stereo texture (cursorFoldU)
+    bool fingerprinted = false;
+    bool historyUpdated = false;
+    const bool wantDepthCompute = (stereoShaderMode_ == StereoShaderMode::Depth3Pass || stereoShaderMode_ == StereoShaderMode::DepthFused);
+    const bool useFused = (stereoShaderMode_ == StereoShaderMode::DepthFused) && (csDepthFused_ != nullptr);
 
     ID3D11ComputeShader* csDepthRawActive = csDepthRaw_;
     ID3D11ComputeShader* csDepthSmoothActive = csDepthSmooth_;
     ID3D11ComputeShader* csParallaxActive = csParallaxSbs_;
 
-    if (stereoEnabled_ && wantDepthCompute && srvToPresent && csDepthRawActive && csDepthSmoothActive && csParallaxActive && csParamsCb_ && sampler_) {
+    if (stereoEnabled_ && wantDepthCompute && srvToPresent && csDepthRawActive && csDepthSmoothActive && csParallaxActive && csParamsCb_ && toneLutSrv_ && sampler_) {
         // IMPORTANT: The compute-based depth stereo pipeline should operate at the resolution of the
         // texture being processed (native capture or downscaled), not at the swapchain backbuffer size.
         // This avoids Debug/Release mismatches when the swapchain is sized to the window.
@@ -1577,9 +2444,20 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
             computeH = backDesc.Height;
         }
 
-        EnsureDepthStereoResources(computeW, computeH);
+        // Output layouts other than half SBS resample the depth of the three separate passes into
+        // layoutOut (pass 3 in the layout); foveation, the fused pass and interpolation stay half SBS.
+        const bool layoutPass = (stereoLayout_ != StereoLayout::HalfSbs) && csParallaxLayout_ && EnsureLayoutOutput(computeW, computeH);
+        // Foveation needs both eye views to span the same source columns (even widths); it always runs
+        // the three separate passes, on two plane sets.
+        const bool foveated = !layoutPass && (foveaScale_ != 0) && csParallaxFoveated_ && foveaCb_ && (computeW % 2) == 0;
+        const DepthCpu::Kernels::FoveaLayout fovea = DepthCpu::Kernels::MakeFoveaLayout(computeW / 2, computeH,
+            (float)foveaRadiusPercent_ / 100.0f, (float)foveaFalloffPercent_ / 100.0f, (uint32_t)(foveated ? foveaScale_ : 2));
+        const bool fused = useFused && !foveated && !layoutPass;
 
-        if (depthRawUav_ && depthRawSrv_ && depthSmoothUav_ && depthSmoothSrv_ && depthPrevSrv_[0] && depthPrevSrv_[1] && depthPrevUav_[0] && depthPrevUav_[1] && stereoOutUav_ && stereoOutSrv_) {
+        EnsureDepthStereoResources(computeW, computeH, foveated ? &fovea : nullptr);
+
+        if (depthRawUav_ && depthRawSrv_ && depthSmoothUav_ && depthSmoothSrv_ && depthPrevSrv_[0] && depthPrevSrv_[1] && depthPrevUav_[0] && depthPrevUav_[1] && stereoOutUav_ && stereoOutSrv_ &&
+            (!foveated || (foveaRawUav_ && foveaSmoothSrv_ && foveaPrevSrv_[0] && foveaPrevSrv_[1]))) {
             // Update CS parameters.
             struct CSParams {
                 UINT outWidth;
@@ -1598,7 +2476,7 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
             CSParams cb{};
             cb.outWidth = computeW;
             cb.outHeight = computeH;
-            cb.mode3d = 2; // SBS
+            cb.mode3d = layoutPass ? (UINT)stereoLayout_ : 2; // 2 = half SBS
             cb.zoomLevel = 0;
 
             const float t = (float)stereoDepthLevel_ / 20.0f;
@@ -1606,7 +2484,6 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
             const float parallaxStrength = (float)stereoParallaxStrengthPercent_ / 100.0f;
             cb.parallaxPx = t * maxShiftPx * parallaxStrength;
             cb.frame = depthFrame_;
-            depthFrame_ += 1.0f;
 
             // Crop mapping is applied inside the compute path when sampling the source.
             // If we're already using the downscaled RT as input, the crop has already been applied.
@@ -1623,8 +2500,94 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
                 cb.cropScale[1] = 1.0f;
             }
 
+            // Repeated frame with the same inputs: once history has converged every pass would rewrite
+            // stereoOut with the values it already holds, so keep presenting it and skip the dispatches.
+            DepthSettleKey key{};
+            key.width = computeW;
+            key.height = computeH;
+            key.parallaxPx = cb.parallaxPx;
+            key.crop[0] = cb.cropOffset[0];
+            key.crop[1] = cb.cropOffset[1];
+            key.crop[2] = cb.cropScale[0];
+            key.crop[3] = cb.cropScale[1];
+            key.fused = fused;
+            key.layout = cb.mode3d;
+            key.foveaScale = foveated ? foveaScale_ : 0;
+            key.foveaRadius = foveaRadiusPercent_;
+            key.foveaFalloff = foveaFalloffPercent_;
+            key.input = srvToPresent;
+            const DepthSettleKey& last = depthSettleKey_;
+            const bool sameKey = key.width == last.width && key.height == last.height &&
+                key.parallaxPx == last.parallaxPx && key.crop[0] == last.crop[0] && key.crop[1] == last.crop[1] &&
+                key.crop[2] == last.crop[2] && key.crop[3] == last.crop[3] && key.fused == last.fused &&
+                key.layout == last.layout && key.foveaScale == last.foveaScale && key.foveaRadius == last.foveaRadius && key.foveaFalloff == last.foveaFalloff &&
+                key.input == last.input;
+            if (!sameKey) {
+                depthSettleKey_ = key;
+                depthSettleTicks_ = 0;
+            }
+
+            const bool runPasses = (depthSettleTicks_ < kDepthSettleTicks);
+            if (runPasses) {
+                if (!gotNewFrame) {
+                    ++depthSettleTicks_;
+                }
+                depthFrame_ += 1.0f;
+                ++rateDepthRunCount_;
+                pipelineRan = true;
+            } else {
+                ++rateDepthSkipCount_;
+                ++depthSkippedTotal_;
+            }
+
+            // Frame interpolation: on a new frame A's depth is the history as the previous frame left it
+            // (before this frame's passes and any scroll shift); picture B and its motion follow the passes.
+            const bool interpolating = interpEnabled_ && !foveated && !layoutPass && csParallaxInterp_ && csMotionLuma_ && csMotionCoarseLuma_ &&
+                csMotionCoarse_ && csMotionFine_ && motionCb_ && interpCb_;
+            ID3D11Texture2D* interpInput = nullptr;
+            if (!interpolating || !sameKey) {
+                interpPictures_ = 0;
+            }
+            if (interpolating && gotNewFrame) {
+                LARGE_INTEGER nowQpc{};
+                QueryPerformanceCounter(&nowQpc);
+                const double dt = (interpArrivalQpc_.QuadPart != 0 && rateQpf_.QuadPart != 0)
+                    ? double(nowQpc.QuadPart - interpArrivalQpc_.QuadPart) / double(rateQpf_.QuadPart) : 0.0;
+                interpArrivalQpc_ = nowQpc;
+                if (dt <= 0.0 || dt > 1.0 / kInterpMinRate) {
+                    interpIntervalSec_ = 0.0;
+                    interpSteady_ = false;
+                } else {
+                    interpSteady_ = (interpIntervalSec_ > 0.0) && dt * 1.5 > interpIntervalSec_ && dt < interpIntervalSec_ * 1.5;
+                    interpIntervalSec_ = (interpIntervalSec_ > 0.0) ? interpIntervalSec_ + (dt - interpIntervalSec_) * 0.2 : dt;
+                }
+
+                ID3D11Resource* inputRes = nullptr;
+                srvToPresent->GetResource(&inputRes);
+                if (inputRes) {
+                    inputRes->QueryInterface(__uuidof(ID3D11Texture2D), (void**)&interpInput);
+                    inputRes->Release();
+                }
+                if (!interpInput || !EnsureInterpolationResources(interpInput)) {
+                    interpPictures_ = 0;
+                } else if (interpPictures_ > 0) {
+                    context_->CopyResource(interpDepthTex_, depthPrevTex_[depthPrevIndex_ & 1]);
+                }
+            }
+
+            // Scroll-aware history: content the capture reports as moved takes its converged depth along
+            // instead of blending against whatever was at its new position. Only when depthPrev belongs to
+            // the frame the moves are relative to and the mapping (key) didn't change. Not with foveation,
+            // whose history lives in the centre / periphery planes.
+            if (runPasses && gotNewFrame && sameKey && !foveated && depthHistoryLinked_ && pendingMovesKnown_ && ShiftDepthHistory(computeW, computeH)) {
+                fpStateValid_ = false; // the resolve must not skip the passes against the shifted history
+            }
+            if (runPasses && gotNewFrame) {
+                historyUpdated = true;
+            }
+
             D3D11_MAPPED_SUBRESOURCE mapped{};
-            if (SUCCEEDED(context_->Map(csParamsCb_, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)) && mapped.pData) {
+            if (runPasses && SUCCEEDED(context_->Map(csParamsCb_, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)) && mapped.pData) {
                 memcpy(mapped.pData, &cb, sizeof(cb));
                 context_->Unmap(csParamsCb_, 0);
             }
@@ -1632,47 +2595,258 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
             const UINT gx = DivRoundUp(computeW, 16);
             const UINT gy = DivRoundUp(computeH, 16);
 
-            // Pass 1: depth raw (writes u0).
-            {
+            // Output sinks resample at their own canvas (the compute size unless the sink sets one).
+            auto sinkCanvas = [&](const SinkSlot& slot, UINT& canvasW, UINT& canvasH) {
+                const OutputSink::Desc& desc = slot.sink->GetDesc();
+                canvasW = (desc.width && desc.height) ? desc.width : computeW;
+                canvasH = (desc.width && desc.height) ? desc.height : computeH;
+            };
+
+            // Content fingerprint: a new frame whose pixels match the one the passes last ran on is treated
+            // like a repeated tick. The GPU compares and writes the passes' DispatchIndirect args, so the
+            // CPU never waits on the result. The history ping-pong still flips below, so each pass pair
+            // carries its history across on the ticks the resolve skips (CarryDepthHistory).
+            bool useIndirect = false;
+            const bool fingerprint = contentFingerprint_ != ContentFingerprint::Off && csContentLattice_ && csContentResolve_ && fpParamsCb_ &&
+                fpArgsUav_ && csHistoryShift_ && historyShiftCb_;
+            if (runPasses && fingerprint) {
+                EnsureContentFingerprintResources(computeW, computeH);
+            }
+            if (runPasses && fingerprint && fpStateUav_) {
+                const bool hashMode = (contentFingerprint_ == ContentFingerprint::LatticeAndHash) && (csContentHash_ != nullptr);
+
+                struct FingerprintParams {
+                    UINT newFrame;
+                    UINT force;
+                    UINT settleTicks;
+                    UINT latticeN;
+
+                    UINT blocksX;
+                    UINT pad0[3];
+
+                    UINT grids[kFingerprintGrids][4];
+                };
+                FingerprintParams fp{};
+                fp.newFrame = gotNewFrame ? 1u : 0u;
+                fp.force = (!sameKey || !fpStateValid_ || hashMode != fpStateHashed_) ? 1u : 0u;
+                fp.settleTicks = (UINT)kDepthSettleTicks;
+                fp.latticeN = kFingerprintLattice;
+                fp.blocksX = DivRoundUp(computeW, 16);
+                fp.grids[kFingerprintGridPasses][0] = gx;
+                fp.grids[kFingerprintGridPasses][1] = gy;
+                if (foveated) {
+                    fp.grids[kFingerprintGridCentre][0] = DivRoundUp(2 * fovea.cw, 16);
+                    fp.grids[kFingerprintGridCentre][1] = DivRoundUp(fovea.ch, 16);
+                    fp.grids[kFingerprintGridPeriphery][0] = DivRoundUp(2 * fovea.pw, 16);
+                    fp.grids[kFingerprintGridPeriphery][1] = DivRoundUp(fovea.ph, 16);
+                }
+                fp.grids[kFingerprintGridCarry][0] = gx;
+                fp.grids[kFingerprintGridCarry][1] = gy;
+                fp.grids[kFingerprintGridCarry][2] = 1;
+                for (size_t i = 0; i < sinks_.size(); ++i) {
+                    UINT canvasW = 0;
+                    UINT canvasH = 0;
+                    sinkCanvas(sinks_[i], canvasW, canvasH);
+                    fp.grids[kFingerprintGridSinks + i][0] = DivRoundUp(canvasW, 16);
+                    fp.grids[kFingerprintGridSinks + i][1] = DivRoundUp(canvasH, 16);
+                }
+
+                D3D11_MAPPED_SUBRESOURCE fpMapped{};
+                if (SUCCEEDED(context_->Map(fpParamsCb_, 0, D3D11_MAP_WRITE_DISCARD, 0, &fpMapped)) && fpMapped.pData) {
+                    memcpy(fpMapped.pData, &fp, sizeof(fp));
+                    context_->Unmap(fpParamsCb_, 0);
+
+                    context_->CSSetConstantBuffers(0, 1, &fpParamsCb_);
+                    ID3D11UnorderedAccessView* fpUavs[2] = { fpStateUav_, fpArgsUav_ };
+                    context_->CSSetUnorderedAccessViews(0, 2, fpUavs, nullptr);
+
+                    if (gotNewFrame) {
+                        context_->CSSetShaderResources(0, 1, &srvToPresent);
+                        context_->CSSetShader(csContentLattice_, nullptr, 0);
+                        context_->Dispatch(DivRoundUp(kFingerprintLattice, 16), DivRoundUp(kFingerprintLattice, 16), 1);
+                        if (hashMode) {
+                            context_->CSSetShader(csContentHash_, nullptr, 0);
+                            context_->Dispatch(DivRoundUp(computeW, 16), DivRoundUp(computeH, 16), 1);
+                        }
+                        UnbindCSResource(context_, 0);
+
+                        fingerprinted = true;
+                        fpStateValid_ = true;
+                        fpStateHashed_ = hashMode;
+                    }
+
+                    context_->CSSetShader(csContentResolve_, nullptr, 0);
+                    context_->Dispatch(1, 1, 1);
+
+                    UnbindCSUav(context_, 0);
+                    UnbindCSUav(context_, 1);
+                    useIndirect = true;
+
+                    // HUD counters only; collected a frame or two later by CollectContentFingerprintStats.
+                    if (!fpReadbackPending_[fpReadbackNext_] && fpReadback_[fpReadbackNext_]) {
+                        context_->CopyResource(fpReadback_[fpReadbackNext_], fpArgsBuf_);
+                        fpReadbackPending_[fpReadbackNext_] = true;
+                        fpReadbackNext_ = (fpReadbackNext_ + 1) % kFingerprintReadbackSlots;
+                    }
+                }
+            }
+
+            // With the fingerprint the groups come from the resolve's args triple for the same grid.
+            auto dispatchPass = [&](UINT grid, UINT groupsX, UINT groupsY) {
+                if (useIndirect) {
+                    context_->DispatchIndirect(fpArgsBuf_, grid * 3 * sizeof(UINT));
+                } else {
+                    context_->Dispatch(groupsX, groupsY, 1);
+                }
+            };
+            auto uploadParams = [&](const CSParams& p) -> bool {
+                D3D11_MAPPED_SUBRESOURCE pm{};
+                if (FAILED(context_->Map(csParamsCb_, 0, D3D11_MAP_WRITE_DISCARD, 0, &pm)) || !pm.pData) return false;
+                memcpy(pm.pData, &p, sizeof(p));
+                context_->Unmap(csParamsCb_, 0);
+                return true;
+            };
+
+            if (runPasses && fused) {
+                // Fused: reads t0=src, t2=depthPrev, t3=toneLut; writes u1=depthPrevNext, u3=stereoOut.
+                const int prevIdx = depthPrevIndex_ & 1;
+                const int nextIdx = (depthPrevIndex_ ^ 1) & 1;
+
+                context_->CSSetShader(csDepthFused_, nullptr, 0);
+                context_->CSSetSamplers(0, 1, &sampler_);
+                context_->CSSetConstantBuffers(0, 1, &csParamsCb_);
+
+                ID3D11ShaderResourceView* srvs[4] = { srvToPresent, nullptr, depthPrevSrv_[prevIdx], toneLutSrv_ };
+                context_->CSSetShaderResources(0, 4, srvs);
+
+                ID3D11UnorderedAccessView* uavs[3] = { depthPrevUav_[nextIdx], nullptr, stereoOutUav_ };
+                context_->CSSetUnorderedAccessViews(1, 3, uavs, nullptr);
+
+                dispatchPass(kFingerprintGridPasses, gx, gy);
+
+                UnbindCSUav(context_, 1);
+                UnbindCSUav(context_, 3);
+                UnbindCSResource(context_, 0);
+                UnbindCSResource(context_, 2);
+                UnbindCSResource(context_, 3);
+
+                if (useIndirect) {
+                    CarryDepthHistory(depthPrevSrv_[prevIdx], depthPrevUav_[nextIdx], computeW, computeH);
+                }
+                depthPrevIndex_ = nextIdx;
+            }
+
+            // Passes 1 + 2 on one plane set (csParamsCb_ must hold its params; groups cover outWidth x outHeight
+            // and match the fingerprint grid `grid`; the history planes are planeW x planeH).
+            auto runDepthPasses = [&](UINT grid, UINT groupsX, UINT groupsY, ID3D11UnorderedAccessView* rawUav, ID3D11ShaderResourceView* rawSrv,
+                                      ID3D11ShaderResourceView* const* prevSrv, ID3D11UnorderedAccessView* const* prevUav, int& prevIndex,
+                                      ID3D11UnorderedAccessView* smoothUav, UINT planeW, UINT planeH) {
+                // Pass 1: depth raw (reads t0=src, t3=toneLut; writes u0).
                 context_->CSSetShader(csDepthRawActive, nullptr, 0);
                 context_->CSSetSamplers(0, 1, &sampler_);
                 context_->CSSetConstantBuffers(0, 1, &csParamsCb_);
 
                 context_->CSSetShaderResources(0, 1, &srvToPresent);
-                context_->CSSetUnorderedAccessViews(0, 1, &depthRawUav_, nullptr);
-                context_->Dispatch(gx, gy, 1);
+                context_->CSSetShaderResources(3, 1, &toneLutSrv_);
+                context_->CSSetUnorderedAccessViews(0, 1, &rawUav, nullptr);
+                dispatchPass(grid, groupsX, groupsY);
 
                 UnbindCSUav(context_, 0);
                 UnbindCSResource(context_, 0);
-            }
+                UnbindCSResource(context_, 3);
 
-            // Pass 2: depth smooth with history ping-pong (reads t1=depthRaw, t2=depthPrev; writes u1=depthPrevNext, u2=depthSmooth).
-            {
-                const int prevIdx = depthPrevIndex_ & 1;
-                const int nextIdx = (depthPrevIndex_ ^ 1) & 1;
+                // Pass 2: depth smooth with history ping-pong (reads t1=depthRaw, t2=depthPrev; writes u1=depthPrevNext, u2=depthSmooth).
+                const int prevIdx = prevIndex & 1;
+                const int nextIdx = (prevIndex ^ 1) & 1;
 
                 context_->CSSetShader(csDepthSmoothActive, nullptr, 0);
-                context_->CSSetSamplers(0, 1, &sampler_);
-                context_->CSSetConstantBuffers(0, 1, &csParamsCb_);
 
-                ID3D11ShaderResourceView* srvs[3] = { nullptr, depthRawSrv_, depthPrevSrv_[prevIdx] };
+                ID3D11ShaderResourceView* srvs[3] = { nullptr, rawSrv, prevSrv[prevIdx] };
                 context_->CSSetShaderResources(0, 3, srvs);
 
-                ID3D11UnorderedAccessView* uavs[2] = { depthPrevUav_[nextIdx], depthSmoothUav_ };
+                ID3D11UnorderedAccessView* uavs[2] = { prevUav[nextIdx], smoothUav };
                 context_->CSSetUnorderedAccessViews(1, 2, uavs, nullptr);
 
-                context_->Dispatch(gx, gy, 1);
+                dispatchPass(grid, groupsX, groupsY);
 
                 UnbindCSUav(context_, 1);
                 UnbindCSUav(context_, 2);
                 UnbindCSResource(context_, 1);
                 UnbindCSResource(context_, 2);
 
-                depthPrevIndex_ = nextIdx;
+                if (useIndirect) {
+                    CarryDepthHistory(prevSrv[prevIdx], prevUav[nextIdx], planeW, planeH);
+                }
+                prevIndex = nextIdx;
+            };
+
+            if (runPasses && !fused && !foveated) {
+                runDepthPasses(kFingerprintGridPasses, gx, gy, depthRawUav_, depthRawSrv_, depthPrevSrv_, depthPrevUav_, depthPrevIndex_, depthSmoothUav_, computeW, computeH);
+            }
+
+            // Foveated: the centre box at full resolution into the top-left of the depth textures, the whole
+            // view at reduced resolution into the fovea textures (CSParams narrowed like DepthCpu::Kernels::
+            // FoveaPlaneParams), then the full-frame params again for pass 3.
+            bool foveaReady = false;
+            if (runPasses && foveated) {
+                auto planeParams = [&](bool centre) {
+                    DepthCpu::Params p;
+                    p.outWidth = cb.outWidth;
+                    p.outHeight = cb.outHeight;
+                    p.zoomLevel = cb.zoomLevel;
+                    p.parallaxPx = cb.parallaxPx;
+                    p.cropOffset[0] = cb.cropOffset[0];
+                    p.cropOffset[1] = cb.cropOffset[1];
+                    p.cropScale[0] = cb.cropScale[0];
+                    p.cropScale[1] = cb.cropScale[1];
+                    const DepthCpu::Params sub = DepthCpu::Kernels::FoveaPlaneParams(p, fovea, centre);
+                    CSParams out = cb;
+                    out.outWidth = sub.outWidth;
+                    out.outHeight = sub.outHeight;
+                    out.cropOffset[0] = sub.cropOffset[0];
+                    out.cropOffset[1] = sub.cropOffset[1];
+                    out.cropScale[0] = sub.cropScale[0];
+                    out.cropScale[1] = sub.cropScale[1];
+                    return out;
+                };
+                const CSParams centreCb = planeParams(true);
+                const CSParams peripheryCb = planeParams(false);
+
+                struct FoveaParams {
+                    UINT centreOrigin[2];
+                    UINT centreSize[2];
+                    UINT peripherySize[2];
+                    float radius;
+                    float falloff;
+                };
+                FoveaParams fp{};
+                fp.centreOrigin[0] = fovea.cx0;
+                fp.centreOrigin[1] = fovea.cy0;
+                fp.centreSize[0] = fovea.cw;
+                fp.centreSize[1] = fovea.ch;
+                fp.peripherySize[0] = fovea.pw;
+                fp.peripherySize[1] = fovea.ph;
+                fp.radius = fovea.radius;
+                fp.falloff = fovea.falloff;
+
+                D3D11_MAPPED_SUBRESOURCE fm{};
+                if (uploadParams(centreCb)) {
+                    runDepthPasses(kFingerprintGridCentre, DivRoundUp(centreCb.outWidth, 16), DivRoundUp(centreCb.outHeight, 16),
+                        depthRawUav_, depthRawSrv_, depthPrevSrv_, depthPrevUav_, depthPrevIndex_, depthSmoothUav_, computeW, computeH);
+                    if (uploadParams(peripheryCb)) {
+                        runDepthPasses(kFingerprintGridPeriphery, DivRoundUp(peripheryCb.outWidth, 16), DivRoundUp(peripheryCb.outHeight, 16),
+                            foveaRawUav_, foveaRawSrv_, foveaPrevSrv_, foveaPrevUav_, foveaPrevIndex_, foveaSmoothUav_, 2 * fovea.pw, fovea.ph);
+                        if (uploadParams(cb) && SUCCEEDED(context_->Map(foveaCb_, 0, D3D11_MAP_WRITE_DISCARD, 0, &fm)) && fm.pData) {
+                            memcpy(fm.pData, &fp, sizeof(fp));
+                            context_->Unmap(foveaCb_, 0);
+                            foveaReady = true;
+                        }
+                    }
+                }
             }
 
             // Pass 3: parallax SBS (reads t0=src, t1=depthSmooth; writes u3=stereoOut).
-            {
+            if (runPasses && !fused && !foveated && !layoutPass) {
                 context_->CSSetShader(csParallaxActive, nullptr, 0);
                 context_->CSSetSamplers(0, 1, &sampler_);
                 context_->CSSetConstantBuffers(0, 1, &csParamsCb_);
@@ -1680,22 +2854,182 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
                 ID3D11ShaderResourceView* srvs[2] = { srvToPresent, depthSmoothSrv_ };
                 context_->CSSetShaderResources(0, 2, srvs);
                 context_->CSSetUnorderedAccessViews(3, 1, &stereoOutUav_, nullptr);
-                context_->Dispatch(gx, gy, 1);
+                dispatchPass(kFingerprintGridPasses, gx, gy);
+
+                UnbindCSUav(context_, 3);
+                UnbindCSResource(context_, 0);
+                UnbindCSResource(context_, 1);
+            }
+
+            // Pass 3 in the output layout (reads t0=src, t1=depthSmooth; writes u3=layoutOut). Runs over the
+            // canvas grid; the double-width layouts write both halves from each thread.
+            if (runPasses && layoutPass) {
+                context_->CSSetShader(csParallaxLayout_, nullptr, 0);
+                context_->CSSetSamplers(0, 1, &sampler_);
+                context_->CSSetConstantBuffers(0, 1, &csParamsCb_);
+
+                ID3D11ShaderResourceView* srvs[2] = { srvToPresent, depthSmoothSrv_ };
+                context_->CSSetShaderResources(0, 2, srvs);
+                context_->CSSetUnorderedAccessViews(3, 1, &layoutOutUav_, nullptr);
+                dispatchPass(kFingerprintGridPasses, gx, gy);
+
+                UnbindCSUav(context_, 3);
+                UnbindCSResource(context_, 0);
+                UnbindCSResource(context_, 1);
+            }
+
+            // Pass 3, foveated (reads t0=src, t1=centre depthSmooth, t4=periphery depthSmooth, b1=FoveaParams; writes u3=stereoOut).
+            if (foveaReady) {
+                context_->CSSetShader(csParallaxFoveated_, nullptr, 0);
+                context_->CSSetSamplers(0, 1, &sampler_);
+                ID3D11Buffer* cbs[2] = { csParamsCb_, foveaCb_ };
+                context_->CSSetConstantBuffers(0, 2, cbs);
+
+                ID3D11ShaderResourceView* srvs[5] = { srvToPresent, depthSmoothSrv_, nullptr, nullptr, foveaSmoothSrv_ };
+                context_->CSSetShaderResources(0, 5, srvs);
+                context_->CSSetUnorderedAccessViews(3, 1, &stereoOutUav_, nullptr);
+                dispatchPass(kFingerprintGridPasses, gx, gy);
 
                 UnbindCSUav(context_, 3);
                 UnbindCSResource(context_, 0);
                 UnbindCSResource(context_, 1);
+                UnbindCSResource(context_, 4);
+                ID3D11Buffer* nullCb = nullptr;
+                context_->CSSetConstantBuffers(1, 1, &nullCb);
+            }
+
+            // Pass 3 wrote picture B (unless the fingerprint's indirect args skipped it).
+            if (runPasses && !useIndirect) {
+                interpPending_ = false;
+            }
+
+            // Frame interpolation: store B, its luma planes and its motion against A, then present phase t
+            // of the pair: the time since B arrived over the source interval (one interval late), or B
+            // itself while the source is too fast or irregular.
+            if (interpInput && interpSrcTex_[0]) {
+                const int next = (interpIndex_ ^ 1) & 1;
+                context_->CopyResource(interpSrcTex_[next], interpInput);
+                interpIndex_ = next;
+                const bool search = (interpPictures_ > 0);
+                const float crop[4] = { cb.cropOffset[0], cb.cropOffset[1], cb.cropScale[0], cb.cropScale[1] };
+                interpPictures_ = EstimateMotion(computeW, computeH, crop, search) ? (search ? 2 : 1) : 0;
+            }
+            if (interpInput) {
+                interpInput->Release();
+                interpInput = nullptr;
+            }
+            if (interpolating && interpPictures_ == 2) {
+                double outInterval = GetFrameInterval();
+                if (outInterval <= 0.0 && presentFps_ > 0.0) outInterval = 1.0 / presentFps_;
+                float phase = 1.0f;
+                if (interpSteady_ && outInterval > 0.0 && interpIntervalSec_ > outInterval * kInterpMinRateRatio) {
+                    LARGE_INTEGER nowQpc{};
+                    QueryPerformanceCounter(&nowQpc);
+                    const double sinceArrival = double(nowQpc.QuadPart - interpArrivalQpc_.QuadPart) / double(rateQpf_.QuadPart);
+                    phase = (float)std::clamp(sinceArrival / interpIntervalSec_, 0.0, 1.0);
+                }
+
+                struct InterpParams {
+                    float t;
+                    float pad0[3];
+                    UINT motionBlocks[2];
+                    float motionBlockUV[2];
+                };
+                InterpParams ip{};
+                ip.t = phase;
+                ip.motionBlocks[0] = DepthCpu::Kernels::MotionBlocks(DepthCpu::Kernels::MotionPlaneSize(computeW));
+                ip.motionBlocks[1] = DepthCpu::Kernels::MotionBlocks(DepthCpu::Kernels::MotionPlaneSize(computeH));
+                const float blockPx = (float)(DepthCpu::Kernels::kMotionBlock * DepthCpu::Kernels::kMotionLumaScale);
+                ip.motionBlockUV[0] = blockPx / (float)computeW;
+                ip.motionBlockUV[1] = blockPx / (float)computeH;
+
+                D3D11_MAPPED_SUBRESOURCE im{};
+                if ((phase < 1.0f || interpPending_) && uploadParams(cb) &&
+                    SUCCEEDED(context_->Map(interpCb_, 0, D3D11_MAP_WRITE_DISCARD, 0, &im)) && im.pData) {
+                    memcpy(im.pData, &ip, sizeof(ip));
+                    context_->Unmap(interpCb_, 0);
+
+                    // Interpolated pass 3 (reads t0/t1=picture B and its depth, t5/t6=picture A and its depth,
+                    // t7=motion field, b2=InterpParams; writes u3=stereoOut).
+                    const int b = interpIndex_ & 1;
+                    context_->CSSetShader(csParallaxInterp_, nullptr, 0);
+                    context_->CSSetSamplers(0, 1, &sampler_);
+                    ID3D11Buffer* cbs[3] = { csParamsCb_, nullptr, interpCb_ };
+                    context_->CSSetConstantBuffers(0, 3, cbs);
+                    ID3D11ShaderResourceView* srvs[8] = { interpSrcSrv_[b], depthPrevSrv_[depthPrevIndex_ & 1], nullptr, nullptr, nullptr,
+                                                          interpSrcSrv_[b ^ 1], interpDepthSrv_, motionFieldSrv_ };
+                    context_->CSSetShaderResources(0, 8, srvs);
+                    context_->CSSetUnorderedAccessViews(3, 1, &stereoOutUav_, nullptr);
+                    context_->Dispatch(gx, gy, 1);
+
+                    UnbindCSUav(context_, 3);
+                    for (UINT slot = 0; slot < 8; ++slot) UnbindCSResource(context_, slot);
+                    ID3D11Buffer* nullCbs[2] = { nullptr, nullptr };
+                    context_->CSSetConstantBuffers(1, 2, nullCbs);
+
+                    interpPending_ = (phase < 1.0f);
+                    ++rateInterpCount_;
+                    pipelineRan = true;
+                }
+            }
+
+            // Output sinks: one more CSParallaxLayout resample per sink from the depth pass 3 read (the
+            // fused pass keeps it only in the history), at the sink's canvas, on the same skip decision.
+            if (runPasses && !foveated && csParallaxLayout_ && !sinks_.empty()) {
+                context_->CSSetShader(csParallaxLayout_, nullptr, 0);
+                context_->CSSetSamplers(0, 1, &sampler_);
+                context_->CSSetConstantBuffers(0, 1, &csParamsCb_);
+                ID3D11ShaderResourceView* srvs[2] = { srvToPresent, fused ? depthPrevSrv_[depthPrevIndex_ & 1] : depthSmoothSrv_ };
+                context_->CSSetShaderResources(0, 2, srvs);
+
+                for (size_t i = 0; i < sinks_.size(); ++i) {
+                    SinkSlot& slot = sinks_[i];
+                    UINT canvasW = 0;
+                    UINT canvasH = 0;
+                    sinkCanvas(slot, canvasW, canvasH);
+                    if (!EnsureSinkOutput(slot, canvasW, canvasH)) continue;
+
+                    CSParams sc = cb;
+                    sc.outWidth = canvasW;
+                    sc.outHeight = canvasH;
+                    sc.mode3d = (UINT)slot.sink->GetDesc().layout;
+                    if (!uploadParams(sc)) continue;
+
+                    context_->CSSetUnorderedAccessViews(3, 1, &slot.outUav, nullptr);
+                    dispatchPass(kFingerprintGridSinks + (UINT)i, DivRoundUp(canvasW, 16), DivRoundUp(canvasH, 16));
+                    UnbindCSUav(context_, 3);
+                    slot.fresh = true;
+                }
+
+                UnbindCSResource(context_, 0);
+                UnbindCSResource(context_, 1);
             }
 
             context_->CSSetShader(nullptr, nullptr, 0);
 
-            // Present the computed SBS image.
-            srvToPresent = stereoOutSrv_;
+            // Present the computed stereo image.
+            srvToPresent = layoutPass ? layoutOutSrv_ : stereoOutSrv_;
+            if (layoutPass && stereoLayout_ == StereoLayout::OverUnder) {
+                presentFold = 2;
+            } else if (layoutPass && stereoLayout_ == StereoLayout::ImageDepth) {
+                presentFold = 3;
+            }
             presentingDownscaled = true;
             depthStereoPresented = true;
         }
     }
 
+    // A new frame the passes never saw breaks the link between fpState and the depth history.
+    if (gotNewFrame && !fingerprinted) {
+        fpStateValid_ = false;
+    }
+    // Moves are relative to the previous new frame, so they only apply if the passes ran on that one.
+    if (gotNewFrame) {
+        depthHistoryLinked_ = historyUpdated;
+        pendingMoves_.clear();
+        pendingMovesKnown_ = false;
+    }
+
     // Final present pass: draw fullscreen triangle sampling srvToPresent into the backbuffer.
     // NOTE: The optional downscale pass binds a different RTV; always rebind the swapchain backbuffer RTV here.
     context_->OMSetRenderTargets(1, &rtv_, nullptr);
@@ -1779,8 +3113,8 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
                 updateCropCb(!presentingDownscaled);
                 // Per-eye disparity.
                 updateStereoCb(uOffset, -1.0f, parallaxStrength);
-                updateCursorCb(false);
-                updateMenuCb(false);
+                updateCursorCb(0);
+                updateMenuCb(0);
                 context_->Draw(3, 0);
             }
 
@@ -1796,8 +3130,8 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
                 context_->RSSetViewports(1, &vp);
                 updateCropCb(!presentingDownscaled);
                 updateStereoCb(uOffset, +1.0f, parallaxStrength);
-                updateCursorCb(false);
-                updateMenuCb(false);
+                updateCursorCb(0);
+                updateMenuCb(0);
                 context_->Draw(3, 0);
             }
         } else {
@@ -1811,9 +3145,10 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
             context_->RSSetViewports(1, &vp);
             updateCropCb(!presentingDownscaled);
             updateStereoCb(0.0f, 0.0f, 0.0f);
-            // When the presented texture already contains SBS (depth compute path), fold U so the cursor draws in both halves.
-            updateCursorCb(stereoEnabled_ && depthStereoPresented);
-            updateMenuCb(stereoEnabled_ && depthStereoPresented);
+            // When the presented texture already contains both views (depth compute path), fold it so the cursor draws in both.
+            const int fold = (stereoEnabled_ && depthStereoPresented) ? presentFold : 0;
+            updateCursorCb(fold);
+            updateMenuCb(fold);
             context_->Draw(3, 0);
         }
 
@@ -1821,6 +3156,45 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
         UnbindPSResource(context_, 1);
     }
 
+    // Output sinks: draw each freshly resampled image into its sink (scaled to a window's client area) with
+    // the same cursor / menu overlay, folded for the sink's layout. Readbacks are delivered as they finish.
+    if (!sinks_.empty()) {
+        for (SinkSlot& slot : sinks_) {
+            if (!slot.fresh) continue;
+            slot.fresh = false;
+
+            UINT targetW = 0, targetH = 0;
+            ID3D11RenderTargetView* sinkRtv = slot.sink->BeginFrame(slot.outW, slot.outH, &targetW, &targetH);
+            if (!sinkRtv) continue;
+            context_->OMSetRenderTargets(1, &sinkRtv, nullptr);
+
+            D3D11_VIEWPORT vp{};
+            vp.Width = (FLOAT)targetW;
+            vp.Height = (FLOAT)targetH;
+            vp.MinDepth = 0.0f;
+            vp.MaxDepth = 1.0f;
+            context_->RSSetViewports(1, &vp);
+
+            ID3D11ShaderResourceView* srvs[2] = { slot.outSrv, (menuOverlayEnabled_ && menuSrv_) ? menuSrv_ : nullptr };
+            context_->PSSetShaderResources(0, 2, srvs);
+            updateCropCb(false);
+            updateStereoCb(0.0f, 0.0f, 0.0f);
+            const int layout = slot.sink->GetDesc().layout;
+            const int fold = (layout == (int)StereoLayout::OverUnder) ? 2 : (layout == (int)StereoLayout::ImageDepth) ? 3 : 1;
+            updateCursorCb(fold);
+            updateMenuCb(fold);
+            context_->Draw(3, 0);
+
+            UnbindPSResource(context_, 0);
+            UnbindPSResource(context_, 1);
+            context_->OMSetRenderTargets(1, &rtv_, nullptr);
+            slot.sink->EndFrame(context_);
+        }
+        for (SinkSlot& slot : sinks_) {
+            slot.sink->Poll(context_);
+        }
+    }
+
     // Note: Diagnostics overlay is drawn as part of the presented frame when possible.
 
     auto buildOverlayText = [&](wchar_t* outBuf, size_t outCch, UINT dpi, bool /*gotNewFrameThisTick*/) {
@@ -1862,6 +3236,22 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
             else matchLabel = L"OK";
         }
 
+        const wchar_t* stereoLabel = L"Off";
+        if (stereoEnabled_) {
+            switch (stereoLayout_) {
+            case StereoLayout::OverUnder: stereoLabel = L"Over-Under"; break;
+            case StereoLayout::FullSbs: stereoLabel = L"Full-SBS"; break;
+            case StereoLayout::ImageDepth: stereoLabel = L"2D+Depth"; break;
+            default: stereoLabel = L"Half-SBS"; break;
+            }
+        }
+
+        // Auto render resolution: the governor's scale and the last measured GPU time per frame.
+        wchar_t rendAuto[48] = L"";
+        if (renderResIndex_ == kRenderResolutionAuto) {
+            swprintf(rendAuto, _countof(rendAuto), L" (auto %d%% %.1fms)", (int)(resGovernor_.GetScale() * 100.0 + 0.5), lastCostMs_);
+        }
+
         // Best-effort estimate of the source/game cadence.
         // - WGC: prefer produced frame rate (frames drained from the pool). FrameArrived callbacks can batch
         //        multiple frames and under-report cadence if you look at event frequency.
@@ -1915,35 +3305,42 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
 
             if (srcW_ > 0 && srcH_ > 0) {
                 swprintf(outBuf, outCch,
-                    L"Out: %.1f/%s %s (new %.1f)  Cap: %.1f %s %s\nSrc: %ux%u  Rend: %ux%u  Out: %ux%u\nStereo: %s (%d)  VSync: %s\n%s",
+                    L"Out: %.1f/%s %s (new %.1f content %.1f)  Cap: %.1f %s %s\nSrc: %ux%u  Rend: %ux%u%s  Out: %ux%u\nStereo: %s (%d)  VSync: %s  Depth: run %.1f skip %.1f\n%s",
                     presentFps,
                     targetBuf,
                     matchLabel,
                     newFrameFps,
+                    contentNewFps_,
                     capFps,
                     capLabel,
                     capExtra,
                     (unsigned)srcW_, (unsigned)srcH_,
                     (unsigned)rendW, (unsigned)rendH,
+                    rendAuto,
                     (unsigned)backDesc.Width, (unsigned)backDesc.Height,
-                    stereoEnabled_ ? L"Half-SBS" : L"Off",
+                    stereoLabel,
                     stereoDepthLevel_,
                     vsyncEnabled_ ? L"On" : L"Off",
+                    depthRunFps_,
+                    depthSkipFps_,
                     capLine);
             } else {
                 swprintf(outBuf, outCch,
-                    L"Out: %.1f/%s %s (new %.1f)  Cap: %.1f %s %s\nOut: %ux%u\nStereo: %s (%d)  VSync: %s\n%s",
+                    L"Out: %.1f/%s %s (new %.1f content %.1f)  Cap: %.1f %s %s\nOut: %ux%u\nStereo: %s (%d)  VSync: %s  Depth: run %.1f skip %.1f\n%s",
                     presentFps,
                     targetBuf,
                     matchLabel,
                     newFrameFps,
+                    contentNewFps_,
                     capFps,
                     capLabel,
                     capExtra,
                     (unsigned)backDesc.Width, (unsigned)backDesc.Height,
-                    stereoEnabled_ ? L"Half-SBS" : L"Off",
+                    stereoLabel,
                     stereoDepthLevel_,
                     vsyncEnabled_ ? L"On" : L"Off",
+                    depthRunFps_,
+                    depthSkipFps_,
                     capLine);
             }
             return;
@@ -1959,9 +3356,10 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
 
         if (srcW_ > 0 && srcH_ > 0) {
             swprintf(outBuf, outCch,
-            L"Output Present: %.1f fps\nOutput New: %.1f fps\nSource Cap: %.1f %s\nPer-eye: %.1f fps\nViews: %.1f /s\nNew Views: %.1f /s\nRepeat: %d\nDPI: %u\nVSync: %s\nCapture: %ux%u\nRender: %ux%u\nStereo: %s (Depth %d)\nOutput: %ux%u\nWindow: %dx%d\nCapStats: %s",
+            L"Output Present: %.1f fps\nOutput New: %.1f fps (content %.1f)\nSource Cap: %.1f %s\nPer-eye: %.1f fps\nViews: %.1f /s\nNew Views: %.1f /s\nRepeat: %d\nDPI: %u\nVSync: %s\nCapture: %ux%u\nRender: %ux%u%s\nStereo: %s (Depth %d)\nDepth Passes: run %.1f/s skip %.1f/s (%llu skipped, %llu shifted)\nInterpolated: %s %.1f/s\nOutput: %ux%u\nWindow: %dx%d\nCapStats: %s",
                 presentFps,
                 newFrameFps,
+                contentNewFps_,
                 capFps,
                 capLabel,
             perEyeFps,
@@ -1972,17 +3370,25 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
                 vsyncEnabled_ ? L"On" : L"Off",
                 (unsigned)srcW_, (unsigned)srcH_,
                 (unsigned)(downW_ ? downW_ : srcW_), (unsigned)(downH_ ? downH_ : srcH_),
-                stereoEnabled_ ? L"Half-SBS" : L"Off",
+                rendAuto,
+                stereoLabel,
                 stereoDepthLevel_,
+                depthRunFps_,
+                depthSkipFps_,
+                depthSkippedTotal_,
+                historyShiftTotal_,
+                interpEnabled_ ? L"On" : L"Off",
+                interpFps_,
                 (unsigned)backDesc.Width, (unsigned)backDesc.Height,
                 winW, winH,
                 capStatsBuf
             );
         } else {
             swprintf(outBuf, outCch,
-            L"Output Present: %.1f fps\nOutput New: %.1f fps\nSource Cap: %.1f %s\nPer-eye: %.1f fps\nViews: %.1f /s\nNew Views: %.1f /s\nRepeat: %d\nDPI: %u\nVSync: %s\nCapture: (none)\nRender: (n/a)\nStereo: %s (Depth %d)\nOutput: %ux%u\nWindow: %dx%d\nCapStats: %s",
+            L"Output Present: %.1f fps\nOutput New: %.1f fps (content %.1f)\nSource Cap: %.1f %s\nPer-eye: %.1f fps\nViews: %.1f /s\nNew Views: %.1f /s\nRepeat: %d\nDPI: %u\nVSync: %s\nCapture: (none)\nRender: (n/a)\nStereo: %s (Depth %d)\nDepth Passes: run %.1f/s skip %.1f/s (%llu skipped, %llu shifted)\nInterpolated: %s %.1f/s\nOutput: %ux%u\nWindow: %dx%d\nCapStats: %s",
                 presentFps,
                 newFrameFps,
+                contentNewFps_,
                 capFps,
                 capLabel,
             perEyeFps,
@@ -1991,8 +3397,14 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
                 repeatCount_,
                 dpi,
                 vsyncEnabled_ ? L"On" : L"Off",
-                stereoEnabled_ ? L"Half-SBS" : L"Off",
+                stereoLabel,
                 stereoDepthLevel_,
+                depthRunFps_,
+                depthSkipFps_,
+                depthSkippedTotal_,
+                historyShiftTotal_,
+                interpEnabled_ ? L"On" : L"Off",
+                interpFps_,
                 (unsigned)backDesc.Width, (unsigned)backDesc.Height,
                 winW, winH,
                 capStatsBuf
@@ -2154,6 +3566,16 @@ void Renderer::Render(ID3D11Texture2D* srcTex, float depth) {
         }
     }
 
+    {
+        double frameScale = 1.0;
+        if (renderResIndex_ == kRenderResolutionAuto) {
+            frameScale = resGovernor_.GetScale();
+        } else if (presentingDownscaled && srcW_ > 0) {
+            frameScale = (double)downW_ / (double)srcW_;
+        }
+        EndGpuTimer(gpuTimer, pipelineRan, frameScale);
+    }
+
     dstRes->Release();
     backBuffer->Release();
     const UINT syncInterval = vsyncEnabled_ ? 1u : 0u;
@@ -2198,7 +3620,43 @@ void Renderer::Cleanup() {
     if (csDepthRaw_) { csDepthRaw_->Release(); csDepthRaw_ = nullptr; }
     if (csDepthSmooth_) { csDepthSmooth_->Release(); csDepthSmooth_ = nullptr; }
     if (csParallaxSbs_) { csParallaxSbs_->Release(); csParallaxSbs_ = nullptr; }
+    if (csDepthFused_) { csDepthFused_->Release(); csDepthFused_ = nullptr; }
+    if (csParallaxFoveated_) { csParallaxFoveated_->Release(); csParallaxFoveated_ = nullptr; }
+    if (csParallaxLayout_) { csParallaxLayout_->Release(); csParallaxLayout_ = nullptr; }
+    if (foveaCb_) { foveaCb_->Release(); foveaCb_ = nullptr; }
     if (csParamsCb_) { csParamsCb_->Release(); csParamsCb_ = nullptr; }
+    if (toneLutSrv_) { toneLutSrv_->Release(); toneLutSrv_ = nullptr; }
+    if (toneLutBuf_) { toneLutBuf_->Release(); toneLutBuf_ = nullptr; }
+    if (csContentLattice_) { csContentLattice_->Release(); csContentLattice_ = nullptr; }
+    if (csContentHash_) { csContentHash_->Release(); csContentHash_ = nullptr; }
+    if (csContentResolve_) { csContentResolve_->Release(); csContentResolve_ = nullptr; }
+    if (fpParamsCb_) { fpParamsCb_->Release(); fpParamsCb_ = nullptr; }
+    if (fpArgsUav_) { fpArgsUav_->Release(); fpArgsUav_ = nullptr; }
+    if (fpArgsBuf_) { fpArgsBuf_->Release(); fpArgsBuf_ = nullptr; }
+    if (fpStateUav_) { fpStateUav_->Release(); fpStateUav_ = nullptr; }
+    if (fpStateBuf_) { fpStateBuf_->Release(); fpStateBuf_ = nullptr; }
+    for (int i = 0; i < kFingerprintReadbackSlots; ++i) {
+        if (fpReadback_[i]) { fpReadback_[i]->Release(); fpReadback_[i] = nullptr; }
+        fpReadbackPending_[i] = false;
+    }
+    fpInW_ = fpInH_ = 0;
+    fpStateValid_ = false;
+    if (csHistoryShift_) { csHistoryShift_->Release(); csHistoryShift_ = nullptr; }
+    if (historyShiftCb_) { historyShiftCb_->Release(); historyShiftCb_ = nullptr; }
+    pendingMoves_.clear();
+    pendingMovesKnown_ = false;
+    depthHistoryLinked_ = false;
+    if (csParallaxInterp_) { csParallaxInterp_->Release(); csParallaxInterp_ = nullptr; }
+    if (csMotionLuma_) { csMotionLuma_->Release(); csMotionLuma_ = nullptr; }
+    if (csMotionCoarseLuma_) { csMotionCoarseLuma_->Release(); csMotionCoarseLuma_ = nullptr; }
+    if (csMotionCoarse_) { csMotionCoarse_->Release(); csMotionCoarse_ = nullptr; }
+    if (csMotionFine_) { csMotionFine_->Release(); csMotionFine_ = nullptr; }
+    if (motionCb_) { motionCb_->Release(); motionCb_ = nullptr; }
+    if (interpCb_) { interpCb_->Release(); interpCb_ = nullptr; }
+    ReleaseInterpolationResources();
+    interpIntervalSec_ = 0.0;
+    interpSteady_ = false;
+    interpArrivalQpc_ = {};
 
     if (depthRawSrv_) { depthRawSrv_->Release(); depthRawSrv_ = nullptr; }
     if (depthRawUav_) { depthRawUav_->Release(); depthRawUav_ = nullptr; }
@@ -2215,11 +3673,18 @@ void Renderer::Cleanup() {
     }
     depthPrevIndex_ = 0;
     depthFrame_ = 0.0f;
+    ReleaseFoveaResources();
 
     if (stereoOutSrv_) { stereoOutSrv_->Release(); stereoOutSrv_ = nullptr; }
     if (stereoOutUav_) { stereoOutUav_->Release(); stereoOutUav_ = nullptr; }
     if (stereoOutTex_) { stereoOutTex_->Release(); stereoOutTex_ = nullptr; }
     depthOutW_ = depthOutH_ = 0;
+    memset(depthOutFovea_, 0, sizeof(depthOutFovea_));
+    if (layoutOutSrv_) { layoutOutSrv_->Release(); layoutOutSrv_ = nullptr; }
+    if (layoutOutUav_) { layoutOutUav_->Release(); layoutOutUav_ = nullptr; }
+    if (layoutOutTex_) { layoutOutTex_->Release(); layoutOutTex_ = nullptr; }
+    layoutOutW_ = layoutOutH_ = 0;
+    RemoveAllOutputSinks();
     if (vs_) { vs_->Release(); vs_ = nullptr; }
     if (stereoCb_) { stereoCb_->Release(); stereoCb_ = nullptr; }
     if (cropCb_) { cropCb_->Release(); cropCb_ = nullptr; }
@@ -2228,6 +3693,9 @@ void Renderer::Cleanup() {
     if (menuSrv_) { menuSrv_->Release(); menuSrv_ = nullptr; }
     if (menuTex_) { menuTex_->Release(); menuTex_ = nullptr; }
     menuW_ = menuH_ = 0;
+    ReleaseGpuTimers();
+    gpuTimersFailed_ = false;
+    costSampleNew_ = false;
     if (context_) { context_->Release(); context_ = nullptr; }
     if (device_) { device_->Release(); device_ = nullptr; }
     if (overlayFont_) { DeleteObject(overlayFont_); overlayFont_ = nullptr; }
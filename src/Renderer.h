@@ -1,13 +1,45 @@
 // Renderer.h
 #pragma once
 #include <d3d11.h>
+#include <dxgi1_2.h>
 #include <windows.h>
 #include <winrt/base.h>
 
+#include <memory>
+#include <vector>
+
+#include "OutputSink.h"
+#include "ResolutionGovernor.h"
+
+namespace DepthCpu { namespace Kernels { struct FoveaLayout; } }
+
 class Renderer {
 public:
     enum class StereoShaderMode {
         Depth3Pass = 0,
+        // Same math as Depth3Pass in a single dispatch; skips the depthRaw/depthSmooth round trips.
+        DepthFused = 1,
+    };
+    // Storage format of the depthRaw / depthSmooth / depthPrev textures (mirrors DepthCpu::DepthPrecision).
+    // Falls back to R32_FLOAT when the device can't store the narrower format from a compute shader.
+    enum class DepthPrecision {
+        Float32 = 0, // R32_FLOAT
+        Unorm16 = 1, // R16_UNORM
+        Unorm8 = 2,  // R8_UNORM
+    };
+    // Output layout of the depth compute path (CSParams.mode3d; mirrors DepthCpu::StereoLayout). The depth
+    // passes always run for the half-SBS canvas; only the final resample differs.
+    enum class StereoLayout {
+        OverUnder = 1,  // left eye on top, right eye below, canvas size
+        HalfSbs = 2,    // two half-width views, canvas size
+        FullSbs = 3,    // two full-width views, twice the canvas width
+        ImageDepth = 4, // 2D + depth: the unshifted picture and its depth as grey, twice the canvas width
+    };
+    // Duplicate-frame elimination for new capture frames whose pixels didn't change.
+    enum class ContentFingerprint {
+        Off = 0,
+        Lattice = 1,        // 64x64 sample lattice
+        LatticeAndHash = 2, // lattice + hash of every 16x16 block (catches changes between lattice points)
     };
     enum class OverlayPosition {
         TopLeft = 0,
@@ -74,10 +106,17 @@ public:
     void SetVSyncEnabled(bool enabled) { vsyncEnabled_ = enabled; }
     bool GetVSyncEnabled() const { return vsyncEnabled_; }
 
-    // Render resolution (output-side downscale). 0 = native (no downscale).
+    // Render resolution (output-side downscale). 0 = native (no downscale), 1..5 = fixed presets,
+    // kRenderResolutionAuto = any size up to the capture's own, steered by ResolutionGovernor from the GPU
+    // time of each frame so the selected frame rate holds (holds its size while the frame rate is Unlimited).
+    static constexpr int kRenderResolutionAuto = 6;
     void SetRenderResolutionIndex(int idx);
     int GetRenderResolutionIndex() const { return renderResIndex_; }
 
+    // GPU time of the most recently measured frame that ran the pipeline (downscale and/or depth passes)
+    // and the size it ran at relative to the source. True once per new measurement (capture traces).
+    bool TakePipelineCostSample(float* costMs, float* renderScale);
+
     // Stereoscopy (Half-SBS). When enabled, draws two views side-by-side.
     void SetStereoEnabled(bool enabled) { stereoEnabled_ = enabled; }
     bool GetStereoEnabled() const { return stereoEnabled_; }
@@ -92,6 +131,52 @@ public:
     void SetStereoShaderMode(StereoShaderMode mode) { stereoShaderMode_ = mode; }
     StereoShaderMode GetStereoShaderMode() const { return stereoShaderMode_; }
 
+    // Depth/history texture precision; takes effect on the next frame (history restarts).
+    void SetDepthPrecision(DepthPrecision precision) { depthPrecision_ = precision; }
+    DepthPrecision GetDepthPrecision() const { return depthPrecision_; }
+
+    // New frames with unchanged content (per the GPU fingerprint) don't restart the depth passes.
+    void SetContentFingerprint(ContentFingerprint mode) { contentFingerprint_ = mode; }
+    ContentFingerprint GetContentFingerprint() const { return contentFingerprint_; }
+
+    // Foveated depth for headset output (mirrors DepthCpu::Engine::SetFoveation): passes 1 and 2 run at
+    // full resolution only over the centre of each eye view and at 1/peripheryScale resolution over the
+    // whole view, and CSParallaxFoveated blends the two across the falloff. peripheryScale 0 = off, else
+    // 2 or 4; radius / falloff are percent of the view's half-size. Uses the 3-pass shaders even in
+    // DepthFused mode; odd compute widths fall back to full resolution. History restarts on change.
+    void SetFoveation(int peripheryScale, int radiusPercent, int falloffPercent);
+    int GetFoveationScale() const { return foveaScale_; }
+
+    // Layout of the presented depth stereo image. Other layouts than HalfSbs replace pass 3 with
+    // CSParallaxLayout on the same depth textures (3-pass, so not fused, foveated or interpolated).
+    void SetStereoLayout(StereoLayout layout) { stereoLayout_ = layout; }
+    StereoLayout GetStereoLayout() const { return stereoLayout_; }
+
+    // Extra outputs of the depth compute path (OutputSink): each new depth frame is resampled once more per
+    // sink into its layout and canvas from the same depth history (CSParallaxLayout), then presented to its
+    // window or read back for shared memory / a file. A sink keeps its last frame while the passes don't
+    // run (stereo off, settled repeats); not with foveation. Returns the sink id, or 0 if it can't open or
+    // kMaxOutputSinks are open already.
+    static constexpr size_t kMaxOutputSinks = 4;
+    int AddOutputSink(const OutputSink::Desc& desc);
+    void RemoveOutputSink(int id);
+    void RemoveAllOutputSinks();
+    size_t GetOutputSinkCount() const { return sinks_.size(); }
+
+    // Moved regions of the frame passed to the next Render() relative to the previous one (source
+    // pixels, as IDXGIOutputDuplication::GetFrameMoveRects reports them). The depth history is
+    // translated along with them so scrolled content keeps its converged depth. known=false (no
+    // information, e.g. frames were dropped in between) leaves the history as is.
+    void SetSourceMoveRects(const DXGI_OUTDUPL_MOVE_RECT* moves, UINT count, bool known);
+
+    // Frame interpolation for slow sources (mirrors DepthCpu::Engine::RenderInterpolated): while new frames
+    // arrive at a steady rate well below the output rate, every presented frame is synthesized between the
+    // two latest source frames along a block motion field and their depth (CSParallaxInterp) instead of
+    // repeating the newest one. Shows the source one new-frame interval late while active; not with
+    // foveation.
+    void SetFrameInterpolation(bool enabled);
+    bool GetFrameInterpolation() const { return interpEnabled_; }
+
     // Returns frame interval in seconds for current framerate
     double GetFrameInterval() const {
         static const double intervals[] = { 1.0/60.0, 1.0/72.0, 1.0/90.0, 1.0/120.0, 0.0 };
@@ -102,7 +187,47 @@ public:
 private:
     void UpdateRateStats(bool gotNewFrame);
     void EnsureOverlayFont(UINT dpi);
-    void EnsureDepthStereoResources(UINT outW, UINT outH);
+    // `fovea` (nullptr = off) also sizes the periphery planes; the centre plane lives in depthRaw/Smooth/Prev.
+    void EnsureDepthStereoResources(UINT outW, UINT outH, const DepthCpu::Kernels::FoveaLayout* fovea = nullptr);
+    void ReleaseFoveaResources();
+    // UAV + SRV texture for a compute pass's colour output (the first format the device can store to).
+    bool CreateComputeOutput(UINT width, UINT height, ID3D11Texture2D** outTex, ID3D11ShaderResourceView** outSrv, ID3D11UnorderedAccessView** outUav);
+    // layoutOut sized for the current layout (SetStereoLayout) over a computeW x computeH canvas.
+    bool EnsureLayoutOutput(UINT computeW, UINT computeH);
+    struct SinkSlot;
+    // The sink's CSParallaxLayout output for its layout over a canvasW x canvasH canvas.
+    bool EnsureSinkOutput(SinkSlot& slot, UINT canvasW, UINT canvasH);
+    static void ReleaseSinkOutput(SinkSlot& slot);
+    void EnsureContentFingerprintResources(UINT inW, UINT inH);
+    void CollectContentFingerprintStats();
+    // Copies depthPrev into the next ping-pong texture translated by pendingMoves_, then flips it.
+    bool ShiftDepthHistory(UINT computeW, UINT computeH);
+    // Copies one history plane into the other over the fingerprint's carry args (skipped ticks only).
+    void CarryDepthHistory(ID3D11ShaderResourceView* from, ID3D11UnorderedAccessView* to, UINT width, UINT height);
+    // Pictures, A's depth and motion planes for frame interpolation, sized for `input` (the compute input)
+    // and the current depth textures.
+    bool EnsureInterpolationResources(ID3D11Texture2D* input);
+    void ReleaseInterpolationResources();
+    // Luma planes of the picture just stored in interpSrcTex_[interpIndex_], then with `search` the coarse
+    // and fine block search against the previous one. `crop` = CSParams cropOffset, cropScale. Returns
+    // true when the motion field was written.
+    bool EstimateMotion(UINT computeW, UINT computeH, const float crop[4], bool search);
+
+    // Timestamp queries around each frame's work, read back (without stalling) a few frames later.
+    struct GpuTimerSlot {
+        ID3D11Query* disjoint = nullptr;
+        ID3D11Query* begin = nullptr;
+        ID3D11Query* end = nullptr;
+        bool pending = false;
+        bool sampled = false;  // the frame ran the pipeline (repeats that re-present cost nothing to scale)
+        bool autoRes = false;
+        double scale = 1.0;
+    };
+    static constexpr int kGpuTimerSlots = 4;
+    GpuTimerSlot* BeginGpuTimer();
+    void EndGpuTimer(GpuTimerSlot* slot, bool sampled, double scale);
+    void CollectGpuTimers();
+    void ReleaseGpuTimers();
 
     HWND hWnd_ = nullptr;
     ID3D11Device* device_ = nullptr;
@@ -123,8 +248,14 @@ private:
     ID3D11ComputeShader* csDepthRaw_ = nullptr;
     ID3D11ComputeShader* csDepthSmooth_ = nullptr;
     ID3D11ComputeShader* csParallaxSbs_ = nullptr;
+    ID3D11ComputeShader* csDepthFused_ = nullptr;
+    ID3D11ComputeShader* csParallaxFoveated_ = nullptr;
+    ID3D11ComputeShader* csParallaxLayout_ = nullptr;
 
     ID3D11Buffer* csParamsCb_ = nullptr;
+    // PASS 1 tone-curve table (Buffer<float2>, t3); see DepthCpu::Kernels::ToneCurveAt.
+    ID3D11Buffer* toneLutBuf_ = nullptr;
+    ID3D11ShaderResourceView* toneLutSrv_ = nullptr;
 
     ID3D11Texture2D* depthRawTex_ = nullptr;
     ID3D11ShaderResourceView* depthRawSrv_ = nullptr;
@@ -140,12 +271,162 @@ private:
     int depthPrevIndex_ = 0;
     float depthFrame_ = 0.0f;
 
+    // Foveation (SetFoveation): the centre plane uses the top-left 2 * cw x ch of the depth textures
+    // above; the periphery planes below are 2 * pw x ph with their own history ping-pong.
+    int foveaScale_ = 0;
+    int foveaRadiusPercent_ = 40;
+    int foveaFalloffPercent_ = 20;
+    ID3D11Buffer* foveaCb_ = nullptr;
+    ID3D11Texture2D* foveaRawTex_ = nullptr;
+    ID3D11ShaderResourceView* foveaRawSrv_ = nullptr;
+    ID3D11UnorderedAccessView* foveaRawUav_ = nullptr;
+    ID3D11Texture2D* foveaSmoothTex_ = nullptr;
+    ID3D11ShaderResourceView* foveaSmoothSrv_ = nullptr;
+    ID3D11UnorderedAccessView* foveaSmoothUav_ = nullptr;
+    ID3D11Texture2D* foveaPrevTex_[2] = { nullptr, nullptr };
+    ID3D11ShaderResourceView* foveaPrevSrv_[2] = { nullptr, nullptr };
+    ID3D11UnorderedAccessView* foveaPrevUav_[2] = { nullptr, nullptr };
+    int foveaPrevIndex_ = 0;
+
+    // Repeated-frame skip: with no new source frame and unchanged CSParams, the depth passes only
+    // advance the CSDepthSmooth EMA on the same depthRaw. After kDepthSettleTicks such ticks history has
+    // provably stopped moving, so stereoOut is re-presented without dispatching anything.
+    // Worst case from a distance of 1: the 0.05 clamp is active for at most 13 ticks (until the 0.14
+    // blend step drops below it), after which one tick is a max-norm contraction by
+    // (0.5 * 0.86 + 0.5) * 0.95 + 0.05 = 0.934; 0.357 * 0.934^115 < 1.5e-4, i.e. under 0.005 px of
+    // parallax at the 30 px maximum.
+    static constexpr int kDepthSettleTicks = 128;
+    struct DepthSettleKey {
+        UINT width = 0;
+        UINT height = 0;
+        float parallaxPx = 0.0f;
+        float crop[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        bool fused = false;
+        int foveaScale = 0;
+        int foveaRadius = 0;
+        int foveaFalloff = 0;
+        UINT layout = 0;
+        ID3D11ShaderResourceView* input = nullptr;
+    };
+    DepthSettleKey depthSettleKey_;
+    int depthSettleTicks_ = 0; // repeated ticks since the last new frame / parameter change
+
+    // Content fingerprint (CSContentLattice / CSContentHash / CSContentResolve). fpArgsBuf_ holds one
+    // DispatchIndirect args triple per grid plus the counters below; it is read back through a small
+    // staging ring without waiting (D3D11_MAP_FLAG_DO_NOT_WAIT), for the HUD only.
+    static constexpr UINT kFingerprintLattice = 64;
+    static constexpr UINT kFingerprintGridPasses = 0;    // full-frame depth passes and pass 3
+    static constexpr UINT kFingerprintGridCentre = 1;    // foveated passes 1 + 2, centre plane
+    static constexpr UINT kFingerprintGridPeriphery = 2; // ... periphery plane
+    static constexpr UINT kFingerprintGridCarry = 3;     // history carry, only on skipped ticks
+    static constexpr UINT kFingerprintGridSinks = 4;     // one per output sink (sinks_ order)
+    static constexpr UINT kFingerprintGrids = kFingerprintGridSinks + (UINT)kMaxOutputSinks; // kFingerprintGrids in kContentFingerprintHlsl
+    static constexpr UINT kFingerprintArgCount = kFingerprintGrids * 3 + 4;
+    static constexpr UINT kFingerprintArgContentNew = kFingerprintGrids * 3 + 2;
+    static constexpr UINT kFingerprintArgSkipped = kFingerprintGrids * 3 + 3;
+    static constexpr int kFingerprintReadbackSlots = 3;
+    ContentFingerprint contentFingerprint_ = ContentFingerprint::Lattice;
+    ID3D11ComputeShader* csContentLattice_ = nullptr;
+    ID3D11ComputeShader* csContentHash_ = nullptr;
+    ID3D11ComputeShader* csContentResolve_ = nullptr;
+    ID3D11Buffer* fpParamsCb_ = nullptr;
+    ID3D11Buffer* fpArgsBuf_ = nullptr;
+    ID3D11UnorderedAccessView* fpArgsUav_ = nullptr;
+    ID3D11Buffer* fpStateBuf_ = nullptr;
+    ID3D11UnorderedAccessView* fpStateUav_ = nullptr;
+    UINT fpInW_ = 0;
+    UINT fpInH_ = 0;
+    bool fpStateValid_ = false; // fpState holds the fingerprint of the frame the passes last ran on
+    bool fpStateHashed_ = false; // ... including the 16x16 block hashes
+    ID3D11Buffer* fpReadback_[kFingerprintReadbackSlots] = { nullptr, nullptr, nullptr };
+    bool fpReadbackPending_[kFingerprintReadbackSlots] = { false, false, false };
+    int fpReadbackNext_ = 0;
+    unsigned long long contentNewTotal_ = 0; // GPU counters as of the latest finished readback
+    unsigned long long fpSkippedTotal_ = 0;
+
+    // Scroll-aware history (CSHistoryShift): moves reported for the next new frame, applied to depthPrev
+    // when the history was last computed from the frame right before it.
+    static constexpr size_t kMaxHistoryMoves = 32;
+    ID3D11ComputeShader* csHistoryShift_ = nullptr;
+    ID3D11Buffer* historyShiftCb_ = nullptr;
+    std::vector<DXGI_OUTDUPL_MOVE_RECT> pendingMoves_;
+    bool pendingMovesKnown_ = false;
+    bool depthHistoryLinked_ = false; // depthPrev was last updated from the most recent new frame
+    unsigned long long historyShiftTotal_ = 0; // new frames whose history was translated
+
+    // Frame interpolation (SetFrameInterpolation). Only sources with a steady cadence (each interval within
+    // a factor of 1.5 of the average) of at least kInterpMinRate and at most 1/kInterpMinRateRatio of the
+    // output rate are interpolated; a pause in a desktop stream must not be replayed as a slow fade.
+    static constexpr double kInterpMinRate = 4.0;
+    static constexpr double kInterpMinRateRatio = 1.5;
+    // interpSrcTex_[interpIndex_] is picture B (the newest
+    // compute input), the other one picture A; interpDepthTex_ holds A's smoothed depth (B's is the live
+    // history). The luma planes follow interpIndex_; the motion field is (du, dv, cost, depth) per block.
+    bool interpEnabled_ = false;
+    ID3D11ComputeShader* csParallaxInterp_ = nullptr;
+    ID3D11ComputeShader* csMotionLuma_ = nullptr;
+    ID3D11ComputeShader* csMotionCoarseLuma_ = nullptr;
+    ID3D11ComputeShader* csMotionCoarse_ = nullptr;
+    ID3D11ComputeShader* csMotionFine_ = nullptr;
+    ID3D11Buffer* motionCb_ = nullptr;
+    ID3D11Buffer* interpCb_ = nullptr;
+    ID3D11Texture2D* interpSrcTex_[2] = { nullptr, nullptr };
+    ID3D11ShaderResourceView* interpSrcSrv_[2] = { nullptr, nullptr };
+    ID3D11Texture2D* interpDepthTex_ = nullptr;
+    ID3D11ShaderResourceView* interpDepthSrv_ = nullptr;
+    ID3D11Texture2D* motionLumaTex_[2] = { nullptr, nullptr };
+    ID3D11ShaderResourceView* motionLumaSrv_[2] = { nullptr, nullptr };
+    ID3D11UnorderedAccessView* motionLumaUav_[2] = { nullptr, nullptr };
+    ID3D11Texture2D* motionCoarseLumaTex_[2] = { nullptr, nullptr };
+    ID3D11ShaderResourceView* motionCoarseLumaSrv_[2] = { nullptr, nullptr };
+    ID3D11UnorderedAccessView* motionCoarseLumaUav_[2] = { nullptr, nullptr };
+    ID3D11Texture2D* motionCoarseTex_ = nullptr;
+    ID3D11ShaderResourceView* motionCoarseSrv_ = nullptr;
+    ID3D11UnorderedAccessView* motionCoarseUav_ = nullptr;
+    ID3D11Texture2D* motionFieldTex_ = nullptr;
+    ID3D11ShaderResourceView* motionFieldSrv_ = nullptr;
+    ID3D11UnorderedAccessView* motionFieldUav_ = nullptr;
+    int interpIndex_ = 0;
+    int interpPictures_ = 0;     // consecutive new frames stored under the same mapping (2 = pair ready)
+    bool interpPending_ = false; // stereoOut holds an interpolated frame short of picture B
+    LARGE_INTEGER interpArrivalQpc_ = {};
+    double interpIntervalSec_ = 0.0; // EMA of the new-frame interval (0 = restarting)
+    bool interpSteady_ = false;      // the last interval was close to the EMA
+    int rateInterpCount_ = 0;
+    double interpFps_ = 0.0;
+
     ID3D11Texture2D* stereoOutTex_ = nullptr;
     ID3D11ShaderResourceView* stereoOutSrv_ = nullptr;
     ID3D11UnorderedAccessView* stereoOutUav_ = nullptr;
 
+    // Output of CSParallaxLayout (SetStereoLayout), layoutOutW_ x layoutOutH_.
+    StereoLayout stereoLayout_ = StereoLayout::HalfSbs;
+    ID3D11Texture2D* layoutOutTex_ = nullptr;
+    ID3D11ShaderResourceView* layoutOutSrv_ = nullptr;
+    ID3D11UnorderedAccessView* layoutOutUav_ = nullptr;
+    UINT layoutOutW_ = 0;
+    UINT layoutOutH_ = 0;
+
+    // Output sinks (AddOutputSink) and their resampled images, outW x outH.
+    struct SinkSlot {
+        int id = 0;
+        std::unique_ptr<OutputSink> sink;
+        ID3D11Texture2D* outTex = nullptr;
+        ID3D11ShaderResourceView* outSrv = nullptr;
+        ID3D11UnorderedAccessView* outUav = nullptr;
+        UINT outW = 0;
+        UINT outH = 0;
+        bool fresh = false; // resampled this frame, not yet drawn into the sink
+    };
+    std::vector<SinkSlot> sinks_;
+    int nextSinkId_ = 1;
+
     UINT depthOutW_ = 0;
     UINT depthOutH_ = 0;
+    // Precision the depth textures were created for (their format may have fallen back to R32_FLOAT).
+    DepthPrecision depthOutPrecision_ = DepthPrecision::Float32;
+    // Foveation layout the depth textures were created for: cx0, cy0, cw, ch, pw, ph (all 0 = off).
+    UINT depthOutFovea_[6] = { 0, 0, 0, 0, 0, 0 };
     ID3D11InputLayout* inputLayout_ = nullptr;
     ID3D11Buffer* vertexBuffer_ = nullptr;
     ID3D11SamplerState* sampler_ = nullptr;
@@ -194,6 +475,15 @@ private:
     ID3D11RenderTargetView* downRtv_ = nullptr;
     ID3D11ShaderResourceView* downSrv_ = nullptr;
 
+    // Auto render resolution
+    ResolutionGovernor resGovernor_;
+    GpuTimerSlot gpuTimers_[kGpuTimerSlots];
+    int gpuTimerNext_ = 0;    // slot the next frame uses = oldest in flight
+    bool gpuTimersFailed_ = false;
+    double lastCostMs_ = 0.0;
+    double lastCostScale_ = 0.0;
+    bool costSampleNew_ = false;
+
 
     int framerateIndex_ = 0; // 0=60, 1=72, 2=90, 3=120, 4=Unlimited
 
@@ -204,6 +494,16 @@ private:
     int rateNewFrameCount_ = 0;
     double presentFps_ = 0.0;
     double newFrameFps_ = 0.0;
+    // Depth compute ticks that dispatched vs. re-presented a settled stereoOut (HUD "Depth:").
+    int rateDepthRunCount_ = 0;
+    int rateDepthSkipCount_ = 0;
+    double depthRunFps_ = 0.0;
+    double depthSkipFps_ = 0.0;
+    unsigned long long depthSkippedTotal_ = 0;
+    // New frames whose content changed (fingerprint), vs. newFrameFps_ which counts new timestamps.
+    double contentNewFps_ = 0.0;
+    unsigned long long rateLastContentNew_ = 0;
+    unsigned long long rateLastFpSkipped_ = 0;
 
     unsigned long long rateLastDxgiProduced_ = 0;
     unsigned long long rateLastWgcArrived_ = 0;
@@ -223,6 +523,7 @@ private:
     int stereoParallaxStrengthPercent_ = 20; // [0,50]
 
     StereoShaderMode stereoShaderMode_ = StereoShaderMode::Depth3Pass;
+    DepthPrecision depthPrecision_ = DepthPrecision::Float32;
 
     bool vsyncEnabled_ = true;
 
@@ -0,0 +1,84 @@
+#include "ResolutionGovernor.h"
+
+#include <algorithm>
+#include <cmath>
+
+void ResolutionGovernor::Reset(double scale) {
+    scale_ = Snap(scale);
+    load_ = 0.0;
+    over_ = 0;
+    under_ = 0;
+    overMinLoad_ = 0.0;
+    underMaxLoad_ = 0.0;
+    hold_ = 0;
+    upBackoff_ = 1;
+    samplesSinceChange_ = 0;
+    grewLast_ = false;
+}
+
+double ResolutionGovernor::Snap(double scale) const {
+    if (config_.quantum > 0.0) scale = std::floor(scale / config_.quantum + 1e-9) * config_.quantum;
+    return std::min(config_.maxScale, std::max(config_.minScale, scale));
+}
+
+bool ResolutionGovernor::Change(double scale) {
+    scale_ = scale;
+    hold_ = config_.holdFrames;
+    over_ = 0;
+    under_ = 0;
+    samplesSinceChange_ = 0;
+    ++changes_;
+    return true;
+}
+
+bool ResolutionGovernor::AddSample(double costMs, double renderedScale, double budgetMs) {
+    if (budgetMs <= 0.0 || costMs <= 0.0 || renderedScale <= 0.0) return false;
+    if (std::fabs(renderedScale - scale_) > 1e-6) return false;
+    if (hold_ > 0) {
+        --hold_;
+        return false;
+    }
+
+    load_ = costMs / budgetMs;
+    ++samplesSinceChange_;
+    // A long quiet stretch earns back the patience lost to oscillation.
+    const uint64_t relaxAfter = (uint64_t)std::max(1, config_.upFrames) * 8;
+    if (upBackoff_ > 1 && samplesSinceChange_ % relaxAfter == 0) upBackoff_ /= 2;
+
+    if (load_ > config_.downLoad) {
+        under_ = 0;
+        overMinLoad_ = over_ ? std::min(overMinLoad_, load_) : load_;
+        if (++over_ < config_.downFrames) return false;
+
+        // The run's smallest load, so a single outlier doesn't cut deeper than needed.
+        double s = Snap(scale_ * std::sqrt(config_.targetLoad / overMinLoad_));
+        if (s >= scale_) s = Snap(scale_ - config_.quantum);
+        if (s >= scale_) {
+            over_ = 0; // already at minScale
+            return false;
+        }
+        if (grewLast_ && samplesSinceChange_ < (uint64_t)config_.upFrames * 2 * upBackoff_) {
+            upBackoff_ = std::min(upBackoff_ * 2, 8);
+        }
+        grewLast_ = false;
+        return Change(s);
+    }
+
+    if (load_ < config_.upLoad) {
+        over_ = 0;
+        underMaxLoad_ = under_ ? std::max(underMaxLoad_, load_) : load_;
+        if (++under_ < config_.upFrames * upBackoff_) return false;
+
+        // The run's largest load, so the step up is sized for the run's worst frame.
+        double s = scale_ * std::sqrt(config_.targetLoad / std::max(underMaxLoad_, 1e-3));
+        s = Snap(std::min(s, scale_ + config_.maxUpStep));
+        under_ = 0;
+        if (s <= scale_) return false;
+        grewLast_ = true;
+        return Change(s);
+    }
+
+    over_ = 0;
+    under_ = 0;
+    return false;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+
+// Policy of the "Auto" render resolution: steers the downscale size from the measured cost of each
+// frame so the selected frame rate keeps holding. Kept free of D3D/Win32 calls so recorded cost traces
+// can be replayed offline (ArinPacingSim --governor).
+//
+// The size is a linear scale of the largest allowed size (1 = the capture's own size). Cost is modelled
+// as proportional to the pixel count: a frame that cost c at scale s predicts c * (s' / s)^2 at s'. That
+// overestimates growing (fixed costs don't grow), so steps up are cautious, and a step down that falls
+// short is followed by another one.
+//
+// Hysteresis: shrinking needs `downFrames` consecutive samples over `downLoad`, growing needs `upFrames`
+// consecutive samples under `upLoad`; loads in between reset both. Each change lands at `targetLoad`
+// (growing by at most `maxUpStep`), and a shrink soon after a grow doubles the wait before the next grow.
+class ResolutionGovernor {
+public:
+    struct Config {
+        double targetLoad = 0.75;  // cost / budget a change steers to
+        double downLoad = 0.90;
+        double upLoad = 0.60;
+        int downFrames = 3;
+        int upFrames = 90;
+        int holdFrames = 6;        // samples ignored after a change (queries in flight, new textures, history restart)
+        double maxUpStep = 0.08;
+        double minScale = 0.35;
+        double maxScale = 1.0;
+        double quantum = 1.0 / 64.0; // scales are multiples of this, so tiny corrections don't re-create textures
+    };
+
+    ResolutionGovernor() = default;
+    explicit ResolutionGovernor(const Config& config) : config_(config) {}
+
+    void SetConfig(const Config& config) { config_ = config; Reset(scale_); }
+    const Config& GetConfig() const { return config_; }
+
+    // Forgets the measurements (capture restarted, frame rate or source changed) and starts over at `scale`.
+    void Reset(double scale = 1.0);
+
+    // One sample per frame that ran the pipeline: `costMs` was measured for a frame rendered at
+    // `renderedScale` against a frame interval of `budgetMs` (<= 0 = unlimited: nothing to hold, the
+    // scale stays). Samples of a scale other than the current one (measurements arrive a few frames
+    // late) are ignored. Returns true when GetScale() changed.
+    bool AddSample(double costMs, double renderedScale, double budgetMs);
+
+    double GetScale() const { return scale_; }
+    double GetLoad() const { return load_; }  // last accepted cost / budget
+    uint64_t GetChangeCount() const { return changes_; }
+
+private:
+    double Snap(double scale) const;
+    bool Change(double scale);
+
+    Config config_;
+    double scale_ = 1.0;
+    double load_ = 0.0;
+    int over_ = 0;
+    int under_ = 0;
+    double overMinLoad_ = 0.0;   // smallest load of the current over-budget run
+    double underMaxLoad_ = 0.0;  // largest load of the current under-budget run
+    int hold_ = 0;
+    int upBackoff_ = 1;          // multiplies upFrames
+    uint64_t samplesSinceChange_ = 0;
+    bool grewLast_ = false;
+    uint64_t changes_ = 0;
+};
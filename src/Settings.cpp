@@ -77,6 +77,16 @@ static void WriteBool(const std::wstring& path, const wchar_t* section, const wc
     WritePrivateProfileStringW(section, key, v ? L"1" : L"0", path.c_str());
 }
 
+static void WriteString(const std::wstring& path, const wchar_t* section, const wchar_t* key, const std::wstring& v) {
+    WritePrivateProfileStringW(section, key, v.c_str(), path.c_str());
+}
+
+static std::wstring ReadString(const std::wstring& path, const wchar_t* section, const wchar_t* key) {
+    wchar_t buf[MAX_PATH] = {};
+    GetPrivateProfileStringW(section, key, L"", buf, (DWORD)(sizeof(buf) / sizeof(buf[0])), path.c_str());
+    return buf;
+}
+
 static bool TryReadInt(const std::wstring& path, const wchar_t* section, const wchar_t* key, int* outV) {
     if (!outV) return false;
     wchar_t buf[64] = {};
@@ -135,6 +145,28 @@ AppSettings AppSettings::Load() {
         }
         s.stereoParallaxStrengthPercent = ClampInt(v, 0, 50);
     }
+    s.stereoShaderMode = ClampInt((int)GetPrivateProfileIntW(L"Stereo", L"ShaderMode", s.stereoShaderMode, path.c_str()), 0, 1);
+    s.stereoDepthPrecision = ClampInt((int)GetPrivateProfileIntW(L"Stereo", L"DepthPrecision", s.stereoDepthPrecision, path.c_str()), 0, 2);
+    s.stereoContentFingerprint = ClampInt((int)GetPrivateProfileIntW(L"Stereo", L"ContentFingerprint", s.stereoContentFingerprint, path.c_str()), 0, 2);
+    {
+        const int v = (int)GetPrivateProfileIntW(L"Stereo", L"Foveation", s.stereoFoveation, path.c_str());
+        s.stereoFoveation = (v <= 0) ? 0 : (v >= 4 ? 4 : 2);
+    }
+    s.stereoFoveaRadiusPercent = ClampInt((int)GetPrivateProfileIntW(L"Stereo", L"FoveaRadiusPercent", s.stereoFoveaRadiusPercent, path.c_str()), 0, 150);
+    s.stereoFoveaFalloffPercent = ClampInt((int)GetPrivateProfileIntW(L"Stereo", L"FoveaFalloffPercent", s.stereoFoveaFalloffPercent, path.c_str()), 0, 150);
+    s.stereoFrameInterpolation = (GetPrivateProfileIntW(L"Stereo", L"FrameInterpolation", s.stereoFrameInterpolation ? 1 : 0, path.c_str()) != 0);
+    s.stereoLayout = ClampInt((int)GetPrivateProfileIntW(L"Stereo", L"Layout", s.stereoLayout, path.c_str()), 1, 4);
+
+    for (int i = 0; i < kMaxSinks; ++i) {
+        wchar_t section[16];
+        wsprintfW(section, L"Sink%d", i + 1);
+        SinkSettings& sink = s.sinks[i];
+        sink.kind = ClampInt((int)GetPrivateProfileIntW(section, L"Kind", sink.kind, path.c_str()), 0, 3);
+        sink.layout = ClampInt((int)GetPrivateProfileIntW(section, L"Layout", sink.layout, path.c_str()), 1, 4);
+        sink.width = ClampInt((int)GetPrivateProfileIntW(section, L"Width", sink.width, path.c_str()), 0, 16384);
+        sink.height = ClampInt((int)GetPrivateProfileIntW(section, L"Height", sink.height, path.c_str()), 0, 16384);
+        sink.name = ReadString(path, section, L"Name");
+    }
 
     s.vsyncEnabled = (GetPrivateProfileIntW(L"Output", L"VSyncEnabled", s.vsyncEnabled ? 1 : 0, path.c_str()) != 0);
     s.clickThrough = (GetPrivateProfileIntW(L"Output", L"ClickThrough", s.clickThrough ? 1 : 0, path.c_str()) != 0);
@@ -145,9 +177,12 @@ AppSettings AppSettings::Load() {
     s.diagnosticsOverlay = (GetPrivateProfileIntW(L"Diagnostics", L"OverlayEnabled", s.diagnosticsOverlay ? 1 : 0, path.c_str()) != 0);
     s.diagnosticsOverlaySizeIndex = ClampInt((int)GetPrivateProfileIntW(L"Diagnostics", L"OverlaySizeIndex", s.diagnosticsOverlaySizeIndex, path.c_str()), 0, 2);
     s.diagnosticsOverlayCompact = (GetPrivateProfileIntW(L"Diagnostics", L"OverlayCompact", s.diagnosticsOverlayCompact ? 1 : 0, path.c_str()) != 0);
+    s.captureTrace = (GetPrivateProfileIntW(L"Diagnostics", L"CaptureTrace", s.captureTrace ? 1 : 0, path.c_str()) != 0);
+    s.captureTraceThumbnails = (GetPrivateProfileIntW(L"Diagnostics", L"CaptureTraceThumbnails", s.captureTraceThumbnails ? 1 : 0, path.c_str()) != 0);
 
     s.framerateIndex = ClampInt((int)GetPrivateProfileIntW(L"Performance", L"FramerateIndex", s.framerateIndex, path.c_str()), 0, 4);
     s.renderResPresetIndex = ClampInt((int)GetPrivateProfileIntW(L"Performance", L"RenderResPresetIndex", s.renderResPresetIndex, path.c_str()), 0, 10);
+    s.captureThread = (GetPrivateProfileIntW(L"Performance", L"CaptureThread", s.captureThread ? 1 : 0, path.c_str()) != 0);
 
     Log::Info("Settings loaded from: " + WideToUtf8Local(path));
     return s;
@@ -159,6 +194,25 @@ void AppSettings::Save() const {
     WriteBool(path, L"Stereo", L"Enabled", stereoEnabled);
     WriteInt(path, L"Stereo", L"DepthLevel", ClampInt(stereoDepthLevel, 1, 20));
     WriteInt(path, L"Stereo", L"ParallaxStrengthPercent", ClampInt(stereoParallaxStrengthPercent, 0, 50));
+    WriteInt(path, L"Stereo", L"ShaderMode", ClampInt(stereoShaderMode, 0, 1));
+    WriteInt(path, L"Stereo", L"DepthPrecision", ClampInt(stereoDepthPrecision, 0, 2));
+    WriteInt(path, L"Stereo", L"ContentFingerprint", ClampInt(stereoContentFingerprint, 0, 2));
+    WriteInt(path, L"Stereo", L"Foveation", stereoFoveation <= 0 ? 0 : (stereoFoveation >= 4 ? 4 : 2));
+    WriteInt(path, L"Stereo", L"FoveaRadiusPercent", ClampInt(stereoFoveaRadiusPercent, 0, 150));
+    WriteInt(path, L"Stereo", L"FoveaFalloffPercent", ClampInt(stereoFoveaFalloffPercent, 0, 150));
+    WriteBool(path, L"Stereo", L"FrameInterpolation", stereoFrameInterpolation);
+    WriteInt(path, L"Stereo", L"Layout", ClampInt(stereoLayout, 1, 4));
+
+    for (int i = 0; i < kMaxSinks; ++i) {
+        wchar_t section[16];
+        wsprintfW(section, L"Sink%d", i + 1);
+        const SinkSettings& sink = sinks[i];
+        WriteInt(path, section, L"Kind", ClampInt(sink.kind, 0, 3));
+        WriteInt(path, section, L"Layout", ClampInt(sink.layout, 1, 4));
+        WriteInt(path, section, L"Width", ClampInt(sink.width, 0, 16384));
+        WriteInt(path, section, L"Height", ClampInt(sink.height, 0, 16384));
+        WriteString(path, section, L"Name", sink.name);
+    }
 
     WriteBool(path, L"Output", L"VSyncEnabled", vsyncEnabled);
     WriteBool(path, L"Output", L"ClickThrough", clickThrough);
@@ -169,7 +223,10 @@ void AppSettings::Save() const {
     WriteBool(path, L"Diagnostics", L"OverlayEnabled", diagnosticsOverlay);
     WriteInt(path, L"Diagnostics", L"OverlaySizeIndex", ClampInt(diagnosticsOverlaySizeIndex, 0, 2));
     WriteBool(path, L"Diagnostics", L"OverlayCompact", diagnosticsOverlayCompact);
+    WriteBool(path, L"Diagnostics", L"CaptureTrace", captureTrace);
+    WriteBool(path, L"Diagnostics", L"CaptureTraceThumbnails", captureTraceThumbnails);
 
     WriteInt(path, L"Performance", L"FramerateIndex", ClampInt(framerateIndex, 0, 4));
     WriteInt(path, L"Performance", L"RenderResPresetIndex", ClampInt(renderResPresetIndex, 0, 10));
+    WriteBool(path, L"Performance", L"CaptureThread", captureThread);
 }
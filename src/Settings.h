@@ -2,11 +2,32 @@
 
 #include <string>
 
+// One extra output of the depth path (Renderer::AddOutputSink), stored as [Sink1]..[Sink4].
+struct SinkSettings {
+    int kind = 0;        // 0=off, 1=window, 2=shared memory, 3=file
+    int layout = 2;      // 1=over-under, 2=half SBS, 3=full SBS, 4=2D + depth
+    int width = 0;       // half-SBS canvas; 0 = the render resolution
+    int height = 0;
+    std::wstring name;   // shared memory: mapping name; file: output path
+};
+
 struct AppSettings {
     // Stereo
     bool stereoEnabled = false;
     int stereoDepthLevel = 10;              // [1,20]
     int stereoParallaxStrengthPercent = 20; // [0,50]
+    int stereoShaderMode = 0;               // 0=Depth3Pass, 1=DepthFused
+    int stereoDepthPrecision = 0;           // 0=float32, 1=unorm16, 2=unorm8 (depth/history textures)
+    int stereoContentFingerprint = 1;       // 0=off, 1=sample lattice, 2=lattice + full block hash
+    int stereoFoveation = 0;                // 0=off, 2/4 = periphery depth at 1/2 or 1/4 resolution
+    int stereoFoveaRadiusPercent = 40;      // [0,150] of the eye view's half-size
+    int stereoFoveaFalloffPercent = 20;     // [0,150]
+    bool stereoFrameInterpolation = false;  // synthesize frames between slow source frames (one frame later)
+    int stereoLayout = 2;                   // 1=over-under, 2=half SBS, 3=full SBS, 4=2D + depth
+
+    // Output sinks
+    static constexpr int kMaxSinks = 4;
+    SinkSettings sinks[kMaxSinks];
 
     // Output / presentation
     bool vsyncEnabled = true;
@@ -23,9 +44,15 @@ struct AppSettings {
     int diagnosticsOverlaySizeIndex = 0;  // 0..2
     bool diagnosticsOverlayCompact = true;
 
+    // Capture trace (per-frame timing ring, saved next to the exe as *.actrace when capture stops).
+    bool captureTrace = false;
+    bool captureTraceThumbnails = false;
+
     // Performance
     int framerateIndex = 0;               // 0..4
-    int renderResPresetIndex = 0;         // 0..N
+    int renderResPresetIndex = 0;         // 0 = native, 1..5 presets, 6 = auto
+    // Acquire frames on a dedicated thread instead of the UI/render tick.
+    bool captureThread = true;
 
     static std::wstring GetSettingsPath();
     static AppSettings Load();
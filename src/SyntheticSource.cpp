@@ -0,0 +1,417 @@
+#include "SyntheticSource.h"
+
+#include "FrameIO.h"
+#include "Log.h"
+#include "Renderer.h"
+
+#include <cmath>
+#include <cwchar>
+#include <memory>
+
+namespace {
+
+// Replay clips are preloaded so disk I/O never shows up in the pacing numbers.
+constexpr size_t kMaxReplayFrames = 3600;
+
+static uint32_t Hash32(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return (uint32_t)x;
+}
+
+static std::string NarrowPath(const std::wstring& w) {
+    if (w.empty()) return std::string();
+    const int n = WideCharToMultiByte(CP_ACP, 0, w.c_str(), (int)w.size(), nullptr, 0, nullptr, nullptr);
+    std::string s((size_t)(n > 0 ? n : 0), '\0');
+    if (n > 0) WideCharToMultiByte(CP_ACP, 0, w.c_str(), (int)w.size(), &s[0], n, nullptr, nullptr);
+    return s;
+}
+
+} // namespace
+
+bool SyntheticSource::ParseSpec(const std::wstring& spec, Config* out) {
+    if (!out) return false;
+    Config c = *out;
+
+    size_t pos = 0;
+    while (pos <= spec.size()) {
+        size_t comma = spec.find(L',', pos);
+        if (comma == std::wstring::npos) comma = spec.size();
+        const std::wstring tok = spec.substr(pos, comma - pos);
+        pos = comma + 1;
+        if (tok.empty()) continue;
+
+        unsigned w = 0, h = 0;
+        double fps = 0.0;
+        int n = 0;
+        if (tok == L"checker") {
+            c.pattern = Pattern::Checker;
+        } else if (tok == L"bars") {
+            c.pattern = Pattern::Bars;
+        } else if (swscanf_s(tok.c_str(), L"repeat=%d", &n) == 1) {
+            c.repeatPercent = (n < 0) ? 0 : (n > 100 ? 100 : n);
+        } else if (swscanf_s(tok.c_str(), L"jitter=%lf", &fps) == 1) {
+            c.jitterMs = (fps < 0.0) ? 0.0 : fps;
+        } else if (tok[0] == L'@') {
+            if (swscanf_s(tok.c_str(), L"@%lf", &fps) != 1 || fps <= 0.0) return false;
+            c.fps = fps;
+        } else {
+            const int got = swscanf_s(tok.c_str(), L"%ux%u@%lf", &w, &h, &fps);
+            if (got < 2 || w == 0 || h == 0) return false;
+            c.width = w;
+            c.height = h;
+            if (got == 3) {
+                if (fps <= 0.0) return false;
+                c.fps = fps;
+            }
+        }
+    }
+
+    *out = c;
+    return true;
+}
+
+bool SyntheticSource::Init(const Config& config) {
+    Cleanup();
+    config_ = config;
+    if (config_.fps <= 0.0) config_.fps = 60.0;
+
+    if (!config_.tracePath.empty()) {
+        if (!LoadTrace()) return false;
+    } else if (!config_.replayPath.empty() && !LoadReplay()) {
+        return false;
+    }
+    if (config_.width == 0 || config_.height == 0) {
+        Log::Error("SyntheticSource::Init: invalid frame size");
+        return false;
+    }
+
+    UINT createFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
+    HRESULT hr = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, createFlags, nullptr, 0,
+        D3D11_SDK_VERSION, &d3dDevice_, nullptr, &d3dContext_);
+    if (FAILED(hr)) {
+        // No usable GPU (CI VM, remote session): WARP keeps the whole render path testable.
+        Log::Info("SyntheticSource::Init: hardware device unavailable; using WARP");
+        hr = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, createFlags, nullptr, 0,
+            D3D11_SDK_VERSION, &d3dDevice_, nullptr, &d3dContext_);
+    }
+    if (FAILED(hr)) {
+        Log::Error("SyntheticSource::Init: D3D11CreateDevice failed");
+        Cleanup();
+        return false;
+    }
+
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = config_.width;
+    desc.Height = config_.height;
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+    hr = d3dDevice_->CreateTexture2D(&desc, nullptr, &texture_);
+    if (FAILED(hr)) {
+        Log::Error("SyntheticSource::Init: CreateTexture2D failed");
+        Cleanup();
+        return false;
+    }
+
+    if (replay_.empty()) pixels_.resize((size_t)config_.width * config_.height * 4);
+
+    LARGE_INTEGER f, now;
+    QueryPerformanceFrequency(&f);
+    QueryPerformanceCounter(&now);
+    qpf_ = f.QuadPart;
+    startQpc_ = now.QuadPart;
+    periodTicks_ = (double)qpf_ / config_.fps;
+    lastIndex_ = -1;
+    lastTimestamp_ = 0;
+    producedFramesTotal_ = 0;
+    lastAccumulatedFrames_ = 0;
+    traceCursor_ = 0;
+    traceLoopOffset_ = 0;
+    lastThumb_ = -1;
+    lastHr_ = S_OK;
+
+    Log::Info("SyntheticSource initialized: " + std::to_string(config_.width) + "x" + std::to_string(config_.height) +
+        " @" + std::to_string(config_.fps) + " fps" +
+        (!trace_.records.empty() ? std::string(" traceRecords=") + std::to_string(trace_.records.size()) +
+                                       " traceThumbs=" + std::to_string(trace_.thumbs.size())
+         : replay_.empty() ? std::string(" pattern=") + std::to_string((int)config_.pattern)
+                           : std::string(" replayFrames=") + std::to_string(replay_.size())) +
+        " jitterMs=" + std::to_string(config_.jitterMs) +
+        " repeatPercent=" + std::to_string(config_.repeatPercent));
+    return true;
+}
+
+bool SyntheticSource::LoadReplay() {
+    FrameIO::ReaderOptions opt;
+    opt.rawWidth = config_.replayRawWidth;
+    opt.rawHeight = config_.replayRawHeight;
+
+    std::string err;
+    std::unique_ptr<FrameIO::FrameReader> reader = FrameIO::OpenReader(NarrowPath(config_.replayPath), opt, &err);
+    if (!reader) {
+        Log::Error("SyntheticSource: cannot open replay: " + err);
+        return false;
+    }
+
+    FrameIO::Frame frame;
+    while (replay_.size() < kMaxReplayFrames && reader->ReadFrame(frame)) {
+        if (replay_.empty()) {
+            config_.width = frame.width;
+            config_.height = frame.height;
+        } else if (frame.width != config_.width || frame.height != config_.height) {
+            Log::Error("SyntheticSource: replay frame " + std::to_string(replay_.size()) + " changes size; stopping there");
+            break;
+        }
+        replay_.push_back(frame.bgra);
+    }
+    if (!reader->GetError().empty()) {
+        Log::Error("SyntheticSource: replay read error: " + reader->GetError());
+    }
+    if (replay_.empty()) {
+        Log::Error("SyntheticSource: replay has no frames");
+        return false;
+    }
+    if (replay_.size() == kMaxReplayFrames) {
+        Log::Info("SyntheticSource: replay truncated to " + std::to_string(kMaxReplayFrames) + " frames");
+    }
+    return true;
+}
+
+bool SyntheticSource::LoadTrace() {
+    std::string err;
+    if (!CaptureTrace::Load(NarrowPath(config_.tracePath), &trace_, &err)) {
+        Log::Error("SyntheticSource: cannot load trace: " + err);
+        return false;
+    }
+    if (trace_.records.empty() || trace_.header.qpcFrequency <= 0) {
+        Log::Error("SyntheticSource: trace has no records");
+        trace_ = CaptureTrace::Trace{};
+        return false;
+    }
+    if (trace_.header.srcWidth && trace_.header.srcHeight) {
+        config_.width = trace_.header.srcWidth;
+        config_.height = trace_.header.srcHeight;
+    }
+    return true;
+}
+
+// Consumes every trace record whose poll time has passed on the replay clock and delivers the
+// newest one that got a frame (accumulating the rest, as a late poll would have seen them).
+bool SyntheticSource::GetTraceFrame(LONGLONG nowQpc, const void** outData, INT64* outTimestamp, UINT* outAccumulated) {
+    const std::vector<CaptureTrace::Record>& recs = trace_.records;
+    const CaptureTrace::Header& h = trace_.header;
+
+    const double elapsed = (double)(nowQpc - startQpc_) * (double)h.qpcFrequency / (double)qpf_;
+    const LONGLONG traceNow = recs.front().pollQpc + (LONGLONG)elapsed;
+
+    const CaptureTrace::Record* got = nullptr;
+    UINT accumulated = 0;
+    for (;;) {
+        if (traceCursor_ == recs.size()) {
+            // Loop, leaving one average poll gap between the last and first record.
+            const LONGLONG span = recs.back().pollQpc - recs.front().pollQpc;
+            LONGLONG gap = (recs.size() > 1) ? span / (LONGLONG)(recs.size() - 1) : h.qpcFrequency / 60;
+            if (gap < 1) gap = 1;
+            traceLoopOffset_ += span + gap;
+            traceCursor_ = 0;
+        }
+        const CaptureTrace::Record& r = recs[traceCursor_];
+        if (r.pollQpc + traceLoopOffset_ > traceNow) break;
+        ++traceCursor_;
+        lastHr_ = (HRESULT)r.acquireHr;
+        if (r.flags & CaptureTrace::kFlagGotFrame) {
+            got = &r;
+            accumulated += r.accumulatedFrames ? r.accumulatedFrames : 1;
+        }
+    }
+    if (!got) return false;
+
+    INT64 ts = got->sourceTimestamp;
+    if (ts != 0 && traceLoopOffset_ != 0) {
+        // Keep timestamps increasing across loops.
+        ts += (INT64)((double)traceLoopOffset_ * (double)h.timestampFrequency / (double)h.qpcFrequency);
+    }
+
+    const void* data = nullptr;
+    if (trace_.thumbs.empty()) {
+        // No thumbnails recorded: new content whenever the recorded timestamp changes.
+        if (ts != lastTimestamp_) {
+            FillPattern(++lastIndex_);
+            data = pixels_.data();
+        }
+    } else if (got->thumbIndex >= 0 && got->thumbIndex != lastThumb_) {
+        FillFromThumb(trace_.thumbs[(size_t)got->thumbIndex]);
+        lastThumb_ = got->thumbIndex;
+        data = pixels_.data();
+    }
+
+    *outData = data;
+    *outTimestamp = ts;
+    *outAccumulated = accumulated;
+    return true;
+}
+
+void SyntheticSource::FillFromThumb(const std::vector<uint8_t>& thumb) {
+    const UINT tw = trace_.header.thumbWidth;
+    const UINT th = trace_.header.thumbHeight;
+    const UINT w = config_.width;
+    const UINT h = config_.height;
+    const uint32_t* src = reinterpret_cast<const uint32_t*>(thumb.data());
+    uint32_t* dst = reinterpret_cast<uint32_t*>(pixels_.data());
+    for (UINT y = 0; y < h; ++y) {
+        const uint32_t* row = src + (size_t)((uint64_t)y * th / h) * tw;
+        for (UINT x = 0; x < w; ++x) {
+            dst[(size_t)y * w + x] = row[(uint64_t)x * tw / w];
+        }
+    }
+}
+
+INT64 SyntheticSource::PresentQpc(long long frameIndex) const {
+    double t = (double)frameIndex * periodTicks_;
+    if (frameIndex > 0 && config_.jitterMs > 0.0) {
+        // Deterministic per-frame jitter, clamped so presents stay ordered.
+        const double u = (double)(Hash32((uint64_t)frameIndex) & 0xFFFF) / 32767.5 - 1.0;
+        double j = u * config_.jitterMs * 1e-3 * (double)qpf_;
+        const double maxJ = periodTicks_ * 0.45;
+        if (j > maxJ) j = maxJ;
+        if (j < -maxJ) j = -maxJ;
+        t += j;
+    }
+    return startQpc_ + (INT64)t;
+}
+
+void SyntheticSource::FillPattern(long long frameIndex) {
+    static const uint32_t kBars[8] = {
+        0xFFC0C0C0, 0xFFC0C000, 0xFF00C0C0, 0xFF00C000, 0xFFC000C0, 0xFFC00000, 0xFF0000C0, 0xFF101010,
+    };
+    const UINT w = config_.width;
+    const UINT h = config_.height;
+    uint32_t* px = reinterpret_cast<uint32_t*>(pixels_.data());
+
+    if (config_.pattern == Pattern::Checker) {
+        for (UINT y = 0; y < h; ++y) {
+            for (UINT x = 0; x < w; ++x) {
+                px[(size_t)y * w + x] = (((x >> 6) ^ (y >> 6)) & 1u) ? 0xFFD0D0D0 : 0xFF303030;
+            }
+        }
+    } else {
+        const UINT barW = (w + 7) / 8;
+        const UINT scroll = (UINT)((frameIndex * 4) % (long long)w);
+        for (UINT y = 0; y < h; ++y) {
+            // Vertical luma ramp on top of the bars so the depth estimator has gradients to work with.
+            const uint32_t shade = 0x40 + (y * 0xBF) / (h ? h : 1);
+            for (UINT x = 0; x < w; ++x) {
+                const uint32_t c = kBars[((x + scroll) % w) / barW];
+                const uint32_t b = ((c & 0xFF) * shade) >> 8;
+                const uint32_t g = (((c >> 8) & 0xFF) * shade) >> 8;
+                const uint32_t r = (((c >> 16) & 0xFF) * shade) >> 8;
+                px[(size_t)y * w + x] = 0xFF000000u | (r << 16) | (g << 8) | b;
+            }
+        }
+    }
+
+    // Moving box: bounces across the frame at a fixed speed.
+    const UINT boxW = w / 8 ? w / 8 : 1;
+    const UINT boxH = h / 8 ? h / 8 : 1;
+    const long long spanX = (long long)(w - boxW) * 2;
+    const long long spanY = (long long)(h - boxH) * 2;
+    long long bx = spanX ? (frameIndex * 6) % spanX : 0;
+    long long by = spanY ? (frameIndex * 4) % spanY : 0;
+    if (bx > spanX / 2) bx = spanX - bx;
+    if (by > spanY / 2) by = spanY - by;
+    for (UINT y = (UINT)by; y < (UINT)by + boxH && y < h; ++y) {
+        for (UINT x = (UINT)bx; x < (UINT)bx + boxW && x < w; ++x) {
+            px[(size_t)y * w + x] = 0xFFFFFFFF;
+        }
+    }
+}
+
+bool SyntheticSource::GetFrame(ID3D11Texture2D** outTex, INT64* outTimestamp) {
+    if (!outTex) return false;
+    *outTex = nullptr;
+    if (!texture_) return false;
+
+    if (frameHeld_) {
+        Log::Error("SyntheticSource::GetFrame: frame was still held; auto-released previous frame");
+        frameHeld_ = false;
+    }
+
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+
+    const void* data = nullptr;
+    INT64 timestamp = 0;
+    UINT accumulated = 0;
+    if (!trace_.records.empty()) {
+        if (!GetTraceFrame(now.QuadPart, &data, &timestamp, &accumulated)) return false;
+    } else {
+        // Latest content frame whose (jittered) present time has passed.
+        long long due = (long long)std::floor((double)(now.QuadPart - startQpc_) / periodTicks_);
+        if (PresentQpc(due + 1) <= now.QuadPart) ++due;
+        while (due > 0 && PresentQpc(due) > now.QuadPart) --due;
+        if (due <= lastIndex_) return false; // like DXGI_ERROR_WAIT_TIMEOUT
+
+        accumulated = (UINT)(due - lastIndex_);
+        lastIndex_ = due;
+
+        // Repeat presents keep the previous content and timestamp (what Renderer::UpdateRepeat counts).
+        const bool repeat = lastTimestamp_ != 0 && (int)(Hash32((uint64_t)due ^ 0x5EEDULL) % 100u) < config_.repeatPercent;
+        if (repeat) {
+            timestamp = lastTimestamp_;
+        } else {
+            if (!replay_.empty()) {
+                data = replay_[(size_t)(due % (long long)replay_.size())].data();
+            } else {
+                FillPattern(due);
+                data = pixels_.data();
+            }
+            timestamp = PresentQpc(due);
+        }
+    }
+
+    if (data) {
+        d3dContext_->UpdateSubresource(texture_, 0, nullptr, data, config_.width * 4, 0);
+    }
+    lastTimestamp_ = timestamp;
+    lastAccumulatedFrames_ = accumulated;
+    producedFramesTotal_ += accumulated;
+
+    texture_->AddRef();
+    *outTex = texture_;
+    if (outTimestamp) *outTimestamp = timestamp;
+    frameHeld_ = true;
+    return true;
+}
+
+void SyntheticSource::ReleaseFrame() {
+    frameHeld_ = false;
+}
+
+void SyntheticSource::Cleanup() {
+    frameHeld_ = false;
+    if (texture_) { texture_->Release(); texture_ = nullptr; }
+    if (d3dContext_) { d3dContext_->Release(); d3dContext_ = nullptr; }
+    if (d3dDevice_) { d3dDevice_->Release(); d3dDevice_ = nullptr; }
+    pixels_.clear();
+    replay_.clear();
+    trace_ = CaptureTrace::Trace{};
+}
+
+bool SyntheticSource::IsLost() const {
+    return lastHr_ == DXGI_ERROR_ACCESS_LOST || lastHr_ == DXGI_ERROR_INVALID_CALL || lastHr_ == DXGI_ERROR_ACCESS_DENIED;
+}
+
+INT64 SyntheticSource::GetTimestampFrequency() const {
+    return !trace_.records.empty() ? trace_.header.timestampFrequency : qpf_;
+}
+
+void SyntheticSource::ReportStats(Renderer& renderer) const {
+    renderer.SetCaptureStatsDXGI(producedFramesTotal_.load(std::memory_order_relaxed), GetLastAccumulatedFrames());
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <d3d11.h>
+#include <windows.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CaptureTrace.h"
+#include "FrameSource.h"
+
+// Display-less frame source: generates test patterns or replays recorded frames (FrameIO formats)
+// on its own D3D11 device, delivering them on a simulated present clock (QPC units, like DXGI).
+// Can also replay a capture trace (CaptureTrace.h): the recorded acquire results, timestamps,
+// accumulated-frame counts and HRESULTs are re-delivered on the recorded schedule, with thumbnails as content.
+// Lets the pacing loop, repeat detection and HUD stats run on machines without a desktop to duplicate.
+class SyntheticSource : public FrameSource {
+public:
+    enum class Pattern {
+        Bars = 0,   // scrolling colour bars + moving box (motion everywhere)
+        Checker,    // static checkerboard with a small moving box (mostly-static desktop)
+    };
+
+    struct Config {
+        UINT width = 1920;
+        UINT height = 1080;
+        double fps = 60.0;          // content present rate
+        double jitterMs = 0.5;      // +/- present-time jitter around the ideal cadence
+        int repeatPercent = 0;      // share of presents that repeat the previous frame (same timestamp)
+        Pattern pattern = Pattern::Bars;
+
+        // Replay instead of generating: image sequence / Y4M / raw BGRA (see FrameIO.h). Loops at the end.
+        std::wstring replayPath;
+        UINT replayRawWidth = 0;
+        UINT replayRawHeight = 0;
+
+        // Replay a capture trace's delivery schedule (overrides fps/jitter/repeat; loops at the end).
+        std::wstring tracePath;
+    };
+
+    // Parses "[WxH][@fps][,checker][,repeat=N][,jitter=MS]" (all parts optional) into `out`.
+    static bool ParseSpec(const std::wstring& spec, Config* out);
+
+    SyntheticSource() = default;
+    ~SyntheticSource() override { Cleanup(); }
+
+    bool Init(const Config& config);
+
+    bool GetFrame(ID3D11Texture2D** outTex, INT64* outTimestamp = nullptr) override;
+    void ReleaseFrame() override;
+    void Cleanup() override;
+
+    ID3D11Device* GetDevice() const override { return d3dDevice_; }
+    ID3D11DeviceContext* GetContext() const override { return d3dContext_; }
+
+    bool IsLost() const override;
+    HRESULT GetLastAcquireHr() const override { return lastHr_; }
+    UINT GetLastAccumulatedFrames() const override { return lastAccumulatedFrames_.load(std::memory_order_relaxed); }
+    INT64 GetTimestampFrequency() const override;
+    void ReportStats(Renderer& renderer) const override;
+
+    UINT GetWidth() const { return config_.width; }
+    UINT GetHeight() const { return config_.height; }
+
+private:
+    bool LoadReplay();
+    bool LoadTrace();
+    bool GetTraceFrame(LONGLONG nowQpc, const void** outData, INT64* outTimestamp, UINT* outAccumulated);
+    void FillPattern(long long frameIndex);
+    void FillFromThumb(const std::vector<uint8_t>& thumb);
+    INT64 PresentQpc(long long frameIndex) const;
+
+    Config config_;
+
+    ID3D11Device* d3dDevice_ = nullptr;
+    ID3D11DeviceContext* d3dContext_ = nullptr;
+    ID3D11Texture2D* texture_ = nullptr;
+
+    std::vector<uint8_t> pixels_;                // BGRA staging for generated frames
+    std::vector<std::vector<uint8_t>> replay_;   // preloaded replay frames (BGRA, width*height*4)
+
+    CaptureTrace::Trace trace_;
+    size_t traceCursor_ = 0;        // next record to consume
+    LONGLONG traceLoopOffset_ = 0;  // trace QPC offset added on each loop
+    int lastThumb_ = -1;
+    HRESULT lastHr_ = S_OK;
+
+    LONGLONG qpf_ = 0;
+    LONGLONG startQpc_ = 0;
+    double periodTicks_ = 0.0;
+    long long lastIndex_ = -1;   // last content frame delivered
+    INT64 lastTimestamp_ = 0;
+    bool frameHeld_ = false;
+
+    // Diagnostics (same meaning as CaptureDXGI's; atomic for the same reason).
+    std::atomic<unsigned long long> producedFramesTotal_{ 0 };
+    std::atomic<UINT> lastAccumulatedFrames_{ 0 };
+};
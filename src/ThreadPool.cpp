@@ -0,0 +1,141 @@
+#include "ThreadPool.h"
+
+namespace {
+
+// Which pool/queue the current thread belongs to (workers only).
+thread_local const ThreadPool* tlsPool = nullptr;
+thread_local unsigned tlsQueueIndex = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 1;
+    }
+
+    const unsigned workerCount = threadCount - 1;
+    queues_.reserve(workerCount + 1);
+    for (unsigned i = 0; i < workerCount + 1; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+
+    workers_.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; ++i) {
+        workers_.emplace_back(&ThreadPool::WorkerMain, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& t : workers_) {
+        if (t.joinable()) t.join();
+    }
+}
+
+unsigned ThreadPool::CurrentQueueIndex() const {
+    if (tlsPool == this) return tlsQueueIndex;
+    return (unsigned)queues_.size() - 1;
+}
+
+void ThreadPool::Submit(TaskGroup& group, Task task) {
+    group.pending_.fetch_add(1, std::memory_order_relaxed);
+
+    Queue& q = *queues_[CurrentQueueIndex()];
+    {
+        // Counted before the item is visible, so a thief's decrement can't run ahead of it and wrap.
+        std::lock_guard<std::mutex> lock(q.mutex);
+        queued_.fetch_add(1, std::memory_order_release);
+        q.items.push_back(Item{ &group, std::move(task) });
+    }
+
+    if (!workers_.empty()) {
+        // Take the sleep lock so a worker or waiter between its predicate check and wait() cannot miss this.
+        { std::lock_guard<std::mutex> lock(sleepMutex_); }
+        wake_.notify_one();
+        if (sleepingWaiters_.load() != 0) done_.notify_all();
+    }
+}
+
+bool ThreadPool::TryPop(unsigned self, Item& out) {
+    if (queued_.load(std::memory_order_acquire) == 0) return false;
+
+    // Own queue: newest first.
+    {
+        Queue& q = *queues_[self];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.items.empty()) {
+            out = std::move(q.items.back());
+            q.items.pop_back();
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Steal: oldest first, starting after our own slot to spread contention.
+    const unsigned n = (unsigned)queues_.size();
+    for (unsigned k = 1; k < n; ++k) {
+        Queue& q = *queues_[(self + k) % n];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.items.empty()) {
+            out = std::move(q.items.front());
+            q.items.pop_front();
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::Execute(Item& item) {
+    item.task();
+    item.task = nullptr;
+    // Sequentially consistent with the waiter's count and pending_ check, so one of them sees the other.
+    if (item.group->pending_.fetch_sub(1) == 1 && sleepingWaiters_.load() != 0) {
+        { std::lock_guard<std::mutex> lock(sleepMutex_); }
+        done_.notify_all();
+    }
+}
+
+void ThreadPool::Wait(TaskGroup& group) {
+    const unsigned self = CurrentQueueIndex();
+    Item item;
+    unsigned idle = 0;
+    while (!group.IsDone()) {
+        if (TryPop(self, item)) {
+            Execute(item);
+            idle = 0;
+        } else if (++idle < kWaitSpins) {
+            // Remaining tasks are running on other threads; short ones finish within a few yields.
+            std::this_thread::yield();
+        } else {
+            // New work wakes us too: with every worker inside a nested Wait(), nobody else would run it.
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            sleepingWaiters_.fetch_add(1);
+            done_.wait(lock, [&]() { return group.pending_.load() == 0 || queued_.load() != 0; });
+            sleepingWaiters_.fetch_sub(1);
+            idle = 0;
+        }
+    }
+}
+
+void ThreadPool::WorkerMain(unsigned index) {
+    tlsPool = this;
+    tlsQueueIndex = index;
+
+    Item item;
+    for (;;) {
+        if (TryPop(index, item)) {
+            Execute(item);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this]() { return stop_ || queued_.load(std::memory_order_acquire) != 0; });
+        if (stop_) return;
+    }
+}
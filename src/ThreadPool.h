@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small work-stealing thread pool used by the CPU depth engine.
+// Each worker owns a deque: it pops its own work LIFO (cache-warm) and steals FIFO from the others.
+// Tasks submitted from inside a task land on the submitting worker's deque, so dependent work
+// (e.g. pass 2 of a tile row) tends to run on the core that just produced its input.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // Outstanding-task counter; Wait() returns once every task submitted against it has run.
+    class TaskGroup {
+    public:
+        bool IsDone() const { return pending_.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class ThreadPool;
+        std::atomic<uint32_t> pending_{ 0 };
+    };
+
+    // threadCount: total threads that execute tasks, including the thread calling Wait().
+    // 0 = one per hardware thread. 1 = no workers (Wait() runs everything inline).
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned GetThreadCount() const { return (unsigned)workers_.size() + 1; }
+
+    void Submit(TaskGroup& group, Task task);
+
+    // Helps execute queued tasks until `group` drains. Once nothing is left to help with it sleeps until
+    // the group's last task finishes or more work is submitted.
+    void Wait(TaskGroup& group);
+
+private:
+    struct Item {
+        TaskGroup* group = nullptr;
+        Task task;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Item> items;
+    };
+
+    unsigned CurrentQueueIndex() const;
+    bool TryPop(unsigned self, Item& out);
+    void Execute(Item& item);
+    void WorkerMain(unsigned index);
+
+    // One queue per worker plus a shared one (last) for threads outside the pool.
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+
+    // Failed pops (each followed by a yield) before Wait() sleeps on done_.
+    static constexpr unsigned kWaitSpins = 64;
+
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;    // workers: queued_ became non-zero, or stop_
+    std::condition_variable done_;    // Wait(): a group drained, or queued_ became non-zero
+    std::atomic<uint32_t> queued_{ 0 };
+    std::atomic<uint32_t> sleepingWaiters_{ 0 }; // threads asleep in Wait()
+    bool stop_ = false;
+};
@@ -0,0 +1,111 @@
+#include "TraceThumbnailer.h"
+
+#include "Log.h"
+
+#include <string>
+
+bool TraceThumbnailer::Init(ID3D11Device* device, UINT srcWidth, UINT srcHeight, DXGI_FORMAT format) {
+    Cleanup();
+    if (!device || srcWidth == 0 || srcHeight == 0) return false;
+    if (format != DXGI_FORMAT_B8G8R8A8_UNORM) {
+        Log::Info("TraceThumbnailer: capture format " + std::to_string((int)format) + " not supported; trace has no thumbnails");
+        return false;
+    }
+
+    UINT level = 0;
+    while ((srcWidth >> level) > kMaxWidth && (srcHeight >> (level + 1)) > 0) ++level;
+
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = srcWidth;
+    desc.Height = srcHeight;
+    desc.MipLevels = level + 1;
+    desc.ArraySize = 1;
+    desc.Format = format;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+    desc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+    HRESULT hr = device->CreateTexture2D(&desc, nullptr, &mipTex_);
+    if (SUCCEEDED(hr)) hr = device->CreateShaderResourceView(mipTex_, nullptr, &mipSrv_);
+    if (FAILED(hr)) {
+        Log::Error("TraceThumbnailer: mip texture creation failed");
+        Cleanup();
+        return false;
+    }
+
+    thumbWidth_ = (srcWidth >> level) ? (srcWidth >> level) : 1;
+    thumbHeight_ = (srcHeight >> level) ? (srcHeight >> level) : 1;
+
+    D3D11_TEXTURE2D_DESC sdesc = {};
+    sdesc.Width = thumbWidth_;
+    sdesc.Height = thumbHeight_;
+    sdesc.MipLevels = 1;
+    sdesc.ArraySize = 1;
+    sdesc.Format = format;
+    sdesc.SampleDesc.Count = 1;
+    sdesc.Usage = D3D11_USAGE_STAGING;
+    sdesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    for (Slot& s : slots_) {
+        if (FAILED(device->CreateTexture2D(&sdesc, nullptr, &s.staging))) {
+            Log::Error("TraceThumbnailer: staging texture creation failed");
+            Cleanup();
+            return false;
+        }
+    }
+
+    mipLevel_ = level;
+    srcWidth_ = srcWidth;
+    srcHeight_ = srcHeight;
+    format_ = format;
+    return true;
+}
+
+void TraceThumbnailer::Cleanup() {
+    for (Slot& s : slots_) {
+        if (s.staging) { s.staging->Release(); s.staging = nullptr; }
+        s.pending = false;
+    }
+    if (mipSrv_) { mipSrv_->Release(); mipSrv_ = nullptr; }
+    if (mipTex_) { mipTex_->Release(); mipTex_ = nullptr; }
+    mipLevel_ = 0;
+    srcWidth_ = srcHeight_ = 0;
+    format_ = DXGI_FORMAT_UNKNOWN;
+    thumbWidth_ = thumbHeight_ = 0;
+    nextSlot_ = 0;
+}
+
+void TraceThumbnailer::Submit(ID3D11DeviceContext* ctx, ID3D11Texture2D* src, uint64_t recordSeq) {
+    if (!ctx || !src || !mipTex_) return;
+
+    Slot& slot = slots_[nextSlot_];
+    if (slot.pending) return;
+
+    D3D11_TEXTURE2D_DESC desc;
+    src->GetDesc(&desc);
+    if (desc.Width != srcWidth_ || desc.Height != srcHeight_ || desc.Format != format_ || desc.SampleDesc.Count != 1) return;
+
+    ctx->CopySubresourceRegion(mipTex_, 0, 0, 0, 0, src, 0, nullptr);
+    ctx->GenerateMips(mipSrv_);
+    ctx->CopySubresourceRegion(slot.staging, 0, 0, 0, 0, mipTex_, mipLevel_, nullptr);
+    slot.recordSeq = recordSeq;
+    slot.pending = true;
+    nextSlot_ = (nextSlot_ + 1) % kSlots;
+}
+
+void TraceThumbnailer::Collect(ID3D11DeviceContext* ctx, CaptureTrace::Recorder& recorder) {
+    if (!ctx) return;
+    // Oldest first; stop at the first readback the GPU hasn't finished.
+    for (int i = 0; i < kSlots; ++i) {
+        Slot& slot = slots_[(nextSlot_ + i) % kSlots];
+        if (!slot.pending) continue;
+
+        D3D11_MAPPED_SUBRESOURCE mapped = {};
+        const HRESULT hr = ctx->Map(slot.staging, 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+        if (hr == DXGI_ERROR_WAS_STILL_DRAWING) break;
+        if (SUCCEEDED(hr)) {
+            recorder.AttachThumbnail(slot.recordSeq, static_cast<const uint8_t*>(mapped.pData), mapped.RowPitch);
+            ctx->Unmap(slot.staging, 0);
+        }
+        slot.pending = false;
+    }
+}
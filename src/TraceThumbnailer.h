@@ -0,0 +1,52 @@
+#pragma once
+
+#include <d3d11.h>
+
+#include <cstdint>
+
+#include "CaptureTrace.h"
+
+// Downscaled frame thumbnails for the capture trace.
+// The captured frame is copied into a mip chain on the GPU, the smallest level that fits
+// kMaxWidth is copied to a staging texture, and the readback is collected a frame or two
+// later without blocking (D3D11_MAP_FLAG_DO_NOT_WAIT), so tracing does not add a GPU sync.
+class TraceThumbnailer {
+public:
+    static constexpr UINT kMaxWidth = 128;
+
+    ~TraceThumbnailer() { Cleanup(); }
+
+    // False for formats the mip path can't handle (only 8-bit BGRA captures get thumbnails).
+    bool Init(ID3D11Device* device, UINT srcWidth, UINT srcHeight, DXGI_FORMAT format);
+    void Cleanup();
+
+    UINT GetWidth() const { return thumbWidth_; }
+    UINT GetHeight() const { return thumbHeight_; }
+
+    // Queues a thumbnail of `src` for trace record `recordSeq`. Skipped (no thumbnail) when
+    // all readback slots are still in flight or the frame size no longer matches.
+    void Submit(ID3D11DeviceContext* ctx, ID3D11Texture2D* src, uint64_t recordSeq);
+    // Hands finished readbacks to the recorder.
+    void Collect(ID3D11DeviceContext* ctx, CaptureTrace::Recorder& recorder);
+
+private:
+    static constexpr int kSlots = 3;
+
+    struct Slot {
+        ID3D11Texture2D* staging = nullptr;
+        uint64_t recordSeq = 0;
+        bool pending = false;
+    };
+
+    ID3D11Texture2D* mipTex_ = nullptr;
+    ID3D11ShaderResourceView* mipSrv_ = nullptr;
+    UINT mipLevel_ = 0;
+    UINT srcWidth_ = 0;
+    UINT srcHeight_ = 0;
+    DXGI_FORMAT format_ = DXGI_FORMAT_UNKNOWN;
+    UINT thumbWidth_ = 0;
+    UINT thumbHeight_ = 0;
+
+    Slot slots_[kSlots];
+    int nextSlot_ = 0;
+};
@@ -351,8 +351,9 @@ void TrayIcon::UpdateMenu(const std::vector<std::wstring>& outputMonitorNames, i
         { L"1920 x 1080" },
         { L"2560 x 1440" },
         { L"3840 x 2160" },
+        { L"Auto (hold frame rate)" },
     };
-    for (int i = 0; i < 6; ++i) {
+    for (int i = 0; i < 7; ++i) {
         UINT flags = MF_STRING;
         if (i == renderResIndex_) flags |= MF_CHECKED;
         // Allow preselecting a preset even when not capturing; it applies immediately once rendering starts.
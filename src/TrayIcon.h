@@ -40,7 +40,7 @@ public:
     int GetOverlayPositionIndex() const { return overlayPosIndex_; }
 
     // Render resolution preset (output-side downscale). 0=Native, 1..N presets.
-    void SetRenderResolutionIndex(int idx) { renderResIndex_ = (idx < 0 ? 0 : (idx > 5 ? 5 : idx)); }
+    void SetRenderResolutionIndex(int idx) { renderResIndex_ = (idx < 0 ? 0 : (idx > 6 ? 6 : idx)); }
     int GetRenderResolutionIndex() const { return renderResIndex_; }
 
     // Input passthrough (click-through)
@@ -78,7 +78,7 @@ private:
     bool diagnosticsOverlay_ = false;
     int diagnosticsOverlaySizeIndex_ = 0; // 0=Small, 1=Medium, 2=Large
     bool diagnosticsOverlayCompact_ = true;
-    int renderResIndex_ = 0; // 0=Native, 1..N presets
+    int renderResIndex_ = 0; // 0=Native, 1..5 presets, 6=Auto
 
     int overlayPosIndex_ = 0; // 0=TopLeft, 1=TopRight, 2=BottomLeft, 3=BottomRight, 4=Center
 
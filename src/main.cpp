@@ -1,5 +1,10 @@
 #include "CaptureDXGI.h"
 #include "CaptureWGC.h"
+#include "SyntheticSource.h"
+#include "CaptureThread.h"
+#include "CaptureTrace.h"
+#include "TraceThumbnailer.h"
+#include "FramePacer.h"
 #include "TrayIcon.h"
 #include "Renderer.h"
 #include "DepthDialog.h"
@@ -107,6 +112,7 @@ static UINT g_windowSelectExpectedH = 0;
 enum class CaptureMode {
     Monitor,
     Window,
+    Synthetic, // SyntheticSource (test patterns / replay); started with --synthetic or --replay
 };
 
 static CaptureMode g_captureMode = CaptureMode::Monitor;
@@ -260,7 +266,23 @@ LRESULT CALLBACK RenderWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam
 // Global handles for capture/render
 static CaptureDXGI g_capture;
 static CaptureWGC g_captureWgc;
+static SyntheticSource g_syntheticSource;
+static SyntheticSource::Config g_syntheticConfig;
+// Acquisition thread in front of the active backend ([Performance] CaptureThread in settings.ini).
+// Declared after the backends so it is torn down first.
+static CaptureThread g_captureThread;
+static bool g_captureThreadEnabled = true;
+static bool g_captureThreadAttempted = false;
+// Move rects of the frame being rendered (reused to avoid per-frame allocations).
+static std::vector<DXGI_OUTDUPL_MOVE_RECT> g_frameMoves;
+static bool g_syntheticRequested = false;
 static Renderer g_renderer;
+
+// Opt-in capture trace ([Diagnostics] CaptureTrace / CaptureTraceThumbnails in settings.ini).
+static bool g_captureTraceEnabled = false;
+static bool g_captureTraceThumbnails = false;
+static CaptureTrace::Recorder g_traceRecorder;
+static TraceThumbnailer g_traceThumbs;
 static HWND g_trayWnd = nullptr;
 static HWND g_renderWnd = nullptr;
 static bool g_capturing = false;
@@ -272,6 +294,20 @@ static bool g_windowSelectAwaitingTarget = false;
 static HWND g_windowSelectLastForegroundRoot = nullptr;
 static bool g_windowSelectIgnoreFirstForeground = false;
 
+static FrameSource& CaptureBackend() {
+    switch (g_captureMode) {
+    case CaptureMode::Monitor: return g_capture;
+    case CaptureMode::Synthetic: return g_syntheticSource;
+    default: return g_captureWgc;
+    }
+}
+
+// What the render loop pulls from: the capture thread's mailbox once it runs, else the backend itself.
+static FrameSource& ActiveSource() {
+    if (g_captureThread.IsRunning()) return g_captureThread;
+    return CaptureBackend();
+}
+
 static HWND FindVisiblePopupMenuWindowForThread(DWORD tid) {
     if (tid == 0) return nullptr;
     struct Ctx {
@@ -426,6 +462,15 @@ static int g_outputMonIndex = -1;
 static bool g_stereoEnabled = false;
 static int g_stereoDepthLevel = 10; // 1..20
 static int g_stereoParallaxStrengthPercent = 20; // 0..50
+static int g_stereoShaderMode = 0; // 0=Depth3Pass, 1=DepthFused
+static int g_stereoDepthPrecision = 0; // 0=float32, 1=unorm16, 2=unorm8
+static int g_stereoContentFingerprint = 1; // 0=off, 1=lattice, 2=lattice+hash
+static int g_stereoFoveation = 0; // 0=off, 2/4 = periphery depth at 1/2 or 1/4 resolution
+static int g_stereoFoveaRadiusPercent = 40;
+static int g_stereoFoveaFalloffPercent = 20;
+static bool g_stereoFrameInterpolation = false;
+static int g_stereoLayout = 2; // Renderer::StereoLayout
+static SinkSettings g_sinks[AppSettings::kMaxSinks];
 static HWND g_stereoSettingsDlgHwnd = nullptr;
 static int g_overlayPosIndex = 0; // 0=TL,1=TR,2=BL,3=BR,4=Center
 static bool g_clickThrough = false;
@@ -730,7 +775,7 @@ static std::wstring g_dxgiCaptureDeviceName;
 // if the user drags the window to a different monitor.
 static HMONITOR g_renderWndLastMonitorForAffinity = nullptr;
 static bool g_windowPickPending = false;
-static int g_renderResPresetIndex = 0; // 0=Native (no downscale), 1..N presets
+static int g_renderResPresetIndex = 0; // 0=Native (no downscale), 1..5 presets, 6=Auto
 static bool g_pendingActiveWindowCapture = false;
 static constexpr UINT_PTR kTimerStartActiveWindowCapture = 0xAC01;
 static constexpr UINT_PTR kTimerRestoreForeground = 0xAC03;
@@ -776,6 +821,88 @@ static bool GetEffectiveExcludeFromCapture() {
     return true;
 }
 
+// Output sinks ([Sink1]..[Sink4]): extra outputs of the renderer, opened after each successful Init.
+// Window sinks get their own top-level window; closing it removes just that sink.
+struct OpenSink {
+    int id = 0;
+    HWND wnd = nullptr;
+};
+static std::vector<OpenSink> g_openSinks;
+
+static LRESULT CALLBACK SinkWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    switch (msg) {
+    case WM_CLOSE:
+        for (size_t i = 0; i < g_openSinks.size(); ++i) {
+            if (g_openSinks[i].wnd == hWnd) {
+                g_renderer.RemoveOutputSink(g_openSinks[i].id);
+                g_openSinks.erase(g_openSinks.begin() + i);
+                break;
+            }
+        }
+        DestroyWindow(hWnd);
+        return 0;
+    case WM_ERASEBKGND:
+        return 1; // the sink's swap chain covers the client area
+    }
+    return DefWindowProc(hWnd, msg, wParam, lParam);
+}
+
+static void CloseOutputSinks() {
+    g_renderer.RemoveAllOutputSinks();
+    for (const OpenSink& s : g_openSinks) {
+        if (s.wnd) DestroyWindow(s.wnd);
+    }
+    g_openSinks.clear();
+}
+
+static void OpenOutputSinks() {
+    CloseOutputSinks();
+    for (int i = 0; i < AppSettings::kMaxSinks; ++i) {
+        const SinkSettings& cfg = g_sinks[i];
+        if (cfg.kind == 0) continue;
+
+        OutputSink::Desc desc;
+        desc.kind = (OutputSink::Kind)(cfg.kind - 1);
+        desc.layout = cfg.layout;
+        desc.width = (UINT)cfg.width;
+        desc.height = (UINT)cfg.height;
+        desc.name = cfg.name;
+        desc.fps = 60;
+
+        HWND wnd = nullptr;
+        if (desc.kind == OutputSink::Kind::Window) {
+            WNDCLASS swc = {};
+            swc.lpfnWndProc = SinkWndProc;
+            swc.hInstance = GetModuleHandle(nullptr);
+            swc.lpszClassName = TEXT("ArinCaptureSinkClass");
+            swc.hCursor = LoadCursor(nullptr, IDC_ARROW);
+            RegisterClass(&swc);
+            wchar_t title[64];
+            swprintf_s(title, L"ArinCapture Sink %d", i + 1);
+            RECT wr = { 0, 0, 960, 540 };
+            AdjustWindowRect(&wr, WS_OVERLAPPEDWINDOW, FALSE);
+            wnd = CreateWindowEx(WS_EX_APPWINDOW, swc.lpszClassName, title, WS_OVERLAPPEDWINDOW,
+                CW_USEDEFAULT, CW_USEDEFAULT, (wr.right - wr.left), (wr.bottom - wr.top),
+                nullptr, nullptr, swc.hInstance, nullptr);
+            if (!wnd) {
+                Log::Error("Sink " + std::to_string(i + 1) + ": failed to create its window.");
+                continue;
+            }
+            ApplyRenderWindowExcludeFromCapture(wnd, GetEffectiveExcludeFromCapture());
+            ShowWindow(wnd, SW_SHOWNOACTIVATE);
+            desc.window = wnd;
+        }
+
+        const int id = g_renderer.AddOutputSink(desc);
+        if (!id) {
+            Log::Error("Sink " + std::to_string(i + 1) + ": failed to open.");
+            if (wnd) DestroyWindow(wnd);
+            continue;
+        }
+        g_openSinks.push_back({ id, wnd });
+    }
+}
+
 static void ChooseOutputMonitorAvoidingDxgiRecursion(const std::vector<Monitors::MonitorInfo>& monitors) {
     if (monitors.size() <= 1) return;
     if (g_captureMode != CaptureMode::Monitor) return;
@@ -852,7 +979,7 @@ static void LogExcludeFromCaptureState(const char* where) {
         ": opt=" + (g_excludeFromCapture ? "1" : "0") +
         " effective=" + (GetEffectiveExcludeFromCapture() ? "1" : "0") +
         " directMon=" + (g_directMonitorCapture ? "1" : "0") +
-        " mode=" + std::string(g_captureMode == CaptureMode::Monitor ? "Monitor" : "Window") +
+        " mode=" + std::string(g_captureMode == CaptureMode::Monitor ? "Monitor" : (g_captureMode == CaptureMode::Synthetic ? "Synthetic" : "Window")) +
         " activeWin=" + (g_activeWindowMode ? "1" : "0") +
         " winSelFollow=" + (g_windowSelectFollowTopmost ? "1" : "0") +
         " winSelDxgiCrop=" + (g_windowSelectDxgiCropActive ? "1" : "0") +
@@ -885,6 +1012,17 @@ static void SaveSettingsFromState(const TrayIcon& tray) {
     s.stereoEnabled = g_stereoEnabled;
     s.stereoDepthLevel = g_stereoDepthLevel;
     s.stereoParallaxStrengthPercent = g_stereoParallaxStrengthPercent;
+    s.stereoShaderMode = g_stereoShaderMode;
+    s.stereoDepthPrecision = g_stereoDepthPrecision;
+    s.stereoContentFingerprint = g_stereoContentFingerprint;
+    s.stereoFoveation = g_stereoFoveation;
+    s.stereoFoveaRadiusPercent = g_stereoFoveaRadiusPercent;
+    s.stereoFoveaFalloffPercent = g_stereoFoveaFalloffPercent;
+    s.stereoFrameInterpolation = g_stereoFrameInterpolation;
+    s.stereoLayout = g_stereoLayout;
+    for (int i = 0; i < AppSettings::kMaxSinks; ++i) {
+        s.sinks[i] = g_sinks[i];
+    }
 
     s.vsyncEnabled = g_vsyncEnabled;
     s.clickThrough = g_clickThrough;
@@ -895,6 +1033,9 @@ static void SaveSettingsFromState(const TrayIcon& tray) {
     s.diagnosticsOverlay = tray.GetDiagnosticsOverlay();
     s.diagnosticsOverlaySizeIndex = tray.GetDiagnosticsOverlaySizeIndex();
     s.diagnosticsOverlayCompact = tray.GetDiagnosticsOverlayCompact();
+    s.captureTrace = g_captureTraceEnabled;
+    s.captureTraceThumbnails = g_captureTraceThumbnails;
+    s.captureThread = g_captureThreadEnabled;
 
     s.framerateIndex = tray.GetFramerateIndex();
     s.renderResPresetIndex = g_renderResPresetIndex;
@@ -996,6 +1137,89 @@ static void UpdateSoftwareCursorFromSource() {
     g_renderer.SetSoftwareCursorPosNormalized(x01, y01);
 }
 
+// Trace files go next to the exe (like the log), one per capture session.
+static std::string CaptureTracePath() {
+    SYSTEMTIME st;
+    GetLocalTime(&st);
+    wchar_t name[64];
+    swprintf_s(name, L"ArinCapture_%04u%02u%02u_%02u%02u%02u.actrace",
+        st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond);
+
+    std::wstring full = name;
+    wchar_t exePath[MAX_PATH] = {0};
+    const DWORD n = GetModuleFileNameW(nullptr, exePath, MAX_PATH);
+    if (n > 0 && n < MAX_PATH) {
+        wchar_t* lastSlash = wcsrchr(exePath, L'\\');
+        if (lastSlash) {
+            *(lastSlash + 1) = L'\0';
+            full = std::wstring(exePath) + name;
+        }
+    }
+
+    // CRT fopen takes ANSI paths.
+    const int needed = WideCharToMultiByte(CP_ACP, 0, full.c_str(), -1, nullptr, 0, nullptr, nullptr);
+    if (needed <= 1) return "ArinCapture.actrace";
+    std::string out((size_t)needed - 1, '\0');
+    WideCharToMultiByte(CP_ACP, 0, full.c_str(), -1, &out[0], needed, nullptr, nullptr);
+    return out;
+}
+
+// Appends one render-loop tick to the capture trace. The trace starts on the first captured frame
+// (so source size/format are known) and is written by EndCaptureTrace when capture stops.
+static void RecordCaptureTrace(FrameSource& source, ID3D11Texture2D* frame, INT64 frameTimestamp, LONGLONG pollQpc, LONGLONG acquiredQpc) {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+
+    if (!g_traceRecorder.IsActive()) {
+        if (!frame) return;
+        D3D11_TEXTURE2D_DESC desc;
+        frame->GetDesc(&desc);
+        LARGE_INTEGER qpf;
+        QueryPerformanceFrequency(&qpf);
+
+        UINT thumbW = 0, thumbH = 0;
+        if (g_captureTraceThumbnails && g_traceThumbs.Init(source.GetDevice(), desc.Width, desc.Height, desc.Format)) {
+            thumbW = g_traceThumbs.GetWidth();
+            thumbH = g_traceThumbs.GetHeight();
+        }
+        const CaptureTrace::Backend backend =
+            (g_captureMode == CaptureMode::Monitor) ? CaptureTrace::Backend::Dxgi :
+            (g_captureMode == CaptureMode::Synthetic) ? CaptureTrace::Backend::Synthetic : CaptureTrace::Backend::Wgc;
+        g_traceRecorder.Begin(backend, qpf.QuadPart, source.GetTimestampFrequency(), desc.Width, desc.Height, thumbW, thumbH);
+        Log::Info("Capture trace started: " + std::to_string(desc.Width) + "x" + std::to_string(desc.Height) +
+            " thumbnails=" + std::to_string(thumbW) + "x" + std::to_string(thumbH));
+    }
+
+    CaptureTrace::Record r{};
+    r.pollQpc = pollQpc;
+    r.acquiredQpc = acquiredQpc;
+    r.renderedQpc = now.QuadPart;
+    r.sourceTimestamp = frame ? frameTimestamp : 0;
+    r.acquireHr = (int32_t)source.GetLastAcquireHr();
+    r.accumulatedFrames = frame ? source.GetLastAccumulatedFrames() : 0;
+    r.flags = frame ? CaptureTrace::kFlagGotFrame : 0;
+    g_renderer.TakePipelineCostSample(&r.costMs, &r.renderScale);
+    const uint64_t seq = g_traceRecorder.Add(r);
+
+    ID3D11DeviceContext* ctx = source.GetContext();
+    if (frame && g_traceThumbs.GetWidth()) g_traceThumbs.Submit(ctx, frame, seq);
+    g_traceThumbs.Collect(ctx, g_traceRecorder);
+}
+
+static void EndCaptureTrace() {
+    if (g_traceRecorder.IsActive()) {
+        const std::string path = CaptureTracePath();
+        std::string err;
+        if (g_traceRecorder.Save(path, &err)) {
+            Log::Info("Capture trace saved: " + path + " (" + std::to_string(g_traceRecorder.GetRecordCount()) + " ticks recorded)");
+        } else {
+            Log::Error("Capture trace save failed: " + err);
+        }
+    }
+    g_traceRecorder.Reset();
+    g_traceThumbs.Cleanup();
+}
+
 static void RenderOneFrame(HWND hWnd) {
     static bool inRender = false;
     static ULONGLONG lastGoodFrameMs = 0;
@@ -1028,14 +1252,20 @@ static void RenderOneFrame(HWND hWnd) {
         g_renderer.ClearSourceCrop();
     }
 
+    // Start acquiring off the UI thread once the render path is up (one attempt per capture session;
+    // backends that can't be driven from another thread keep being polled here).
+    if (g_captureThreadEnabled && !g_captureThreadAttempted) {
+        g_captureThreadAttempted = true;
+        g_captureThread.Start(&CaptureBackend());
+    }
+
+    FrameSource& source = ActiveSource();
     ID3D11Texture2D* frame = nullptr;
     INT64 frameTimestamp = 0;
-    bool got = false;
-    if (g_captureMode == CaptureMode::Monitor) {
-        got = g_capture.GetFrame(&frame, &frameTimestamp);
-    } else {
-        got = g_captureWgc.GetFrame(&frame, &frameTimestamp);
-    }
+    LARGE_INTEGER pollQpc = {}, acquiredQpc = {};
+    if (g_captureTraceEnabled) QueryPerformanceCounter(&pollQpc);
+    const bool got = source.GetFrame(&frame, &frameTimestamp);
+    if (g_captureTraceEnabled) QueryPerformanceCounter(&acquiredQpc);
 
     // Capture stall watchdog:
     // - DXGI duplication can hard-fail (ACCESS_LOST/INVALID_CALL) when a fullscreen app changes modes.
@@ -1046,41 +1276,31 @@ static void RenderOneFrame(HWND hWnd) {
             lastGoodFrameMs = nowMs;
             stallStopPosted = false;
         }
-        if (g_captureMode == CaptureMode::Monitor) {
-            // DXGI: don't treat WAIT_TIMEOUT as a stall (it just means no screen changes).
-            const HRESULT hr = g_capture.GetLastAcquireNextFrameHr();
-            if (!stallStopPosted && (hr == DXGI_ERROR_ACCESS_LOST || hr == DXGI_ERROR_INVALID_CALL || hr == DXGI_ERROR_ACCESS_DENIED)) {
-                stallStopPosted = true;
-                Log::Error("Capture lost (DXGI duplication): stopping capture to reset UI state");
-                if (g_trayWnd) {
-                    PostMessage(g_trayWnd, WM_APP + 2, 0, 2);
-                }
+        // DXGI: WAIT_TIMEOUT is not a loss (it just means no screen changes).
+        if (!stallStopPosted && source.IsLost()) {
+            stallStopPosted = true;
+            Log::Error("Capture lost (DXGI duplication): stopping capture to reset UI state");
+            if (g_trayWnd) {
+                PostMessage(g_trayWnd, WM_APP + 2, 0, 2);
             }
         }
     }
 
     // Push capture backend diagnostics (for HUD Cap: ...).
-    if (g_captureMode == CaptureMode::Monitor) {
-        g_renderer.SetCaptureStatsDXGI(g_capture.GetProducedFramesTotal(), g_capture.GetLastAccumulatedFrames());
-    } else {
-        g_renderer.SetCaptureStatsWGC(
-            g_captureWgc.GetFrameArrivedCount(),
-            g_captureWgc.GetFrameProducedCount(),
-            g_captureWgc.GetFrameConsumedCount());
-    }
+    source.ReportStats(g_renderer);
 
     if (got) {
+        const bool movesKnown = source.GetLastMoveRects(g_frameMoves);
+        g_renderer.SetSourceMoveRects(g_frameMoves.data(), (UINT)g_frameMoves.size(), movesKnown);
         g_renderer.UpdateRepeat(frameTimestamp);
         g_renderer.Render(frame, 0.0f);
-        if (g_captureMode == CaptureMode::Monitor) {
-            g_capture.ReleaseFrame();
-        } else {
-            g_captureWgc.ReleaseFrame();
-        }
+        if (g_captureTraceEnabled) RecordCaptureTrace(source, frame, frameTimestamp, pollQpc.QuadPart, acquiredQpc.QuadPart);
+        source.ReleaseFrame();
         frame->Release();
     } else {
         // Still present cached frame/overlay even if capture stalls.
         g_renderer.Render(nullptr, 0.0f);
+        if (g_captureTraceEnabled) RecordCaptureTrace(source, nullptr, 0, pollQpc.QuadPart, acquiredQpc.QuadPart);
     }
 
     inRender = false;
@@ -1373,7 +1593,12 @@ LRESULT CALLBACK TrayWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
         g_renderer.SetStereoDepthLevel(g_stereoDepthLevel);
         g_renderer.SetStereoParallaxStrengthPercent(g_stereoParallaxStrengthPercent);
         g_renderer.SetRenderResolutionIndex(g_renderResPresetIndex);
-        g_renderer.SetStereoShaderMode(Renderer::StereoShaderMode::Depth3Pass);
+        g_renderer.SetStereoShaderMode((Renderer::StereoShaderMode)g_stereoShaderMode);
+        g_renderer.SetDepthPrecision((Renderer::DepthPrecision)g_stereoDepthPrecision);
+        g_renderer.SetContentFingerprint((Renderer::ContentFingerprint)g_stereoContentFingerprint);
+        g_renderer.SetFoveation(g_stereoFoveation, g_stereoFoveaRadiusPercent, g_stereoFoveaFalloffPercent);
+        g_renderer.SetFrameInterpolation(g_stereoFrameInterpolation);
+        g_renderer.SetStereoLayout((Renderer::StereoLayout)g_stereoLayout);
 
         // Persist once on startup as a safe migration step:
         // - First run: creates the file
@@ -1566,14 +1791,36 @@ LRESULT CALLBACK TrayWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
                         g_activeWindowDxgiCropMonitorRect = {0, 0, 0, 0};
                     }
 
+                } else if (wParam == 4) {
+                    // Synthetic/replay source (no desktop needed); see SyntheticSource.h.
+                    g_captureMode = CaptureMode::Synthetic;
+                    g_directMonitorCapture = false;
+                    g_directMonitorCaptureDeviceName.clear();
+                    g_dxgiCaptureDeviceName.clear();
+                    g_windowPickPending = false;
+                    g_activeWindowMode = false;
+                    g_activeWindowTarget = nullptr;
+                    g_activeWindowTargetRoot = nullptr;
+                    g_activeWindowTitleHint.clear();
+                    g_windowSelectAwaitingTarget = false;
+                    g_windowSelectLastForegroundRoot = nullptr;
+                    SetActiveWindowForegroundHookEnabled(false);
+
+                    if (!g_syntheticSource.Init(g_syntheticConfig)) {
+                        Log::Error("Failed to initialize synthetic frame source.");
+                        tray.SetCaptureActive(false);
+                        break;
+                    }
+                    tray.SetCaptureActive(true);
+                    LogExcludeFromCaptureState("StartCapture: Synthetic");
                 }
                 // 2. Get capture frame size/format for swap chain
                 ID3D11Texture2D* frame = nullptr;
                 UINT width = 1280, height = 720;
                 DXGI_FORMAT format = DXGI_FORMAT_B8G8R8A8_UNORM;
                 bool gotFirstFrame = false;
-                if (g_captureMode == CaptureMode::Monitor) {
-                    gotFirstFrame = g_capture.GetFrame(&frame);
+                if (g_captureMode == CaptureMode::Monitor || g_captureMode == CaptureMode::Synthetic) {
+                    gotFirstFrame = ActiveSource().GetFrame(&frame);
                 } else {
                     // WGC: avoid waiting on a first frame; the item size is known immediately.
                     {
@@ -1595,11 +1842,7 @@ LRESULT CALLBACK TrayWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
                     width = desc.Width;
                     height = desc.Height;
                     format = desc.Format;
-                    if (g_captureMode == CaptureMode::Monitor) {
-                        g_capture.ReleaseFrame();
-                    } else {
-                        g_captureWgc.ReleaseFrame();
-                    }
+                    ActiveSource().ReleaseFrame();
                     frame->Release();
                 }
 
@@ -1667,8 +1910,8 @@ LRESULT CALLBACK TrayWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
                     ShowWindow(g_renderWnd, SW_SHOWNOACTIVATE);
                 }
                 // 4. Initialize renderer (IMPORTANT: use the same D3D11 device/context as capture)
-                ID3D11Device* dev = (g_captureMode == CaptureMode::Monitor) ? g_capture.GetDevice() : g_captureWgc.GetDevice();
-                ID3D11DeviceContext* ctx = (g_captureMode == CaptureMode::Monitor) ? g_capture.GetContext() : g_captureWgc.GetContext();
+                ID3D11Device* dev = ActiveSource().GetDevice();
+                ID3D11DeviceContext* ctx = ActiveSource().GetContext();
                 if (g_renderWnd && g_renderer.Init(g_renderWnd, width, height, format, dev, ctx)) {
                     BeginHighResTimers();
                     // Re-apply all user-facing render flags after Init/Cleanup.
@@ -1691,6 +1934,7 @@ LRESULT CALLBACK TrayWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
                     ApplyRenderWindowClickThrough(g_renderWnd, g_clickThrough);
                     ApplyRenderWindowExcludeFromCapture(g_renderWnd, GetEffectiveExcludeFromCapture());
                     g_renderWndNoActivate = (g_captureMode == CaptureMode::Window);
+                    OpenOutputSinks();
                     g_capturing = true;
 
                     // Default: open output window as borderless fullscreen.
@@ -1728,11 +1972,10 @@ LRESULT CALLBACK TrayWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
                 }
                 tray.SetCaptureActive(false);
                 Log::Info("Stopping capture...");
-                if (g_captureMode == CaptureMode::Monitor) {
-                    g_capture.Cleanup();
-                } else {
-                    g_captureWgc.Cleanup();
-                }
+                EndCaptureTrace();
+                ActiveSource().Cleanup();
+                g_captureThreadAttempted = false;
+                CloseOutputSinks();
                 g_renderer.Cleanup();
                 EndHighResTimers();
                 if (g_renderWnd) {
@@ -1994,6 +2237,7 @@ LRESULT CALLBACK TrayWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
                     ApplyRenderWindowClickThrough(g_renderWnd, g_clickThrough);
                     ApplyRenderWindowExcludeFromCapture(g_renderWnd, GetEffectiveExcludeFromCapture());
                     g_renderWndNoActivate = (g_captureMode == CaptureMode::Window);
+                    OpenOutputSinks();
 
                     if (g_defaultOutputFullscreen) {
                         UpdateOutputMonitorIndexFromWindow(g_renderWnd);
@@ -2127,6 +2371,7 @@ LRESULT CALLBACK TrayWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
             ApplyRenderWindowExcludeFromCapture(g_renderWnd, GetEffectiveExcludeFromCapture());
             EnsureRenderWindowShowsInTaskbar(g_renderWnd);
             g_renderWndNoActivate = (g_captureMode == CaptureMode::Window);
+            OpenOutputSinks();
 
             // Default: open output window as borderless fullscreen.
             if (g_defaultOutputFullscreen) {
@@ -2228,6 +2473,8 @@ LRESULT CALLBACK TrayWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
     case WM_DESTROY:
         // Best-effort persist of the last in-memory state.
         SaveSettingsFromState(tray);
+        EndCaptureTrace();
+        g_captureThread.Stop();
         tray.Cleanup();
         PostQuitMessage(0);
         break;
@@ -2396,18 +2643,40 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow) {
     // Dev/escape hatch: allow closing an existing tray-only instance even if the tray menu is broken.
     // Usage: ArinCaptureSBS.exe --shutdown
     {
+        // Headless testing: start capture from a synthetic/replay source instead of the desktop.
+        // Usage: ArinCaptureSBS.exe --synthetic[=WxH@fps,checker,repeat=N,jitter=MS] [--replay <frames>] [--replay-trace <file.actrace>]
         int argc = 0;
         LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
         bool shutdown = false;
         if (argv) {
             for (int i = 1; i < argc; ++i) {
-                if (argv[i] && lstrcmpiW(argv[i], L"--shutdown") == 0) {
+                if (!argv[i]) continue;
+                if (lstrcmpiW(argv[i], L"--shutdown") == 0) {
                     shutdown = true;
                     break;
                 }
+                if (lstrcmpiW(argv[i], L"--synthetic") == 0) {
+                    g_syntheticRequested = true;
+                } else if (wcsncmp(argv[i], L"--synthetic=", 12) == 0) {
+                    g_syntheticRequested = true;
+                    if (!SyntheticSource::ParseSpec(argv[i] + 12, &g_syntheticConfig)) {
+                        MessageBoxW(nullptr, L"Invalid --synthetic spec (expected WxH@fps[,checker][,repeat=N][,jitter=MS]).", L"ArinCapture", MB_OK | MB_ICONERROR);
+                        LocalFree(argv);
+                        return 1;
+                    }
+                } else if (lstrcmpiW(argv[i], L"--replay") == 0 && i + 1 < argc) {
+                    g_syntheticRequested = true;
+                    g_syntheticConfig.replayPath = argv[++i];
+                } else if (lstrcmpiW(argv[i], L"--replay-trace") == 0 && i + 1 < argc) {
+                    g_syntheticRequested = true;
+                    g_syntheticConfig.tracePath = argv[++i];
+                }
             }
             LocalFree(argv);
         }
+        // Raw BGRA replays take their frame size from the --synthetic spec.
+        g_syntheticConfig.replayRawWidth = g_syntheticConfig.width;
+        g_syntheticConfig.replayRawHeight = g_syntheticConfig.height;
 
         if (shutdown) {
             HWND existing = FindWindowW(L"ArinCaptureTrayClass", L"ArinCapture");
@@ -2436,6 +2705,20 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow) {
         g_stereoEnabled = s.stereoEnabled;
         g_stereoDepthLevel = s.stereoDepthLevel;
         g_stereoParallaxStrengthPercent = s.stereoParallaxStrengthPercent;
+        g_stereoShaderMode = s.stereoShaderMode;
+        g_stereoDepthPrecision = s.stereoDepthPrecision;
+        g_stereoContentFingerprint = s.stereoContentFingerprint;
+        g_stereoFoveation = s.stereoFoveation;
+        g_stereoFoveaRadiusPercent = s.stereoFoveaRadiusPercent;
+        g_stereoFoveaFalloffPercent = s.stereoFoveaFalloffPercent;
+        g_stereoFrameInterpolation = s.stereoFrameInterpolation;
+        g_stereoLayout = s.stereoLayout;
+        for (int i = 0; i < AppSettings::kMaxSinks; ++i) {
+            g_sinks[i] = s.sinks[i];
+        }
+        g_captureTraceEnabled = s.captureTrace;
+        g_captureTraceThumbnails = s.captureTraceThumbnails;
+        g_captureThreadEnabled = s.captureThread;
 
         g_vsyncEnabled = s.vsyncEnabled;
         g_clickThrough = s.clickThrough;
@@ -2455,13 +2738,24 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow) {
         g_renderer.SetStereoEnabled(s.stereoEnabled);
         g_renderer.SetStereoDepthLevel(s.stereoDepthLevel);
         g_renderer.SetStereoParallaxStrengthPercent(s.stereoParallaxStrengthPercent);
-        g_renderer.SetStereoShaderMode(Renderer::StereoShaderMode::Depth3Pass);
+        g_renderer.SetStereoShaderMode((Renderer::StereoShaderMode)s.stereoShaderMode);
+        g_renderer.SetDepthPrecision((Renderer::DepthPrecision)s.stereoDepthPrecision);
+        g_renderer.SetContentFingerprint((Renderer::ContentFingerprint)s.stereoContentFingerprint);
+        g_renderer.SetFoveation(s.stereoFoveation, s.stereoFoveaRadiusPercent, s.stereoFoveaFalloffPercent);
+        g_renderer.SetFrameInterpolation(s.stereoFrameInterpolation);
+        g_renderer.SetStereoLayout((Renderer::StereoLayout)s.stereoLayout);
 
         Log::Info(
             std::string("Settings summary:") +
             " stereoEnabled=" + std::to_string((int)s.stereoEnabled) +
             " depthLevel=" + std::to_string(s.stereoDepthLevel) +
             " parallaxStrengthPercent=" + std::to_string(s.stereoParallaxStrengthPercent) +
+            " shaderMode=" + std::to_string(s.stereoShaderMode) +
+            " depthPrecision=" + std::to_string(s.stereoDepthPrecision) +
+            " contentFingerprint=" + std::to_string(s.stereoContentFingerprint) +
+            " foveation=" + std::to_string(s.stereoFoveation) +
+            " frameInterpolation=" + std::to_string((int)s.stereoFrameInterpolation) +
+            " layout=" + std::to_string(s.stereoLayout) +
             " vsync=" + std::to_string((int)s.vsyncEnabled) +
             " cursorOverlay=" + std::to_string((int)s.cursorOverlay) +
             " renderResPresetIndex=" + std::to_string(s.renderResPresetIndex)
@@ -2482,13 +2776,17 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow) {
 
     g_trayWnd = hWnd;
 
+    if (g_syntheticRequested) {
+        PostMessage(hWnd, WM_APP + 2, 4, 0);
+    }
+
     // Message loop with frame pacing
     MSG msg;
     Log::Info("Entering message loop");
 
     LARGE_INTEGER qpf;
     QueryPerformanceFrequency(&qpf);
-    LONGLONG nextFrameQpc = 0;
+    FramePacer pacer(qpf.QuadPart);
 
     for (;;) {
         while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
@@ -2505,48 +2803,28 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow) {
         }
 
         if (!(g_capturing && g_renderWnd)) {
-            nextFrameQpc = 0;
+            pacer.Reset();
             WaitMessage();
             continue;
         }
 
-        const double intervalSec = g_renderer.GetFrameInterval();
         LARGE_INTEGER now;
         QueryPerformanceCounter(&now);
 
-        if (intervalSec <= 0.0) {
-            // Unlimited: render as fast as possible, but still yield to the message queue.
+        // Policy lives in FramePacer (simulated by ArinPacingSim); this loop only carries it out.
+        const FramePacer::Decision d = pacer.Next(now.QuadPart, g_renderer.GetFrameInterval());
+        switch (d.action) {
+        case FramePacer::Action::Render:
             RenderOneFrame(g_renderWnd);
-            MsgWaitForMultipleObjectsEx(0, nullptr, 0, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
-            continue;
-        }
-
-        const LONGLONG intervalTicks = (LONGLONG)(intervalSec * (double)qpf.QuadPart);
-        if (intervalTicks <= 0) {
+            break;
+        case FramePacer::Action::RenderAndYield:
             RenderOneFrame(g_renderWnd);
             MsgWaitForMultipleObjectsEx(0, nullptr, 0, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
-            continue;
-        }
-
-        if (nextFrameQpc == 0) {
-            nextFrameQpc = now.QuadPart + intervalTicks;
-        }
-
-        if (now.QuadPart >= nextFrameQpc) {
-            RenderOneFrame(g_renderWnd);
-            nextFrameQpc += intervalTicks;
-            // If we fell far behind, resync instead of trying to "catch up".
-            if (now.QuadPart - nextFrameQpc > intervalTicks * 4) {
-                nextFrameQpc = now.QuadPart + intervalTicks;
-            }
-            continue;
+            break;
+        case FramePacer::Action::Wait:
+            MsgWaitForMultipleObjectsEx(0, nullptr, d.waitMs, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+            break;
         }
-
-        const LONGLONG remaining = nextFrameQpc - now.QuadPart;
-        DWORD timeoutMs = (DWORD)((remaining * 1000LL) / qpf.QuadPart);
-        // Avoid a long oversleep; wake at least every 1ms.
-        if (timeoutMs > 1) timeoutMs -= 1;
-        MsgWaitForMultipleObjectsEx(0, nullptr, timeoutMs, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
     }
     return 0;
 }